@@ -0,0 +1,18 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_BENCHMARKS_HPP_
+#define MINECLONE_CLIENT_BENCHMARKS_HPP_
+
+#include "Common.hpp"
+
+#include <ostream>
+
+namespace MineClone
+{
+
+// Micro benchmarks that run without a window or a GPU, started with --benchmark <name>.
+// Returns false when there is no benchmark with that name.
+bool RunBenchmark(const std::string &name, std::ostream &output);
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_BENCHMARKS_HPP_
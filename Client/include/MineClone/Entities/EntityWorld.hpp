@@ -0,0 +1,282 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_ENTITIES_ENTITYWORLD_HPP_
+#define MINECLONE_CLIENT_ENTITIES_ENTITYWORLD_HPP_
+
+#include "../Common.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace MineClone
+{
+
+// one bit per component type
+using ComponentMask = uint64_t;
+
+inline constexpr size_t MAX_COMPONENT_TYPES = 64;
+
+// Ids are handed out the first time a component type is used, in no particular order. Components are plain data: they
+// are moved around with memcpy and never constructed or destroyed.
+uint32_t RegisterComponentType(size_t size);
+
+[[nodiscard]] size_t GetComponentSize(uint32_t component);
+
+template <typename T>
+[[nodiscard]] uint32_t GetComponentId()
+{
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>, "components have to be plain data");
+    static_assert(alignof(T) <= alignof(std::max_align_t), "component columns are only aligned for the standard types");
+
+    static const uint32_t id = RegisterComponentType(sizeof(T));
+    return id;
+}
+
+template <typename... Ts>
+[[nodiscard]] ComponentMask GetComponentMask()
+{
+    return (ComponentMask{0} | ... | (ComponentMask{1} << GetComponentId<Ts>()));
+}
+
+// A handle that stays valid while the entity lives, wherever its components move. The generation of a slot goes up
+// when its entity is destroyed, so handles of dead entities never point at the one that reuses the slot.
+struct Entity
+{
+    static constexpr uint32_t INVALID_INDEX = ~uint32_t{0};
+
+    uint32_t Index{INVALID_INDEX};
+    uint32_t Generation{0};
+
+    [[nodiscard]] constexpr bool operator==(const Entity &other) const noexcept
+    {
+        return Index == other.Index && Generation == other.Generation;
+    }
+
+    [[nodiscard]] constexpr bool operator!=(const Entity &other) const noexcept
+    {
+        return !(*this == other);
+    }
+}; // struct Entity
+
+// All entities with exactly the same set of components, one dense array per component and one row per entity.
+// Removing a row moves the last one into its place, so the arrays never have holes.
+class Archetype
+{
+  public:
+    explicit Archetype(ComponentMask mask);
+
+    NON_COPYABLE(Archetype);
+    NON_MOVABLE(Archetype);
+
+  public:
+    // appends a row with zeroed components
+    size_t Push(Entity entity);
+
+    // removes the row, returns the entity that was moved into it or an invalid one if it was the last row
+    Entity SwapRemove(size_t row);
+
+    // copies the components both archetypes have from a row of this one to a row of the other
+    void CopyRow(size_t row, Archetype &destination, size_t destinationRow) const;
+
+    [[nodiscard]] ComponentMask GetMask() const noexcept;
+    [[nodiscard]] size_t GetSize() const noexcept;
+    [[nodiscard]] const Entity *GetEntities() const noexcept;
+    [[nodiscard]] size_t GetMemoryUsage() const noexcept;
+
+    // the component has to be part of the archetype
+    template <typename T>
+    [[nodiscard]] T *GetColumn() noexcept
+    {
+        return reinterpret_cast<T *>(m_columns[m_columnIndices[GetComponentId<T>()]].Data.data());
+    }
+
+  private:
+    struct Column
+    {
+        uint32_t Component;
+        size_t Size;
+        std::vector<std::byte> Data;
+    }; // struct Column
+
+    const ComponentMask m_mask;
+    std::vector<Column> m_columns{};
+    std::array<uint8_t, MAX_COMPONENT_TYPES> m_columnIndices{};
+    std::vector<Entity> m_entities{};
+}; // class Archetype
+
+// Entities for mobs, item drops and anything else with more than a handful of instances. Components are stored by
+// archetype as structures of arrays: a system asking for positions and velocities walks a few dense arrays front to
+// back instead of chasing one heap object per entity through a virtual call.
+//
+// Adding or removing components moves the entity to another archetype, which copies all of its components; do it for
+// state changes, not every tick. Nothing may change the structure while a system iterates, queue the changes with
+// Defer instead and Flush them once the systems are done. Iterating from several threads at once is fine as long as
+// no two of them write the same components, see SystemScheduler.
+class EntityWorld
+{
+  public:
+    EntityWorld() = default;
+
+    NON_COPYABLE(EntityWorld);
+    NON_MOVABLE(EntityWorld);
+
+  public:
+    template <typename... Ts>
+    Entity Create(const Ts &...components)
+    {
+        const Entity entity = Allocate(GetComponentMask<Ts...>());
+        (Write(entity, components), ...);
+
+        return entity;
+    }
+
+    // handles of dead entities are ignored
+    void Destroy(Entity entity);
+
+    // destroys every entity, the archetypes stay around
+    void Clear();
+
+    [[nodiscard]] bool IsAlive(Entity entity) const noexcept;
+
+    template <typename T>
+    [[nodiscard]] bool Has(Entity entity) const
+    {
+        return IsAlive(entity) && (m_archetypes[m_slots[entity.Index].Archetype]->GetMask() >> GetComponentId<T>() & 1) != 0;
+    }
+
+    // nullptr for dead entities and missing components, valid until the structure changes
+    template <typename T>
+    [[nodiscard]] T *Get(Entity entity)
+    {
+        if (!Has<T>(entity))
+            return nullptr;
+
+        const Slot &slot = m_slots[entity.Index];
+        return m_archetypes[slot.Archetype]->template GetColumn<T>() + slot.Row;
+    }
+
+    // overwrites the component if the entity already has it
+    template <typename T>
+    void Add(Entity entity, const T &component)
+    {
+        if (!IsAlive(entity))
+            return;
+
+        ChangeMask(entity, m_archetypes[m_slots[entity.Index].Archetype]->GetMask() | ComponentMask{1} << GetComponentId<T>());
+        Write(entity, component);
+    }
+
+    template <typename T>
+    void Remove(Entity entity)
+    {
+        if (!IsAlive(entity))
+            return;
+
+        ChangeMask(entity, m_archetypes[m_slots[entity.Index].Archetype]->GetMask() & ~(ComponentMask{1} << GetComponentId<T>()));
+    }
+
+    // Calls function(count, entities, columns...) once per archetype that has all of the components, with one array per
+    // component in the order they are listed. Meant for loops over whole arrays and the batched APIs that take them.
+    template <typename... Ts, typename F>
+    void EachColumn(F &&function)
+    {
+        const ComponentMask mask = GetComponentMask<Ts...>();
+        const IterationScope scope{*this};
+
+        for (const std::unique_ptr<Archetype> &archetype : m_archetypes)
+        {
+            if ((archetype->GetMask() & mask) != mask || archetype->GetSize() == 0)
+                continue;
+
+            function(archetype->GetSize(), archetype->GetEntities(), archetype->template GetColumn<Ts>()...);
+        }
+    }
+
+    // calls function(entity, components...) for every entity that has all of the components
+    template <typename... Ts, typename F>
+    void Each(F &&function)
+    {
+        EachColumn<Ts...>([&function](size_t count, const Entity *entities, Ts *...columns) {
+            for (size_t i = 0; i < count; i++)
+                function(entities[i], columns[i]...);
+        });
+    }
+
+    // runs the command on the next Flush, callable from any thread and while iterating
+    void Defer(std::function<void(EntityWorld &)> command);
+
+    // runs the deferred commands in the order they were queued
+    void Flush();
+
+    [[nodiscard]] size_t GetEntityCount() const noexcept;
+    [[nodiscard]] size_t GetArchetypeCount() const noexcept;
+
+    void Dump(std::ostream &stream) const;
+
+  private:
+    struct Slot
+    {
+        uint32_t Generation{0};
+        uint32_t Archetype{0};
+        uint32_t Row{0};
+    }; // struct Slot
+
+    // counts the iterations in flight, structural changes in the middle of one would move rows under it
+    class IterationScope
+    {
+      public:
+        explicit IterationScope(EntityWorld &world) noexcept : m_world{world}
+        {
+            m_world.m_iterations.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        ~IterationScope()
+        {
+            m_world.m_iterations.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        NON_COPYABLE(IterationScope);
+        NON_MOVABLE(IterationScope);
+
+      private:
+        EntityWorld &m_world;
+    }; // class IterationScope
+
+    Entity Allocate(ComponentMask mask);
+    void ChangeMask(Entity entity, ComponentMask mask);
+    uint32_t FindArchetype(ComponentMask mask);
+    void CheckStructureChange() const;
+
+    template <typename T>
+    void Write(Entity entity, const T &component)
+    {
+        const Slot &slot = m_slots[entity.Index];
+        std::memcpy(m_archetypes[slot.Archetype]->template GetColumn<T>() + slot.Row, &component, sizeof(T));
+    }
+
+  private:
+    std::vector<std::unique_ptr<Archetype>> m_archetypes{};
+    std::unordered_map<ComponentMask, uint32_t> m_archetypeIndices{};
+
+    std::vector<Slot> m_slots{};
+    std::vector<uint32_t> m_freeSlots{};
+    size_t m_entityCount{0};
+
+    std::atomic<uint32_t> m_iterations{0};
+
+    std::mutex m_deferredMutex{};
+    std::vector<std::function<void(EntityWorld &)>> m_deferred{};
+    std::vector<std::function<void(EntityWorld &)>> m_flushing{};
+}; // class EntityWorld
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_ENTITIES_ENTITYWORLD_HPP_
@@ -0,0 +1,65 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_ENTITIES_SYSTEMSCHEDULER_HPP_
+#define MINECLONE_CLIENT_ENTITIES_SYSTEMSCHEDULER_HPP_
+
+#include "EntityWorld.hpp"
+
+#include <MineClone/Jobs/JobSystem.hpp>
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace MineClone
+{
+
+using SystemFunction = std::function<void(EntityWorld &world, float seconds)>;
+
+// Runs the systems of an entity world once per tick, each as one job. Every system declares the components it reads
+// and writes; two systems conflict when one writes what the other touches, and conflicting systems run in the order
+// they were added while the rest run at the same time. Systems don't have to be thread safe among themselves, only
+// their declarations have to be honest.
+//
+// Systems may only change the structure of the world through EntityWorld::Defer, the commands run after all of them.
+class SystemScheduler
+{
+  public:
+    void Add(std::string name, ComponentMask reads, ComponentMask writes, SystemFunction function);
+
+    // runs the systems on the job system, where this thread only waits, or one after another here without one; then
+    // flushes the world
+    void Run(EntityWorld &world, float seconds, JobSystem *jobSystem);
+
+    [[nodiscard]] size_t GetSystemCount() const noexcept;
+
+    void Dump(std::ostream &stream) const;
+
+  private:
+    struct System
+    {
+        std::string Name;
+        ComponentMask Reads;
+        ComponentMask Writes;
+        SystemFunction Function;
+
+        // earlier systems that conflict with this one
+        std::vector<size_t> Dependencies;
+
+        double TotalMilliseconds{0.0};
+    }; // struct System
+
+    static void Execute(System &system, EntityWorld &world, float seconds);
+
+  private:
+    std::vector<System> m_systems{};
+    std::vector<JobHandle> m_jobs{};
+    std::vector<JobHandle> m_dependencies{};
+
+    uint64_t m_runs{0};
+    double m_totalMilliseconds{0.0};
+}; // class SystemScheduler
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_ENTITIES_SYSTEMSCHEDULER_HPP_
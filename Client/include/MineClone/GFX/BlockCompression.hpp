@@ -0,0 +1,56 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_BLOCKCOMPRESSION_HPP_
+#define MINECLONE_CLIENT_GFX_BLOCKCOMPRESSION_HPP_
+
+#include "Mipmaps.hpp"
+
+#include <string>
+#include <vector>
+
+namespace MineClone
+{
+
+enum class TextureFormat : uint8_t
+{
+    Rgba8, // 32 bits per texel, for devices without BC support
+    Bc1,   // 4 bits per texel, opaque RGB at 5:6:5 endpoint precision
+    Bc7,   // 8 bits per texel, RGBA with much better color fidelity than BC1
+    Count
+}; // enum class TextureFormat
+
+// Encoders for the BC formats, one 4x4 block at a time so the blocks of a texture can be spread over threads. Images
+// whose sides aren't multiples of 4, the smallest mips, are padded by repeating their last row and column.
+//
+// BC1 fits the endpoints to the principal axis of the block's colors and refines them with a least squares pass. BC7
+// only uses mode 6, a single subset with 7 bit endpoints, a shared bit per endpoint and 4 bit indices, which is close
+// to the best mode for the smooth, opaque textures blocks have. The decoders are references for what the encoders
+// write: BC1 completely, BC7 mode 6 only.
+namespace BlockCompression
+{
+
+[[nodiscard]] const char *GetFormatName(TextureFormat format) noexcept;
+
+// the inverse of GetFormatName ignoring case, returns false for unknown names
+[[nodiscard]] bool ParseFormat(const std::string &name, TextureFormat &format) noexcept;
+
+// whole blocks, the last ones padded
+[[nodiscard]] size_t GetEncodedSize(TextureFormat format, uint32_t width, uint32_t height) noexcept;
+
+// appends the encoded image to out
+void Encode(TextureFormat format, const TextureImage &image, std::vector<uint8_t> &out);
+[[nodiscard]] TextureImage Decode(TextureFormat format, const uint8_t *data, uint32_t width, uint32_t height);
+
+// texels in row major order
+void EncodeBc1Block(const uint32_t *texels, uint8_t *out) noexcept;
+void EncodeBc7Block(const uint32_t *texels, uint8_t *out) noexcept;
+void DecodeBc1Block(const uint8_t *data, uint32_t *texels) noexcept;
+void DecodeBc7Block(const uint8_t *data, uint32_t *texels) noexcept;
+
+// peak signal to noise ratio over the color channels in dB, higher is better and identical images are infinite
+[[nodiscard]] double ComputePsnr(const TextureImage &reference, const TextureImage &image);
+
+} // namespace BlockCompression
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_BLOCKCOMPRESSION_HPP_
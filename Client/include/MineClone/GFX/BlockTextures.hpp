@@ -0,0 +1,99 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_BLOCKTEXTURES_HPP_
+#define MINECLONE_CLIENT_GFX_BLOCKTEXTURES_HPP_
+
+#include "BlockCompression.hpp"
+#include "Graphics.hpp"
+#include "MemoryAllocator.hpp"
+#include "Mipmaps.hpp"
+
+#include <MineClone/Jobs/JobSystem.hpp>
+#include <MineClone/World/Block.hpp>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace MineClone
+{
+
+class VulkanContext; // VulkanContext.hpp
+
+struct BlockTextureOptions
+{
+    // falls back to RGBA8 where the device can't sample BC formats
+    TextureFormat Format{TextureFormat::Bc7};
+    MipFilter Filter{MipFilter::Kaiser};
+
+    // encoded layers are kept here by content hash, nothing is cached when empty
+    std::string CacheDirectory{};
+}; // struct BlockTextureOptions
+
+// The tiling texture of a block, generated until there are texture assets. Layer 0 is the texture for unknown blocks.
+[[nodiscard]] TextureImage GenerateBlockTexture(BlockId block, uint32_t size);
+
+// One texture layer per block in a single 2D array image with full mip chains: unlike an atlas, nothing bleeds between
+// textures at the lower mips and the UVs of merged quads simply repeat. Each layer is mipmapped and block compressed on
+// a worker, or read from the disk cache when a layer with the same content was encoded before. The chunk fragment
+// shader samples the array by the layer index in the quad's material.
+class BlockTextures
+{
+  public:
+    static constexpr uint32_t TEXTURE_SIZE = 32;
+
+    // one layer per block id, the mesher uses the block as the texture index
+    static constexpr uint32_t LAYER_COUNT = Blocks::LAMP + 1;
+
+  public:
+    NON_COPYABLE(BlockTextures);
+    NON_MOVABLE(BlockTextures);
+
+    BlockTextures() = default;
+    ~BlockTextures();
+
+  public:
+    // encodes on the job system's workers when there is one and blocks until the layers are queued for upload
+    void Create(VulkanContext *context, JobSystem *jobSystem, const BlockTextureOptions &options);
+
+    void Destroy();
+
+    void Dump(std::ostream &stream) const;
+
+    [[nodiscard]] VkImageView GetImageView() noexcept;
+    [[nodiscard]] VkSampler GetSampler() noexcept;
+    [[nodiscard]] TextureFormat GetFormat() const noexcept;
+
+  private:
+    struct Layer
+    {
+        std::vector<uint8_t> Data{};         // every mip level, largest first
+        std::vector<size_t> LevelOffsets{};
+        double Psnr{0.0};                    // of the top level after encoding
+        bool Cached{false};
+    }; // struct Layer
+
+    [[nodiscard]] TextureFormat SelectFormat(TextureFormat preferred);
+    void EncodeLayer(uint32_t index);
+    [[nodiscard]] bool LoadCached(const std::string &path, uint64_t hash, Layer &layer) const;
+    void SaveCached(const std::string &path, uint64_t hash, const Layer &layer) const;
+    void CreateImage();
+    void CreateSampler();
+
+  private:
+    VulkanContext *m_context{nullptr};
+    BlockTextureOptions m_options{};
+    TextureFormat m_format{TextureFormat::Rgba8};
+    uint32_t m_levelCount{0};
+
+    std::vector<Layer> m_layers{};
+    double m_encodeSeconds{0.0};
+
+    VkImage m_image{VK_NULL_HANDLE};
+    MemoryAllocation m_memory{};
+    VkImageView m_imageView{VK_NULL_HANDLE};
+    VkSampler m_sampler{VK_NULL_HANDLE};
+}; // class BlockTextures
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_BLOCKTEXTURES_HPP_
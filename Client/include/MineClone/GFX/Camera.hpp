@@ -0,0 +1,52 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_CAMERA_HPP_
+#define MINECLONE_CLIENT_GFX_CAMERA_HPP_
+
+#include "../Common.hpp"
+
+#include <array>
+
+namespace MineClone
+{
+
+// A free flying perspective camera. Right handed with +Y up, yaw 0 looks along -Z. The matrix follows the Vulkan
+// conventions: clip space Y points down and depth goes from 0 at the near plane to 1 at the far plane.
+class Camera
+{
+  public:
+    // column major, like GLSL
+    using Matrix = std::array<float, 16>;
+
+  public:
+    void SetPosition(float x, float y, float z) noexcept;
+
+    // radians, pitch is clamped just short of straight up and down
+    void SetRotation(float yaw, float pitch) noexcept;
+    void Rotate(float yaw, float pitch) noexcept;
+
+    // forward and right follow the view direction flattened onto the ground, up is always +Y
+    void Move(float forward, float right, float up) noexcept;
+
+    void SetPerspective(float fovY, float nearPlane, float farPlane) noexcept;
+    void SetAspect(float aspect) noexcept;
+
+    [[nodiscard]] Matrix GetViewProjection() const noexcept;
+
+    [[nodiscard]] float GetX() const noexcept;
+    [[nodiscard]] float GetY() const noexcept;
+    [[nodiscard]] float GetZ() const noexcept;
+    [[nodiscard]] float GetYaw() const noexcept;
+    [[nodiscard]] float GetPitch() const noexcept;
+
+  private:
+    float m_x{0.0f}, m_y{0.0f}, m_z{0.0f};
+    float m_yaw{0.0f}, m_pitch{0.0f};
+    float m_fovY{1.2f};
+    float m_aspect{1.0f};
+    float m_near{0.1f};
+    float m_far{1000.0f};
+}; // class Camera
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_CAMERA_HPP_
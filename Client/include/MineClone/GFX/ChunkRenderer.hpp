@@ -0,0 +1,154 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_CHUNKRENDERER_HPP_
+#define MINECLONE_CLIENT_GFX_CHUNKRENDERER_HPP_
+
+#include "Camera.hpp"
+#include "Graphics.hpp"
+#include "MemoryAllocator.hpp"
+#include "SectionVisibility.hpp"
+#include "TlsfHeap.hpp"
+
+#include <MineClone/World/ChunkMesher.hpp>
+
+#include <ostream>
+#include <vector>
+
+namespace MineClone
+{
+
+class VulkanContext; // VulkanContext.hpp
+
+// Draws meshed sections with vertex pulling, the pipeline has no vertex input state. The quads of every section are
+// sub-allocated from one device local storage buffer, a shared index buffer expands each quad into two triangles.
+// Only the sections SectionVisibility lets through are drawn: their commands go to a per frame indirect buffer and
+// the whole set is drawn with one indirect call, so recording costs the same for ten sections or ten thousand. With
+// GpuCulling active the cpu pass is skipped and the draw list comes from its compute pass instead. Devices without
+// indirect draws get one direct draw per section, split into batches that are recorded in parallel.
+class ChunkRenderer
+{
+  public:
+    // 128 MiB of quads
+    static constexpr uint32_t QUAD_CAPACITY = 1u << 24;
+
+    // one origin and one indirect command per section
+    static constexpr uint32_t SECTION_CAPACITY = 1u << 16;
+
+    // every pair of neighboring blocks shares at most one face, plus the faces on the section boundary
+    static constexpr uint32_t MAX_SECTION_QUADS = 3 * ChunkSection::VOLUME + 6 * ChunkSection::SIZE * ChunkSection::SIZE;
+
+    // direct draws per batch, enough that a batch outweighs the cost of its own command buffer
+    static constexpr uint32_t DRAWS_PER_BATCH = 256;
+
+    struct PushConstants
+    {
+        Camera::Matrix ViewProjection;
+    }; // struct PushConstants
+
+  public:
+    NON_COPYABLE(ChunkRenderer);
+    NON_MOVABLE(ChunkRenderer);
+
+    ChunkRenderer() = default;
+    ~ChunkRenderer();
+
+  public:
+    void Create(VulkanContext *context);
+
+    void Destroy();
+
+    // Section coordinates, not blocks. Returns false when the quad buffer or the upload ring is full, the ring drains
+    // within a frame or two so the call can be retried later. Empty sections are added too, views pass through them.
+    bool AddSection(int32_t x, int32_t y, int32_t z, const ChunkMesh &mesh, SectionConnectivity connectivity);
+
+    // Stops drawing the section from the next frame on. Its quads and index are recycled once the frames in flight
+    // that may still draw it have finished. Does nothing for sections that were never added.
+    void RemoveSection(int32_t x, int32_t y, int32_t z);
+
+    // picks the sections RecordBatch draws and writes their commands for the frame, once per frame before recording
+    void UpdateVisibility(const Camera &camera, size_t frame);
+
+    // how many command buffers the frame's draws are recorded into, 0 when nothing is drawn
+    [[nodiscard]] uint32_t GetBatchCount(size_t frame) const noexcept;
+
+    // Inside the render pass, with viewport and scissor set. Batches only read the state UpdateVisibility left behind,
+    // so they can be recorded concurrently into different command buffers.
+    void RecordBatch(VkCommandBuffer commandBuffer, const Camera &camera, size_t frame, uint32_t batch) const;
+
+    void Dump(std::ostream &stream) const;
+
+    [[nodiscard]] SectionVisibility &GetVisibility() noexcept;
+    [[nodiscard]] VkDescriptorSetLayout GetDescriptorSetLayout() noexcept;
+    [[nodiscard]] size_t GetSectionCount() const noexcept;
+    [[nodiscard]] size_t GetQuadCount() const noexcept;
+    [[nodiscard]] bool UsesIndirectDraws() const noexcept;
+    [[nodiscard]] bool UsesIndirectCount() const noexcept;
+
+  private:
+    // indexed like the sections of m_visibility
+    struct SectionDraw
+    {
+        int32_t X, Y, Z;
+        uint32_t FirstQuad;
+        uint32_t QuadCount;
+        uint32_t Block; // in m_quadHeap
+    }; // struct SectionDraw
+
+    // removed, but possibly still drawn by a frame in flight
+    struct RetiredSection
+    {
+        uint32_t Index;
+        uint32_t Block;
+        bool Hidden;           // the culling pass no longer sees it either
+        uint64_t ReleaseFrame; // once Hidden
+    }; // struct RetiredSection
+
+    void CreateDescriptors();
+    void CreateBuffers();
+
+    // once per frame, after its fence
+    void ReleaseRetiredSections();
+
+    [[nodiscard]] VkDeviceSize GetCountOffset(size_t frame) const noexcept;
+    [[nodiscard]] VkDeviceSize GetCommandOffset(size_t frame) const noexcept;
+
+  private:
+    VulkanContext *m_context{nullptr};
+
+    VkDescriptorSetLayout m_descriptorSetLayout{VK_NULL_HANDLE};
+    VkDescriptorPool m_descriptorPool{VK_NULL_HANDLE};
+    VkDescriptorSet m_descriptorSet{VK_NULL_HANDLE};
+
+    VkBuffer m_quadBuffer{VK_NULL_HANDLE};
+    MemoryAllocation m_quadMemory{};
+    VkBuffer m_indexBuffer{VK_NULL_HANDLE};
+    MemoryAllocation m_indexMemory{};
+    VkBuffer m_sectionBuffer{VK_NULL_HANDLE};
+    MemoryAllocation m_sectionMemory{};
+
+    // host visible, per frame in flight a draw count followed by SECTION_CAPACITY commands
+    VkBuffer m_indirectBuffer{VK_NULL_HANDLE};
+    MemoryAllocation m_indirectMemory{};
+    std::vector<uint32_t> m_drawCounts{};
+
+    // indirect draws need multiDrawIndirect and drawIndirectFirstInstance, without them RecordBatch loops over direct draws
+    bool m_indirectDraws{false};
+    PFN_vkCmdDrawIndexedIndirectCountKHR m_drawIndexedIndirectCount{nullptr};
+
+    TlsfHeap m_quadHeap{QUAD_CAPACITY};
+    uint32_t m_quadCount{0};
+    std::vector<SectionDraw> m_draws{};
+    std::vector<RetiredSection> m_retired{};
+    uint64_t m_frameCount{0};
+
+    SectionVisibility m_visibility{};
+    std::vector<uint32_t> m_visible{};
+
+    // totals over every UpdateVisibility call, for the averages in Dump
+    uint64_t m_visibilityUpdates{0};
+    uint64_t m_inFrustumTotal{0};
+    uint64_t m_visibleTotal{0};
+}; // class ChunkRenderer
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_CHUNKRENDERER_HPP_
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_COMMANDPOOLS_HPP_
+#define MINECLONE_CLIENT_GFX_COMMANDPOOLS_HPP_
+
+#include "Graphics.hpp"
+
+#include <ostream>
+#include <vector>
+
+namespace MineClone
+{
+
+class VulkanContext; // VulkanContext.hpp
+
+// One command pool per frame in flight and recording thread, so threads record at the same time without locking and
+// a frame's buffers are recycled with a single pool reset once its fence signals. Thread 0 is the render thread, which
+// also owns the frame's primary buffer; job system worker i is thread i + 1. Secondary buffers are allocated the first
+// time a frame needs that many on a thread and reused from then on.
+class CommandPools
+{
+  public:
+    NON_COPYABLE(CommandPools);
+    NON_MOVABLE(CommandPools);
+
+    CommandPools() = default;
+    ~CommandPools();
+
+  public:
+    void Create(VulkanContext *context, size_t frameCount, size_t threadCount);
+
+    void Destroy();
+
+    // after the frame's fence, every buffer of the frame goes back to the initial state
+    void Reset(size_t frame);
+
+    [[nodiscard]] VkCommandBuffer GetPrimary(size_t frame) noexcept;
+
+    // only from the given thread, until the next Reset of the frame
+    [[nodiscard]] VkCommandBuffer AllocateSecondary(size_t frame, size_t thread);
+
+    void Dump(std::ostream &stream) const;
+
+    [[nodiscard]] size_t GetThreadCount() const noexcept;
+
+  private:
+    struct ThreadPool
+    {
+        VkCommandPool Pool{VK_NULL_HANDLE};
+        std::vector<VkCommandBuffer> Secondaries{};
+        size_t Used{0}; // secondaries handed out since the last reset
+    }; // struct ThreadPool
+
+    [[nodiscard]] ThreadPool &GetPool(size_t frame, size_t thread) noexcept;
+
+  private:
+    VulkanContext *m_context{nullptr};
+    size_t m_threadCount{0};
+
+    // frame major
+    std::vector<ThreadPool> m_pools{};
+    std::vector<VkCommandBuffer> m_primaries{};
+
+    // totals over every Reset, for the averages in Dump
+    uint64_t m_resets{0};
+    uint64_t m_secondariesUsed{0};
+}; // class CommandPools
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_COMMANDPOOLS_HPP_
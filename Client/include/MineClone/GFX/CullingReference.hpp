@@ -0,0 +1,84 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_CULLINGREFERENCE_HPP_
+#define MINECLONE_CLIENT_GFX_CULLINGREFERENCE_HPP_
+
+#include "Frustum.hpp"
+
+#include <vector>
+
+namespace MineClone
+{
+
+// std430 mirror of Section in cull.comp, the world space bounds of a section's quads
+struct CullSection
+{
+    float MinX, MinY, MinZ;
+    uint32_t FirstQuad;
+    float MaxX, MaxY, MaxZ;
+    uint32_t QuadCount;
+}; // struct CullSection
+
+static_assert(sizeof(CullSection) == 32, "CullSection has to match the std430 layout of cull.comp");
+
+// std430 mirror of Parameters in cull.comp
+struct CullParameters
+{
+    static constexpr uint32_t OCCLUSION = 1;
+
+    std::array<Frustum::Plane, 6> Planes;
+
+    // the camera the depth pyramid was rendered with
+    Camera::Matrix OcclusionViewProjection;
+
+    uint32_t SectionCount;
+    uint32_t Flags;
+    uint32_t PyramidWidth;
+    uint32_t PyramidHeight;
+    uint32_t PyramidLevels;
+    uint32_t Padding[3];
+}; // struct CullParameters
+
+static_assert(sizeof(CullParameters) == 192, "CullParameters has to match the std430 layout of cull.comp");
+
+// Hi-Z pyramid on the cpu. Level 0 is the depth buffer, a texel of level k holds the farthest depth of the 2^k x 2^k
+// pixels it covers. Level sizes round up, so the pyramid covers odd sized buffers exactly.
+class DepthPyramid
+{
+  public:
+    // one level per halving, down to a single texel on the larger axis
+    [[nodiscard]] static uint32_t LevelCount(uint32_t width, uint32_t height) noexcept;
+    [[nodiscard]] static uint32_t LevelSize(uint32_t size, uint32_t level) noexcept;
+
+    // reduces a row major depth buffer like depth_pyramid.comp does
+    void Build(const float *depth, uint32_t width, uint32_t height);
+
+    // takes levels read back from the gpu, tightly packed one after another
+    void Assign(const float *levels, uint32_t width, uint32_t height);
+
+    [[nodiscard]] float Fetch(uint32_t level, uint32_t x, uint32_t y) const noexcept;
+
+    [[nodiscard]] uint32_t GetWidth() const noexcept;
+    [[nodiscard]] uint32_t GetHeight() const noexcept;
+    [[nodiscard]] uint32_t GetLevelCount() const noexcept;
+
+    // floats in all levels together
+    [[nodiscard]] static size_t TexelCount(uint32_t width, uint32_t height) noexcept;
+
+  private:
+    void Resize(uint32_t width, uint32_t height);
+
+  private:
+    uint32_t m_width{0}, m_height{0};
+    std::vector<size_t> m_levelOffsets{};
+    std::vector<float> m_texels{};
+}; // class DepthPyramid
+
+// The cpu reference of cull.comp, the same tests in the same order. A section without quads is never drawn.
+[[nodiscard]] bool IsSectionVisible(const CullParameters &parameters, const CullSection &section, const DepthPyramid *pyramid) noexcept;
+
+// appends the indices of the visible sections in ascending order
+void CullSections(const CullParameters &parameters, const CullSection *sections, const DepthPyramid *pyramid, std::vector<uint32_t> &visible);
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_CULLINGREFERENCE_HPP_
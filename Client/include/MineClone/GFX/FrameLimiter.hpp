@@ -0,0 +1,88 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_FRAMELIMITER_HPP_
+#define MINECLONE_CLIENT_GFX_FRAMELIMITER_HPP_
+
+#include "Graphics.hpp"
+
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace MineClone
+{
+
+enum class LatencyMode : uint8_t
+{
+    LowLatency,  // fresh input over smooth frame pacing
+    Throughput,  // the most frames per second
+    PowerSaving, // vsync and a frame rate cap, for battery and kiosk installs
+    Count
+}; // enum class LatencyMode
+
+// what a latency mode configures
+struct LatencySettings
+{
+    // most preferred first, FIFO is always supported and the fallback when none of them is
+    std::vector<VkPresentModeKHR> PresentModes{};
+    size_t FramesInFlight{2};
+    double FrameRateCap{0.0}; // 0 is uncapped
+}; // struct LatencySettings
+
+// power saving caps at this rate unless a cap is given
+inline constexpr double POWER_SAVING_FRAME_RATE = 30.0;
+
+// a frame rate cap of 0 keeps the mode's default
+[[nodiscard]] LatencySettings GetLatencyModeSettings(LatencyMode mode, double frameRateCap);
+
+[[nodiscard]] const char *GetLatencyModeName(LatencyMode mode) noexcept;
+
+// the inverse of GetLatencyModeName, returns false for unknown names
+[[nodiscard]] bool ParseLatencyMode(const std::string &name, LatencyMode &mode) noexcept;
+
+// Paces frames to a fixed rate. The OS sleep is too coarse for it, a 1 ms sleep often takes two, so the limiter sleeps
+// in short steps while the remaining time exceeds what a step has been observed to take, and spins the rest.
+class FrameLimiter
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+  public:
+    NON_COPYABLE(FrameLimiter);
+    NON_MOVABLE(FrameLimiter);
+
+    FrameLimiter() = default;
+
+  public:
+    // 0 turns the limiter off
+    void SetFrameRate(double frameRate) noexcept;
+
+    // returns once the next frame is due, right away when the limiter is off
+    void Wait();
+
+    void Dump(std::ostream &stream) const;
+
+    [[nodiscard]] double GetFrameRate() const noexcept;
+
+  private:
+    void SleepUntil(Clock::time_point deadline);
+
+  private:
+    double m_frameRate{0.0};
+    Clock::duration m_period{};
+    Clock::time_point m_next{};
+
+    // running mean and variance of how long a sleep step really takes, in seconds
+    double m_sleepMean{0.002};
+    double m_sleepM2{0.0};
+    uint64_t m_sleepCount{1};
+
+    // totals for Dump
+    uint64_t m_frames{0};
+    double m_overshootTotal{0.0};
+    double m_sleptTotal{0.0};
+}; // class FrameLimiter
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_FRAMELIMITER_HPP_
@@ -0,0 +1,123 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_FRAMEPROFILER_HPP_
+#define MINECLONE_CLIENT_GFX_FRAMEPROFILER_HPP_
+
+#include "Graphics.hpp"
+
+#include <array>
+#include <chrono>
+#include <ostream>
+#include <vector>
+
+namespace MineClone
+{
+
+class VulkanContext; // VulkanContext.hpp
+
+enum class CpuTimer : size_t
+{
+    Limiter,
+    FenceWait,
+    Acquire,
+    Visibility,
+    Record,
+    Submit,
+    Present,
+    Count
+}; // enum class CpuTimer
+
+enum class GpuTimer : size_t
+{
+    RenderPass,
+    Count
+}; // enum class GpuTimer
+
+struct TimingStatistics
+{
+    size_t Samples{0};
+    double Min{0.0};
+    double Average{0.0};
+    double P99{0.0};
+}; // struct TimingStatistics
+
+// Fixed size ring of the most recent samples, in milliseconds.
+class RollingSamples
+{
+  public:
+    static constexpr size_t CAPACITY = 512;
+
+    void Add(double value) noexcept;
+
+    [[nodiscard]] TimingStatistics Compute() const;
+
+  private:
+    std::array<double, CAPACITY> m_samples{};
+    size_t m_next{0};
+    size_t m_count{0};
+}; // class RollingSamples
+
+class FrameProfiler
+{
+  public:
+    class ScopedTimer
+    {
+      public:
+        NON_COPYABLE(ScopedTimer);
+        NON_MOVABLE(ScopedTimer);
+
+        ScopedTimer(FrameProfiler &profiler, CpuTimer timer) noexcept;
+        ~ScopedTimer();
+
+      private:
+        FrameProfiler &m_profiler;
+        const CpuTimer m_timer;
+        const std::chrono::steady_clock::time_point m_start;
+    }; // class ScopedTimer
+
+  public:
+    NON_COPYABLE(FrameProfiler);
+    NON_MOVABLE(FrameProfiler);
+
+    FrameProfiler() = default;
+
+    ~FrameProfiler();
+
+    void Create(VulkanContext *context);
+
+    void Destroy();
+
+    [[nodiscard]] ScopedTimer Time(CpuTimer timer) noexcept;
+
+    void AddSample(CpuTimer timer, double milliseconds) noexcept;
+
+    // must be recorded outside of a render pass, before any timestamp of the frame
+    void ResetQueries(VkCommandBuffer commandBuffer, size_t frame);
+
+    void BeginGpuTimer(VkCommandBuffer commandBuffer, size_t frame, GpuTimer timer);
+
+    void EndGpuTimer(VkCommandBuffer commandBuffer, size_t frame, GpuTimer timer);
+
+    // reads back the timestamps of a frame, only call this once its in flight fence has signaled so it never stalls
+    void CollectGpuResults(size_t frame);
+
+    [[nodiscard]] TimingStatistics GetStatistics(CpuTimer timer) const;
+    [[nodiscard]] TimingStatistics GetStatistics(GpuTimer timer) const;
+
+    void Dump(std::ostream &stream) const;
+
+  private:
+    [[nodiscard]] uint32_t QueryIndex(size_t frame, GpuTimer timer) const noexcept;
+
+  private:
+    VulkanContext *m_context{nullptr};
+    VkQueryPool m_queryPool{VK_NULL_HANDLE};
+    double m_timestampPeriod{1.0};
+    uint64_t m_timestampMask{~0ull};
+    std::vector<bool> m_pendingQueries{};
+    std::array<RollingSamples, static_cast<size_t>(CpuTimer::Count)> m_cpuSamples{};
+    std::array<RollingSamples, static_cast<size_t>(GpuTimer::Count)> m_gpuSamples{};
+}; // class FrameProfiler
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_FRAMEPROFILER_HPP_
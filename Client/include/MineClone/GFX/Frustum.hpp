@@ -0,0 +1,39 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_FRUSTUM_HPP_
+#define MINECLONE_CLIENT_GFX_FRUSTUM_HPP_
+
+#include "Camera.hpp"
+
+#include <array>
+
+namespace MineClone
+{
+
+// The six clip planes of a view projection matrix, pointing inwards. Boxes are tested against the plane corner that
+// lies furthest along the plane normal, a box is culled once that corner is behind any plane.
+class Frustum
+{
+  public:
+    struct Plane
+    {
+        float X, Y, Z, W;
+    }; // struct Plane
+
+  public:
+    explicit Frustum(const Camera::Matrix &viewProjection) noexcept;
+
+    [[nodiscard]] bool TestBox(float minX, float minY, float minZ, float maxX, float maxY, float maxZ) const noexcept;
+
+    // Tests count cubes with the given edge length, minimum corners in SoA arrays. The arrays have to be readable up to
+    // the next multiple of Simd::LANES. Writes one byte per cube, 1 if it is at least partially inside.
+    void TestCubes(const float *minX, const float *minY, const float *minZ, float size, size_t count, uint8_t *visible) const noexcept;
+
+    [[nodiscard]] const std::array<Plane, 6> &GetPlanes() const noexcept;
+
+  private:
+    std::array<Plane, 6> m_planes;
+}; // class Frustum
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_FRUSTUM_HPP_
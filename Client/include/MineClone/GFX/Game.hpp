@@ -4,13 +4,62 @@
 
 #include "VulkanContext.hpp"
 
+#include <MineClone/Game/Simulation.hpp>
+#include <MineClone/Jobs/JobSystem.hpp>
+#include <MineClone/World/BlockTicker.hpp>
+#include <MineClone/World/ChunkStreamer.hpp>
+#include <MineClone/World/ChunkView.hpp>
+
+#include <memory>
+#include <vector>
+
 namespace MineClone
 {
 
+struct GameOptions
+{
+    // render into offscreen images without a window, for benchmarking on machines without a display
+    bool Headless{false};
+    size_t HeadlessFrames{1000};
+
+    // 0 sizes the job system to the core count
+    size_t WorkerThreads{0};
+
+    // records the draw batches on the render thread instead of the workers, to compare the two
+    bool SerialRecording{false};
+
+    // F1 to F3 switch between the modes while running
+    LatencyMode Latency{LatencyMode::Throughput};
+
+    // frames per second, 0 keeps the latency mode's default
+    double FrameRateCap{0.0};
+
+    // the cache directory is relative to the working directory
+    BlockTextureOptions Textures{TextureFormat::Bc7, MipFilter::Kaiser, "texture-cache"};
+
+    // frustum culling only when disabled, to compare against the cave visibility search
+    bool OcclusionCulling{true};
+
+    // cull in a compute pass with a Hi-Z pyramid instead of on the cpu, where the device supports it
+    bool GpuCulling{false};
+
+    // compare every gpu culled frame with the cpu reference, slow
+    bool VerifyCulling{false};
+
+    // in chunks around the camera
+    int ViewDistance{12};
+
+    // ticks per second of the simulation thread and of the world, 20 or 60
+    uint32_t TickRate{20};
+
+    // region files to load and save chunks, the world is generated from scratch every run when empty
+    std::string WorldDirectory{};
+}; // struct GameOptions
+
 class Game
 {
   public:
-    Game(std::string title, size_t width, size_t height);
+    Game(std::string title, size_t width, size_t height, GameOptions options = {});
 
     virtual ~Game();
 
@@ -26,18 +75,57 @@ class Game
 
     [[nodiscard]] size_t GetWidth() const noexcept;
     [[nodiscard]] size_t GetHeight() const noexcept;
+    [[nodiscard]] JobSystem &GetJobSystem() noexcept;
+
+  protected:
+    // joins the simulation thread, subclasses call it first thing in their destructor so no tick runs into them
+    void StopSimulation();
+
+    // called on the render thread once the chunks around the spawn are meshed, before the simulation starts
+    virtual void OnSpawnAreaLoaded();
+
+    // called on the simulation thread every tick after the block updates, with the meshed chunks as of the last handover
+    // from streaming
+    virtual void OnWorldTick(const ChunkView &chunks, float seconds);
 
   private:
+    // chunks around the origin that are loaded and meshed before the first frame, the rest streams in
+    static constexpr int SPAWN_RADIUS = 6;
+
     void Initialize();
+    void HeadlessLoop();
+    void ConfigureRenderer();
+    void LoadSpawnArea();
+    void UpdateStreaming();
+    void UploadPendingSections();
+    void SampleInput();
+    void UpdateCamera();
 
   private:
     size_t m_width, m_height;
     const std::string m_title;
+    const GameOptions m_options;
 
     bool m_hasGlfw{false};
     GLFWwindow *m_glWindow{nullptr};
+    JobSystem m_jobSystem{};
+    Simulation m_simulation{};
     VulkanContext m_vulkanContext{};
     VkSurfaceKHR m_surface{VK_NULL_HANDLE};
+
+    ChunkStreamer m_chunkStreamer{};
+    std::vector<ChunkPosition> m_evictedChunks{};
+
+    // what the simulation thread last got of the chunks, copied and handed over again whenever they change
+    std::shared_ptr<const ChunkView> m_chunkView{std::make_shared<ChunkView>()};
+
+    // meshes wait here until the upload ring has room for them
+    std::vector<StreamedSection> m_pendingSections{};
+
+    // owned by the simulation thread while it runs, the block updates read the handed over chunks like the entities
+    BlockTicker m_blockTicker{};
+    std::vector<BlockTick> m_scheduledTicks{};
+    std::vector<BlockTick> m_randomTicks{};
 }; // class Window
 
 } // namespace MineClone
@@ -0,0 +1,159 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_GPUCULLING_HPP_
+#define MINECLONE_CLIENT_GFX_GPUCULLING_HPP_
+
+#include "CullingReference.hpp"
+#include "Graphics.hpp"
+#include "MemoryAllocator.hpp"
+
+#include <ostream>
+#include <vector>
+
+namespace MineClone
+{
+
+class VulkanContext; // VulkanContext.hpp
+
+// Culls sections in a compute pass before the render pass. Every section's bounds are tested against the frustum and,
+// when occlusion culling is on, against a Hi-Z pyramid reduced from the previous frame's depth buffer. Survivors are
+// appended to a device local indirect draw list through an atomic counter, which the chunk renderer draws with
+// vkCmdDrawIndexedIndirectCountKHR, so the render thread does no per section work at all.
+//
+// With verification on, each frame's draw list and the pyramid it was culled against are read back, and once the
+// frame's fence has signaled they are compared with CullSections on the cpu. That works on any device, lavapipe
+// included.
+class GpuCulling
+{
+  public:
+    static constexpr uint32_t WORKGROUP_SIZE = 64;
+    static constexpr uint32_t PYRAMID_WORKGROUP_SIZE = 8;
+
+    struct PyramidPushConstants
+    {
+        int32_t SourceSize[2];
+        int32_t DestinationSize[2];
+        int32_t Reduce;
+    }; // struct PyramidPushConstants
+
+  public:
+    NON_COPYABLE(GpuCulling);
+    NON_MOVABLE(GpuCulling);
+
+    GpuCulling() = default;
+    ~GpuCulling();
+
+  public:
+    // after the chunk renderer, support is decided here
+    void Create(VulkanContext *context);
+
+    void Destroy();
+
+    // the pyramid matches the depth buffer, so it is rebuilt with every swap chain
+    void CreatePyramid();
+    void DestroyPyramid();
+
+    // Section index as in the chunk renderer. Returns false when the upload ring is full.
+    bool SetSection(uint32_t index, const CullSection &section);
+
+    // outside a render pass, before the draws that use the list
+    void RecordCull(VkCommandBuffer commandBuffer, size_t frame, const Camera &camera);
+
+    // after the render pass, reduces its depth buffer for the next frame
+    void RecordDepthPyramid(VkCommandBuffer commandBuffer, const Camera &camera);
+
+    // once the frame's fence has signaled, before it is recorded again
+    void Verify(size_t frame);
+
+    void Dump(std::ostream &stream) const;
+
+    void SetEnabled(bool enabled) noexcept;
+    void SetOcclusionCulling(bool enabled) noexcept;
+    void SetVerification(bool enabled);
+
+    [[nodiscard]] bool IsSupported() const noexcept;
+    [[nodiscard]] bool IsActive() const noexcept;
+    [[nodiscard]] bool IsOcclusionSupported() const noexcept;
+
+    [[nodiscard]] VkBuffer GetDrawBuffer() noexcept;
+    [[nodiscard]] VkDeviceSize GetCountOffset(size_t frame) const noexcept;
+    [[nodiscard]] VkDeviceSize GetCommandOffset(size_t frame) const noexcept;
+
+  private:
+    struct Readback
+    {
+        VkBuffer Buffer{VK_NULL_HANDLE};
+        MemoryAllocation Memory{};
+        CullParameters Parameters{};
+        std::vector<CullSection> Sections{}; // as culled, removed sections are cleared and their slots reused
+        bool Pending{false};
+        bool Occlusion{false};
+    }; // struct Readback
+
+    void CreatePipelines();
+    void CreateBuffers();
+    void CreateDescriptors();
+    void CreateReadbacks();
+    void DestroyReadbacks();
+    void WriteCullPyramidDescriptors();
+
+    void RecordReadback(VkCommandBuffer commandBuffer, size_t frame);
+
+    [[nodiscard]] VkDeviceSize GetReadbackPyramidOffset() const noexcept;
+
+  private:
+    VulkanContext *m_context{nullptr};
+    bool m_supported{false};
+    bool m_enabled{false};
+    bool m_occlusionSupported{false};
+    bool m_occlusionCulling{true};
+    bool m_verification{false};
+
+    VkDescriptorSetLayout m_cullSetLayout{VK_NULL_HANDLE};
+    VkPipelineLayout m_cullPipelineLayout{VK_NULL_HANDLE};
+    VkPipeline m_cullPipeline{VK_NULL_HANDLE};
+
+    VkDescriptorSetLayout m_pyramidSetLayout{VK_NULL_HANDLE};
+    VkPipelineLayout m_pyramidPipelineLayout{VK_NULL_HANDLE};
+    VkPipeline m_pyramidPipeline{VK_NULL_HANDLE};
+
+    VkDescriptorPool m_descriptorPool{VK_NULL_HANDLE};
+    std::vector<VkDescriptorSet> m_cullSets{};
+    VkSampler m_sampler{VK_NULL_HANDLE};
+
+    VkBuffer m_sectionBuffer{VK_NULL_HANDLE};
+    MemoryAllocation m_sectionMemory{};
+    std::vector<CullSection> m_sections{};
+
+    // host visible, one CullParameters per frame in flight
+    VkBuffer m_parameterBuffer{VK_NULL_HANDLE};
+    MemoryAllocation m_parameterMemory{};
+
+    // device local, per frame in flight a draw count followed by the commands
+    VkBuffer m_drawBuffer{VK_NULL_HANDLE};
+    MemoryAllocation m_drawMemory{};
+    VkDeviceSize m_frameDrawSize{0};
+
+    // recreated with the swap chain
+    VkImage m_pyramidImage{VK_NULL_HANDLE};
+    MemoryAllocation m_pyramidMemory{};
+    VkImageView m_pyramidView{VK_NULL_HANDLE};
+    std::vector<VkImageView> m_pyramidLevelViews{};
+    VkDescriptorPool m_pyramidPool{VK_NULL_HANDLE};
+    std::vector<VkDescriptorSet> m_pyramidSets{};
+    VkExtent2D m_pyramidExtent{};
+    uint32_t m_pyramidLevels{0};
+    bool m_pyramidInitialized{false};
+    bool m_pyramidValid{false};
+    Camera::Matrix m_pyramidViewProjection{};
+
+    std::vector<Readback> m_readbacks{};
+    DepthPyramid m_referencePyramid{};
+    std::vector<uint32_t> m_referenceVisible{};
+    std::vector<uint32_t> m_gpuVisible{};
+    uint64_t m_verifiedFrames{0};
+    uint64_t m_mismatchedFrames{0};
+}; // class GpuCulling
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_GPUCULLING_HPP_
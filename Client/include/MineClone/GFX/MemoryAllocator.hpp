@@ -0,0 +1,147 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_MEMORYALLOCATOR_HPP_
+#define MINECLONE_CLIENT_GFX_MEMORYALLOCATOR_HPP_
+
+#include "Graphics.hpp"
+#include "TlsfHeap.hpp"
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+namespace MineClone
+{
+
+class VulkanContext; // VulkanContext.hpp
+
+// linear resources (buffers, linear images) and optimal images must not share a bufferImageGranularity page
+enum class ResourceTiling : uint8_t
+{
+    Linear,
+    Optimal
+}; // enum class ResourceTiling
+
+struct MemoryAllocation
+{
+    VkDeviceMemory Memory{VK_NULL_HANDLE};
+    VkDeviceSize Offset{0};
+    VkDeviceSize Size{0};
+
+    // persistently mapped pointer to Offset, nullptr unless the memory is host visible
+    void *Mapped{nullptr};
+
+    uint32_t MemoryType{0};
+    uint32_t Block{0};
+    uint32_t HeapBlock{TlsfHeap::INVALID_BLOCK};
+
+    [[nodiscard]] inline bool IsValid() const noexcept
+    {
+        return Memory != VK_NULL_HANDLE;
+    }
+
+    [[nodiscard]] inline bool IsDedicated() const noexcept
+    {
+        return HeapBlock == TlsfHeap::INVALID_BLOCK;
+    }
+}; // struct MemoryAllocation
+
+struct MemoryTypeStatistics
+{
+    size_t BlockCount{0};
+    size_t DedicatedCount{0};
+    size_t AllocationCount{0};
+    VkDeviceSize ReservedBytes{0};
+    VkDeviceSize UsedBytes{0};
+    size_t FreeRangeCount{0};
+    VkDeviceSize LargestFreeRange{0};
+
+    // 0 when all free memory is one range, close to 1 when it is scattered into many small holes
+    [[nodiscard]] double Fragmentation() const noexcept;
+}; // struct MemoryTypeStatistics
+
+struct MemoryStatistics
+{
+    std::vector<MemoryTypeStatistics> Types{};
+    uint32_t DeviceAllocationCount{0};
+    uint32_t MaxDeviceAllocationCount{0};
+}; // struct MemoryStatistics
+
+// Sub-allocates buffers and images from large VkDeviceMemory blocks, one list of blocks per memory type, so the
+// number of vkAllocateMemory calls stays far below maxMemoryAllocationCount. Host visible blocks are mapped once
+// for their whole lifetime. Safe to call from any thread.
+class MemoryAllocator
+{
+  public:
+    static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = VkDeviceSize{64} << 20;
+
+  public:
+    NON_COPYABLE(MemoryAllocator);
+    NON_MOVABLE(MemoryAllocator);
+
+    MemoryAllocator() = default;
+    ~MemoryAllocator();
+
+  public:
+    void Create(VulkanContext *context);
+
+    void Destroy();
+
+    // picks the first memory type with all of properties, preferred is tried first when given
+    [[nodiscard]] MemoryAllocation Allocate(const VkMemoryRequirements &requirements, VkMemoryPropertyFlags properties, ResourceTiling tiling,
+                                            VkMemoryPropertyFlags preferred = 0);
+
+    void Free(MemoryAllocation &allocation);
+
+    void CreateBuffer(const VkBufferCreateInfo &createInfo, VkMemoryPropertyFlags properties, VkBuffer &buffer, MemoryAllocation &allocation,
+                      VkMemoryPropertyFlags preferred = 0);
+    void DestroyBuffer(VkBuffer &buffer, MemoryAllocation &allocation);
+
+    void CreateImage(const VkImageCreateInfo &createInfo, VkMemoryPropertyFlags properties, VkImage &image, MemoryAllocation &allocation);
+    void DestroyImage(VkImage &image, MemoryAllocation &allocation);
+
+    [[nodiscard]] MemoryStatistics GetStatistics();
+    [[nodiscard]] const VkPhysicalDeviceMemoryProperties &GetMemoryProperties() const noexcept;
+
+    void Dump(std::ostream &stream);
+
+  private:
+    struct MemoryBlock
+    {
+        VkDeviceMemory Memory{VK_NULL_HANDLE};
+        void *Mapped{nullptr};
+        TlsfHeap Heap;
+
+        explicit MemoryBlock(VkDeviceSize size) : Heap{size}
+        {
+        }
+    }; // struct MemoryBlock
+
+    struct MemoryTypePool
+    {
+        VkDeviceSize BlockSize{DEFAULT_BLOCK_SIZE};
+        std::vector<std::unique_ptr<MemoryBlock>> Blocks{};
+        size_t DedicatedCount{0};
+        VkDeviceSize DedicatedBytes{0};
+    }; // struct MemoryTypePool
+
+    [[nodiscard]] std::optional<uint32_t> FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const noexcept;
+
+    bool AllocateFromType(uint32_t memoryType, VkDeviceSize size, VkDeviceSize alignment, MemoryAllocation &allocation);
+    bool AllocateDedicated(uint32_t memoryType, VkDeviceSize size, MemoryAllocation &allocation);
+    VkDeviceMemory AllocateDeviceMemory(uint32_t memoryType, VkDeviceSize size, void **mapped);
+    void FreeDeviceMemory(VkDeviceMemory memory, void *mapped);
+
+  private:
+    VulkanContext *m_context{nullptr};
+    VkPhysicalDeviceMemoryProperties m_memoryProperties{};
+    VkDeviceSize m_bufferImageGranularity{1};
+    std::vector<MemoryTypePool> m_pools{};
+    uint32_t m_deviceAllocationCount{0};
+    std::mutex m_mutex{};
+}; // class MemoryAllocator
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_MEMORYALLOCATOR_HPP_
@@ -0,0 +1,51 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_MIPMAPS_HPP_
+#define MINECLONE_CLIENT_GFX_MIPMAPS_HPP_
+
+#include "../Common.hpp"
+
+#include <string>
+#include <vector>
+
+namespace MineClone
+{
+
+// sRGB RGBA8 texels packed little endian, red in the low byte like VK_FORMAT_R8G8B8A8_SRGB; rows top to bottom
+struct TextureImage
+{
+    uint32_t Width{0};
+    uint32_t Height{0};
+    std::vector<uint32_t> Texels{};
+}; // struct TextureImage
+
+enum class MipFilter : uint8_t
+{
+    Box,    // averages 2x2 texels, blurs little but aliases fine detail
+    Kaiser, // Kaiser windowed sinc over 6x6 texels, keeps lower mips sharp without the aliasing
+    Count
+}; // enum class MipFilter
+
+// Mip chain generation for tiling textures: the filters wrap around the edges, so lower mips tile as seamlessly as the
+// base level. Texels are converted to linear light for filtering, the separable passes run Simd::LANES texels at a time.
+namespace Mipmaps
+{
+
+[[nodiscard]] const char *GetFilterName(MipFilter filter) noexcept;
+
+// the inverse of GetFilterName, returns false for unknown names
+[[nodiscard]] bool ParseFilter(const std::string &name, MipFilter &filter) noexcept;
+
+// down to 1x1, sizes have to be powers of two
+[[nodiscard]] uint32_t GetLevelCount(uint32_t width, uint32_t height) noexcept;
+
+// half the size in both dimensions, a dimension that is already 1 stays 1
+[[nodiscard]] TextureImage Downsample(const TextureImage &image, MipFilter filter);
+
+// level 0 is a copy of the image
+[[nodiscard]] std::vector<TextureImage> GenerateChain(const TextureImage &image, MipFilter filter);
+
+} // namespace Mipmaps
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_MIPMAPS_HPP_
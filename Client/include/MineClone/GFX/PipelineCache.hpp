@@ -0,0 +1,46 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_PIPELINECACHE_HPP_
+#define MINECLONE_CLIENT_GFX_PIPELINECACHE_HPP_
+
+#include "Graphics.hpp"
+
+#include <string>
+#include <vector>
+
+namespace MineClone
+{
+
+class VulkanContext; // VulkanContext.hpp
+
+class PipelineCache
+{
+  public:
+    NON_COPYABLE(PipelineCache);
+    NON_MOVABLE(PipelineCache);
+
+    PipelineCache() = default;
+
+    ~PipelineCache();
+
+    void Create(VulkanContext *context, std::string path);
+
+    // writes to a temporary file first and renames it over the old cache, so a crash can't leave a torn file behind
+    void Save();
+
+    void Destroy();
+
+    [[nodiscard]] VkPipelineCache GetVkPipelineCache() noexcept;
+
+  private:
+    [[nodiscard]] std::vector<char> Load() const;
+    [[nodiscard]] bool IsCompatible(const std::vector<char> &data) const;
+
+  private:
+    VulkanContext *m_context{nullptr};
+    std::string m_path{};
+    VkPipelineCache m_cache{VK_NULL_HANDLE};
+}; // class PipelineCache
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_PIPELINECACHE_HPP_
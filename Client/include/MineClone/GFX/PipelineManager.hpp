@@ -0,0 +1,55 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_PIPELINEMANAGER_HPP_
+#define MINECLONE_CLIENT_GFX_PIPELINEMANAGER_HPP_
+
+#include "Graphics.hpp"
+#include "Shader.hpp"
+#include <optional>
+
+namespace MineClone
+{
+
+class VulkanContext; // VulkanContext.hpp
+
+// Owns the render pass and every pipeline built against it. Viewport and scissor are dynamic state, so nothing in here
+// depends on the swap chain extent and it only has to be rebuilt when the color format changes.
+class PipelineManager
+{
+  public:
+    NON_COPYABLE(PipelineManager);
+    NON_MOVABLE(PipelineManager);
+
+    PipelineManager() = default;
+
+    ~PipelineManager();
+
+    void Create(VulkanContext *context, VkFormat colorFormat);
+
+    void Destroy();
+
+    [[nodiscard]] VkFormat GetColorFormat() const noexcept;
+    [[nodiscard]] VkFormat GetDepthFormat() const noexcept;
+    [[nodiscard]] VkRenderPass GetRenderPass() noexcept;
+    [[nodiscard]] VkPipelineLayout GetPipelineLayout() noexcept;
+    [[nodiscard]] VkPipeline GetPipeline() noexcept;
+
+  private:
+    void CreateRenderPass();
+    void CreateGraphicsPipeline();
+
+  private:
+#ifdef MINECLONE_RUNTIME_SHADER_COMPILER
+    std::optional<CompiledShader> m_compiledFragShader{};
+    std::optional<CompiledShader> m_compiledVertShader{};
+#endif
+    VulkanContext *m_context{nullptr};
+    VkFormat m_colorFormat{VK_FORMAT_UNDEFINED};
+    VkFormat m_depthFormat{VK_FORMAT_UNDEFINED};
+    VkRenderPass m_renderPass{VK_NULL_HANDLE};
+    VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
+    VkPipeline m_pipeline{VK_NULL_HANDLE};
+}; // class PipelineManager
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_PIPELINEMANAGER_HPP_
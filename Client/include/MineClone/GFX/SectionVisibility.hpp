@@ -0,0 +1,91 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_SECTIONVISIBILITY_HPP_
+#define MINECLONE_CLIENT_GFX_SECTIONVISIBILITY_HPP_
+
+#include "Camera.hpp"
+
+#include <MineClone/World/SectionConnectivity.hpp>
+
+#include <array>
+#include <unordered_map>
+#include <vector>
+
+namespace MineClone
+{
+
+struct VisibilityStatistics
+{
+    size_t Loaded{0};
+    size_t InFrustum{0};
+    size_t Visible{0};
+}; // struct VisibilityStatistics
+
+// Decides which loaded sections get drawn. Sections outside the view frustum are rejected in SIMD batches, then a breadth
+// first search from the camera's section walks the face connectivity graph, so terrain behind solid rock is skipped.
+// The search never turns back towards the camera, which keeps it linear in the number of sections it reaches.
+class SectionVisibility
+{
+  public:
+    static constexpr uint32_t INVALID = ~0u;
+
+  public:
+    // section coordinates, returns the index the section keeps until it is removed, released indices are reused
+    uint32_t Add(int32_t x, int32_t y, int32_t z, SectionConnectivity connectivity);
+
+    // The section is no longer visible or found, but its index is only handed out again after Release. Callers can
+    // keep data indexed by it alive while frames in flight still read it.
+    void Remove(uint32_t index);
+    void Release(uint32_t index);
+
+    void Clear() noexcept;
+
+    [[nodiscard]] uint32_t Find(int32_t x, int32_t y, int32_t z) const;
+
+    // Replaces visible with the indices of the sections to draw, nearest first. Without a loaded section around the
+    // camera, or with occlusion culling disabled, that is every section in the frustum.
+    void Update(const Camera &camera, std::vector<uint32_t> &visible);
+
+    void SetOcclusionCulling(bool enabled) noexcept;
+
+    [[nodiscard]] bool IsOcclusionCullingEnabled() const noexcept;
+    [[nodiscard]] size_t GetSectionCount() const noexcept;
+    [[nodiscard]] const VisibilityStatistics &GetStatistics() const noexcept;
+
+  private:
+    struct Node
+    {
+        int32_t X, Y, Z;
+        SectionConnectivity Connectivity;
+        std::array<uint32_t, BLOCK_FACE_COUNT> Neighbors;
+    }; // struct Node
+
+    struct Step
+    {
+        uint32_t Section;
+        uint8_t Entry;      // face the search came in through, BLOCK_FACE_COUNT for the camera section
+        uint8_t Directions; // faces the search has left through on its way here
+    }; // struct Step
+
+  private:
+    std::vector<Node> m_nodes{};
+    std::unordered_map<uint64_t, uint32_t> m_indices{};
+
+    // removed nodes, waiting for Release and free for Add
+    std::vector<uint32_t> m_removed{};
+    std::vector<uint32_t> m_free{};
+
+    // minimum corners in blocks, padded to a multiple of Simd::LANES
+    std::vector<float> m_minX{}, m_minY{}, m_minZ{};
+
+    std::vector<uint8_t> m_inFrustum{};
+    std::vector<uint32_t> m_visitedFrame{};
+    uint32_t m_frame{0};
+    std::vector<Step> m_queue{};
+
+    bool m_occlusionCulling{true};
+    VisibilityStatistics m_statistics{};
+}; // class SectionVisibility
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_SECTIONVISIBILITY_HPP_
@@ -3,7 +3,9 @@
 
 #include "Graphics.hpp"
 
+#ifdef MINECLONE_RUNTIME_SHADER_COMPILER
 #include <shaderc/shaderc.hpp>
+#endif
 
 namespace MineClone
 {
@@ -19,23 +21,26 @@ class ShaderException : public Exception
 struct CompiledShader
 {
     std::string Name;
-    shaderc_shader_kind Kind;
+    VkShaderStageFlagBits Stage;
     std::vector<uint32_t> Data;
 };
 
+#ifdef MINECLONE_RUNTIME_SHADER_COMPILER
 class ShaderCompiler
 {
   public:
-    CompiledShader Compile(const std::string &data, const std::string &name, shaderc_shader_kind kind);
+    CompiledShader Compile(const std::string &data, const std::string &name, VkShaderStageFlagBits stage);
 
   private:
     shaderc::Compiler m_compiler;
     shaderc::CompileOptions m_options;
 }; // class ShaderCompiler
+#endif
 
 class ShaderModule
 {
   public:
+    ShaderModule(VkDevice device, VkShaderStageFlagBits stage, const uint32_t *code, size_t codeSize);
     ShaderModule(VkDevice device, const CompiledShader &compiledShader);
     virtual ~ShaderModule();
 
@@ -47,13 +52,13 @@ class ShaderModule
 
     [[nodiscard]] VkShaderModule GetVkModule() const noexcept;
 
-    [[nodiscard]] shaderc_shader_kind GetKind() const noexcept;
+    [[nodiscard]] VkShaderStageFlagBits GetStage() const noexcept;
 
     [[nodiscard]] VkPipelineShaderStageCreateInfo CreateInfo() const;
 
   private:
     VkDevice m_device;
-    shaderc_shader_kind m_kind;
+    VkShaderStageFlagBits m_stage;
     VkShaderModule m_module{VK_NULL_HANDLE};
 }; // class ShaderModule
 
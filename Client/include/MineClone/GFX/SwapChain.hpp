@@ -3,8 +3,7 @@
 #define MINECLONE_CLIENT_GFX_SWAPCHAIN_HPP_
 
 #include "Graphics.hpp"
-#include "Shader.hpp"
-#include <optional>
+#include "MemoryAllocator.hpp"
 
 namespace MineClone
 {
@@ -35,40 +34,40 @@ class SwapChain
 
     void Create(VulkanContext *context);
 
-    void Recreate();
+    void CreateFramebuffers(VkRenderPass renderPass, VkFormat depthFormat);
 
     void Destroy();
 
     [[nodiscard]] VkSurfaceFormatKHR &GetSwapChainFormat() noexcept;
     [[nodiscard]] VkExtent2D &GetSwapChainExtent() noexcept;
+    [[nodiscard]] VkPresentModeKHR GetPresentMode() const noexcept;
     [[nodiscard]] VkSwapchainKHR GetSwapChain() noexcept;
     [[nodiscard]] std::vector<VkImage> &GetSwapChainImages() noexcept;
     [[nodiscard]] std::vector<VkImageView> &GetSwapChainImageViews() noexcept;
-    [[nodiscard]] VkRenderPass GetRenderPass() noexcept;
-    [[nodiscard]] VkPipelineLayout GetPipelineLayout() noexcept;
-    [[nodiscard]] VkPipeline GetPipeline() noexcept;
     [[nodiscard]] std::vector<VkFramebuffer> &GetSwapChainFramebuffers() noexcept;
+    [[nodiscard]] VkImage GetDepthImage() noexcept;
+    [[nodiscard]] VkImageView GetDepthImageView() noexcept;
+    [[nodiscard]] bool IsDepthSampled() const noexcept;
 
   private:
-    void CreateSwapChain();
+    void CreateSwapChain(VkSwapchainKHR oldSwapChain);
+    void CreateOffscreenImages();
     void CreateImageViews();
-    void CreateRenderPass();
-    void CreateGraphicsPipeline();
-    void CreateFramebuffers();
+    void CreateDepthImage(VkFormat depthFormat);
 
   private:
-    std::optional<CompiledShader> m_compiledFragShader{};
-    std::optional<CompiledShader> m_compiledVertShader{};
     VulkanContext *m_context{nullptr};
     VkSurfaceFormatKHR m_swapChainFormat{};
     VkPresentModeKHR m_swapChainPresentMode{};
     VkExtent2D m_swapChainExtent{};
     VkSwapchainKHR m_swapChain{VK_NULL_HANDLE};
     std::vector<VkImage> m_swapChainImages;
+    std::vector<MemoryAllocation> m_offscreenImageMemory;
     std::vector<VkImageView> m_swapChainImageViews;
-    VkRenderPass m_renderPass{VK_NULL_HANDLE};
-    VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
-    VkPipeline m_pipeline{VK_NULL_HANDLE};
+    VkImage m_depthImage{VK_NULL_HANDLE};
+    MemoryAllocation m_depthImageMemory{};
+    VkImageView m_depthImageView{VK_NULL_HANDLE};
+    bool m_depthSampled{false};
     std::vector<VkFramebuffer> m_swapChainFramebuffers{};
 }; // class SwapChain
 
@@ -0,0 +1,88 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_TLSFHEAP_HPP_
+#define MINECLONE_CLIENT_GFX_TLSFHEAP_HPP_
+
+#include <MineClone/Common.hpp>
+
+#include <array>
+#include <vector>
+
+namespace MineClone
+{
+
+// Two level segregated fit allocator over an abstract range of [0, size). It only hands out offsets, the memory
+// itself lives elsewhere (e.g. a VkDeviceMemory block). Allocation and free are O(1): free ranges are bucketed by
+// the position of their highest bit and SL_COUNT linear subdivisions below it, two bitmaps find the first bucket
+// that is large enough, and neighbouring free ranges are merged as soon as they are released.
+class TlsfHeap
+{
+  public:
+    static constexpr uint32_t INVALID_BLOCK = ~0u;
+
+    struct Allocation
+    {
+        uint32_t Block{INVALID_BLOCK};
+        uint64_t Offset{0};
+    }; // struct Allocation
+
+  public:
+    explicit TlsfHeap(uint64_t size);
+
+  public:
+    // alignment must be a power of two
+    [[nodiscard]] bool Allocate(uint64_t size, uint64_t alignment, Allocation &allocation);
+
+    void Free(uint32_t block);
+
+    [[nodiscard]] uint64_t GetSize() const noexcept;
+    [[nodiscard]] uint64_t GetUsedSize() const noexcept;
+    [[nodiscard]] size_t GetAllocationCount() const noexcept;
+    [[nodiscard]] size_t GetFreeRangeCount() const noexcept;
+    [[nodiscard]] uint64_t GetLargestFreeRange() const noexcept;
+    [[nodiscard]] bool IsEmpty() const noexcept;
+
+  private:
+    static constexpr uint32_t SL_LOG2 = 5;
+    static constexpr uint32_t SL_COUNT = 1u << SL_LOG2;
+    static constexpr uint32_t FL_COUNT = 64 - SL_LOG2 + 1;
+
+    struct Block
+    {
+        uint64_t Offset{0};
+        uint64_t Size{0};
+        uint32_t PreviousPhysical{INVALID_BLOCK};
+        uint32_t NextPhysical{INVALID_BLOCK};
+        uint32_t PreviousFree{INVALID_BLOCK};
+        uint32_t NextFree{INVALID_BLOCK};
+        bool Free{false};
+    }; // struct Block
+
+    static void Mapping(uint64_t size, uint32_t &firstLevel, uint32_t &secondLevel) noexcept;
+
+    uint32_t NewBlock();
+    void ReleaseBlock(uint32_t block);
+
+    void InsertFree(uint32_t block);
+    void RemoveFree(uint32_t block);
+    [[nodiscard]] uint32_t FindFree(uint64_t size) const noexcept;
+
+    // splits the tail past size off into a new free block
+    void Split(uint32_t block, uint64_t size);
+
+  private:
+    const uint64_t m_size;
+    uint64_t m_usedSize{0};
+    size_t m_allocationCount{0};
+    size_t m_freeRangeCount{0};
+
+    std::vector<Block> m_blocks{};
+    std::vector<uint32_t> m_unusedBlocks{};
+
+    uint64_t m_firstLevelBitmap{0};
+    std::array<uint32_t, FL_COUNT> m_secondLevelBitmaps{};
+    std::array<uint32_t, FL_COUNT * SL_COUNT> m_freeLists{};
+}; // class TlsfHeap
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_TLSFHEAP_HPP_
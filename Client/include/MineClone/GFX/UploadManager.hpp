@@ -0,0 +1,114 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GFX_UPLOADMANAGER_HPP_
+#define MINECLONE_CLIENT_GFX_UPLOADMANAGER_HPP_
+
+#include "Graphics.hpp"
+#include "MemoryAllocator.hpp"
+
+#include <array>
+#include <mutex>
+#include <vector>
+
+namespace MineClone
+{
+
+class VulkanContext; // VulkanContext.hpp
+
+// Streams data to device local buffers and images through a persistently mapped staging ring. Copies queued
+// during a frame are recorded and submitted together once per frame, on the dedicated transfer queue when the
+// device has one. Ring space is recycled when the fence of the batch that used it signals.
+class UploadManager
+{
+  public:
+    static constexpr VkDeviceSize RING_SIZE = VkDeviceSize{32} << 20;
+    static constexpr size_t MAX_BATCHES = 2;
+
+    // stages of the graphics queue that may read uploaded data, they wait for the upload semaphore
+    static constexpr VkPipelineStageFlags CONSUMER_STAGES = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                                                            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT |
+                                                            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+
+  public:
+    NON_COPYABLE(UploadManager);
+    NON_MOVABLE(UploadManager);
+
+    UploadManager() = default;
+    ~UploadManager();
+
+  public:
+    void Create(VulkanContext *context);
+
+    void Destroy();
+
+    // Both return false when the ring has no room left for this frame, try again next frame. Safe to call
+    // from worker threads. Destinations must be created with exclusive sharing and TRANSFER_DST usage.
+    bool UploadBuffer(VkBuffer buffer, VkDeviceSize offset, const void *data, VkDeviceSize size);
+    bool UploadImage(VkImage image, const VkImageSubresourceLayers &subresource, VkExtent3D extent, const void *data, VkDeviceSize size,
+                     VkImageLayout finalLayout);
+
+    // records and submits everything queued since the last call, returns the semaphore the graphics
+    // submission of this frame has to wait on or VK_NULL_HANDLE if nothing was uploaded
+    [[nodiscard]] VkSemaphore Submit(size_t frame);
+
+    // the acquiring half of the queue family ownership transfers, recorded at the start of the frame
+    void RecordAcquireBarriers(VkCommandBuffer commandBuffer, size_t frame);
+
+    [[nodiscard]] bool HasDedicatedQueue() const noexcept;
+    [[nodiscard]] VkDeviceSize GetPendingBytes() noexcept;
+
+  private:
+    struct BufferCopy
+    {
+        VkBuffer Buffer;
+        VkBufferCopy Region;
+    }; // struct BufferCopy
+
+    struct ImageCopy
+    {
+        VkImage Image;
+        VkBufferImageCopy Region;
+        VkImageLayout FinalLayout;
+    }; // struct ImageCopy
+
+    struct Batch
+    {
+        VkCommandPool CommandPool{VK_NULL_HANDLE};
+        VkCommandBuffer CommandBuffer{VK_NULL_HANDLE};
+        VkFence Fence{VK_NULL_HANDLE};
+        VkSemaphore Semaphore{VK_NULL_HANDLE};
+
+        // ring position after the last byte this batch used
+        uint64_t RingEnd{0};
+
+        std::vector<VkBufferMemoryBarrier> BufferAcquires{};
+        std::vector<VkImageMemoryBarrier> ImageAcquires{};
+    }; // struct Batch
+
+    [[nodiscard]] bool Reserve(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset);
+    void Record(Batch &batch);
+
+  private:
+    VulkanContext *m_context{nullptr};
+    uint32_t m_transferFamily{0};
+    uint32_t m_graphicsFamily{0};
+    VkQueue m_transferQueue{VK_NULL_HANDLE};
+
+    VkBuffer m_ringBuffer{VK_NULL_HANDLE};
+    MemoryAllocation m_ringMemory{};
+    VkDeviceSize m_copyAlignment{16};
+
+    // running totals, the ring offset is the position modulo RING_SIZE
+    uint64_t m_ringHead{0};
+    uint64_t m_ringTail{0};
+    uint64_t m_submittedHead{0};
+
+    std::array<Batch, MAX_BATCHES> m_batches{};
+
+    std::mutex m_mutex{};
+    std::vector<BufferCopy> m_bufferCopies{};
+    std::vector<ImageCopy> m_imageCopies{};
+}; // class UploadManager
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GFX_UPLOADMANAGER_HPP_
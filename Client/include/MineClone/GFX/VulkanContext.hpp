@@ -6,8 +6,21 @@
 #include <optional>
 #include <vector>
 
+#include "BlockTextures.hpp"
+#include "Camera.hpp"
+#include "ChunkRenderer.hpp"
+#include "CommandPools.hpp"
+#include "FrameLimiter.hpp"
+#include "FrameProfiler.hpp"
+#include "GpuCulling.hpp"
 #include "Graphics.hpp"
+#include "MemoryAllocator.hpp"
+#include "PipelineCache.hpp"
+#include "PipelineManager.hpp"
 #include "SwapChain.hpp"
+#include "UploadManager.hpp"
+
+#include <MineClone/Jobs/JobSystem.hpp>
 
 namespace MineClone
 {
@@ -16,10 +29,11 @@ struct QueueFamilyIndices
 {
     std::optional<uint32_t> GraphicsFamily;
     std::optional<uint32_t> PresentFamily;
+    std::optional<uint32_t> TransferFamily; // only set for a family without graphics support
 
-    [[nodiscard]] inline bool IsComplete() const noexcept
+    [[nodiscard]] inline bool IsComplete(bool requirePresent = true) const noexcept
     {
-        return GraphicsFamily.has_value() && PresentFamily.has_value();
+        return GraphicsFamily.has_value() && (PresentFamily.has_value() || !requirePresent);
     }
 }; // struct QueueFamilyIndices
 
@@ -28,7 +42,6 @@ class VulkanContext;
 struct InFlightFrameData
 {
   public:
-    VkCommandBuffer CommandBuffer{VK_NULL_HANDLE};
     VkSemaphore ImageAvailableSemaphore{VK_NULL_HANDLE};
     VkSemaphore RenderFinishedSemaphore{VK_NULL_HANDLE};
     VkFence InFlightFence{VK_NULL_HANDLE};
@@ -52,7 +65,9 @@ struct InFlightFrameData
 class VulkanContext
 {
   public:
+    // per frame resources are created for this many, a latency mode may use fewer
     static constexpr size_t MAX_FRAMES_IN_FLIGHT = 2;
+    static_assert(MAX_FRAMES_IN_FLIGHT <= UploadManager::MAX_BATCHES, "every frame in flight needs its own upload batch");
 
   public:
     NON_COPYABLE(VulkanContext);
@@ -62,43 +77,87 @@ class VulkanContext
     ~VulkanContext();
 
   public:
+    // Before Initialize. Draw batches are recorded on the workers into secondary command buffers, without a job system
+    // the render thread records them one after the other.
+    void SetJobSystem(JobSystem *jobSystem) noexcept;
+
+    // Before or after Initialize, from the next frame on. The swap chain is recreated when the mode prefers other present
+    // modes, a frame rate cap of 0 keeps the mode's default.
+    void SetLatencyMode(LatencyMode mode, double frameRateCap = 0.0);
+
+    // before Initialize
+    void SetBlockTextureOptions(const BlockTextureOptions &options);
+
     void Initialize(GLFWwindow *window);
 
+    // renders into offscreen images instead of a swap chain, requires neither a window nor VK_KHR_swapchain
+    void InitializeHeadless(VkExtent2D extent);
+
+    // Sleeps for the frame rate cap and waits until the next frame's resources are free. Called before sampling input,
+    // so the frame is rendered with input that is as fresh as possible; Render waits by itself otherwise.
+    void WaitForNextFrame();
+
     void Render();
 
+    void WaitIdle();
+
     void Destroy();
 
     void RequireRecreateSwapChain();
 
+    [[nodiscard]] LatencyMode GetLatencyMode() const noexcept;
+    [[nodiscard]] const LatencySettings &GetLatencySettings() const noexcept;
+    [[nodiscard]] bool IsHeadless() const noexcept;
+    [[nodiscard]] VkExtent2D GetHeadlessExtent() const noexcept;
     [[nodiscard]] GLFWwindow *GetWindow() noexcept;
     [[nodiscard]] std::vector<VkExtensionProperties> &GetExtensions() noexcept;
     [[nodiscard]] VkInstance GetInstance() noexcept;
     [[nodiscard]] VkPhysicalDevice GetPhysicalDevice() noexcept;
+    [[nodiscard]] VkPhysicalDeviceProperties &GetPhysicalDeviceProperties() noexcept;
+    [[nodiscard]] const VkPhysicalDeviceFeatures &GetPhysicalDeviceFeatures() const noexcept;
+    [[nodiscard]] bool IsDeviceExtensionEnabled(const char *name) const noexcept;
     [[nodiscard]] VkDevice GetDevice() noexcept;
     [[nodiscard]] VkQueue GetGraphicsQueue() noexcept;
     [[nodiscard]] VkQueue GetPresentQueue() noexcept;
+    [[nodiscard]] VkQueue GetTransferQueue() noexcept;
     [[nodiscard]] VkSurfaceKHR GetSurface() noexcept;
     [[nodiscard]] QueueFamilyIndices &GetQueueFamilyIndices() noexcept;
     [[nodiscard]] SwapChainSupportDetails &GetSwapChainSupportDetails() noexcept;
+    [[nodiscard]] MemoryAllocator &GetMemoryAllocator() noexcept;
     [[nodiscard]] SwapChain &GetSwapChain() noexcept;
-    [[nodiscard]] VkCommandPool GetCommandPool() noexcept;
+    [[nodiscard]] PipelineManager &GetPipelineManager() noexcept;
+    [[nodiscard]] FrameProfiler &GetFrameProfiler() noexcept;
+    [[nodiscard]] UploadManager &GetUploadManager() noexcept;
+    [[nodiscard]] BlockTextures &GetBlockTextures() noexcept;
+    [[nodiscard]] ChunkRenderer &GetChunkRenderer() noexcept;
+    [[nodiscard]] GpuCulling &GetGpuCulling() noexcept;
+    [[nodiscard]] Camera &GetCamera() noexcept;
+    [[nodiscard]] CommandPools &GetCommandPools() noexcept;
+    [[nodiscard]] VkPipelineCache GetPipelineCache() noexcept;
+
+    [[nodiscard]] uint32_t FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties);
 
   private:
+    void Initialize();
     void CreateInstance();
     void SetupDebugCallbacks();
     void CreateSurface();
     void PickPhysicalDevice();
     void CreateLogicalDevice();
+    void CreatePipelineCache();
     void CreateSwapChain();
-    void CreateCommandPool();
-    void CreateCommandBuffer();
+    void CreatePipelines();
+    void CreateCommandPools();
     void RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+    void RecordDrawBatches(VkCommandBuffer commandBuffer, uint32_t imageIndex);
     void CreateSyncObjects();
 
     bool HandleDrawResult(VkResult result);
     void RecreateSwapChain();
 
   private:
+    bool m_headless{false};
+    VkExtent2D m_headlessExtent{};
     GLFWwindow *m_window{nullptr};
     bool m_requireValidationLayers{false};
     std::vector<const char *> m_requiredValidationLayers{};
@@ -107,16 +166,39 @@ class VulkanContext
     VkDebugUtilsMessengerEXT m_debugMessenger{VK_NULL_HANDLE};
     VkSurfaceKHR m_surface{VK_NULL_HANDLE};
     VkPhysicalDevice m_physicalDevice{VK_NULL_HANDLE};
+    VkPhysicalDeviceProperties m_physicalDeviceProperties{};
+    VkPhysicalDeviceFeatures m_physicalDeviceFeatures{};
+    std::vector<const char *> m_deviceExtensions{};
     QueueFamilyIndices m_queueFamilyIndices{};
     VkDevice m_device{VK_NULL_HANDLE};
     VkQueue m_graphicsQueue{VK_NULL_HANDLE};
     VkQueue m_presentQueue{VK_NULL_HANDLE};
+    VkQueue m_transferQueue{VK_NULL_HANDLE};
     SwapChainSupportDetails m_swapChainSupportDetails{};
+    MemoryAllocator m_memoryAllocator{};
+    PipelineCache m_pipelineCache{};
     SwapChain m_swapChain{};
-    VkCommandPool m_commandPool{VK_NULL_HANDLE};
+    PipelineManager m_pipelineManager{};
+    CommandPools m_commandPools{};
     std::array<InFlightFrameData, MAX_FRAMES_IN_FLIGHT> m_inFlightFrameData;
+    FrameProfiler m_frameProfiler{};
+    UploadManager m_uploadManager{};
+    BlockTextureOptions m_blockTextureOptions{};
+    BlockTextures m_blockTextures{};
+    ChunkRenderer m_chunkRenderer{};
+    GpuCulling m_gpuCulling{};
+    Camera m_camera{};
+
+    JobSystem *m_jobSystem{nullptr};
+    std::vector<JobHandle> m_recordJobs{};
+    std::vector<VkCommandBuffer> m_batchBuffers{};
+
+    LatencyMode m_latencyMode{LatencyMode::Throughput};
+    LatencySettings m_latencySettings{GetLatencyModeSettings(LatencyMode::Throughput, 0.0)};
+    FrameLimiter m_frameLimiter{};
 
     size_t m_currentFrame{0};
+    bool m_frameReady{false}; // the fence of the current frame has been waited for
     bool m_requireRecreateSwapChain{false};
 }; // class VulkanInitializer
 
@@ -0,0 +1,50 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GAME_ENTITYSYSTEMS_HPP_
+#define MINECLONE_CLIENT_GAME_ENTITYSYSTEMS_HPP_
+
+#include "../Common.hpp"
+
+#include <MineClone/Entities/SystemScheduler.hpp>
+#include <MineClone/Physics/Collision.hpp>
+
+namespace MineClone
+{
+
+// Entities are made of these and of PhysicsBody, which the physics system hands to StepBodies one column at a time.
+
+struct ItemDrop
+{
+    BlockId Block;
+    uint16_t Count;
+    float Age; // seconds
+}; // struct ItemDrop
+
+struct Mob
+{
+    float HeadingX, HeadingZ; // blocks per second
+    float WanderSeconds;      // until the next heading
+    uint32_t Random;
+}; // struct Mob
+
+namespace EntityConstants
+{
+
+inline constexpr float GRAVITY = 32.0f;
+inline constexpr float ITEM_LIFETIME = 300.0f;
+inline constexpr float MOB_SPEED = 1.5f;
+
+// clears a block at the gravity above
+inline constexpr float JUMP_VELOCITY = 9.0f;
+
+} // namespace EntityConstants
+
+Entity SpawnMob(EntityWorld &world, float x, float y, float z, uint32_t seed);
+Entity SpawnItem(EntityWorld &world, float x, float y, float z, BlockId block, uint16_t count);
+
+// Wandering and physics share the bodies and run in that order, item aging runs next to both. The physics system reads
+// the world through blocks, which has to stay alive and is only touched by that system.
+void AddEntitySystems(SystemScheduler &scheduler, BlockAccess &blocks);
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GAME_ENTITYSYSTEMS_HPP_
@@ -6,13 +6,40 @@
 
 #include "../GFX/Game.hpp"
 
+#include "EntitySystems.hpp"
+
 namespace MineClone
 {
 
 class MineCloneGame : public Game {
   public:
-    MineCloneGame();
+    explicit MineCloneGame(GameOptions options = {});
+
+    ~MineCloneGame() override;
+
+    NON_COPYABLE(MineCloneGame);
+    NON_MOVABLE(MineCloneGame);
+
+  protected:
+    void OnSpawnAreaLoaded() override;
+    void OnWorldTick(const ChunkView &chunks, float seconds) override;
+
+  private:
+    // mobs around the origin, items are only dropped by them for now
+    static constexpr int SPAWN_MOBS = 256;
+    static constexpr float SPAWN_AREA = 64.0f;
+
+    // a mob drops an item every this many seconds on average
+    static constexpr float DROP_INTERVAL = 30.0f;
+
+  private:
+    EntityWorld m_entities{};
+    SystemScheduler m_systems{};
+    BlockAccess m_blocks;
 
+    // the view of the tick that is running, entities only ever touch the simulation thread and its jobs
+    const ChunkView *m_tickChunks{nullptr};
+    uint32_t m_random{0x9E3779B9u};
 };
 
 } // namespace MineClone
@@ -0,0 +1,113 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_GAME_SIMULATION_HPP_
+#define MINECLONE_CLIENT_GAME_SIMULATION_HPP_
+
+#include "../Common.hpp"
+
+#include <MineClone/GFX/Camera.hpp>
+#include <MineClone/Jobs/TripleBuffer.hpp>
+#include <MineClone/World/ChunkView.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <thread>
+
+namespace MineClone
+{
+
+// held keys as axes from -1 to 1, sampled by the render thread
+struct PlayerInput
+{
+    float Forward{0.0f};
+    float Right{0.0f};
+    float Up{0.0f};
+    float Yaw{0.0f};
+    float Pitch{0.0f};
+}; // struct PlayerInput
+
+struct PlayerState
+{
+    float X{0.0f}, Y{0.0f}, Z{0.0f};
+    float Yaw{0.0f}, Pitch{0.0f};
+}; // struct PlayerState
+
+// the last two ticks, so the renderer can interpolate between them whichever snapshot it picks up
+struct SimulationSnapshot
+{
+    uint64_t Tick{0};
+    std::chrono::steady_clock::time_point Time{}; // when Current was due
+    PlayerState Previous{};
+    PlayerState Current{};
+}; // struct SimulationSnapshot
+
+// Advances the world at a fixed tick rate on its own thread, independent of the frame rate. A slow frame doesn't slow
+// the world down and a fast one doesn't cost extra ticks, the thread sleeps until the next tick is due. The render
+// thread hands over input and picks up snapshots through triple buffers, neither side ever waits for the other.
+//
+// Rendering lags one tick behind: a frame shows the state between the two latest ticks, at the fraction of a tick that
+// has passed since the newer one was due.
+class Simulation
+{
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    // behind by more ticks than this, the backlog is dropped instead of spiraling into ever longer catch ups
+    static constexpr uint32_t MAX_CATCH_UP_TICKS = 5;
+
+  public:
+    NON_COPYABLE(Simulation);
+    NON_MOVABLE(Simulation);
+
+    Simulation() = default;
+    ~Simulation();
+
+    // runs on the simulation thread every tick after the player moved, with the latest chunks handed over
+    using WorldTickFunction = std::function<void(const ChunkView &chunks, float seconds)>;
+
+  public:
+    // set before Start, ticks before the first chunk view is handed over skip it
+    void SetWorldTick(WorldTickFunction function);
+
+    // 20 or 60 Hz are the intended rates
+    void Start(uint32_t tickRate, const PlayerState &player);
+
+    // joins the thread
+    void Stop();
+
+    // render thread only
+    void SetInput(const PlayerInput &input) noexcept;
+    void SetChunkView(std::shared_ptr<const ChunkView> view) noexcept;
+    [[nodiscard]] PlayerState Interpolate(Clock::time_point time) noexcept;
+
+    void Dump(std::ostream &stream) const;
+
+    [[nodiscard]] bool IsRunning() const noexcept;
+
+  private:
+    void Run();
+    void Tick(const PlayerInput &input);
+
+  private:
+    std::thread m_thread{};
+    std::atomic<bool> m_running{false};
+    Clock::duration m_tickDuration{};
+    uint32_t m_tickRate{0};
+
+    TripleBuffer<PlayerInput> m_input{};
+    TripleBuffer<SimulationSnapshot> m_snapshots{};
+    TripleBuffer<std::shared_ptr<const ChunkView>> m_chunkViews{};
+    WorldTickFunction m_worldTick{};
+
+    // owned by the simulation thread while it runs
+    Camera m_player{};
+    uint64_t m_tick{0};
+    uint64_t m_skippedTicks{0};
+    double m_tickSeconds{0.0};
+}; // class Simulation
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_GAME_SIMULATION_HPP_
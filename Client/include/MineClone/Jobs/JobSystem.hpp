@@ -0,0 +1,169 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_JOBS_JOBSYSTEM_HPP_
+#define MINECLONE_CLIENT_JOBS_JOBSYSTEM_HPP_
+
+#include "WorkStealingQueue.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace MineClone
+{
+
+enum class JobPriority : uint8_t
+{
+    High,
+    Normal,
+    Low,
+    Count
+};
+
+inline constexpr size_t JOB_PRIORITY_COUNT = static_cast<size_t>(JobPriority::Count);
+
+// ties jobs to an owner, e.g. a chunk, so they can be waited on or cancelled together when it unloads
+class JobGroup
+{
+  public:
+    JobGroup() = default;
+
+    NON_COPYABLE(JobGroup);
+    NON_MOVABLE(JobGroup);
+
+  public:
+    // jobs that have not started yet are skipped, running jobs may poll IsCancelled to stop early
+    void Cancel() noexcept;
+
+    [[nodiscard]] bool IsCancelled() const noexcept;
+    [[nodiscard]] bool IsIdle() const noexcept;
+
+  private:
+    friend class JobSystem;
+
+    std::atomic<bool> m_cancelled{false};
+    std::atomic<uint32_t> m_pendingJobs{0};
+}; // class JobGroup
+
+class Job
+{
+  public:
+    Job(std::function<void()> function, JobPriority priority, std::shared_ptr<JobGroup> group);
+
+    NON_COPYABLE(Job);
+    NON_MOVABLE(Job);
+
+  public:
+    [[nodiscard]] bool IsFinished() const noexcept;
+
+    // only meaningful once the job has finished
+    [[nodiscard]] bool IsCancelled() const noexcept;
+
+    [[nodiscard]] JobPriority GetPriority() const noexcept;
+
+  private:
+    friend class JobSystem;
+
+    std::function<void()> m_function;
+    const JobPriority m_priority;
+    const std::shared_ptr<JobGroup> m_group;
+
+    // keeps the job alive while it is queued, the queues only hold raw pointers
+    std::shared_ptr<Job> m_self;
+
+    std::atomic<uint32_t> m_pendingDependencies{1};
+    std::atomic<bool> m_dependencyCancelled{false};
+    std::atomic<bool> m_finished{false};
+    std::atomic<bool> m_cancelled{false};
+
+    std::mutex m_mutex;
+    std::vector<Job *> m_continuations;
+}; // class Job
+
+using JobHandle = std::shared_ptr<Job>;
+
+class JobSystem
+{
+  public:
+    JobSystem() = default;
+    ~JobSystem();
+
+    NON_COPYABLE(JobSystem);
+    NON_MOVABLE(JobSystem);
+
+  public:
+    // 0 workers picks one per core, minus the render thread
+    void Create(size_t workerCount = 0);
+
+    // waits for all scheduled jobs, cancel the groups first to skip pending work
+    void Destroy();
+
+    // the job runs once all of its dependencies have finished, a cancelled dependency cancels it as well
+    JobHandle Schedule(std::function<void()> function, JobPriority priority = JobPriority::Normal, std::shared_ptr<JobGroup> group = nullptr,
+                       const std::vector<JobHandle> &dependencies = {});
+
+    JobHandle Then(const JobHandle &job, std::function<void()> function, JobPriority priority = JobPriority::Normal);
+
+    // waiting threads run other jobs in the meantime instead of blocking
+    void Wait(const JobHandle &job);
+    void Wait(const JobGroup &group);
+    void WaitIdle();
+
+    // Like Wait, but only helps with jobs at least as urgent as the awaited one and sleeps when there are none, so
+    // generation, meshing or saving never end up on the waiting thread. For the render thread.
+    void WaitUrgent(const JobHandle &job);
+
+    // sleeps until the job is done without running any job itself, for threads with work of their own to get back to
+    void WaitBlocking(const JobHandle &job);
+
+    [[nodiscard]] size_t GetWorkerCount() const noexcept;
+    [[nodiscard]] bool IsWorkerThread() const noexcept;
+
+    // 0 to GetWorkerCount() - 1 on the workers, for per thread state; only meaningful when IsWorkerThread
+    [[nodiscard]] size_t GetWorkerIndex() const noexcept;
+
+  private:
+    struct Worker
+    {
+        std::thread Thread;
+        std::array<WorkStealingQueue<Job *>, JOB_PRIORITY_COUNT> Queues;
+    }; // struct Worker
+
+    void WorkerMain(size_t index);
+
+    void Enqueue(Job *job);
+    Job *FindJob(JobPriority lowest = JobPriority::Low);
+    bool RunOne(JobPriority lowest = JobPriority::Low);
+    void WaitSleeping(const JobHandle &job, bool help);
+    void WakeWaiters();
+    void Execute(Job *job);
+    void Finish(Job &job, bool cancelled);
+
+  private:
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    // jobs scheduled from threads outside the pool, or that overflowed a worker queue
+    std::mutex m_globalMutex;
+    std::array<std::deque<Job *>, JOB_PRIORITY_COUNT> m_globalQueues;
+    std::array<std::atomic<size_t>, JOB_PRIORITY_COUNT> m_globalSizes{};
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    std::atomic<size_t> m_sleepingWorkers{0};
+    std::atomic<size_t> m_queuedJobs{0};
+    std::atomic<size_t> m_outstandingJobs{0};
+    bool m_stopping{false};
+
+    // threads in WaitUrgent and WaitBlocking sleep until a job is queued or finished, the epoch counts both
+    std::mutex m_waitMutex;
+    std::condition_variable m_waitCondition;
+    std::atomic<size_t> m_blockedWaiters{0};
+    std::atomic<uint64_t> m_waitEpoch{0};
+}; // class JobSystem
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_JOBS_JOBSYSTEM_HPP_
@@ -0,0 +1,64 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_JOBS_TRIPLEBUFFER_HPP_
+#define MINECLONE_CLIENT_JOBS_TRIPLEBUFFER_HPP_
+
+#include "../Common.hpp"
+
+#include <array>
+#include <atomic>
+
+namespace MineClone
+{
+
+// Hands the latest value from one producer thread to one consumer thread without locks. The producer fills its buffer
+// and publishes it by swapping it with the shared one, the consumer swaps the shared one into its own buffer when it is
+// newer. Neither side ever waits, values published in between two reads are skipped.
+template <typename T>
+class TripleBuffer
+{
+  public:
+    TripleBuffer() = default;
+
+    NON_COPYABLE(TripleBuffer);
+    NON_MOVABLE(TripleBuffer);
+
+  public:
+    // producer side, stays valid until Publish
+    [[nodiscard]] T &GetWriteBuffer() noexcept
+    {
+        return m_buffers[m_writeIndex];
+    }
+
+    void Publish() noexcept
+    {
+        m_writeIndex = m_shared.exchange(static_cast<uint8_t>(m_writeIndex | FRESH), std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // consumer side, returns false and keeps the current value when nothing was published since the last call
+    bool Update() noexcept
+    {
+        if ((m_shared.load(std::memory_order_relaxed) & FRESH) == 0)
+            return false;
+
+        m_readIndex = m_shared.exchange(m_readIndex, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    [[nodiscard]] const T &Read() const noexcept
+    {
+        return m_buffers[m_readIndex];
+    }
+
+  private:
+    static constexpr uint8_t INDEX_MASK = 3;
+    static constexpr uint8_t FRESH = 4;
+
+    std::array<T, 3> m_buffers{};
+    uint8_t m_writeIndex{0};
+    uint8_t m_readIndex{1};
+    std::atomic<uint8_t> m_shared{2};
+}; // class TripleBuffer
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_JOBS_TRIPLEBUFFER_HPP_
@@ -0,0 +1,103 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_JOBS_WORKSTEALINGQUEUE_HPP_
+#define MINECLONE_CLIENT_JOBS_WORKSTEALINGQUEUE_HPP_
+
+#include "../Common.hpp"
+
+#include <atomic>
+#include <memory>
+
+namespace MineClone
+{
+
+// Chase-Lev deque, only the owning thread may Push and Pop, any thread may Steal
+template <typename T>
+class WorkStealingQueue
+{
+    static_assert(std::is_pointer_v<T>, "WorkStealingQueue stores pointers");
+
+  public:
+    // capacity must be a power of two
+    explicit WorkStealingQueue(size_t capacity = 1024)
+        : m_mask{static_cast<int64_t>(capacity) - 1}, m_buffer{std::make_unique<std::atomic<T>[]>(capacity)}
+    {
+        ASSERT(capacity != 0 && (capacity & (capacity - 1)) == 0, "WorkStealingQueue capacity must be a power of two");
+    }
+
+    NON_COPYABLE(WorkStealingQueue);
+    NON_MOVABLE(WorkStealingQueue);
+
+  public:
+    // returns false when the queue is full
+    bool Push(T item) noexcept
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        const int64_t top = m_top.load(std::memory_order_acquire);
+
+        if (bottom - top > m_mask)
+            return false;
+
+        m_buffer[bottom & m_mask].store(item, std::memory_order_relaxed);
+        m_bottom.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    T Pop() noexcept
+    {
+        const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T item = m_buffer[bottom & m_mask].load(std::memory_order_relaxed);
+
+        if (top == bottom)
+        {
+            // last item, race the thieves for it
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                item = nullptr;
+
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+
+        return item;
+    }
+
+    T Steal() noexcept
+    {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+
+        if (top >= bottom)
+            return nullptr;
+
+        T item = m_buffer[top & m_mask].load(std::memory_order_relaxed);
+
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+
+        return item;
+    }
+
+    [[nodiscard]] bool IsEmpty() const noexcept
+    {
+        return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+    }
+
+  private:
+    alignas(64) std::atomic<int64_t> m_top{0};
+    alignas(64) std::atomic<int64_t> m_bottom{0};
+    const int64_t m_mask;
+    std::unique_ptr<std::atomic<T>[]> m_buffer;
+}; // class WorkStealingQueue
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_JOBS_WORKSTEALINGQUEUE_HPP_
@@ -0,0 +1,89 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_PHYSICS_BLOCKACCESS_HPP_
+#define MINECLONE_CLIENT_PHYSICS_BLOCKACCESS_HPP_
+
+#include "../World/Chunk.hpp"
+
+#include <array>
+#include <functional>
+
+namespace MineClone
+{
+
+// the chunk at chunk coordinates, nullptr when it isn't loaded
+using ChunkLookup = std::function<const Chunk *(int32_t x, int32_t z)>;
+
+// Reads blocks by world coordinates through a small direct mapped cache of chunks, so only the first block read in a
+// chunk pays for the lookup. Collision and raycasts touch a handful of neighboring chunks over and over, with 4x4
+// slots indexed by the low bits of the chunk coordinates those never evict each other.
+//
+// The cache holds plain pointers: Reset it whenever chunks may have been unloaded, at least once per tick. One
+// accessor per thread, the lookup has to be safe to call from all of them.
+class BlockAccess
+{
+  public:
+    explicit BlockAccess(ChunkLookup lookup);
+
+  public:
+    // blocks below and above the world are air, like in unloaded chunks; use IsLoaded to tell the two apart
+    [[nodiscard]] inline BlockId GetBlock(int32_t x, int32_t y, int32_t z)
+    {
+        if (y < 0 || y >= Chunk::HEIGHT)
+            return Blocks::AIR;
+
+        const Chunk *chunk = GetChunk(x >> 4, z >> 4);
+        return chunk == nullptr ? Blocks::AIR : chunk->GetBlock(x & 15, y, z & 15);
+    }
+
+    // unloaded chunks are solid, so nothing falls out of the loaded world
+    [[nodiscard]] inline bool IsSolid(int32_t x, int32_t y, int32_t z)
+    {
+        if (y < 0)
+            return true;
+
+        if (y >= Chunk::HEIGHT)
+            return false;
+
+        const Chunk *chunk = GetChunk(x >> 4, z >> 4);
+        return chunk == nullptr || IsOpaque(chunk->GetBlock(x & 15, y, z & 15));
+    }
+
+    [[nodiscard]] inline bool IsLoaded(int32_t x, int32_t z)
+    {
+        return GetChunk(x >> 4, z >> 4) != nullptr;
+    }
+
+    [[nodiscard]] inline const Chunk *GetChunk(int32_t chunkX, int32_t chunkZ)
+    {
+        Slot &slot = m_slots[(static_cast<uint32_t>(chunkZ) & 3) << 2 | (static_cast<uint32_t>(chunkX) & 3)];
+
+        if (slot.Valid && slot.X == chunkX && slot.Z == chunkZ)
+            return slot.Cached;
+
+        return Load(slot, chunkX, chunkZ);
+    }
+
+    // forgets every cached chunk
+    void Reset() noexcept;
+
+    [[nodiscard]] size_t GetLookupCount() const noexcept;
+
+  private:
+    struct Slot
+    {
+        int32_t X{0}, Z{0};
+        const Chunk *Cached{nullptr};
+        bool Valid{false};
+    }; // struct Slot
+
+    const Chunk *Load(Slot &slot, int32_t chunkX, int32_t chunkZ);
+
+  private:
+    ChunkLookup m_lookup;
+    std::array<Slot, 16> m_slots{};
+    size_t m_lookupCount{0};
+}; // class BlockAccess
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_PHYSICS_BLOCKACCESS_HPP_
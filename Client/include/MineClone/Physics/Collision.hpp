@@ -0,0 +1,43 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_PHYSICS_COLLISION_HPP_
+#define MINECLONE_CLIENT_PHYSICS_COLLISION_HPP_
+
+#include "BlockAccess.hpp"
+
+namespace MineClone
+{
+
+// axis aligned, in blocks
+struct BoundingBox
+{
+    float MinX, MinY, MinZ;
+    float MaxX, MaxY, MaxZ;
+}; // struct BoundingBox
+
+struct PhysicsBody
+{
+    BoundingBox Box;
+    float VelocityX, VelocityY, VelocityZ; // blocks per second
+    bool OnGround;
+}; // struct PhysicsBody
+
+struct MoveResult
+{
+    float X, Y, Z; // how far the box actually moved
+    bool CollidedX, CollidedY, CollidedZ;
+}; // struct MoveResult
+
+// Sweeps the box by the motion through the solid blocks and moves it as far as it gets, one axis at a time: Y first,
+// then X and Z, so walking into a wall while falling slides along it instead of stopping dead. Each axis only looks at
+// the blocks the box sweeps over, the cost grows with the size of the box and the motion, not with the world.
+//
+// Boxes that already overlap a block can still move out of it, they're only stopped by blocks in front of them.
+MoveResult MoveBox(BlockAccess &blocks, BoundingBox &box, float dx, float dy, float dz);
+
+// Applies gravity to count bodies and moves them for seconds, zeroing the velocity on the axes they hit something.
+// All bodies share the chunk cache of blocks, keeping neighbors next to each other in the array keeps it warm.
+void StepBodies(BlockAccess &blocks, PhysicsBody *bodies, size_t count, float seconds, float gravity);
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_PHYSICS_COLLISION_HPP_
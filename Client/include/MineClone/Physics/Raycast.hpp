@@ -0,0 +1,31 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_PHYSICS_RAYCAST_HPP_
+#define MINECLONE_CLIENT_PHYSICS_RAYCAST_HPP_
+
+#include "BlockAccess.hpp"
+
+namespace MineClone
+{
+
+struct RaycastHit
+{
+    int32_t X, Y, Z;
+    BlockId Block;
+    BlockFace Face; // the face the ray entered through
+    float Distance;
+}; // struct RaycastHit
+
+// Finds the first opaque block along the ray, for picking the block the player looks at. The ray steps from block to
+// block by whichever boundary it crosses next (Amanatides and Woo), so it visits every block it touches exactly once
+// and nothing else. Distances are in lengths of the direction, normalize it to measure in blocks.
+//
+// Unloaded chunks end the ray without a hit, a ray that starts inside a block hits it at distance 0.
+[[nodiscard]] bool Raycast(BlockAccess &blocks, float originX, float originY, float originZ, float directionX, float directionY,
+                           float directionZ, float maxDistance, RaycastHit &hit);
+
+// true if no opaque block lies between the two points, and neither does an unloaded chunk
+[[nodiscard]] bool HasLineOfSight(BlockAccess &blocks, float fromX, float fromY, float fromZ, float toX, float toY, float toZ);
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_PHYSICS_RAYCAST_HPP_
@@ -0,0 +1,467 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_SIMD_HPP_
+#define MINECLONE_CLIENT_SIMD_HPP_
+
+#include "Common.hpp"
+
+// The instruction set is picked at build time with MINECLONE_SIMD, every kernel written against these wrappers
+// evaluates SIMD_LANES values per call.
+#if defined(MINECLONE_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(MINECLONE_SIMD_SSE41)
+#include <smmintrin.h>
+#else
+#include <cmath>
+#include <cstring>
+#endif
+
+namespace MineClone
+{
+
+namespace Simd
+{
+
+#if defined(MINECLONE_SIMD_AVX2)
+
+inline constexpr size_t LANES = 8;
+inline constexpr const char *NAME = "AVX2";
+
+using Float = __m256;
+using Int = __m256i;
+
+inline Float Set(float value) noexcept
+{
+    return _mm256_set1_ps(value);
+}
+
+inline Int SetInt(int32_t value) noexcept
+{
+    return _mm256_set1_epi32(value);
+}
+
+inline Float Load(const float *data) noexcept
+{
+    return _mm256_loadu_ps(data);
+}
+
+inline void Store(float *data, Float value) noexcept
+{
+    _mm256_storeu_ps(data, value);
+}
+
+inline Float Add(Float a, Float b) noexcept
+{
+    return _mm256_add_ps(a, b);
+}
+
+inline Float Sub(Float a, Float b) noexcept
+{
+    return _mm256_sub_ps(a, b);
+}
+
+inline Float Mul(Float a, Float b) noexcept
+{
+    return _mm256_mul_ps(a, b);
+}
+
+// not fused, the other backends round the product on its own and terrain has to come out the same on all of them
+inline Float MulAdd(Float a, Float b, Float c) noexcept
+{
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+}
+
+inline Float Min(Float a, Float b) noexcept
+{
+    return _mm256_min_ps(a, b);
+}
+
+inline Float Max(Float a, Float b) noexcept
+{
+    return _mm256_max_ps(a, b);
+}
+
+inline Float Floor(Float a) noexcept
+{
+    return _mm256_floor_ps(a);
+}
+
+inline Int ToInt(Float a) noexcept
+{
+    return _mm256_cvttps_epi32(a);
+}
+
+inline Float ToFloat(Int a) noexcept
+{
+    return _mm256_cvtepi32_ps(a);
+}
+
+inline Float AsFloat(Int a) noexcept
+{
+    return _mm256_castsi256_ps(a);
+}
+
+inline Int AsInt(Float a) noexcept
+{
+    return _mm256_castps_si256(a);
+}
+
+inline Int Add(Int a, Int b) noexcept
+{
+    return _mm256_add_epi32(a, b);
+}
+
+inline Int Mul(Int a, Int b) noexcept
+{
+    return _mm256_mullo_epi32(a, b);
+}
+
+inline Int And(Int a, Int b) noexcept
+{
+    return _mm256_and_si256(a, b);
+}
+
+inline Int Xor(Int a, Int b) noexcept
+{
+    return _mm256_xor_si256(a, b);
+}
+
+inline Int ShiftLeft(Int a, int bits) noexcept
+{
+    return _mm256_slli_epi32(a, bits);
+}
+
+inline Int ShiftRight(Int a, int bits) noexcept
+{
+    return _mm256_srli_epi32(a, bits);
+}
+
+inline Int Less(Int a, Int b) noexcept
+{
+    return _mm256_cmpgt_epi32(b, a);
+}
+
+inline Int Equal(Int a, Int b) noexcept
+{
+    return _mm256_cmpeq_epi32(a, b);
+}
+
+inline Int Or(Int a, Int b) noexcept
+{
+    return _mm256_or_si256(a, b);
+}
+
+// picks a where the mask lanes are set
+inline Float Select(Int mask, Float a, Float b) noexcept
+{
+    return _mm256_blendv_ps(b, a, _mm256_castsi256_ps(mask));
+}
+
+inline Int Less(Float a, Float b) noexcept
+{
+    return _mm256_castps_si256(_mm256_cmp_ps(a, b, _CMP_LT_OQ));
+}
+
+// one bit per lane, lane 0 in bit 0
+inline uint32_t MoveMask(Int mask) noexcept
+{
+    return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+}
+
+#elif defined(MINECLONE_SIMD_SSE41)
+
+inline constexpr size_t LANES = 4;
+inline constexpr const char *NAME = "SSE4.1";
+
+using Float = __m128;
+using Int = __m128i;
+
+inline Float Set(float value) noexcept
+{
+    return _mm_set1_ps(value);
+}
+
+inline Int SetInt(int32_t value) noexcept
+{
+    return _mm_set1_epi32(value);
+}
+
+inline Float Load(const float *data) noexcept
+{
+    return _mm_loadu_ps(data);
+}
+
+inline void Store(float *data, Float value) noexcept
+{
+    _mm_storeu_ps(data, value);
+}
+
+inline Float Add(Float a, Float b) noexcept
+{
+    return _mm_add_ps(a, b);
+}
+
+inline Float Sub(Float a, Float b) noexcept
+{
+    return _mm_sub_ps(a, b);
+}
+
+inline Float Mul(Float a, Float b) noexcept
+{
+    return _mm_mul_ps(a, b);
+}
+
+inline Float MulAdd(Float a, Float b, Float c) noexcept
+{
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+}
+
+inline Float Min(Float a, Float b) noexcept
+{
+    return _mm_min_ps(a, b);
+}
+
+inline Float Max(Float a, Float b) noexcept
+{
+    return _mm_max_ps(a, b);
+}
+
+inline Float Floor(Float a) noexcept
+{
+    return _mm_floor_ps(a);
+}
+
+inline Int ToInt(Float a) noexcept
+{
+    return _mm_cvttps_epi32(a);
+}
+
+inline Float ToFloat(Int a) noexcept
+{
+    return _mm_cvtepi32_ps(a);
+}
+
+inline Float AsFloat(Int a) noexcept
+{
+    return _mm_castsi128_ps(a);
+}
+
+inline Int AsInt(Float a) noexcept
+{
+    return _mm_castps_si128(a);
+}
+
+inline Int Add(Int a, Int b) noexcept
+{
+    return _mm_add_epi32(a, b);
+}
+
+inline Int Mul(Int a, Int b) noexcept
+{
+    return _mm_mullo_epi32(a, b);
+}
+
+inline Int And(Int a, Int b) noexcept
+{
+    return _mm_and_si128(a, b);
+}
+
+inline Int Xor(Int a, Int b) noexcept
+{
+    return _mm_xor_si128(a, b);
+}
+
+inline Int ShiftLeft(Int a, int bits) noexcept
+{
+    return _mm_slli_epi32(a, bits);
+}
+
+inline Int ShiftRight(Int a, int bits) noexcept
+{
+    return _mm_srli_epi32(a, bits);
+}
+
+inline Int Less(Int a, Int b) noexcept
+{
+    return _mm_cmplt_epi32(a, b);
+}
+
+inline Int Equal(Int a, Int b) noexcept
+{
+    return _mm_cmpeq_epi32(a, b);
+}
+
+inline Int Or(Int a, Int b) noexcept
+{
+    return _mm_or_si128(a, b);
+}
+
+inline Float Select(Int mask, Float a, Float b) noexcept
+{
+    return _mm_blendv_ps(b, a, _mm_castsi128_ps(mask));
+}
+
+inline Int Less(Float a, Float b) noexcept
+{
+    return _mm_castps_si128(_mm_cmplt_ps(a, b));
+}
+
+inline uint32_t MoveMask(Int mask) noexcept
+{
+    return static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(mask)));
+}
+
+#else
+
+inline constexpr size_t LANES = 1;
+inline constexpr const char *NAME = "scalar";
+
+using Float = float;
+using Int = int32_t;
+
+inline Float Set(float value) noexcept
+{
+    return value;
+}
+
+inline Int SetInt(int32_t value) noexcept
+{
+    return value;
+}
+
+inline Float Load(const float *data) noexcept
+{
+    return *data;
+}
+
+inline void Store(float *data, Float value) noexcept
+{
+    *data = value;
+}
+
+inline Float Add(Float a, Float b) noexcept
+{
+    return a + b;
+}
+
+inline Float Sub(Float a, Float b) noexcept
+{
+    return a - b;
+}
+
+inline Float Mul(Float a, Float b) noexcept
+{
+    return a * b;
+}
+
+inline Float MulAdd(Float a, Float b, Float c) noexcept
+{
+    return a * b + c;
+}
+
+inline Float Min(Float a, Float b) noexcept
+{
+    return a < b ? a : b;
+}
+
+inline Float Max(Float a, Float b) noexcept
+{
+    return a > b ? a : b;
+}
+
+inline Float Floor(Float a) noexcept
+{
+    return std::floor(a);
+}
+
+inline Int ToInt(Float a) noexcept
+{
+    return static_cast<Int>(a);
+}
+
+inline Float ToFloat(Int a) noexcept
+{
+    return static_cast<Float>(a);
+}
+
+inline Float AsFloat(Int a) noexcept
+{
+    Float result;
+    std::memcpy(&result, &a, sizeof(result));
+    return result;
+}
+
+inline Int AsInt(Float a) noexcept
+{
+    Int result;
+    std::memcpy(&result, &a, sizeof(result));
+    return result;
+}
+
+// integer math wraps like the vector units do
+inline Int Add(Int a, Int b) noexcept
+{
+    return static_cast<Int>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+}
+
+inline Int Mul(Int a, Int b) noexcept
+{
+    return static_cast<Int>(static_cast<uint32_t>(a) * static_cast<uint32_t>(b));
+}
+
+inline Int And(Int a, Int b) noexcept
+{
+    return a & b;
+}
+
+inline Int Xor(Int a, Int b) noexcept
+{
+    return a ^ b;
+}
+
+inline Int ShiftLeft(Int a, int bits) noexcept
+{
+    return static_cast<Int>(static_cast<uint32_t>(a) << bits);
+}
+
+inline Int ShiftRight(Int a, int bits) noexcept
+{
+    return static_cast<Int>(static_cast<uint32_t>(a) >> bits);
+}
+
+inline Int Less(Int a, Int b) noexcept
+{
+    return a < b ? -1 : 0;
+}
+
+inline Int Equal(Int a, Int b) noexcept
+{
+    return a == b ? -1 : 0;
+}
+
+inline Int Or(Int a, Int b) noexcept
+{
+    return a | b;
+}
+
+inline Float Select(Int mask, Float a, Float b) noexcept
+{
+    return mask != 0 ? a : b;
+}
+
+inline Int Less(Float a, Float b) noexcept
+{
+    return a < b ? -1 : 0;
+}
+
+inline uint32_t MoveMask(Int mask) noexcept
+{
+    return mask != 0 ? 1u : 0u;
+}
+
+#endif
+
+} // namespace Simd
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_SIMD_HPP_
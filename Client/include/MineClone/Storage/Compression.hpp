@@ -0,0 +1,27 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_STORAGE_COMPRESSION_HPP_
+#define MINECLONE_CLIENT_STORAGE_COMPRESSION_HPP_
+
+#include <MineClone/Common.hpp>
+
+#include <vector>
+
+namespace MineClone
+{
+
+// Byte oriented LZ77 in the LZ4 block format: greedy matching through a hash table of the last position of every four
+// byte sequence. It trades ratio for speed, serialized sections are mostly runs of packed words and palette ids that
+// compress well even so, and decompression runs at memory speed.
+
+// upper bound of the compressed size of size bytes
+[[nodiscard]] size_t CompressBound(size_t size) noexcept;
+
+// appends the compressed data to output
+void Compress(const uint8_t *data, size_t size, std::vector<uint8_t> &output);
+
+// false when the input is malformed or doesn't decompress to exactly outputSize bytes
+[[nodiscard]] bool Decompress(const uint8_t *data, size_t size, uint8_t *output, size_t outputSize) noexcept;
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_STORAGE_COMPRESSION_HPP_
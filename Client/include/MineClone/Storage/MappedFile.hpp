@@ -0,0 +1,57 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_STORAGE_MAPPEDFILE_HPP_
+#define MINECLONE_CLIENT_STORAGE_MAPPEDFILE_HPP_
+
+#include <MineClone/Common.hpp>
+
+#include <string>
+
+namespace MineClone
+{
+
+// A file opened for reading and writing, with a read only mapping of its contents. Reads go through the mapping, so a
+// read is a page fault at worst; writes go through the file handle and grow the mapping when they extend the file.
+// The mapping moves when it grows, pointers into it are only valid until the next Write.
+class MappedFile
+{
+  public:
+    NON_COPYABLE(MappedFile);
+    NON_MOVABLE(MappedFile);
+
+    MappedFile() = default;
+    ~MappedFile();
+
+  public:
+    // creates the file when it doesn't exist, throws when it can't be opened or mapped
+    void Open(const std::string &path);
+
+    void Close() noexcept;
+
+    [[nodiscard]] bool Write(uint64_t offset, const void *data, size_t size);
+
+    // blocks until every write so far is on disk
+    [[nodiscard]] bool Sync();
+
+    [[nodiscard]] bool IsOpen() const noexcept;
+    [[nodiscard]] const uint8_t *GetData() const noexcept;
+    [[nodiscard]] uint64_t GetSize() const noexcept;
+
+  private:
+    [[nodiscard]] bool Map(uint64_t size);
+    void Unmap() noexcept;
+
+  private:
+#ifdef _WIN32
+    void *m_handle{nullptr};
+    void *m_mapping{nullptr};
+#else
+    int m_descriptor{-1};
+#endif
+    const uint8_t *m_data{nullptr};
+    uint64_t m_mappedSize{0};
+    uint64_t m_size{0};
+}; // class MappedFile
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_STORAGE_MAPPEDFILE_HPP_
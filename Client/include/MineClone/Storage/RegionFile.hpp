@@ -0,0 +1,100 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_STORAGE_REGIONFILE_HPP_
+#define MINECLONE_CLIENT_STORAGE_REGIONFILE_HPP_
+
+#include "MappedFile.hpp"
+
+#include <array>
+#include <vector>
+
+namespace MineClone
+{
+
+// The chunks of a 32x32 column area in one file, as sector aligned blobs behind a fixed size offset table:
+//  - sectors 0 to 5 hold two copies of the table, each with a sequence number and a checksum
+//  - every blob is a small header with its checksum followed by the compressed chunk, padded to whole sectors
+//
+// A blob is never written over a blob that a table on disk still points at. Save puts it in free sectors or at the
+// end of the file, Flush syncs the blobs and only then writes the table into the slot of the older copy. A crash
+// leaves at least one complete table that points at complete blobs, Open picks the newest one whose checksum holds.
+// Sectors of replaced blobs become free once neither copy of the table refers to them any more.
+//
+// Not thread safe, RegionStorage serializes access.
+class RegionFile
+{
+  public:
+    static constexpr int SIZE = 32;
+    static constexpr size_t CHUNK_COUNT = SIZE * SIZE;
+    static constexpr size_t SECTOR_SIZE = 4096;
+
+    struct Blob
+    {
+        const uint8_t *Data{nullptr}; // compressed, into the mapping
+        uint32_t Size{0};
+        uint32_t RawSize{0};
+    }; // struct Blob
+
+  public:
+    NON_COPYABLE(RegionFile);
+    NON_MOVABLE(RegionFile);
+
+    RegionFile() = default;
+    ~RegionFile();
+
+  public:
+    // creates an empty region when the file doesn't exist, throws when it can't be opened or no table is intact
+    void Open(const std::string &path);
+
+    // flushes first
+    void Close();
+
+    // Coordinates within the region. Returns false when the chunk was never saved or its blob is damaged. The data
+    // stays valid until the next Save or Flush.
+    [[nodiscard]] bool Find(int x, int z, Blob &blob) const;
+
+    // written right away, but only part of the region on disk after the next Flush
+    [[nodiscard]] bool Save(int x, int z, const uint8_t *data, size_t size, size_t rawSize);
+
+    [[nodiscard]] bool Flush();
+
+    [[nodiscard]] bool Contains(int x, int z) const noexcept;
+    [[nodiscard]] size_t GetChunkCount() const noexcept;
+    [[nodiscard]] uint64_t GetFileSize() const noexcept;
+    [[nodiscard]] uint64_t GetUsedSize() const noexcept;
+
+  private:
+    struct TableEntry
+    {
+        uint32_t Sector;
+        uint32_t SectorCount; // 0 when the chunk isn't stored
+    }; // struct TableEntry
+
+    using Table = std::array<TableEntry, CHUNK_COUNT>;
+
+    [[nodiscard]] bool ReadTable(int slot, uint64_t &sequence, Table &table) const;
+    [[nodiscard]] bool WriteTable(int slot);
+
+    [[nodiscard]] uint32_t AllocateSectors(uint32_t count);
+    void Reference(const TableEntry &entry, int delta);
+
+  private:
+    std::string m_path{};
+    MappedFile m_file{};
+
+    // the table Find and Save work on, and what the two slots on disk hold
+    Table m_table{};
+    std::array<Table, 2> m_slots{};
+    uint64_t m_sequence{0};
+    int m_newestSlot{0};
+    bool m_dirty{false};
+
+    // per sector, how many of the three tables point into it; 0 is free
+    std::vector<uint8_t> m_sectorReferences{};
+    uint32_t m_firstFreeSector{0};
+
+    std::vector<uint8_t> m_writeBuffer{};
+}; // class RegionFile
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_STORAGE_REGIONFILE_HPP_
@@ -0,0 +1,93 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_STORAGE_REGIONSTORAGE_HPP_
+#define MINECLONE_CLIENT_STORAGE_REGIONSTORAGE_HPP_
+
+#include "RegionFile.hpp"
+
+#include <MineClone/World/Chunk.hpp>
+
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+namespace MineClone
+{
+
+struct StorageStatistics
+{
+    size_t Loads{0};
+    size_t Saves{0};
+    uint64_t RawBytes{0};        // serialized chunks saved
+    uint64_t CompressedBytes{0}; // the same after compression
+}; // struct StorageStatistics
+
+// The world on disk, one RegionFile per 32x32 chunks in a directory, named r.<x>.<z>.mcr. Up to MAX_OPEN_REGIONS stay
+// open, the least recently used one is closed to make room for the next.
+//
+// Safe to call from any thread. Loads share a lock and decompress straight out of the mapping, so they run in
+// parallel; saves serialize and compress before taking the exclusive lock, which only covers the write itself.
+class RegionStorage
+{
+  public:
+    static constexpr size_t MAX_OPEN_REGIONS = 64;
+
+  public:
+    NON_COPYABLE(RegionStorage);
+    NON_MOVABLE(RegionStorage);
+
+    RegionStorage() = default;
+    ~RegionStorage();
+
+  public:
+    // creates the directory when needed
+    void Open(const std::string &directory);
+
+    // flushes and closes every region
+    void Close();
+
+    // Fills the chunk at its position. Returns false when it was never saved or can't be read, the chunk has to be
+    // generated then.
+    [[nodiscard]] bool Load(Chunk &chunk);
+
+    [[nodiscard]] bool Save(const Chunk &chunk);
+
+    // makes every save so far durable
+    [[nodiscard]] bool Flush();
+
+    [[nodiscard]] StorageStatistics GetStatistics() const;
+    [[nodiscard]] uint64_t GetFileSize() const;
+
+  private:
+    struct OpenRegion
+    {
+        RegionFile File;
+        std::atomic<uint64_t> LastUse{0};
+    }; // struct OpenRegion
+
+    [[nodiscard]] OpenRegion *FindRegion(int32_t x, int32_t z);
+
+    // with the exclusive lock held, nullptr when create is false and there is no file
+    [[nodiscard]] OpenRegion *OpenRegionFile(int32_t x, int32_t z, bool create);
+
+    [[nodiscard]] bool Decode(const RegionFile &region, int x, int z, Chunk &chunk);
+
+    [[nodiscard]] std::string GetRegionPath(int32_t x, int32_t z) const;
+
+  private:
+    std::string m_directory{};
+
+    mutable std::shared_mutex m_mutex{};
+    std::unordered_map<uint64_t, std::unique_ptr<OpenRegion>> m_regions{};
+    std::atomic<uint64_t> m_useCounter{0};
+
+    std::atomic<size_t> m_loads{0};
+    std::atomic<size_t> m_saves{0};
+    std::atomic<uint64_t> m_rawBytes{0};
+    std::atomic<uint64_t> m_compressedBytes{0};
+}; // class RegionStorage
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_STORAGE_REGIONSTORAGE_HPP_
@@ -3,6 +3,12 @@
 
 #include "Common.hpp"
 
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace MineClone
 {
 
@@ -14,6 +20,51 @@ inline R FirstOrDefault(T &container, Predicate predicate, R defaultValue)
     return iterator == end(container) ? defaultValue : *iterator;
 }
 
+// value must not be 0
+inline unsigned CountTrailingZeros(uint32_t value) noexcept
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(value));
+#endif
+}
+
+// value must not be 0
+inline unsigned CountTrailingZeros64(uint64_t value) noexcept
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctzll(value));
+#endif
+}
+
+// index of the highest set bit, value must not be 0
+inline unsigned BitScanReverse64(uint64_t value) noexcept
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<unsigned>(index);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#endif
+}
+
+inline unsigned PopCount(uint32_t value) noexcept
+{
+#ifdef _MSC_VER
+    return static_cast<unsigned>(__popcnt(value));
+#else
+    return static_cast<unsigned>(__builtin_popcount(value));
+#endif
+}
+
 } // namespace MineClone
 
 #endif // MINECLONE_CLIENT_UTILITY_HPP_
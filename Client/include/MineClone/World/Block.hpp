@@ -0,0 +1,59 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_WORLD_BLOCK_HPP_
+#define MINECLONE_CLIENT_WORLD_BLOCK_HPP_
+
+#include "../Common.hpp"
+
+namespace MineClone
+{
+
+using BlockId = uint16_t;
+
+namespace Blocks
+{
+
+inline constexpr BlockId AIR = 0;
+inline constexpr BlockId STONE = 1;
+inline constexpr BlockId DIRT = 2;
+inline constexpr BlockId GRASS = 3;
+inline constexpr BlockId SAND = 4;
+inline constexpr BlockId WATER = 5;
+inline constexpr BlockId BEDROCK = 6;
+inline constexpr BlockId LAMP = 7;
+
+} // namespace Blocks
+
+enum class BlockFace : uint8_t
+{
+    PositiveX,
+    NegativeX,
+    PositiveY,
+    NegativeY,
+    PositiveZ,
+    NegativeZ,
+    Count
+}; // enum class BlockFace
+
+inline constexpr size_t BLOCK_FACE_COUNT = static_cast<size_t>(BlockFace::Count);
+
+// every non air block hides the faces behind it until block properties exist
+[[nodiscard]] inline constexpr bool IsOpaque(BlockId block) noexcept
+{
+    return block != Blocks::AIR;
+}
+
+// blocks that change on their own now and then, picked by random ticks (see BlockTicker)
+[[nodiscard]] inline constexpr bool IsRandomlyTicked(BlockId block) noexcept
+{
+    return block == Blocks::GRASS;
+}
+
+// block light level the block gives off, 0 to 15
+[[nodiscard]] inline constexpr uint8_t GetLightEmission(BlockId block) noexcept
+{
+    return block == Blocks::LAMP ? 15 : 0;
+}
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_WORLD_BLOCK_HPP_
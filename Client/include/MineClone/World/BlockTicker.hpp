@@ -0,0 +1,94 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_WORLD_BLOCKTICKER_HPP_
+#define MINECLONE_CLIENT_WORLD_BLOCKTICKER_HPP_
+
+#include "Chunk.hpp"
+#include "ChunkView.hpp"
+#include "TimingWheel.hpp"
+
+#include <ostream>
+#include <vector>
+
+namespace MineClone
+{
+
+// a block due for an update, in world coordinates
+struct BlockTick
+{
+    int32_t X, Y, Z;
+    BlockId Block;
+}; // struct BlockTick
+
+struct TickStatistics
+{
+    uint64_t Ticks{0};
+    size_t Scheduled{0};
+    size_t Expired{0};
+    size_t Dropped{0};         // scheduled ticks whose chunk was unloaded or whose block changed
+    size_t RandomTicks{0};
+    size_t SectionsSampled{0};
+    size_t SectionsSkipped{0}; // no tickable blocks, not a single random number drawn for them
+    double TotalMilliseconds{0.0};
+}; // struct TickStatistics
+
+// Finds the blocks that update in a world tick, of two kinds:
+//  - scheduled: a block asks to be updated after a delay, kept in a timing wheel so both scheduling and expiring
+//    are constant time no matter how many are pending. A tick is only delivered while the block at the position is
+//    still the one that scheduled it.
+//  - random: RANDOM_TICKS_PER_SECTION positions of every loaded section are picked per tick, and the blocks there
+//    update when IsRandomlyTicked holds for them. Sections without such blocks are skipped by their tickable count,
+//    the rest take a single xorshift draw for all of their positions.
+// The chunks come in with every tick, as a view of the loaded ones. What the updates do is up to the caller, the ticker
+// only reads the chunks.
+class BlockTicker
+{
+  public:
+    static constexpr uint32_t RANDOM_TICKS_PER_SECTION = 3;
+
+  public:
+    NON_COPYABLE(BlockTicker);
+    NON_MOVABLE(BlockTicker);
+
+    BlockTicker() = default;
+
+  public:
+    // drops the pending scheduled ticks
+    void Clear();
+
+    // in ticks from the current one, 0 counts as 1
+    void Schedule(int32_t x, int32_t y, int32_t z, BlockId block, uint64_t delay);
+
+    // Advances one tick and appends the blocks that update in it. Scheduled ticks in chunks that aren't in the view are
+    // dropped.
+    void Tick(const ChunkView &chunks, std::vector<BlockTick> &scheduled, std::vector<BlockTick> &random);
+
+    void Dump(std::ostream &stream) const;
+
+    [[nodiscard]] size_t GetPendingCount() const noexcept;
+    [[nodiscard]] const TickStatistics &GetStatistics() const noexcept;
+
+  private:
+    void TickScheduled(const ChunkView &chunks, std::vector<BlockTick> &scheduled);
+    void TickRandom(const ChunkView &chunks, std::vector<BlockTick> &random);
+
+    [[nodiscard]] inline uint64_t NextRandom() noexcept
+    {
+        m_random ^= m_random << 13;
+        m_random ^= m_random >> 7;
+        m_random ^= m_random << 17;
+        return m_random;
+    }
+
+  private:
+    TimingWheel<BlockTick> m_wheel{};
+    std::vector<BlockTick> m_expired{};
+
+    uint64_t m_random{0x9E3779B97F4A7C15};
+    size_t m_chunkCount{0}; // in the view of the last tick
+
+    TickStatistics m_statistics{};
+}; // class BlockTicker
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_WORLD_BLOCKTICKER_HPP_
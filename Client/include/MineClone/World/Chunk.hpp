@@ -0,0 +1,87 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_WORLD_CHUNK_HPP_
+#define MINECLONE_CLIENT_WORLD_CHUNK_HPP_
+
+#include "ChunkSection.hpp"
+#include "NibbleArray.hpp"
+
+#include <array>
+#include <vector>
+
+namespace MineClone
+{
+
+// A full height column of chunk sections, with a sky and a block light level per block next to them (see LightEngine).
+class Chunk
+{
+  public:
+    static constexpr int SECTION_COUNT = 16;
+    static constexpr int HEIGHT = SECTION_COUNT * ChunkSection::SIZE;
+
+    // bounds what a stored chunk may claim to decompress to
+    static constexpr size_t MAX_SERIALIZED_SIZE = SECTION_COUNT * ChunkSection::MAX_SERIALIZED_SIZE;
+
+  public:
+    Chunk(int32_t x, int32_t z) noexcept;
+
+    [[nodiscard]] inline BlockId GetBlock(int x, int y, int z) const noexcept
+    {
+        return m_sections[y >> 4].Get(x, y & 15, z);
+    }
+
+    inline void SetBlock(int x, int y, int z, BlockId block)
+    {
+        m_sections[y >> 4].Set(x, y & 15, z, block);
+    }
+
+    [[nodiscard]] inline uint8_t GetSkyLight(int x, int y, int z) const noexcept
+    {
+        return m_skyLight[y >> 4].Get(ChunkSection::Index(x, y & 15, z));
+    }
+
+    inline void SetSkyLight(int x, int y, int z, uint8_t level)
+    {
+        m_skyLight[y >> 4].Set(ChunkSection::Index(x, y & 15, z), level);
+    }
+
+    [[nodiscard]] inline uint8_t GetBlockLight(int x, int y, int z) const noexcept
+    {
+        return m_blockLight[y >> 4].Get(ChunkSection::Index(x, y & 15, z));
+    }
+
+    inline void SetBlockLight(int x, int y, int z, uint8_t level)
+    {
+        m_blockLight[y >> 4].Set(ChunkSection::Index(x, y & 15, z), level);
+    }
+
+    [[nodiscard]] ChunkSection &GetSection(int index) noexcept;
+    [[nodiscard]] const ChunkSection &GetSection(int index) const noexcept;
+
+    [[nodiscard]] NibbleArray &GetSkyLight(int section) noexcept;
+    [[nodiscard]] const NibbleArray &GetSkyLight(int section) const noexcept;
+    [[nodiscard]] NibbleArray &GetBlockLight(int section) noexcept;
+    [[nodiscard]] const NibbleArray &GetBlockLight(int section) const noexcept;
+
+    [[nodiscard]] int32_t GetX() const noexcept;
+    [[nodiscard]] int32_t GetZ() const noexcept;
+
+    // compacts the light arrays as well
+    void Compact();
+
+    // the sections one after another, see ChunkSection::Serialize; neither the position nor the light is part of it,
+    // LightEngine::LightChunk recomputes the light of loaded chunks
+    void Serialize(std::vector<uint8_t> &output) const;
+    bool Deserialize(const uint8_t *data, size_t size);
+
+    [[nodiscard]] size_t GetMemoryUsage() const noexcept;
+
+  private:
+    int32_t m_x, m_z;
+    std::array<ChunkSection, SECTION_COUNT> m_sections{};
+    std::array<NibbleArray, SECTION_COUNT> m_skyLight{};
+    std::array<NibbleArray, SECTION_COUNT> m_blockLight{};
+}; // class Chunk
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_WORLD_CHUNK_HPP_
@@ -0,0 +1,141 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_WORLD_CHUNKMESHER_HPP_
+#define MINECLONE_CLIENT_WORLD_CHUNKMESHER_HPP_
+
+#include "ChunkSection.hpp"
+
+#include <array>
+#include <vector>
+
+namespace MineClone
+{
+
+// One merged face in two 32 bit words, the vertex shader expands it into four corners from gl_VertexIndex:
+//  Position: x, y, z of the first corner (5 bits each, 0 to 16), face (3 bits), width - 1 and height - 1 (4 bits each)
+//  Material: texture layer (16 bits), ambient occlusion of the four corners (2 bits each, 3 is unoccluded)
+// Corners go u -> v counter-clockwise around u x v, where u and v are the two axes of the face plane in the order
+// X: (z, y), Y: (x, z), Z: (x, y). That normal points the wrong way for +X, +Y and -Z, their winding gets flipped.
+struct ChunkQuad
+{
+    uint32_t Position;
+    uint32_t Material;
+
+    [[nodiscard]] static constexpr ChunkQuad Pack(int x, int y, int z, BlockFace face, int width, int height, uint16_t texture,
+                                                  uint8_t occlusion) noexcept
+    {
+        const auto position = static_cast<uint32_t>(x) | static_cast<uint32_t>(y) << 5 | static_cast<uint32_t>(z) << 10 |
+                              static_cast<uint32_t>(face) << 15 | static_cast<uint32_t>(width - 1) << 18 | static_cast<uint32_t>(height - 1) << 22;
+
+        return {position, static_cast<uint32_t>(texture) | static_cast<uint32_t>(occlusion) << 16};
+    }
+
+    [[nodiscard]] constexpr int GetX() const noexcept
+    {
+        return static_cast<int>(Position & 31);
+    }
+
+    [[nodiscard]] constexpr int GetY() const noexcept
+    {
+        return static_cast<int>(Position >> 5 & 31);
+    }
+
+    [[nodiscard]] constexpr int GetZ() const noexcept
+    {
+        return static_cast<int>(Position >> 10 & 31);
+    }
+
+    [[nodiscard]] constexpr BlockFace GetFace() const noexcept
+    {
+        return static_cast<BlockFace>(Position >> 15 & 7);
+    }
+
+    [[nodiscard]] constexpr int GetWidth() const noexcept
+    {
+        return static_cast<int>(Position >> 18 & 15) + 1;
+    }
+
+    [[nodiscard]] constexpr int GetHeight() const noexcept
+    {
+        return static_cast<int>(Position >> 22 & 15) + 1;
+    }
+
+    [[nodiscard]] constexpr uint16_t GetTexture() const noexcept
+    {
+        return static_cast<uint16_t>(Material & 0xFFFF);
+    }
+
+    // corner 0 to 3 in u -> v order
+    [[nodiscard]] constexpr int GetOcclusion(int corner) const noexcept
+    {
+        return static_cast<int>(Material >> (16 + 2 * corner) & 3);
+    }
+}; // struct ChunkQuad
+
+static_assert(sizeof(ChunkQuad) == 8);
+
+// Quads replace both the vertex and the index buffer, every quad is drawn as the indices 4q + {0, 1, 2, 2, 3, 0} of a
+// shared index buffer.
+struct ChunkMesh
+{
+    std::vector<ChunkQuad> Quads;
+    size_t FaceCount{0};
+
+    void Clear() noexcept;
+}; // struct ChunkMesh
+
+struct MeshingStatistics
+{
+    size_t SectionCount{0};
+    size_t FaceCount{0};
+    size_t QuadCount{0};
+    double TotalMilliseconds{0.0};
+
+    [[nodiscard]] double AverageMicroseconds() const noexcept;
+}; // struct MeshingStatistics
+
+// Turns a section into quads. Visible faces are found per axis with bit operations on 16 bit block columns (plus one bit of
+// neighbor padding on either side), then coplanar faces of the same block and ambient occlusion are greedily merged into
+// rectangles.
+// A mesher keeps its scratch buffers between calls, use one per thread.
+class ChunkMesher
+{
+  public:
+    // indexed by BlockFace, nullptr is treated as air
+    using Neighbors = std::array<const ChunkSection *, BLOCK_FACE_COUNT>;
+
+  public:
+    void Mesh(const ChunkSection &section, const Neighbors &neighbors, ChunkMesh &mesh);
+
+    [[nodiscard]] const MeshingStatistics &GetStatistics() const noexcept;
+
+    void ResetStatistics() noexcept;
+
+  private:
+    void BuildColumns(const ChunkSection &section, const Neighbors &neighbors);
+    void MeshAxis(BlockFace positive, BlockFace negative, const std::array<uint32_t, 256> &columns, ChunkMesh &mesh);
+    void MergePlane(BlockFace face, int slice, std::array<uint16_t, ChunkSection::SIZE> &rows, ChunkMesh &mesh);
+    void EmitQuad(BlockFace face, int slice, int u, int v, int width, int height, BlockId block, uint8_t occlusion, ChunkMesh &mesh);
+
+    [[nodiscard]] bool IsOpaqueAt(int x, int y, int z) const noexcept;
+    [[nodiscard]] uint8_t ComputeOcclusion(BlockFace face, int slice, int u, int v) const noexcept;
+
+  private:
+    std::array<BlockId, ChunkSection::VOLUME> m_blocks{};
+
+    // opaque bits along each axis, bit 0 and bit 17 hold the neighbor sections
+    std::array<uint32_t, 256> m_columnsX{}; // [y][z], bit x + 1
+    std::array<uint32_t, 256> m_columnsY{}; // [z][x], bit y + 1
+    std::array<uint32_t, 256> m_columnsZ{}; // [y][x], bit z + 1
+
+    std::array<std::array<uint16_t, ChunkSection::SIZE>, ChunkSection::SIZE> m_positivePlanes{};
+    std::array<std::array<uint16_t, ChunkSection::SIZE>, ChunkSection::SIZE> m_negativePlanes{};
+
+    // corner occlusion of the plane being merged, [v][u]
+    std::array<uint8_t, 256> m_occlusion{};
+
+    MeshingStatistics m_statistics{};
+}; // class ChunkMesher
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_WORLD_CHUNKMESHER_HPP_
@@ -0,0 +1,125 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_WORLD_CHUNKSECTION_HPP_
+#define MINECLONE_CLIENT_WORLD_CHUNKSECTION_HPP_
+
+#include "Block.hpp"
+
+#include <vector>
+
+namespace MineClone
+{
+
+// A 16x16x16 cube of blocks. Blocks are stored as bit packed indices into a per section palette, entries never straddle
+// two words so both reads and writes are a shift and a mask. The storage switches between three modes on its own:
+//  - SingleValue: the whole section is one block, nothing but the block id is stored
+//  - Palette: 1, 2, 4 or 8 bits per entry, growing as new blocks are added
+//  - Direct: more than 256 distinct blocks, 16 bit entries hold the block id itself
+class ChunkSection
+{
+  public:
+    static constexpr int SIZE = 16;
+    static constexpr size_t VOLUME = SIZE * SIZE * SIZE;
+
+    // the most Serialize ever writes: mode and bits, then a 16 bit id per block in direct storage
+    static constexpr size_t MAX_SERIALIZED_SIZE = 2 + VOLUME * sizeof(BlockId);
+
+    enum class StorageMode : uint8_t
+    {
+        SingleValue,
+        Palette,
+        Direct
+    }; // enum class StorageMode
+
+  public:
+    ChunkSection() = default;
+
+    explicit ChunkSection(BlockId fill) noexcept;
+
+    // y major so horizontal layers are contiguous
+    [[nodiscard]] static constexpr size_t Index(int x, int y, int z) noexcept
+    {
+        return (static_cast<size_t>(y) << 8) | (static_cast<size_t>(z) << 4) | static_cast<size_t>(x);
+    }
+
+    [[nodiscard]] inline BlockId Get(int x, int y, int z) const noexcept
+    {
+        return Get(Index(x, y, z));
+    }
+
+    [[nodiscard]] inline BlockId Get(size_t index) const noexcept
+    {
+        switch (m_mode)
+        {
+        case StorageMode::SingleValue:
+            return m_singleValue;
+        case StorageMode::Palette:
+            return m_palette[ReadEntry(index)];
+        default:
+            return static_cast<BlockId>(ReadEntry(index));
+        }
+    }
+
+    inline void Set(int x, int y, int z, BlockId block)
+    {
+        Set(Index(x, y, z), block);
+    }
+
+    void Set(size_t index, BlockId block);
+
+    void Fill(BlockId block) noexcept;
+
+    // replaces every block at once from VOLUME ids in Index order, much cheaper than Set for freshly generated sections
+    void Assign(const BlockId *blocks);
+
+    // rebuilds the palette from the blocks that are still in use and picks the smallest storage for them
+    void Compact();
+
+    // Appends the storage as it is: mode, palette and packed words, native byte order. Deserialize advances data past
+    // the section and returns false for malformed input, the section is left in an unspecified state then.
+    void Serialize(std::vector<uint8_t> &output) const;
+    bool Deserialize(const uint8_t *&data, const uint8_t *end);
+
+    [[nodiscard]] StorageMode GetStorageMode() const noexcept;
+    [[nodiscard]] unsigned GetBitsPerEntry() const noexcept;
+    [[nodiscard]] size_t GetPaletteSize() const noexcept;
+    [[nodiscard]] size_t GetNonAirCount() const noexcept;
+    [[nodiscard]] bool IsEmpty() const noexcept;
+
+    // blocks for which IsRandomlyTicked holds, sections without any are skipped by random ticks
+    [[nodiscard]] size_t GetTickableCount() const noexcept;
+    [[nodiscard]] size_t GetMemoryUsage() const noexcept;
+
+  private:
+    [[nodiscard]] inline uint32_t ReadEntry(size_t index) const noexcept
+    {
+        const unsigned entriesPerWordLog2 = 6 - m_bitsLog2;
+        const size_t word = index >> entriesPerWordLog2;
+        const unsigned shift = static_cast<unsigned>(index & ((size_t{1} << entriesPerWordLog2) - 1)) << m_bitsLog2;
+        const uint64_t mask = (uint64_t{1} << (1u << m_bitsLog2)) - 1;
+
+        return static_cast<uint32_t>((m_data[word] >> shift) & mask);
+    }
+
+    void WriteEntry(size_t index, uint32_t value) noexcept;
+
+    [[nodiscard]] uint32_t GetOrAddPaletteEntry(BlockId block);
+
+    void Repack(uint8_t bitsLog2);
+    void ConvertToDirect();
+    void StoreDirect(const BlockId *blocks);
+    void BuildPalette(const BlockId *blocks);
+
+  private:
+    StorageMode m_mode{StorageMode::SingleValue};
+    uint8_t m_bitsLog2{0};
+    BlockId m_singleValue{Blocks::AIR};
+    uint16_t m_nonAirCount{0};
+    uint16_t m_tickableCount{0};
+    std::vector<BlockId> m_palette{};
+    std::vector<uint16_t> m_paletteCounts{};
+    std::vector<uint64_t> m_data{};
+}; // class ChunkSection
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_WORLD_CHUNKSECTION_HPP_
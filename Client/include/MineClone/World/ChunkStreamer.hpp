@@ -0,0 +1,186 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_WORLD_CHUNKSTREAMER_HPP_
+#define MINECLONE_CLIENT_WORLD_CHUNKSTREAMER_HPP_
+
+#include "ChunkMesher.hpp"
+#include "SectionConnectivity.hpp"
+#include "TerrainGenerator.hpp"
+
+#include <MineClone/Jobs/JobSystem.hpp>
+#include <MineClone/Storage/RegionStorage.hpp>
+
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MineClone
+{
+
+struct StreamingOptions
+{
+    // chunks within this distance of the camera are meshed, one more ring is loaded for their neighbors
+    int Radius{12};
+
+    // chunks are only evicted this much further out, so moving back and forth across a border doesn't reload them
+    int Hysteresis{2};
+
+    // jobs in flight at once, 0 picks two per worker; a short queue keeps following the camera when it moves fast
+    size_t MaxJobs{0};
+
+    // chunks are loaded from and saved to region files here, everything is generated and nothing saved when empty
+    std::string WorldDirectory{};
+}; // struct StreamingOptions
+
+// a section meshed on a worker, waiting to be added to the chunk renderer
+struct StreamedSection
+{
+    int32_t X, Y, Z;
+    ChunkMesh Mesh;
+    SectionConnectivity Connectivity;
+}; // struct StreamedSection
+
+struct ChunkPosition
+{
+    int32_t X, Z;
+}; // struct ChunkPosition
+
+struct StreamingStatistics
+{
+    size_t Loaded{0};    // from the region files
+    size_t Generated{0};
+    size_t Meshed{0};
+    size_t Evicted{0};
+    size_t Discarded{0}; // results of jobs for chunks that were evicted while they ran
+}; // struct StreamingStatistics
+
+// Keeps the chunks around the camera loaded and meshed. Update runs on the render thread once per frame and never
+// waits: it takes finished results, evicts what moved out of range and hands the next jobs to the job system. Loading
+// (or generating when the region files don't have the chunk) and meshing run on workers.
+//
+// Only MaxJobs jobs are in flight at a time and the next ones are picked every frame by distance, with chunks behind
+// the camera counting as further away. Flying fast leaves holes at the edge of the view that fill in nearest first
+// instead of a backlog that stalls. A chunk is meshed once its four horizontal neighbors are loaded, so its meshes
+// never have to be rebuilt when the neighbors arrive. Evicted chunks cancel their jobs; generated ones are saved, and
+// reloaded from memory if they come back before the save is written.
+class ChunkStreamer
+{
+  public:
+    NON_COPYABLE(ChunkStreamer);
+    NON_MOVABLE(ChunkStreamer);
+
+    ChunkStreamer() = default;
+    ~ChunkStreamer();
+
+  public:
+    void Create(JobSystem *jobSystem, const StreamingOptions &options);
+
+    // cancels the jobs in flight, then saves the generated chunks and flushes them, blocks until that is done
+    void Destroy();
+
+    // Position in blocks and the horizontal view direction. Appends the sections meshed since the last call to meshed,
+    // and the chunks whose sections have to be removed from the renderer to evicted.
+    void Update(float x, float z, float directionX, float directionZ, std::vector<StreamedSection> &meshed, std::vector<ChunkPosition> &evicted);
+
+    // the loaded chunk at a position, nullptr while it is missing or still loading
+    [[nodiscard]] std::shared_ptr<const Chunk> GetChunk(int32_t x, int32_t z) const;
+
+    // whether every chunk within radius of the last Update's position has been meshed
+    [[nodiscard]] bool IsAreaMeshed(int radius) const;
+
+    void Dump(std::ostream &stream) const;
+
+    [[nodiscard]] const StreamingStatistics &GetStatistics() const noexcept;
+
+  private:
+    enum class ChunkState : uint8_t
+    {
+        Missing,
+        Loading,
+        Loaded,
+        Meshing,
+        Meshed
+    };
+
+    struct ChunkEntry
+    {
+        int32_t X, Z;
+        ChunkState State{ChunkState::Missing};
+        std::shared_ptr<const Chunk> Data{};
+        std::shared_ptr<JobGroup> Group{};
+        uint64_t Ticket{0}; // of the job in flight, results with another ticket are stale
+        bool Generated{false};
+    }; // struct ChunkEntry
+
+    // either a chunk or its sections
+    struct Completion
+    {
+        uint64_t Key;
+        uint64_t Ticket;
+        std::shared_ptr<const Chunk> Data;
+        bool Generated;
+        std::vector<StreamedSection> Sections;
+    }; // struct Completion
+
+    struct Candidate
+    {
+        float Priority; // lower first
+        ChunkEntry *Entry;
+    }; // struct Candidate
+
+    void ProcessCompletions(std::vector<StreamedSection> &meshed);
+    void Evict(std::vector<ChunkPosition> &evicted);
+    void Request();
+    void Schedule(float directionX, float directionZ);
+
+    void ScheduleLoad(ChunkEntry &entry);
+    void ScheduleMesh(ChunkEntry &entry);
+    void Complete(Completion completion);
+
+    [[nodiscard]] const ChunkEntry *Find(int32_t x, int32_t z) const;
+    [[nodiscard]] bool HasNeighbors(const ChunkEntry &entry) const;
+
+  private:
+    JobSystem *m_jobSystem{nullptr};
+    StreamingOptions m_options{};
+    const TerrainGenerator m_generator{};
+
+    RegionStorage m_storage{};
+    bool m_persistent{false};
+
+    // every chunk that is requested, in flight or resident
+    std::unordered_map<uint64_t, ChunkEntry> m_chunks{};
+    int32_t m_centerX{0}, m_centerZ{0};
+    bool m_hasCenter{false};
+
+    uint64_t m_nextTicket{1};
+    size_t m_jobsInFlight{0};
+    std::vector<Candidate> m_candidates{};
+
+    // written by the jobs, swapped out by Update
+    std::mutex m_completionMutex{};
+    std::vector<Completion> m_completions{};
+    std::vector<Completion> m_processing{};
+
+    // of evicted chunks, their running jobs still finish and reference the streamer
+    std::vector<std::shared_ptr<JobGroup>> m_cancelled{};
+
+    // generated chunks go to disk in the background as they are evicted
+    std::shared_ptr<JobGroup> m_saveGroup{};
+
+    // Evicted chunks until their save is written, the latest eviction of each position. Loads look here before the
+    // storage: a chunk that comes back into range before its save ran would be read stale or not at all.
+    std::mutex m_unsavedMutex{};
+    std::unordered_map<uint64_t, std::shared_ptr<const Chunk>> m_unsaved{};
+
+    // held by a save job from start to finish, two saves of one position could otherwise be written out of order
+    std::mutex m_saveMutex{};
+
+    StreamingStatistics m_statistics{};
+}; // class ChunkStreamer
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_WORLD_CHUNKSTREAMER_HPP_
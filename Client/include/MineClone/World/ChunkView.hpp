@@ -0,0 +1,41 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_WORLD_CHUNKVIEW_HPP_
+#define MINECLONE_CLIENT_WORLD_CHUNKVIEW_HPP_
+
+#include "Chunk.hpp"
+
+#include <memory>
+#include <unordered_map>
+
+namespace MineClone
+{
+
+// A fixed set of loaded chunks for threads that read blocks on their own schedule, like the simulation. The render
+// thread owns streaming: it copies the view, changes the copy and hands it over, a view is never changed once shared.
+// Holding a view keeps its chunks alive, even after the streamer has evicted them.
+class ChunkView
+{
+  public:
+    void Add(std::shared_ptr<const Chunk> chunk);
+    void Remove(int32_t x, int32_t z);
+
+    // nullptr when the chunk isn't in the view
+    [[nodiscard]] const Chunk *Find(int32_t x, int32_t z) const;
+
+    [[nodiscard]] size_t GetSize() const noexcept;
+
+    // calls function(chunk) for every chunk, in no particular order
+    template <typename F>
+    void ForEach(F &&function) const
+    {
+        for (const auto &[key, chunk] : m_chunks)
+            function(*chunk);
+    }
+
+  private:
+    std::unordered_map<uint64_t, std::shared_ptr<const Chunk>> m_chunks{};
+}; // class ChunkView
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_WORLD_CHUNKVIEW_HPP_
@@ -0,0 +1,112 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_WORLD_LIGHTENGINE_HPP_
+#define MINECLONE_CLIENT_WORLD_LIGHTENGINE_HPP_
+
+#include "Chunk.hpp"
+
+#include <array>
+#include <vector>
+
+namespace MineClone
+{
+
+enum class LightChannel : uint8_t
+{
+    Sky,
+    Block
+}; // enum class LightChannel
+
+// a block whose id has changed, relative to the center chunk of the neighborhood it is updated in
+struct LightChange
+{
+    int X, Y, Z;
+}; // struct LightChange
+
+struct LightStatistics
+{
+    size_t LitChunks{0};
+    size_t Changes{0};
+    size_t Added{0};   // blocks that got brighter
+    size_t Removed{0}; // blocks that went dark before being lit again
+}; // struct LightStatistics
+
+// Sky and block light from 0 to 15, propagated breadth first: every block that isn't opaque has the level of its
+// brightest neighbor minus one, or its own emission. Sky light also travels straight down at 15 without losing any.
+//
+// A chunk is lit as a whole once with LightChunk. After that, Update only walks the blocks whose level actually
+// changes: a removal pass darkens everything that was lit through the changed blocks and collects the brighter blocks
+// at its border, then an add pass spreads from those and from new emitters. One edit touches at most the blocks within
+// 15 of it, never a whole chunk, and a batch of edits like an explosion shares both passes.
+//
+// Light crosses chunk borders, so both work on the center of a 3x3 neighborhood and write into the neighbors as well;
+// missing neighbors are treated as opaque and unlit. The engine keeps its queues between calls, use one per thread and
+// never let two threads work on overlapping neighborhoods.
+class LightEngine
+{
+  public:
+    // [z + 1][x + 1] in chunks relative to the center, only the center is required
+    using Neighborhood = std::array<std::array<Chunk *, 3>, 3>;
+
+  public:
+    // Computes the light of the center from scratch: sky light down every column and from the emitters, plus the
+    // light that comes in across the borders from neighbors that are already lit.
+    void LightChunk(const Neighborhood &chunks);
+
+    // Call once the blocks are changed in the chunks. Positions are relative to the center and have to be in it.
+    void Update(const Neighborhood &chunks, const LightChange *changes, size_t count);
+
+    [[nodiscard]] const LightStatistics &GetStatistics() const noexcept;
+
+    void ResetStatistics() noexcept;
+
+  private:
+    // x and z from -16 to 31 offset by 16, y from 0 to 255 and the level packed in one word
+    struct Node
+    {
+        uint32_t Bits;
+
+        [[nodiscard]] static constexpr Node Pack(int x, int y, int z, uint8_t level) noexcept
+        {
+            return {static_cast<uint32_t>(x + 16) | static_cast<uint32_t>(z + 16) << 6 | static_cast<uint32_t>(y) << 12 |
+                    static_cast<uint32_t>(level) << 20};
+        }
+
+        [[nodiscard]] constexpr int GetX() const noexcept
+        {
+            return static_cast<int>(Bits & 63) - 16;
+        }
+
+        [[nodiscard]] constexpr int GetZ() const noexcept
+        {
+            return static_cast<int>(Bits >> 6 & 63) - 16;
+        }
+
+        [[nodiscard]] constexpr int GetY() const noexcept
+        {
+            return static_cast<int>(Bits >> 12 & 255);
+        }
+
+        [[nodiscard]] constexpr uint8_t GetLevel() const noexcept
+        {
+            return static_cast<uint8_t>(Bits >> 20 & 15);
+        }
+    }; // struct Node
+
+    void SeedSkyLight(const Neighborhood &chunks);
+    void SeedBlockLight(const Neighborhood &chunks);
+    void SeedBorders(const Neighborhood &chunks, LightChannel channel);
+    void SeedNeighbors(const Neighborhood &chunks, LightChannel channel, int x, int y, int z);
+
+    void PropagateRemoval(const Neighborhood &chunks, LightChannel channel);
+    void PropagateAddition(const Neighborhood &chunks, LightChannel channel);
+
+  private:
+    std::vector<Node> m_addQueue{};
+    std::vector<Node> m_removeQueue{};
+
+    LightStatistics m_statistics{};
+}; // class LightEngine
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_WORLD_LIGHTENGINE_HPP_
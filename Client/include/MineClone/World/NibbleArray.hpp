@@ -0,0 +1,52 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_WORLD_NIBBLEARRAY_HPP_
+#define MINECLONE_CLIENT_WORLD_NIBBLEARRAY_HPP_
+
+#include "ChunkSection.hpp"
+
+#include <vector>
+
+namespace MineClone
+{
+
+// A 4 bit value per block of a section, two to a byte in ChunkSection::Index order with the even index in the low
+// nibble. Like a single value section, an array that holds one value everywhere stores nothing but that value: most
+// sections are either fully lit by the sky or completely dark.
+class NibbleArray
+{
+  public:
+    static constexpr size_t BYTE_SIZE = ChunkSection::VOLUME / 2;
+
+  public:
+    NibbleArray() = default;
+
+    explicit NibbleArray(uint8_t fill) noexcept;
+
+    [[nodiscard]] inline uint8_t Get(size_t index) const noexcept
+    {
+        if (m_data.empty())
+            return m_fill;
+
+        return static_cast<uint8_t>(m_data[index >> 1] >> ((index & 1) << 2) & 15);
+    }
+
+    void Set(size_t index, uint8_t value);
+
+    void Fill(uint8_t value) noexcept;
+
+    // drops the storage again when every entry has the same value
+    void Compact();
+
+    // the value everywhere, only meaningful when IsUniform
+    [[nodiscard]] uint8_t GetFill() const noexcept;
+    [[nodiscard]] bool IsUniform() const noexcept;
+    [[nodiscard]] size_t GetMemoryUsage() const noexcept;
+
+  private:
+    uint8_t m_fill{0};
+    std::vector<uint8_t> m_data{};
+}; // class NibbleArray
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_WORLD_NIBBLEARRAY_HPP_
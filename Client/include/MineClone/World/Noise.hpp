@@ -0,0 +1,34 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_WORLD_NOISE_HPP_
+#define MINECLONE_CLIENT_WORLD_NOISE_HPP_
+
+#include <MineClone/Common.hpp>
+
+namespace MineClone
+{
+
+struct FractalSettings
+{
+    float Frequency{1.0f / 128.0f};
+    int Octaves{4};
+    float Lacunarity{2.0f};
+    float Gain{0.5f};
+}; // struct FractalSettings
+
+// Hashed gradient noise evaluated Simd::LANES points at a time. The batch functions take structure of arrays
+// coordinates and write one value per point, roughly in [-1, 1].
+namespace Noise
+{
+
+void Gradient2D(uint32_t seed, const float *x, const float *z, float *out, size_t count) noexcept;
+void Gradient3D(uint32_t seed, const float *x, const float *y, const float *z, float *out, size_t count) noexcept;
+
+// sums octaves of gradient noise, every octave uses its own seed so they do not line up at the origin
+void Fractal2D(uint32_t seed, const FractalSettings &settings, const float *x, const float *z, float *out, size_t count) noexcept;
+void Fractal3D(uint32_t seed, const FractalSettings &settings, const float *x, const float *y, const float *z, float *out, size_t count) noexcept;
+
+} // namespace Noise
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_WORLD_NOISE_HPP_
@@ -0,0 +1,38 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_WORLD_SECTIONCONNECTIVITY_HPP_
+#define MINECLONE_CLIENT_WORLD_SECTIONCONNECTIVITY_HPP_
+
+#include "ChunkSection.hpp"
+
+namespace MineClone
+{
+
+// Which pairs of section faces are connected through non opaque blocks, one bit for each of the 15 pairs. Used to
+// walk the visibility graph: a view entering through one face can only leave through faces connected to it.
+class SectionConnectivity
+{
+  public:
+    static constexpr uint16_t NONE = 0;
+    static constexpr uint16_t ALL = 0x7FFF;
+
+  public:
+    constexpr SectionConnectivity() noexcept = default;
+
+    constexpr explicit SectionConnectivity(uint16_t bits) noexcept : m_bits{bits}
+    {
+    }
+
+    // flood fills the air of the section from its boundary
+    [[nodiscard]] static SectionConnectivity Compute(const ChunkSection &section);
+
+    [[nodiscard]] bool Connects(BlockFace a, BlockFace b) const noexcept;
+
+    [[nodiscard]] uint16_t GetBits() const noexcept;
+
+  private:
+    uint16_t m_bits{ALL};
+}; // class SectionConnectivity
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_WORLD_SECTIONCONNECTIVITY_HPP_
@@ -0,0 +1,48 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_WORLD_TERRAINGENERATOR_HPP_
+#define MINECLONE_CLIENT_WORLD_TERRAINGENERATOR_HPP_
+
+#include "Chunk.hpp"
+#include "Noise.hpp"
+
+namespace MineClone
+{
+
+struct TerrainSettings
+{
+    uint32_t Seed{1337};
+    int SeaLevel{62};
+
+    // fractal 2D noise gives the rough surface height of every column
+    float BaseHeight{68.0f};
+    float HeightAmplitude{36.0f};
+    FractalSettings Height{1.0f / 384.0f, 5};
+
+    // 3D density pushes the surface around to form overhangs and cliffs
+    float OverhangAmplitude{14.0f};
+    FractalSettings Overhang{1.0f / 64.0f, 3};
+
+    // tunnels run where two noise fields are both close to zero
+    float CaveThreshold{0.09f};
+    FractalSettings Cave{1.0f / 56.0f, 2};
+}; // struct TerrainSettings
+
+// Fills whole chunks from seeded noise. The noise is only sampled on a coarse lattice in SIMD batches and
+// interpolated per block, Generate is const and can run on any number of worker threads at once.
+class TerrainGenerator
+{
+  public:
+    explicit TerrainGenerator(TerrainSettings settings = {});
+
+  public:
+    void Generate(Chunk &chunk) const;
+
+    [[nodiscard]] const TerrainSettings &GetSettings() const noexcept;
+
+  private:
+    TerrainSettings m_settings;
+}; // class TerrainGenerator
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_WORLD_TERRAINGENERATOR_HPP_
@@ -0,0 +1,109 @@
+#pragma once
+#ifndef MINECLONE_CLIENT_WORLD_TIMINGWHEEL_HPP_
+#define MINECLONE_CLIENT_WORLD_TIMINGWHEEL_HPP_
+
+#include "../Common.hpp"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace MineClone
+{
+
+// Hierarchical timing wheel: LEVELS wheels of SLOTS buckets, each wheel a tick resolution SLOTS times coarser than the
+// one below. An entry goes into the bucket of the highest digit in which its due tick differs from the current one,
+// which is constant time. When the lower digits of the current tick roll over to zero, the bucket of the next digit is
+// poured into the finer wheels, so every entry moves down at most LEVELS - 1 times before it expires in level 0.
+//
+// Delays past the range of the wheel are clamped to its end, 2^24 ticks is about 9 days at 20 ticks per second.
+template <typename T>
+class TimingWheel
+{
+  public:
+    static constexpr unsigned SLOT_BITS = 6;
+    static constexpr size_t SLOTS = size_t{1} << SLOT_BITS;
+    static constexpr unsigned LEVELS = 4;
+    static constexpr uint64_t MAX_DELAY = (uint64_t{1} << (SLOT_BITS * LEVELS)) - 1;
+
+  public:
+    // delays of 0 are due next tick, nothing can expire in the tick that is being processed
+    void Schedule(uint64_t delay, T value)
+    {
+        Insert(m_tick + std::clamp<uint64_t>(delay, 1, MAX_DELAY), std::move(value));
+        m_size++;
+    }
+
+    // moves to the next tick and appends what is due then to expired
+    void Advance(std::vector<T> &expired)
+    {
+        m_tick++;
+
+        for (unsigned level = LEVELS - 1; level > 0; level--)
+        {
+            // a lower digit that isn't zero means this wheel's bucket was already poured
+            if ((m_tick & ((uint64_t{1} << (SLOT_BITS * level)) - 1)) != 0)
+                continue;
+
+            std::vector<Entry> &bucket = m_wheels[level][Digit(m_tick, level)];
+            m_cascade.swap(bucket);
+
+            for (Entry &entry : m_cascade)
+                Insert(entry.Due, std::move(entry.Value));
+
+            m_cascade.clear();
+        }
+
+        std::vector<Entry> &bucket = m_wheels[0][Digit(m_tick, 0)];
+
+        for (Entry &entry : bucket)
+            expired.push_back(std::move(entry.Value));
+
+        m_size -= bucket.size();
+        bucket.clear();
+    }
+
+    [[nodiscard]] uint64_t GetTick() const noexcept
+    {
+        return m_tick;
+    }
+
+    [[nodiscard]] size_t GetSize() const noexcept
+    {
+        return m_size;
+    }
+
+  private:
+    struct Entry
+    {
+        uint64_t Due;
+        T Value;
+    }; // struct Entry
+
+    [[nodiscard]] static constexpr size_t Digit(uint64_t tick, unsigned level) noexcept
+    {
+        return static_cast<size_t>(tick >> (SLOT_BITS * level) & (SLOTS - 1));
+    }
+
+    void Insert(uint64_t due, T value)
+    {
+        const uint64_t differing = due ^ m_tick;
+
+        unsigned level = 0;
+        while (level + 1 < LEVELS && (differing >> (SLOT_BITS * (level + 1))) != 0)
+            level++;
+
+        m_wheels[level][Digit(due, level)].push_back({due, std::move(value)});
+    }
+
+  private:
+    std::array<std::array<std::vector<Entry>, SLOTS>, LEVELS> m_wheels{};
+    std::vector<Entry> m_cascade{};
+    uint64_t m_tick{0};
+    size_t m_size{0};
+}; // class TimingWheel
+
+} // namespace MineClone
+
+#endif // MINECLONE_CLIENT_WORLD_TIMINGWHEEL_HPP_
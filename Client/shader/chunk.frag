@@ -0,0 +1,18 @@
+#version 450
+
+layout(set = 0, binding = 2) uniform sampler2DArray blockTextures;
+
+layout(location = 0) in vec2 fragUV;
+layout(location = 1) flat in uint fragTexture;
+layout(location = 2) in float fragShade;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    // UVs repeat once per block across merged quads, layers past the end of the array are the unknown texture at 0
+    uint layer = fragTexture < uint(textureSize(blockTextures, 0).z) ? fragTexture : 0u;
+    vec3 color = texture(blockTextures, vec3(fragUV, float(layer))).rgb;
+
+    outColor = vec4(color * fragShade, 1.0);
+}
@@ -0,0 +1,67 @@
+#version 450
+
+// Vertex pulling, there are no vertex attributes. Every quad is two words in the storage buffer (see ChunkQuad in
+// ChunkMesher.hpp) and is drawn as indices 4q + {0, 1, 2, 2, 3, 0}, so gl_VertexIndex holds both quad and corner.
+// Each indirect draw is one section, its firstInstance indexes the section origins.
+struct Quad
+{
+    uint Position;
+    uint Material;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Quads
+{
+    Quad quads[];
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer Sections
+{
+    ivec4 sectionOrigins[];
+};
+
+layout(push_constant) uniform PushConstants
+{
+    mat4 viewProjection;
+} constants;
+
+layout(location = 0) out vec2 fragUV;
+layout(location = 1) flat out uint fragTexture;
+layout(location = 2) out float fragShade;
+
+// u and v axes of the face plane per axis, corners go u -> v
+const ivec3 U_AXES[3] = ivec3[](ivec3(0, 0, 1), ivec3(1, 0, 0), ivec3(1, 0, 0));
+const ivec3 V_AXES[3] = ivec3[](ivec3(0, 1, 0), ivec3(0, 0, 1), ivec3(0, 1, 0));
+
+// +X, -X, +Y, -Y, +Z, -Z
+const float FACE_SHADE[6] = float[](0.8, 0.8, 1.0, 0.5, 0.9, 0.9);
+const float OCCLUSION_SHADE[4] = float[](0.4, 0.6, 0.8, 1.0);
+
+void main()
+{
+    Quad quad = quads[gl_VertexIndex >> 2];
+
+    uint face = (quad.Position >> 15) & 7u;
+    uint axis = face >> 1;
+    int width = int((quad.Position >> 18) & 15u) + 1;
+    int height = int((quad.Position >> 22) & 15u) + 1;
+    uvec4 light = (uvec4(quad.Material >> 16) >> uvec4(0u, 2u, 4u, 6u)) & 3u;
+
+    // split along the brighter diagonal so a single dark corner doesn't bleed into the whole quad
+    uint corner = (uint(gl_VertexIndex) + (light.x + light.z < light.y + light.w ? 1u : 0u)) & 3u;
+
+    // u x v points against the normal of +X, +Y and -Z, their corners go the other way around
+    if (face == 0u || face == 2u || face == 5u)
+        corner = (4u - corner) & 3u;
+
+    int du = (corner == 1u || corner == 2u) ? width : 0;
+    int dv = corner >= 2u ? height : 0;
+
+    ivec3 base = ivec3(quad.Position & 31u, (quad.Position >> 5) & 31u, (quad.Position >> 10) & 31u);
+    ivec3 position = sectionOrigins[gl_InstanceIndex].xyz + base + U_AXES[axis] * du + V_AXES[axis] * dv;
+
+    gl_Position = constants.viewProjection * vec4(vec3(position), 1.0);
+
+    fragUV = vec2(du, dv);
+    fragTexture = quad.Material & 0xFFFFu;
+    fragShade = FACE_SHADE[face] * OCCLUSION_SHADE[light[corner]];
+}
@@ -0,0 +1,1092 @@
+#include <MineClone/Benchmarks.hpp>
+
+#include <MineClone/GFX/BlockTextures.hpp>
+#include <MineClone/GFX/SectionVisibility.hpp>
+#include <MineClone/Game/EntitySystems.hpp>
+#include <MineClone/Jobs/JobSystem.hpp>
+#include <MineClone/Physics/Collision.hpp>
+#include <MineClone/Physics/Raycast.hpp>
+#include <MineClone/Simd.hpp>
+#include <MineClone/Storage/RegionStorage.hpp>
+#include <MineClone/World/BlockTicker.hpp>
+#include <MineClone/World/ChunkView.hpp>
+#include <MineClone/World/LightEngine.hpp>
+#include <MineClone/World/Noise.hpp>
+#include <MineClone/World/SectionConnectivity.hpp>
+#include <MineClone/World/TerrainGenerator.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MineClone
+{
+
+namespace
+{
+
+using Clock = std::chrono::steady_clock;
+
+double SecondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// FNV-1a over raw bytes, for comparing outputs bit for bit
+uint64_t HashBytes(uint64_t hash, const void *data, size_t size)
+{
+    const auto *bytes = static_cast<const uint8_t *>(data);
+
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+// Hashes fractal noise over a fixed grid and the blocks of the chunks around the origin. Every SIMD backend has to
+// produce the same values, otherwise a seed gives different worlds depending on the build. The references are from
+// the scalar build, update them together with any intended change to the noise or the generator.
+void CheckTerrainReference(const TerrainGenerator &generator, std::ostream &output)
+{
+    constexpr uint64_t FNV_OFFSET = 1469598103934665603ull;
+    constexpr uint64_t NOISE_REFERENCE = 0x211e6d8e73edf28dull;
+    constexpr uint64_t TERRAIN_REFERENCE = 0x4f8cd5cb57cdb3d1ull;
+    constexpr size_t POINTS = 65536;
+
+    std::vector<float> x(POINTS), y(POINTS), z(POINTS), values(POINTS);
+
+    for (size_t i = 0; i < POINTS; i++)
+    {
+        x[i] = static_cast<float>(i % 64) * 1.37f - 40.0f;
+        y[i] = static_cast<float>(i / 64 % 32) * 2.11f;
+        z[i] = static_cast<float>(i / 2048) * 3.3f + 0.5f;
+    }
+
+    FractalSettings settings{};
+    settings.Octaves = 5;
+    Noise::Fractal3D(1234, settings, x.data(), y.data(), z.data(), values.data(), POINTS);
+
+    const uint64_t noise = HashBytes(FNV_OFFSET, values.data(), values.size() * sizeof(float));
+    uint64_t terrain = FNV_OFFSET;
+
+    for (int chunkX = -2; chunkX < 2; chunkX++)
+    {
+        for (int chunkZ = -2; chunkZ < 2; chunkZ++)
+        {
+            Chunk chunk{chunkX, chunkZ};
+            generator.Generate(chunk);
+
+            for (int blockY = 0; blockY < Chunk::HEIGHT; blockY++)
+            {
+                for (int blockZ = 0; blockZ < ChunkSection::SIZE; blockZ++)
+                {
+                    for (int blockX = 0; blockX < ChunkSection::SIZE; blockX++)
+                    {
+                        const BlockId block = chunk.GetBlock(blockX, blockY, blockZ);
+                        terrain = HashBytes(terrain, &block, sizeof(block));
+                    }
+                }
+            }
+        }
+    }
+
+    const auto verdict = [](uint64_t hash, uint64_t reference) {
+        return hash == reference ? "matches the scalar reference" : "DIFFERS from the scalar reference";
+    };
+
+    output << "  noise " << verdict(noise, NOISE_REFERENCE) << ", terrain " << verdict(terrain, TERRAIN_REFERENCE) << std::endl;
+}
+
+void BenchmarkTerrain(std::ostream &output)
+{
+    constexpr int RADIUS = 12;
+    constexpr int CHUNK_COUNT = (2 * RADIUS) * (2 * RADIUS);
+
+    const TerrainGenerator generator{};
+
+    // single thread first, this is the per core number
+    Clock::time_point start = Clock::now();
+
+    for (int x = -RADIUS; x < RADIUS; x++)
+    {
+        for (int z = -RADIUS; z < RADIUS; z++)
+        {
+            Chunk chunk{x, z};
+            generator.Generate(chunk);
+        }
+    }
+
+    const double singleSeconds = SecondsSince(start);
+
+    // then every core through the job system, the calling thread helps while it waits
+    JobSystem jobSystem;
+    jobSystem.Create();
+
+    start = Clock::now();
+
+    for (int x = -RADIUS; x < RADIUS; x++)
+    {
+        for (int z = -RADIUS; z < RADIUS; z++)
+        {
+            jobSystem.Schedule([&generator, x, z] {
+                Chunk chunk{x, z};
+                generator.Generate(chunk);
+            });
+        }
+    }
+
+    jobSystem.WaitIdle();
+
+    const double parallelSeconds = SecondsSince(start);
+    const size_t threads = jobSystem.GetWorkerCount() + 1;
+
+    jobSystem.Destroy();
+
+    output << "terrain (" << Simd::NAME << "): " << CHUNK_COUNT << " chunks" << std::endl;
+    output << "  1 thread: " << CHUNK_COUNT / singleSeconds << " chunks/s, " << singleSeconds * 1000.0 / CHUNK_COUNT << " ms/chunk" << std::endl;
+    output << "  " << threads << " threads: " << CHUNK_COUNT / parallelSeconds << " chunks/s, " << CHUNK_COUNT / parallelSeconds / threads
+           << " chunks/s per core" << std::endl;
+
+    CheckTerrainReference(generator, output);
+}
+
+void BenchmarkTicks(std::ostream &output)
+{
+    constexpr int SOURCE_COUNT = 64;
+    constexpr int AREA = 64;
+    constexpr int TICKS = 200;
+    constexpr size_t SCHEDULED = 1000000;
+    constexpr uint64_t MAX_DELAY = 1200; // a minute at 20 Hz
+
+    const TerrainGenerator generator{};
+    std::vector<std::unique_ptr<Chunk>> sources(SOURCE_COUNT);
+
+    JobSystem jobSystem;
+    jobSystem.Create();
+
+    for (int i = 0; i < SOURCE_COUNT; i++)
+    {
+        jobSystem.Schedule([&generator, &sources, i] {
+            sources[i] = std::make_unique<Chunk>(i % 8, i / 8);
+            generator.Generate(*sources[i]);
+        });
+    }
+
+    jobSystem.WaitIdle();
+    jobSystem.Destroy();
+
+    // far more loaded chunks than any view distance, copies of the generated ones
+    BlockTicker ticker;
+    ChunkView chunks;
+
+    for (int i = 0; i < AREA * AREA; i++)
+    {
+        auto chunk = std::make_shared<Chunk>(i % AREA - AREA / 2, i / AREA - AREA / 2);
+
+        for (int y = 0; y < Chunk::SECTION_COUNT; y++)
+            chunk->GetSection(y) = sources[static_cast<size_t>(i * 7919) % sources.size()]->GetSection(y);
+
+        chunks.Add(std::move(chunk));
+    }
+
+    std::vector<BlockTick> scheduled, random;
+
+    Clock::time_point start = Clock::now();
+
+    for (int tick = 0; tick < TICKS; tick++)
+    {
+        random.clear();
+        ticker.Tick(chunks, scheduled, random);
+    }
+
+    const double randomSeconds = SecondsSince(start) / TICKS;
+    const TickStatistics &statistics = ticker.GetStatistics();
+    const auto sectionCount = static_cast<double>(statistics.SectionsSampled + statistics.SectionsSkipped) / TICKS;
+
+    // what the section counters save: looking at every block of every section once per tick
+    start = Clock::now();
+    size_t tickable = 0;
+
+    for (int i = 0; i < SOURCE_COUNT; i++)
+    {
+        for (int y = 0; y < Chunk::SECTION_COUNT; y++)
+        {
+            const ChunkSection &section = sources[i]->GetSection(y);
+
+            for (size_t index = 0; index < ChunkSection::VOLUME; index++)
+                tickable += IsRandomlyTicked(section.Get(index));
+        }
+    }
+
+    const double naiveSeconds = SecondsSince(start) * (AREA * AREA) / SOURCE_COUNT;
+
+    // scheduled updates at the surface of one chunk, every one of them still valid when it expires
+    std::mt19937 randomEngine{1234};
+    std::vector<BlockTick> grass;
+
+    for (int x = 0; x < ChunkSection::SIZE; x++)
+    {
+        for (int z = 0; z < ChunkSection::SIZE; z++)
+        {
+            for (int y = Chunk::HEIGHT - 1; y >= 0; y--)
+            {
+                if (sources[0]->GetBlock(x, y, z) == Blocks::AIR)
+                    continue;
+
+                grass.push_back({x, y, z, sources[0]->GetBlock(x, y, z)});
+                break;
+            }
+        }
+    }
+
+    // on their own, the random ticks of thousands of chunks would dwarf the wheel
+    BlockTicker wheel;
+    ChunkView wheelChunks;
+    wheelChunks.Add(std::make_shared<Chunk>(*sources[0]));
+
+    start = Clock::now();
+
+    for (size_t i = 0; i < SCHEDULED; i++)
+    {
+        const BlockTick &tick = grass[i % grass.size()];
+        wheel.Schedule(tick.X, tick.Y, tick.Z, tick.Block, 1 + randomEngine() % MAX_DELAY);
+    }
+
+    const double scheduleSeconds = SecondsSince(start);
+
+    size_t delivered = 0;
+    start = Clock::now();
+
+    while (wheel.GetPendingCount() != 0)
+    {
+        scheduled.clear();
+        random.clear();
+        wheel.Tick(wheelChunks, scheduled, random);
+        delivered += scheduled.size();
+    }
+
+    const double expireSeconds = SecondsSince(start);
+
+    output << "ticks: " << AREA * AREA << " chunks, " << sectionCount << " sections" << std::endl;
+    output << "  random: " << randomSeconds * 1000.0 << " ms/tick, " << static_cast<double>(statistics.RandomTicks) / TICKS << " ticks, "
+           << 100.0 * static_cast<double>(statistics.SectionsSkipped) / TICKS / sectionCount << "% of sections skipped" << std::endl;
+    output << "  every block: " << naiveSeconds * 1000.0 << " ms/tick for " << tickable * (AREA * AREA) / SOURCE_COUNT << " tickable blocks"
+           << std::endl;
+    output << "  scheduled: " << SCHEDULED / scheduleSeconds << " inserts/s, " << static_cast<double>(delivered) / expireSeconds
+           << " expired/s over " << MAX_DELAY << " ticks, " << wheel.GetStatistics().Dropped << " dropped" << std::endl;
+}
+
+void BenchmarkVisibility(std::ostream &output)
+{
+    constexpr int RADIUS = 16;
+    constexpr int SIZE = 2 * RADIUS + 1;
+    constexpr int UPDATES = 200;
+
+    const TerrainGenerator generator{};
+    std::vector<std::unique_ptr<Chunk>> chunks(SIZE * SIZE);
+    std::vector<std::array<SectionConnectivity, Chunk::SECTION_COUNT>> connectivity(SIZE * SIZE);
+
+    JobSystem jobSystem;
+    jobSystem.Create();
+
+    for (int i = 0; i < SIZE * SIZE; i++)
+    {
+        jobSystem.Schedule([&generator, &chunks, &connectivity, i] {
+            chunks[i] = std::make_unique<Chunk>(i % SIZE - RADIUS, i / SIZE - RADIUS);
+            generator.Generate(*chunks[i]);
+
+            for (int y = 0; y < Chunk::SECTION_COUNT; y++)
+                connectivity[i][y] = SectionConnectivity::Compute(chunks[i]->GetSection(y));
+        });
+    }
+
+    jobSystem.WaitIdle();
+    jobSystem.Destroy();
+
+    SectionVisibility visibility;
+
+    for (int i = 0; i < SIZE * SIZE; i++)
+    {
+        for (int y = 0; y < Chunk::SECTION_COUNT; y++)
+            visibility.Add(chunks[i]->GetX(), y, chunks[i]->GetZ(), connectivity[i][y]);
+    }
+
+    struct View
+    {
+        const char *Name;
+        float Y, Pitch;
+    }; // struct View
+
+    constexpr View VIEWS[] = {{"surface", 110.0f, -0.4f}, {"underground", 12.0f, 0.0f}};
+
+    output << "visibility (" << Simd::NAME << "): " << visibility.GetSectionCount() << " sections" << std::endl;
+
+    std::vector<uint32_t> visible;
+
+    for (const View &view : VIEWS)
+    {
+        for (const bool occlusion : {false, true})
+        {
+            Camera camera;
+            camera.SetPosition(8.0f, view.Y, 8.0f);
+            camera.SetAspect(16.0f / 9.0f);
+            visibility.SetOcclusionCulling(occlusion);
+
+            size_t drawn = 0;
+            const Clock::time_point start = Clock::now();
+
+            // turn a full circle so every direction is sampled
+            for (int update = 0; update < UPDATES; update++)
+            {
+                camera.SetRotation(static_cast<float>(update) * 6.2831853f / UPDATES, view.Pitch);
+                visibility.Update(camera, visible);
+                drawn += visible.size();
+            }
+
+            const double seconds = SecondsSince(start);
+            const double average = static_cast<double>(drawn) / UPDATES;
+            const double percent = 100.0 * average / static_cast<double>(visibility.GetSectionCount());
+
+            output << "  " << view.Name << (occlusion ? " frustum + caves: " : " frustum only:    ") << average << " sections drawn on average ("
+                   << percent << "%), " << seconds * 1e6 / UPDATES << " us/update" << std::endl;
+        }
+    }
+}
+
+void BenchmarkLighting(std::ostream &output)
+{
+    constexpr int EDITS = 2000;
+    constexpr int RELIGHTS = 50;
+    constexpr int EXPLOSIONS = 50;
+    constexpr int EXPLOSION_RADIUS = 5;
+    constexpr int PARALLEL_CHUNKS = 256;
+
+    const TerrainGenerator generator{};
+
+    // a 3x3 neighborhood, lit from the corners inwards like chunks arriving one by one
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    LightEngine::Neighborhood neighborhood{};
+
+    for (int z = -1; z <= 1; z++)
+    {
+        for (int x = -1; x <= 1; x++)
+        {
+            chunks.push_back(std::make_unique<Chunk>(x, z));
+            generator.Generate(*chunks.back());
+            neighborhood[z + 1][x + 1] = chunks.back().get();
+        }
+    }
+
+    LightEngine engine;
+
+    for (int z = -1; z <= 1; z++)
+    {
+        for (int x = -1; x <= 1; x++)
+        {
+            LightEngine::Neighborhood around{};
+            for (int dz = -1; dz <= 1; dz++)
+            {
+                for (int dx = -1; dx <= 1; dx++)
+                {
+                    if (std::abs(x + dx) <= 1 && std::abs(z + dz) <= 1)
+                        around[dz + 1][dx + 1] = neighborhood[z + dz + 1][x + dx + 1];
+                }
+            }
+
+            engine.LightChunk(around);
+        }
+    }
+
+    Chunk &center = *neighborhood[1][1];
+
+    // the top block of a column, the edits happen at the surface where they are the most expensive
+    const auto surface = [](const Chunk &chunk, int x, int z) {
+        int y = Chunk::HEIGHT - 1;
+        while (y > 1 && !IsOpaque(chunk.GetBlock(x, y, z)))
+            y--;
+
+        return y;
+    };
+
+    const auto edit = [&surface](Chunk &chunk, std::mt19937 &random, LightChange &change) {
+        const int x = static_cast<int>(random() % ChunkSection::SIZE), z = static_cast<int>(random() % ChunkSection::SIZE);
+        const int y = surface(chunk, x, z);
+
+        // dig the top block or put a lamp on it, the world stays the same on average
+        change = random() % 2 == 0 || y + 1 >= Chunk::HEIGHT ? LightChange{x, y, z} : LightChange{x, y + 1, z};
+        chunk.SetBlock(change.X, change.Y, change.Z, change.Y == y ? Blocks::AIR : Blocks::LAMP);
+    };
+
+    Clock::time_point start = Clock::now();
+
+    for (int i = 0; i < RELIGHTS; i++)
+        engine.LightChunk(neighborhood);
+
+    const double relightSeconds = SecondsSince(start) / RELIGHTS;
+
+    std::mt19937 random{1234};
+    engine.ResetStatistics();
+    start = Clock::now();
+
+    for (int i = 0; i < EDITS; i++)
+    {
+        LightChange change{};
+        edit(center, random, change);
+        engine.Update(neighborhood, &change, 1);
+    }
+
+    const double editSeconds = SecondsSince(start);
+    const LightStatistics editStatistics = engine.GetStatistics();
+
+    // craters: every block in a sphere at the surface in one batch
+    std::vector<LightChange> crater;
+    engine.ResetStatistics();
+    double explosionSeconds = 0.0;
+
+    for (int i = 0; i < EXPLOSIONS; i++)
+    {
+        const int cx = 4 + static_cast<int>(random() % 8), cz = 4 + static_cast<int>(random() % 8);
+        const int cy = surface(center, cx, cz);
+
+        crater.clear();
+        for (int y = cy - EXPLOSION_RADIUS; y <= cy + EXPLOSION_RADIUS; y++)
+        {
+            for (int z = std::max(cz - EXPLOSION_RADIUS, 0); z <= std::min(cz + EXPLOSION_RADIUS, ChunkSection::SIZE - 1); z++)
+            {
+                for (int x = std::max(cx - EXPLOSION_RADIUS, 0); x <= std::min(cx + EXPLOSION_RADIUS, ChunkSection::SIZE - 1); x++)
+                {
+                    const int dx = x - cx, dy = y - cy, dz = z - cz;
+                    if (dx * dx + dy * dy + dz * dz > EXPLOSION_RADIUS * EXPLOSION_RADIUS || !IsOpaque(center.GetBlock(x, y, z)))
+                        continue;
+
+                    center.SetBlock(x, y, z, Blocks::AIR);
+                    crater.push_back({x, y, z});
+                }
+            }
+        }
+
+        start = Clock::now();
+        engine.Update(neighborhood, crater.data(), crater.size());
+        explosionSeconds += SecondsSince(start);
+    }
+
+    const LightStatistics explosionStatistics = engine.GetStatistics();
+
+    // the same edits on a chunk without neighbors, then compared against lighting the result from scratch
+    Chunk isolated{0, 0};
+    generator.Generate(isolated);
+
+    LightEngine::Neighborhood alone{};
+    alone[1][1] = &isolated;
+    engine.LightChunk(alone);
+
+    for (int i = 0; i < EDITS; i++)
+    {
+        LightChange change{};
+        edit(isolated, random, change);
+        engine.Update(alone, &change, 1);
+    }
+
+    Chunk reference = isolated;
+    alone[1][1] = &reference;
+    engine.LightChunk(alone);
+
+    size_t mismatches = 0;
+    for (int y = 0; y < Chunk::HEIGHT; y++)
+    {
+        for (int z = 0; z < ChunkSection::SIZE; z++)
+        {
+            for (int x = 0; x < ChunkSection::SIZE; x++)
+            {
+                mismatches += isolated.GetSkyLight(x, y, z) != reference.GetSkyLight(x, y, z);
+                mismatches += isolated.GetBlockLight(x, y, z) != reference.GetBlockLight(x, y, z);
+            }
+        }
+    }
+
+    // independent chunks on every core, each job with its own engine
+    std::vector<std::unique_ptr<Chunk>> parallelChunks(PARALLEL_CHUNKS);
+    for (int i = 0; i < PARALLEL_CHUNKS; i++)
+    {
+        parallelChunks[i] = std::make_unique<Chunk>(i % 16, i / 16);
+        generator.Generate(*parallelChunks[i]);
+    }
+
+    JobSystem jobSystem;
+    jobSystem.Create();
+
+    start = Clock::now();
+
+    for (int i = 0; i < PARALLEL_CHUNKS; i++)
+    {
+        jobSystem.Schedule([&parallelChunks, &edit, i] {
+            LightEngine jobEngine;
+            LightEngine::Neighborhood single{};
+            single[1][1] = parallelChunks[i].get();
+
+            jobEngine.LightChunk(single);
+
+            std::mt19937 jobRandom{static_cast<uint32_t>(i)};
+            for (int e = 0; e < EDITS / 10; e++)
+            {
+                LightChange change{};
+                edit(*parallelChunks[i], jobRandom, change);
+                jobEngine.Update(single, &change, 1);
+            }
+        });
+    }
+
+    jobSystem.WaitIdle();
+
+    const double parallelSeconds = SecondsSince(start);
+    const size_t threads = jobSystem.GetWorkerCount() + 1;
+
+    jobSystem.Destroy();
+
+    output << "lighting: 3x3 chunks" << std::endl;
+    output << "  full relight: " << relightSeconds * 1000.0 << " ms/chunk" << std::endl;
+    output << "  single edits: " << EDITS / editSeconds << " updates/s, " << editSeconds * 1e6 / EDITS << " us/update, "
+           << static_cast<double>(editStatistics.Added + editStatistics.Removed) / EDITS << " blocks relit/update" << std::endl;
+    output << "  explosions:   " << static_cast<double>(explosionStatistics.Changes) / EXPLOSIONS << " blocks each, "
+           << explosionSeconds * 1000.0 / EXPLOSIONS << " ms/explosion, " << explosionStatistics.Changes / explosionSeconds << " updates/s"
+           << std::endl;
+    output << "  " << threads << " threads: " << PARALLEL_CHUNKS / parallelSeconds << " chunks/s lit with " << EDITS / 10
+           << " edits each, " << PARALLEL_CHUNKS * (EDITS / 10) / parallelSeconds << " updates/s" << std::endl;
+    output << "  incremental against relit from scratch: " << (mismatches == 0 ? "identical" : std::to_string(mismatches) + " LEVELS DIFFER")
+           << std::endl;
+}
+
+void BenchmarkRegion(std::ostream &output)
+{
+    constexpr int SOURCE_RADIUS = 4;
+    constexpr int SOURCE_SIZE = 2 * SOURCE_RADIUS;
+    constexpr int AREA = 64; // 2x2 regions
+    constexpr int CHUNK_COUNT = AREA * AREA;
+
+    const TerrainGenerator generator{};
+    std::vector<std::unique_ptr<Chunk>> sources(SOURCE_SIZE * SOURCE_SIZE);
+
+    JobSystem jobSystem;
+    jobSystem.Create();
+
+    for (int i = 0; i < SOURCE_SIZE * SOURCE_SIZE; i++)
+    {
+        jobSystem.Schedule([&generator, &sources, i] {
+            sources[i] = std::make_unique<Chunk>(i % SOURCE_SIZE - SOURCE_RADIUS, i / SOURCE_SIZE - SOURCE_RADIUS);
+            generator.Generate(*sources[i]);
+        });
+    }
+
+    jobSystem.WaitIdle();
+    jobSystem.Destroy();
+
+    // every position gets one of the generated chunks, so the numbers reflect real terrain
+    const auto sourceOf = [&sources](int index) -> const Chunk & {
+        return *sources[static_cast<size_t>(index * 7919) % sources.size()];
+    };
+
+    const auto makeChunk = [&sourceOf](int index) {
+        Chunk chunk{index % AREA - AREA / 2, index / AREA - AREA / 2};
+
+        for (int y = 0; y < Chunk::SECTION_COUNT; y++)
+            chunk.GetSection(y) = sourceOf(index).GetSection(y);
+
+        return chunk;
+    };
+
+    std::vector<int> order(CHUNK_COUNT);
+    std::iota(order.begin(), order.end(), 0);
+
+    std::mt19937 random{1234};
+    std::shuffle(order.begin(), order.end(), random);
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "mineclone-region-benchmark";
+    std::filesystem::remove_all(directory);
+
+    RegionStorage storage;
+    storage.Open(directory.string());
+
+    output << "region: " << CHUNK_COUNT << " chunks in " << directory.string() << std::endl;
+
+    // saves include serializing and compressing, the flush makes them durable
+    Clock::time_point start = Clock::now();
+    size_t failures = 0;
+
+    for (const int index : order)
+        failures += !storage.Save(makeChunk(index));
+
+    failures += !storage.Flush();
+
+    double seconds = SecondsSince(start);
+    StorageStatistics statistics = storage.GetStatistics();
+
+    output << "  save + flush: " << CHUNK_COUNT / seconds << " chunks/s, " << statistics.RawBytes / seconds / (1 << 20) << " MB/s raw" << std::endl;
+    output << "  compression: " << statistics.RawBytes / CHUNK_COUNT << " -> " << statistics.CompressedBytes / CHUNK_COUNT
+           << " bytes/chunk, ratio " << static_cast<double>(statistics.RawBytes) / static_cast<double>(statistics.CompressedBytes)
+           << ", " << storage.GetFileSize() / (1 << 20) << " MB on disk" << std::endl;
+
+    const auto loadAll = [&](const char *name) {
+        std::shuffle(order.begin(), order.end(), random);
+
+        size_t mismatches = 0;
+        const Clock::time_point loadStart = Clock::now();
+
+        for (const int index : order)
+        {
+            Chunk chunk{index % AREA - AREA / 2, index / AREA - AREA / 2};
+
+            if (!storage.Load(chunk))
+            {
+                failures++;
+                continue;
+            }
+
+            // one column per chunk keeps the check cheap next to the load
+            const Chunk &source = sourceOf(index);
+
+            for (int y = 0; y < Chunk::HEIGHT; y++)
+                mismatches += chunk.GetBlock(index & 15, y, index >> 4 & 15) != source.GetBlock(index & 15, y, index >> 4 & 15);
+        }
+
+        const double loadSeconds = SecondsSince(loadStart);
+        output << "  " << name << CHUNK_COUNT / loadSeconds << " chunks/s, " << loadSeconds * 1e6 / CHUNK_COUNT << " us/chunk";
+        output << (mismatches == 0 ? "" : ", BLOCKS DIFFER") << std::endl;
+    };
+
+    loadAll("load:          ");
+
+    // a quarter saved again, the old sectors get reused once both tables moved on
+    std::shuffle(order.begin(), order.end(), random);
+    start = Clock::now();
+
+    for (int i = 0; i < CHUNK_COUNT / 4; i++)
+    {
+        failures += !storage.Save(makeChunk(order[i]));
+
+        if (i % 64 == 63)
+            failures += !storage.Flush();
+    }
+
+    failures += !storage.Flush();
+    seconds = SecondsSince(start);
+
+    output << "  overwrite:     " << CHUNK_COUNT / 4 / seconds << " chunks/s, " << storage.GetFileSize() / (1 << 20) << " MB on disk" << std::endl;
+
+    loadAll("load again:    ");
+
+    // cold, the tables are read and the files mapped again
+    storage.Close();
+    storage.Open(directory.string());
+    loadAll("reopened:      ");
+
+    storage.Close();
+    std::filesystem::remove_all(directory);
+
+    if (failures != 0)
+        output << "  " << failures << " saves or loads failed" << std::endl;
+}
+
+void BenchmarkTextures(std::ostream &output)
+{
+    constexpr int REPEATS = 20;
+
+    std::vector<TextureImage> images;
+    for (uint32_t layer = 0; layer < BlockTextures::LAYER_COUNT; layer++)
+        images.push_back(GenerateBlockTexture(static_cast<BlockId>(layer), BlockTextures::TEXTURE_SIZE));
+
+    output << "textures (" << Simd::NAME << "): " << images.size() << " layers of " << BlockTextures::TEXTURE_SIZE << "x"
+           << BlockTextures::TEXTURE_SIZE << std::endl;
+
+    std::vector<std::vector<TextureImage>> chains(images.size());
+
+    for (int filter = 0; filter < static_cast<int>(MipFilter::Count); filter++)
+    {
+        const Clock::time_point start = Clock::now();
+
+        for (int repeat = 0; repeat < REPEATS; repeat++)
+        {
+            for (size_t layer = 0; layer < images.size(); layer++)
+                chains[layer] = Mipmaps::GenerateChain(images[layer], static_cast<MipFilter>(filter));
+        }
+
+        const double seconds = SecondsSince(start);
+        output << "  " << Mipmaps::GetFilterName(static_cast<MipFilter>(filter)) << " mips: " << seconds * 1e6 / (REPEATS * images.size())
+               << " us/layer" << std::endl;
+    }
+
+    // the kaiser chains from the last pass, the same data the game uploads
+    for (int format = 0; format < static_cast<int>(TextureFormat::Count); format++)
+    {
+        const auto textureFormat = static_cast<TextureFormat>(format);
+        size_t bytes = 0, uncompressed = 0;
+        double psnr = 0.0;
+
+        const Clock::time_point start = Clock::now();
+
+        for (size_t layer = 0; layer < images.size(); layer++)
+        {
+            std::vector<uint8_t> data;
+
+            for (const TextureImage &level : chains[layer])
+            {
+                BlockCompression::Encode(textureFormat, level, data);
+                uncompressed += BlockCompression::GetEncodedSize(TextureFormat::Rgba8, level.Width, level.Height);
+            }
+
+            bytes += data.size();
+            psnr += BlockCompression::ComputePsnr(images[layer], BlockCompression::Decode(textureFormat, data.data(), images[layer].Width,
+                                                                                           images[layer].Height));
+        }
+
+        const double seconds = SecondsSince(start);
+
+        // the unknown texture's hard checker edges are the worst case, it's part of the average like any other layer
+        output << "  " << BlockCompression::GetFormatName(textureFormat) << ": " << seconds * 1e6 / images.size() << " us/layer, "
+               << static_cast<double>(uncompressed) / static_cast<double>(bytes) << "x smaller, "
+               << psnr / static_cast<double>(images.size()) << " dB PSNR" << std::endl;
+    }
+}
+
+void BenchmarkPhysics(std::ostream &output)
+{
+    constexpr int AREA = 16;
+    constexpr int STEPS = 100;
+    constexpr float STEP_SECONDS = 1.0f / 20.0f;
+    constexpr float GRAVITY = 32.0f;
+    constexpr size_t COUNTS[] = {1000, 10000, 100000};
+    constexpr size_t RAYS = 1000000;
+
+    const TerrainGenerator generator{};
+    std::vector<std::unique_ptr<Chunk>> chunks(AREA * AREA);
+
+    JobSystem jobSystem;
+    jobSystem.Create();
+
+    for (int i = 0; i < AREA * AREA; i++)
+    {
+        jobSystem.Schedule([&generator, &chunks, i] {
+            chunks[i] = std::make_unique<Chunk>(i % AREA, i / AREA);
+            generator.Generate(*chunks[i]);
+        });
+    }
+
+    jobSystem.WaitIdle();
+    jobSystem.Destroy();
+
+    // a hash lookup like the streamer's, this is what the accessor's cache saves on every block
+    std::unordered_map<uint64_t, const Chunk *> loaded;
+    for (const std::unique_ptr<Chunk> &chunk : chunks)
+        loaded[static_cast<uint64_t>(static_cast<uint32_t>(chunk->GetX())) << 32 | static_cast<uint32_t>(chunk->GetZ())] = chunk.get();
+
+    BlockAccess blocks{[&loaded](int32_t x, int32_t z) -> const Chunk * {
+        const auto chunk = loaded.find(static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(z));
+        return chunk == loaded.end() ? nullptr : chunk->second;
+    }};
+
+    const auto surface = [&blocks](int32_t x, int32_t z) {
+        int32_t y = Chunk::HEIGHT - 1;
+        while (y > 0 && !blocks.IsSolid(x, y, z))
+            y--;
+
+        return static_cast<float>(y + 1);
+    };
+
+    std::mt19937 randomEngine{1234};
+    std::uniform_real_distribution<float> across{1.0f, AREA * ChunkSection::SIZE - 1.0f};
+    std::uniform_real_distribution<float> speed{-4.0f, 4.0f};
+
+    output << "physics: " << AREA * AREA << " chunks" << std::endl;
+
+    for (const size_t count : COUNTS)
+    {
+        // mobs that wander around and drop onto the terrain, ordered by chunk like a spatially sorted entity list
+        std::vector<PhysicsBody> bodies(count);
+
+        for (PhysicsBody &body : bodies)
+        {
+            const float x = across(randomEngine), z = across(randomEngine);
+            const float y = surface(static_cast<int32_t>(x), static_cast<int32_t>(z)) + 4.0f;
+
+            body.Box = {x - 0.3f, y, z - 0.3f, x + 0.3f, y + 1.8f, z + 0.3f};
+            body.VelocityX = speed(randomEngine);
+            body.VelocityZ = speed(randomEngine);
+        }
+
+        std::sort(bodies.begin(), bodies.end(), [](const PhysicsBody &a, const PhysicsBody &b) {
+            const auto key = [](const PhysicsBody &body) {
+                return std::make_pair(static_cast<int32_t>(body.Box.MinZ) >> 4, static_cast<int32_t>(body.Box.MinX) >> 4);
+            };
+            return key(a) < key(b);
+        });
+
+        blocks.Reset();
+        const size_t lookups = blocks.GetLookupCount();
+
+        const Clock::time_point start = Clock::now();
+
+        for (int step = 0; step < STEPS; step++)
+        {
+            blocks.Reset();
+            StepBodies(blocks, bodies.data(), bodies.size(), STEP_SECONDS, GRAVITY);
+        }
+
+        const double seconds = SecondsSince(start);
+        const auto grounded = std::count_if(bodies.begin(), bodies.end(), [](const PhysicsBody &body) {
+            return body.OnGround;
+        });
+
+        output << "  " << count << " bodies: " << seconds * 1e9 / static_cast<double>(STEPS * count) << " ns/body, "
+               << static_cast<double>(blocks.GetLookupCount() - lookups) / static_cast<double>(STEPS * count) << " chunk lookups/body, "
+               << grounded << " on the ground" << std::endl;
+    }
+
+    // picking from eye height in random directions, at most 8 blocks like the reach of a player
+    std::normal_distribution<float> direction{};
+    size_t hits = 0, sighted = 0;
+    double visited = 0.0;
+
+    Clock::time_point start = Clock::now();
+    blocks.Reset();
+
+    for (size_t i = 0; i < RAYS; i++)
+    {
+        const float x = across(randomEngine), z = across(randomEngine);
+        const float y = surface(static_cast<int32_t>(x), static_cast<int32_t>(z)) + 1.6f;
+
+        float dx = direction(randomEngine), dy = direction(randomEngine), dz = direction(randomEngine);
+        const float length = std::sqrt(dx * dx + dy * dy + dz * dz);
+        dx /= length;
+        dy /= length;
+        dz /= length;
+
+        RaycastHit hit{};
+        if (Raycast(blocks, x, y, z, dx, dy, dz, 8.0f, hit))
+        {
+            hits++;
+            visited += hit.Distance;
+        }
+    }
+
+    const double raySeconds = SecondsSince(start);
+
+    // line of sight between mobs up to 32 blocks apart
+    start = Clock::now();
+
+    for (size_t i = 0; i < RAYS; i++)
+    {
+        const float x = across(randomEngine), z = across(randomEngine);
+        const float toX = std::clamp(x + speed(randomEngine) * 8.0f, 0.0f, AREA * ChunkSection::SIZE - 1.0f);
+        const float toZ = std::clamp(z + speed(randomEngine) * 8.0f, 0.0f, AREA * ChunkSection::SIZE - 1.0f);
+
+        sighted += HasLineOfSight(blocks, x, surface(static_cast<int32_t>(x), static_cast<int32_t>(z)) + 1.6f, z, toX,
+                                  surface(static_cast<int32_t>(toX), static_cast<int32_t>(toZ)) + 1.6f, toZ);
+    }
+
+    const double sightSeconds = SecondsSince(start);
+
+    // both include finding the surface for the random eyes, a scan down the column from the top of the world
+    output << "  raycasts: " << RAYS / raySeconds << " rays/s, " << 100.0 * static_cast<double>(hits) / RAYS << "% hit at "
+           << visited / static_cast<double>(std::max<size_t>(hits, 1)) << " blocks on average" << std::endl;
+    output << "  line of sight: " << RAYS / sightSeconds << " checks/s, " << 100.0 * static_cast<double>(sighted) / RAYS << "% clear"
+           << std::endl;
+}
+
+void BenchmarkEntities(std::ostream &output)
+{
+    constexpr int AREA = 16;
+    constexpr int TICKS = 100;
+    constexpr float TICK_SECONDS = 1.0f / 20.0f;
+    constexpr size_t COUNTS[] = {1000, 10000, 100000};
+
+    const TerrainGenerator generator{};
+    std::vector<std::unique_ptr<Chunk>> chunks(AREA * AREA);
+
+    JobSystem jobSystem;
+    jobSystem.Create();
+
+    for (int i = 0; i < AREA * AREA; i++)
+    {
+        jobSystem.Schedule([&generator, &chunks, i] {
+            chunks[i] = std::make_unique<Chunk>(i % AREA, i / AREA);
+            generator.Generate(*chunks[i]);
+        });
+    }
+
+    jobSystem.WaitIdle();
+
+    const ChunkLookup lookup = [&chunks](int32_t x, int32_t z) -> const Chunk * {
+        return x < 0 || z < 0 || x >= AREA || z >= AREA ? nullptr : chunks[z * AREA + x].get();
+    };
+
+    BlockAccess blocks{lookup};
+    SystemScheduler scheduler;
+    AddEntitySystems(scheduler, blocks);
+
+    std::mt19937 randomEngine{1234};
+    std::uniform_real_distribution<float> across{1.0f, AREA * ChunkSection::SIZE - 1.0f};
+
+    output << "entities: " << scheduler.GetSystemCount() << " systems, " << jobSystem.GetWorkerCount() + 1 << " threads" << std::endl;
+
+    for (const size_t count : COUNTS)
+    {
+        // half mobs and half items, the same population for the object baseline below
+        EntityWorld world;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const float x = across(randomEngine), z = across(randomEngine);
+
+            if (i % 2 == 0)
+                SpawnMob(world, x, 200.0f, z, static_cast<uint32_t>(randomEngine()));
+            else
+                SpawnItem(world, x, 200.0f, z, Blocks::DIRT, 1);
+        }
+
+        Clock::time_point start = Clock::now();
+
+        for (int tick = 0; tick < TICKS; tick++)
+            scheduler.Run(world, TICK_SECONDS, nullptr);
+
+        const double serialSeconds = SecondsSince(start) / TICKS;
+
+        start = Clock::now();
+
+        for (int tick = 0; tick < TICKS; tick++)
+            scheduler.Run(world, TICK_SECONDS, &jobSystem);
+
+        const double parallelSeconds = SecondsSince(start) / TICKS;
+
+        // what the archetypes replace: one heap object per entity ticked through a virtual call
+        struct EntityObject
+        {
+            virtual ~EntityObject() = default;
+            virtual void Tick(BlockAccess &access, float seconds) = 0;
+
+            PhysicsBody Body{};
+        };
+
+        struct MobObject final : EntityObject
+        {
+            Mob State{};
+
+            void Tick(BlockAccess &access, float seconds) override
+            {
+                State.WanderSeconds -= seconds;
+                Body.VelocityX = State.HeadingX;
+                Body.VelocityZ = State.HeadingZ;
+                StepBodies(access, &Body, 1, seconds, EntityConstants::GRAVITY);
+            }
+        };
+
+        struct ItemObject final : EntityObject
+        {
+            ItemDrop Item{};
+
+            void Tick(BlockAccess &access, float seconds) override
+            {
+                Item.Age += seconds;
+                StepBodies(access, &Body, 1, seconds, EntityConstants::GRAVITY);
+            }
+        };
+
+        std::vector<std::unique_ptr<EntityObject>> objects;
+        world.EachColumn<PhysicsBody>([&objects](size_t bodyCount, const Entity *, PhysicsBody *bodies) {
+            for (size_t i = 0; i < bodyCount; i++)
+            {
+                std::unique_ptr<EntityObject> object;
+                if (i % 2 == 0)
+                    object = std::make_unique<MobObject>();
+                else
+                    object = std::make_unique<ItemObject>();
+
+                object->Body = bodies[i];
+                objects.push_back(std::move(object));
+            }
+        });
+
+        // spawned over time, the objects end up in no particular order
+        std::shuffle(objects.begin(), objects.end(), randomEngine);
+
+        start = Clock::now();
+
+        for (int tick = 0; tick < TICKS; tick++)
+        {
+            blocks.Reset();
+
+            for (const std::unique_ptr<EntityObject> &object : objects)
+                object->Tick(blocks, TICK_SECONDS);
+        }
+
+        const double objectSeconds = SecondsSince(start) / TICKS;
+
+        output << "  " << count << " entities: " << serialSeconds * 1000.0 << " ms/tick serial, " << parallelSeconds * 1000.0
+               << " ms/tick on the job system, " << serialSeconds * 1e9 / static_cast<double>(count) << " ns/entity; objects "
+               << objectSeconds * 1000.0 << " ms/tick, " << objectSeconds * 1e9 / static_cast<double>(count) << " ns/entity" << std::endl;
+    }
+
+    jobSystem.Destroy();
+
+    // item drops come and go all the time, every destroyed slot is reused by the next spawn
+    constexpr size_t CHURN = 1000000;
+    EntityWorld world;
+    std::vector<Entity> alive;
+
+    const Clock::time_point start = Clock::now();
+
+    for (size_t i = 0; i < CHURN; i++)
+    {
+        alive.push_back(SpawnItem(world, 8.0f, 100.0f, 8.0f, Blocks::DIRT, 1));
+
+        if (alive.size() > 1000)
+        {
+            const size_t victim = randomEngine() % alive.size();
+            world.Destroy(alive[victim]);
+            alive[victim] = alive.back();
+            alive.pop_back();
+        }
+    }
+
+    const double churnSeconds = SecondsSince(start);
+
+    output << "  churn: " << CHURN / churnSeconds << " spawns and destroys/s, " << world.GetEntityCount() << " alive in "
+           << world.GetArchetypeCount() << " archetypes" << std::endl;
+}
+
+} // namespace
+
+bool RunBenchmark(const std::string &name, std::ostream &output)
+{
+    static const std::map<std::string, std::function<void(std::ostream &)>> BENCHMARKS = {
+        {"entities", &BenchmarkEntities},
+        {"lighting", &BenchmarkLighting},
+        {"physics", &BenchmarkPhysics},
+        {"region", &BenchmarkRegion},
+        {"terrain", &BenchmarkTerrain},
+        {"textures", &BenchmarkTextures},
+        {"ticks", &BenchmarkTicks},
+        {"visibility", &BenchmarkVisibility},
+    };
+
+    const auto benchmark = BENCHMARKS.find(name);
+
+    if (benchmark == BENCHMARKS.end())
+        return false;
+
+    benchmark->second(output);
+    return true;
+}
+
+} // namespace MineClone
@@ -1,17 +1,96 @@
 #include <MineClone/Client.hpp>
 
+#include <MineClone/Benchmarks.hpp>
 #include <MineClone/Game/MineCloneGame.hpp>
 
+#include <algorithm>
 #include <iostream>
 
 namespace MineClone
 {
 
+namespace
+{
+
+struct ClientOptions
+{
+    GameOptions Game{};
+    std::string Benchmark{};
+}; // struct ClientOptions
+
+ClientOptions ParseOptions(int argc, char **argv)
+{
+    ClientOptions options{};
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+
+        if (argument == "--headless")
+            options.Game.Headless = true;
+        else if (argument == "--frames" && i + 1 < argc)
+            options.Game.HeadlessFrames = std::stoul(argv[++i]);
+        else if (argument == "--workers" && i + 1 < argc)
+            options.Game.WorkerThreads = std::stoul(argv[++i]);
+        else if (argument == "--serial-recording")
+            options.Game.SerialRecording = true;
+        else if (argument == "--latency" && i + 1 < argc)
+        {
+            if (!ParseLatencyMode(argv[++i], options.Game.Latency))
+                throw Exception("Unknown latency mode: "s + argv[i]);
+        }
+        else if (argument == "--fps-cap" && i + 1 < argc)
+            options.Game.FrameRateCap = std::max(0.0, std::stod(argv[++i]));
+        else if (argument == "--texture-format" && i + 1 < argc)
+        {
+            if (!BlockCompression::ParseFormat(argv[++i], options.Game.Textures.Format))
+                throw Exception("Unknown texture format: "s + argv[i]);
+        }
+        else if (argument == "--mip-filter" && i + 1 < argc)
+        {
+            if (!Mipmaps::ParseFilter(argv[++i], options.Game.Textures.Filter))
+                throw Exception("Unknown mip filter: "s + argv[i]);
+        }
+        else if (argument == "--texture-cache" && i + 1 < argc)
+            options.Game.Textures.CacheDirectory = argv[++i];
+        else if (argument == "--no-occlusion-culling")
+            options.Game.OcclusionCulling = false;
+        else if (argument == "--gpu-culling")
+            options.Game.GpuCulling = true;
+        else if (argument == "--verify-culling")
+            options.Game.GpuCulling = options.Game.VerifyCulling = true;
+        else if (argument == "--view-distance" && i + 1 < argc)
+            options.Game.ViewDistance = std::max(1, std::stoi(argv[++i]));
+        else if (argument == "--tick-rate" && i + 1 < argc)
+            options.Game.TickRate = std::max(1u, static_cast<uint32_t>(std::stoul(argv[++i])));
+        else if (argument == "--world" && i + 1 < argc)
+            options.Game.WorldDirectory = argv[++i];
+        else if (argument == "--benchmark" && i + 1 < argc)
+            options.Benchmark = argv[++i];
+        else
+            throw Exception("Unknown argument: " + argument);
+    }
+
+    return options;
+}
+
+} // namespace
+
 int Main(int argc, char **argv)
 {
     try
     {
-        MineCloneGame game;
+        const ClientOptions options = ParseOptions(argc, argv);
+
+        if (!options.Benchmark.empty())
+        {
+            if (!RunBenchmark(options.Benchmark, std::cout))
+                throw Exception("Unknown benchmark: " + options.Benchmark);
+
+            return 0;
+        }
+
+        MineCloneGame game{options.Game};
         game.GameLoop();
     }
     catch (const std::exception &e)
@@ -0,0 +1,274 @@
+#include <MineClone/Entities/EntityWorld.hpp>
+
+#include <utility>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr uint8_t NO_COLUMN = 0xFF;
+
+struct ComponentRegistry
+{
+    std::mutex Mutex;
+    std::array<size_t, MAX_COMPONENT_TYPES> Sizes{};
+    uint32_t Count{0};
+}; // struct ComponentRegistry
+
+ComponentRegistry &GetRegistry()
+{
+    static ComponentRegistry registry;
+    return registry;
+}
+
+} // namespace
+
+uint32_t RegisterComponentType(size_t size)
+{
+    ComponentRegistry &registry = GetRegistry();
+    const std::lock_guard lock{registry.Mutex};
+
+    ASSERT(registry.Count < MAX_COMPONENT_TYPES, "Too many component types");
+
+    registry.Sizes[registry.Count] = size;
+    return registry.Count++;
+}
+
+size_t GetComponentSize(uint32_t component)
+{
+    ComponentRegistry &registry = GetRegistry();
+    const std::lock_guard lock{registry.Mutex};
+
+    return registry.Sizes[component];
+}
+
+Archetype::Archetype(ComponentMask mask) : m_mask{mask}
+{
+    m_columnIndices.fill(NO_COLUMN);
+
+    for (uint32_t component = 0; component < MAX_COMPONENT_TYPES; component++)
+    {
+        if ((mask >> component & 1) == 0)
+            continue;
+
+        m_columnIndices[component] = static_cast<uint8_t>(m_columns.size());
+        m_columns.push_back({component, GetComponentSize(component), {}});
+    }
+}
+
+size_t Archetype::Push(Entity entity)
+{
+    const size_t row = m_entities.size();
+    m_entities.push_back(entity);
+
+    for (Column &column : m_columns)
+        column.Data.resize(column.Data.size() + column.Size);
+
+    return row;
+}
+
+Entity Archetype::SwapRemove(size_t row)
+{
+    const size_t last = m_entities.size() - 1;
+
+    for (Column &column : m_columns)
+    {
+        if (row != last)
+            std::memcpy(column.Data.data() + row * column.Size, column.Data.data() + last * column.Size, column.Size);
+
+        column.Data.resize(column.Data.size() - column.Size);
+    }
+
+    const Entity moved = row == last ? Entity{} : m_entities[last];
+    m_entities[row] = m_entities[last];
+    m_entities.pop_back();
+
+    return moved;
+}
+
+void Archetype::CopyRow(size_t row, Archetype &destination, size_t destinationRow) const
+{
+    for (const Column &column : m_columns)
+    {
+        const uint8_t index = destination.m_columnIndices[column.Component];
+        if (index == NO_COLUMN)
+            continue;
+
+        std::memcpy(destination.m_columns[index].Data.data() + destinationRow * column.Size, column.Data.data() + row * column.Size,
+                    column.Size);
+    }
+}
+
+ComponentMask Archetype::GetMask() const noexcept
+{
+    return m_mask;
+}
+
+size_t Archetype::GetSize() const noexcept
+{
+    return m_entities.size();
+}
+
+const Entity *Archetype::GetEntities() const noexcept
+{
+    return m_entities.data();
+}
+
+size_t Archetype::GetMemoryUsage() const noexcept
+{
+    size_t bytes = m_entities.capacity() * sizeof(Entity);
+
+    for (const Column &column : m_columns)
+        bytes += column.Data.capacity();
+
+    return bytes;
+}
+
+void EntityWorld::Destroy(Entity entity)
+{
+    CheckStructureChange();
+
+    if (!IsAlive(entity))
+        return;
+
+    Slot &slot = m_slots[entity.Index];
+
+    if (const Entity moved = m_archetypes[slot.Archetype]->SwapRemove(slot.Row); moved.Index != Entity::INVALID_INDEX)
+        m_slots[moved.Index].Row = slot.Row;
+
+    slot.Generation++;
+    m_freeSlots.push_back(entity.Index);
+    m_entityCount--;
+}
+
+void EntityWorld::Clear()
+{
+    CheckStructureChange();
+
+    for (const std::unique_ptr<Archetype> &archetype : m_archetypes)
+    {
+        while (archetype->GetSize() != 0)
+            Destroy(archetype->GetEntities()[archetype->GetSize() - 1]);
+    }
+}
+
+bool EntityWorld::IsAlive(Entity entity) const noexcept
+{
+    return entity.Index < m_slots.size() && m_slots[entity.Index].Generation == entity.Generation;
+}
+
+void EntityWorld::Defer(std::function<void(EntityWorld &)> command)
+{
+    const std::lock_guard lock{m_deferredMutex};
+    m_deferred.push_back(std::move(command));
+}
+
+void EntityWorld::Flush()
+{
+    // commands may defer more commands, those run on the next flush
+    {
+        const std::lock_guard lock{m_deferredMutex};
+        m_flushing.swap(m_deferred);
+    }
+
+    for (const std::function<void(EntityWorld &)> &command : m_flushing)
+        command(*this);
+
+    m_flushing.clear();
+}
+
+size_t EntityWorld::GetEntityCount() const noexcept
+{
+    return m_entityCount;
+}
+
+size_t EntityWorld::GetArchetypeCount() const noexcept
+{
+    return m_archetypes.size();
+}
+
+void EntityWorld::Dump(std::ostream &stream) const
+{
+    if (m_slots.empty())
+        return;
+
+    size_t bytes = m_slots.capacity() * sizeof(Slot) + m_freeSlots.capacity() * sizeof(uint32_t);
+    for (const std::unique_ptr<Archetype> &archetype : m_archetypes)
+        bytes += archetype->GetMemoryUsage();
+
+    stream << "entities: " << m_entityCount << " alive in " << m_archetypes.size() << " archetypes, " << m_slots.size() << " slots, "
+           << static_cast<double>(bytes) / 1024.0 << " KiB\n";
+}
+
+Entity EntityWorld::Allocate(ComponentMask mask)
+{
+    CheckStructureChange();
+
+    uint32_t index;
+    if (m_freeSlots.empty())
+    {
+        ASSERT(m_slots.size() < Entity::INVALID_INDEX, "Too many entities");
+
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    else
+    {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+
+    Slot &slot = m_slots[index];
+    const Entity entity{index, slot.Generation};
+
+    slot.Archetype = FindArchetype(mask);
+    slot.Row = static_cast<uint32_t>(m_archetypes[slot.Archetype]->Push(entity));
+    m_entityCount++;
+
+    return entity;
+}
+
+void EntityWorld::ChangeMask(Entity entity, ComponentMask mask)
+{
+    CheckStructureChange();
+
+    Slot &slot = m_slots[entity.Index];
+    Archetype &source = *m_archetypes[slot.Archetype];
+
+    if (source.GetMask() == mask)
+        return;
+
+    // finding the archetype may add one and move the others, the reference to the source stays valid
+    const uint32_t destinationIndex = FindArchetype(mask);
+    Archetype &destination = *m_archetypes[destinationIndex];
+
+    const size_t row = destination.Push(entity);
+    source.CopyRow(slot.Row, destination, row);
+
+    if (const Entity moved = source.SwapRemove(slot.Row); moved.Index != Entity::INVALID_INDEX)
+        m_slots[moved.Index].Row = slot.Row;
+
+    slot.Archetype = destinationIndex;
+    slot.Row = static_cast<uint32_t>(row);
+}
+
+uint32_t EntityWorld::FindArchetype(ComponentMask mask)
+{
+    if (const auto found = m_archetypeIndices.find(mask); found != m_archetypeIndices.end())
+        return found->second;
+
+    const auto index = static_cast<uint32_t>(m_archetypes.size());
+    m_archetypes.push_back(std::make_unique<Archetype>(mask));
+    m_archetypeIndices.emplace(mask, index);
+
+    return index;
+}
+
+void EntityWorld::CheckStructureChange() const
+{
+    ASSERT(m_iterations.load(std::memory_order_relaxed) == 0, "Entities can't be created, destroyed or changed while iterating, use Defer");
+}
+
+} // namespace MineClone
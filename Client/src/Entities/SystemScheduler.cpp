@@ -0,0 +1,88 @@
+#include <MineClone/Entities/SystemScheduler.hpp>
+
+#include <chrono>
+#include <utility>
+
+namespace MineClone
+{
+
+void SystemScheduler::Add(std::string name, ComponentMask reads, ComponentMask writes, SystemFunction function)
+{
+    System system{std::move(name), reads | writes, writes, std::move(function), {}};
+
+    for (size_t i = 0; i < m_systems.size(); i++)
+    {
+        const System &earlier = m_systems[i];
+
+        if ((system.Writes & earlier.Reads) != 0 || (earlier.Writes & system.Reads) != 0)
+            system.Dependencies.push_back(i);
+    }
+
+    m_systems.push_back(std::move(system));
+}
+
+void SystemScheduler::Run(EntityWorld &world, float seconds, JobSystem *jobSystem)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    if (jobSystem == nullptr)
+    {
+        for (System &system : m_systems)
+            Execute(system, world, seconds);
+    }
+    else
+    {
+        m_jobs.clear();
+
+        for (System &system : m_systems)
+        {
+            m_dependencies.clear();
+            for (const size_t dependency : system.Dependencies)
+                m_dependencies.push_back(m_jobs[dependency]);
+
+            m_jobs.push_back(jobSystem->Schedule([&system, &world, seconds] { Execute(system, world, seconds); }, JobPriority::High, nullptr,
+                                                 m_dependencies));
+        }
+
+        // helping would let the caller pick up unrelated work, like meshing, and hold up the tick with it
+        for (const JobHandle &job : m_jobs)
+            jobSystem->WaitBlocking(job);
+
+        m_jobs.clear();
+    }
+
+    world.Flush();
+
+    m_runs++;
+    m_totalMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+size_t SystemScheduler::GetSystemCount() const noexcept
+{
+    return m_systems.size();
+}
+
+void SystemScheduler::Dump(std::ostream &stream) const
+{
+    if (m_runs == 0)
+        return;
+
+    const auto runs = static_cast<double>(m_runs);
+
+    stream << "systems: " << m_runs << " runs, " << m_totalMilliseconds / runs << " ms/run";
+
+    for (const System &system : m_systems)
+        stream << ", " << system.Name << " " << system.TotalMilliseconds / runs << " ms";
+
+    stream << "\n";
+}
+
+void SystemScheduler::Execute(System &system, EntityWorld &world, float seconds)
+{
+    // only this system's job writes its time, jobs of one run never run the same system twice
+    const auto start = std::chrono::steady_clock::now();
+    system.Function(world, seconds);
+    system.TotalMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace MineClone
@@ -0,0 +1,657 @@
+#include <MineClone/GFX/BlockCompression.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr std::array<const char *, static_cast<size_t>(TextureFormat::Count)> FORMAT_NAMES = {"RGBA8", "BC1", "BC7"};
+
+constexpr size_t BLOCK_TEXELS = 16;
+
+// interpolation weights of 4 bit BC7 indices, in 64ths
+constexpr std::array<int, 16> BC7_WEIGHTS = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+constexpr uint32_t BC7_MODE_6 = 6;
+constexpr uint32_t MAGENTA = 0xFFFF00FF;
+
+// refinement passes after the initial fit, each one rarely helps once the previous one didn't
+constexpr int REFINE_ITERATIONS = 2;
+
+using Vec4 = std::array<float, 4>;
+
+Vec4 Unpack(uint32_t texel) noexcept
+{
+    return {static_cast<float>(texel & 0xFF), static_cast<float>(texel >> 8 & 0xFF), static_cast<float>(texel >> 16 & 0xFF),
+            static_cast<float>(texel >> 24)};
+}
+
+uint32_t Pack(int r, int g, int b, int a) noexcept
+{
+    return static_cast<uint32_t>(r) | static_cast<uint32_t>(g) << 8 | static_cast<uint32_t>(b) << 16 | static_cast<uint32_t>(a) << 24;
+}
+
+// the line through the colors with the least squared distance to them, over the first channels only
+template <size_t CHANNELS>
+void FitLine(const std::array<Vec4, BLOCK_TEXELS> &colors, Vec4 &mean, Vec4 &axis) noexcept
+{
+    mean = {};
+    Vec4 low, high;
+    low.fill(255.0f);
+    high.fill(0.0f);
+
+    for (const Vec4 &color : colors)
+    {
+        for (size_t c = 0; c < CHANNELS; c++)
+        {
+            mean[c] += color[c] / BLOCK_TEXELS;
+            low[c] = std::min(low[c], color[c]);
+            high[c] = std::max(high[c], color[c]);
+        }
+    }
+
+    std::array<std::array<float, CHANNELS>, CHANNELS> covariance{};
+
+    for (const Vec4 &color : colors)
+    {
+        for (size_t i = 0; i < CHANNELS; i++)
+        {
+            for (size_t j = 0; j < CHANNELS; j++)
+                covariance[i][j] += (color[i] - mean[i]) * (color[j] - mean[j]);
+        }
+    }
+
+    // power iteration from the bounding box diagonal, which is usually close already
+    axis = {};
+    for (size_t c = 0; c < CHANNELS; c++)
+        axis[c] = high[c] - low[c];
+
+    for (int iteration = 0; iteration < 8; iteration++)
+    {
+        Vec4 next{};
+        float largest = 0.0f;
+
+        for (size_t i = 0; i < CHANNELS; i++)
+        {
+            for (size_t j = 0; j < CHANNELS; j++)
+                next[i] += covariance[i][j] * axis[j];
+
+            largest = std::max(largest, std::abs(next[i]));
+        }
+
+        if (largest == 0.0f)
+            break;
+
+        for (size_t c = 0; c < CHANNELS; c++)
+            axis[c] = next[c] / largest;
+    }
+
+    float length = 0.0f;
+    for (size_t c = 0; c < CHANNELS; c++)
+        length += axis[c] * axis[c];
+
+    length = std::sqrt(length);
+    for (size_t c = 0; c < CHANNELS; c++)
+        axis[c] = length > 0.0f ? axis[c] / length : 0.0f;
+}
+
+// the ends of the fitted line, where the outermost colors project onto it
+template <size_t CHANNELS>
+void FitEndpoints(const std::array<Vec4, BLOCK_TEXELS> &colors, Vec4 &first, Vec4 &second) noexcept
+{
+    Vec4 mean, axis;
+    FitLine<CHANNELS>(colors, mean, axis);
+
+    float low = std::numeric_limits<float>::max(), high = std::numeric_limits<float>::lowest();
+
+    for (const Vec4 &color : colors)
+    {
+        float t = 0.0f;
+        for (size_t c = 0; c < CHANNELS; c++)
+            t += (color[c] - mean[c]) * axis[c];
+
+        low = std::min(low, t);
+        high = std::max(high, t);
+    }
+
+    for (size_t c = 0; c < 4; c++)
+    {
+        first[c] = std::clamp(mean[c] + axis[c] * high, 0.0f, 255.0f);
+        second[c] = std::clamp(mean[c] + axis[c] * low, 0.0f, 255.0f);
+    }
+}
+
+// Least squares endpoints for fixed indices, weight is how much of the first endpoint each texel gets. Returns false
+// when all texels use the same weight and the system has no unique solution.
+bool SolveEndpoints(const std::array<Vec4, BLOCK_TEXELS> &colors, const std::array<float, BLOCK_TEXELS> &weights, Vec4 &first, Vec4 &second) noexcept
+{
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    Vec4 ax{}, bx{};
+
+    for (size_t i = 0; i < BLOCK_TEXELS; i++)
+    {
+        const float a = weights[i], b = 1.0f - a;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+
+        for (size_t c = 0; c < 4; c++)
+        {
+            ax[c] += a * colors[i][c];
+            bx[c] += b * colors[i][c];
+        }
+    }
+
+    const float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) < 1e-6f)
+        return false;
+
+    for (size_t c = 0; c < 4; c++)
+    {
+        first[c] = std::clamp((ax[c] * bb - bx[c] * ab) / determinant, 0.0f, 255.0f);
+        second[c] = std::clamp((bx[c] * aa - ax[c] * ab) / determinant, 0.0f, 255.0f);
+    }
+
+    return true;
+}
+
+std::array<Vec4, BLOCK_TEXELS> UnpackBlock(const uint32_t *texels) noexcept
+{
+    std::array<Vec4, BLOCK_TEXELS> colors;
+    for (size_t i = 0; i < BLOCK_TEXELS; i++)
+        colors[i] = Unpack(texels[i]);
+
+    return colors;
+}
+
+// nearest palette entry for every texel, returns the total squared error
+template <size_t CHANNELS, size_t SIZE>
+float SelectIndices(const std::array<Vec4, BLOCK_TEXELS> &colors, const std::array<Vec4, SIZE> &palette,
+                    std::array<uint8_t, BLOCK_TEXELS> &indices) noexcept
+{
+    float total = 0.0f;
+
+    for (size_t i = 0; i < BLOCK_TEXELS; i++)
+    {
+        float best = std::numeric_limits<float>::max();
+
+        for (size_t entry = 0; entry < SIZE; entry++)
+        {
+            float error = 0.0f;
+            for (size_t c = 0; c < CHANNELS; c++)
+                error += (colors[i][c] - palette[entry][c]) * (colors[i][c] - palette[entry][c]);
+
+            if (error < best)
+            {
+                best = error;
+                indices[i] = static_cast<uint8_t>(entry);
+            }
+        }
+
+        total += best;
+    }
+
+    return total;
+}
+
+// BC1
+
+uint16_t To565(const Vec4 &color) noexcept
+{
+    const auto quantize = [](float value, int max) {
+        return static_cast<uint16_t>(std::clamp(static_cast<int>(std::lround(value * max / 255.0f)), 0, max));
+    };
+
+    return static_cast<uint16_t>(quantize(color[0], 31) << 11 | quantize(color[1], 63) << 5 | quantize(color[2], 31));
+}
+
+Vec4 From565(uint16_t color) noexcept
+{
+    const int r = color >> 11, g = color >> 5 & 63, b = color & 31;
+    return {static_cast<float>(r << 3 | r >> 2), static_cast<float>(g << 2 | g >> 4), static_cast<float>(b << 3 | b >> 2), 255.0f};
+}
+
+// the four color mode, the decoders round the thirds down
+std::array<Vec4, 4> Bc1Palette(uint16_t first, uint16_t second) noexcept
+{
+    const Vec4 a = From565(first), b = From565(second);
+    std::array<Vec4, 4> palette{a, b, {}, {}};
+
+    for (size_t c = 0; c < 4; c++)
+    {
+        palette[2][c] = std::floor((2.0f * a[c] + b[c]) / 3.0f);
+        palette[3][c] = std::floor((a[c] + 2.0f * b[c]) / 3.0f);
+    }
+
+    return palette;
+}
+
+// BC7 mode 6
+
+struct Bc7Endpoints
+{
+    std::array<uint8_t, 4> First, Second; // 7 bits
+    uint8_t FirstBit, SecondBit;
+}; // struct Bc7Endpoints
+
+uint8_t QuantizeBc7(float value, uint8_t bit) noexcept
+{
+    return static_cast<uint8_t>(std::clamp(static_cast<int>(std::lround((value - bit) / 2.0f)), 0, 127));
+}
+
+std::array<Vec4, 16> Bc7Palette(const Bc7Endpoints &endpoints) noexcept
+{
+    std::array<Vec4, 16> palette;
+
+    for (size_t entry = 0; entry < palette.size(); entry++)
+    {
+        const int weight = BC7_WEIGHTS[entry];
+
+        for (size_t c = 0; c < 4; c++)
+        {
+            const int first = endpoints.First[c] << 1 | endpoints.FirstBit;
+            const int second = endpoints.Second[c] << 1 | endpoints.SecondBit;
+            palette[entry][c] = static_cast<float>(((64 - weight) * first + weight * second + 32) >> 6);
+        }
+    }
+
+    return palette;
+}
+
+// tries the four shared bit combinations, keeps the best in endpoints and indices and returns its error
+float QuantizeBc7Endpoints(const std::array<Vec4, BLOCK_TEXELS> &colors, const Vec4 &first, const Vec4 &second, Bc7Endpoints &endpoints,
+                           std::array<uint8_t, BLOCK_TEXELS> &indices) noexcept
+{
+    float bestError = std::numeric_limits<float>::max();
+
+    for (uint8_t bits = 0; bits < 4; bits++)
+    {
+        Bc7Endpoints candidate{};
+        candidate.FirstBit = bits & 1;
+        candidate.SecondBit = bits >> 1;
+
+        for (size_t c = 0; c < 4; c++)
+        {
+            candidate.First[c] = QuantizeBc7(first[c], candidate.FirstBit);
+            candidate.Second[c] = QuantizeBc7(second[c], candidate.SecondBit);
+        }
+
+        std::array<uint8_t, BLOCK_TEXELS> candidateIndices{};
+        const float error = SelectIndices<4>(colors, Bc7Palette(candidate), candidateIndices);
+
+        if (error < bestError)
+        {
+            bestError = error;
+            endpoints = candidate;
+            indices = candidateIndices;
+        }
+    }
+
+    return bestError;
+}
+
+class BitWriter
+{
+  public:
+    explicit BitWriter(uint8_t *data) noexcept : m_data{data}
+    {
+    }
+
+    void Write(uint32_t value, int bits) noexcept
+    {
+        for (int bit = 0; bit < bits; bit++, m_position++)
+            m_data[m_position >> 3] |= static_cast<uint8_t>((value >> bit & 1) << (m_position & 7));
+    }
+
+  private:
+    uint8_t *m_data;
+    size_t m_position{0};
+}; // class BitWriter
+
+class BitReader
+{
+  public:
+    explicit BitReader(const uint8_t *data) noexcept : m_data{data}
+    {
+    }
+
+    uint32_t Read(int bits) noexcept
+    {
+        uint32_t value = 0;
+        for (int bit = 0; bit < bits; bit++, m_position++)
+            value |= static_cast<uint32_t>(m_data[m_position >> 3] >> (m_position & 7) & 1) << bit;
+
+        return value;
+    }
+
+  private:
+    const uint8_t *m_data;
+    size_t m_position{0};
+}; // class BitReader
+
+size_t GetBlockBytes(TextureFormat format) noexcept
+{
+    return format == TextureFormat::Bc1 ? 8 : 16;
+}
+
+} // namespace
+
+namespace BlockCompression
+{
+
+const char *GetFormatName(TextureFormat format) noexcept
+{
+    return FORMAT_NAMES[static_cast<size_t>(format)];
+}
+
+bool ParseFormat(const std::string &name, TextureFormat &format) noexcept
+{
+    const auto found = std::find_if(FORMAT_NAMES.begin(), FORMAT_NAMES.end(), [&name](const char *formatName) {
+        return std::equal(name.begin(), name.end(), formatName, formatName + std::strlen(formatName),
+                          [](char a, char b) { return std::toupper(static_cast<unsigned char>(a)) == b; });
+    });
+
+    if (found == FORMAT_NAMES.end())
+        return false;
+
+    format = static_cast<TextureFormat>(found - FORMAT_NAMES.begin());
+    return true;
+}
+
+size_t GetEncodedSize(TextureFormat format, uint32_t width, uint32_t height) noexcept
+{
+    if (format == TextureFormat::Rgba8)
+        return size_t{width} * height * 4;
+
+    return size_t{(width + 3) / 4} * ((height + 3) / 4) * GetBlockBytes(format);
+}
+
+void Encode(TextureFormat format, const TextureImage &image, std::vector<uint8_t> &out)
+{
+    const size_t offset = out.size();
+    out.resize(offset + GetEncodedSize(format, image.Width, image.Height));
+
+    if (format == TextureFormat::Rgba8)
+    {
+        std::memcpy(out.data() + offset, image.Texels.data(), image.Texels.size() * sizeof(uint32_t));
+        return;
+    }
+
+    uint8_t *block = out.data() + offset;
+    std::array<uint32_t, BLOCK_TEXELS> texels;
+
+    for (uint32_t y = 0; y < image.Height; y += 4)
+    {
+        for (uint32_t x = 0; x < image.Width; x += 4, block += GetBlockBytes(format))
+        {
+            for (uint32_t i = 0; i < BLOCK_TEXELS; i++)
+            {
+                const uint32_t texelX = std::min(x + i % 4, image.Width - 1), texelY = std::min(y + i / 4, image.Height - 1);
+                texels[i] = image.Texels[size_t{texelY} * image.Width + texelX];
+            }
+
+            if (format == TextureFormat::Bc1)
+                EncodeBc1Block(texels.data(), block);
+            else
+                EncodeBc7Block(texels.data(), block);
+        }
+    }
+}
+
+TextureImage Decode(TextureFormat format, const uint8_t *data, uint32_t width, uint32_t height)
+{
+    TextureImage image{width, height, std::vector<uint32_t>(size_t{width} * height)};
+
+    if (format == TextureFormat::Rgba8)
+    {
+        std::memcpy(image.Texels.data(), data, image.Texels.size() * sizeof(uint32_t));
+        return image;
+    }
+
+    std::array<uint32_t, BLOCK_TEXELS> texels;
+
+    for (uint32_t y = 0; y < height; y += 4)
+    {
+        for (uint32_t x = 0; x < width; x += 4, data += GetBlockBytes(format))
+        {
+            if (format == TextureFormat::Bc1)
+                DecodeBc1Block(data, texels.data());
+            else
+                DecodeBc7Block(data, texels.data());
+
+            for (uint32_t i = 0; i < BLOCK_TEXELS; i++)
+            {
+                const uint32_t texelX = x + i % 4, texelY = y + i / 4;
+                if (texelX < width && texelY < height)
+                    image.Texels[size_t{texelY} * width + texelX] = texels[i];
+            }
+        }
+    }
+
+    return image;
+}
+
+void EncodeBc1Block(const uint32_t *texels, uint8_t *out) noexcept
+{
+    const std::array<Vec4, BLOCK_TEXELS> colors = UnpackBlock(texels);
+
+    Vec4 first, second;
+    FitEndpoints<3>(colors, first, second);
+
+    uint16_t color0 = To565(first), color1 = To565(second);
+    std::array<uint8_t, BLOCK_TEXELS> indices{};
+    float error = SelectIndices<3>(colors, Bc1Palette(color0, color1), indices);
+
+    // how much of the first endpoint each palette entry holds
+    constexpr std::array<float, 4> ENTRY_WEIGHTS = {1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f};
+
+    for (int iteration = 0; iteration < REFINE_ITERATIONS; iteration++)
+    {
+        std::array<float, BLOCK_TEXELS> weights;
+        for (size_t i = 0; i < BLOCK_TEXELS; i++)
+            weights[i] = ENTRY_WEIGHTS[indices[i]];
+
+        if (!SolveEndpoints(colors, weights, first, second))
+            break;
+
+        const uint16_t refined0 = To565(first), refined1 = To565(second);
+        std::array<uint8_t, BLOCK_TEXELS> refinedIndices{};
+        const float refinedError = SelectIndices<3>(colors, Bc1Palette(refined0, refined1), refinedIndices);
+
+        if (refinedError >= error)
+            break;
+
+        color0 = refined0;
+        color1 = refined1;
+        indices = refinedIndices;
+        error = refinedError;
+    }
+
+    // the first color has to be the larger one for the four color mode, equal ones would select the three color mode
+    if (color0 < color1)
+    {
+        std::swap(color0, color1);
+        for (uint8_t &index : indices)
+            index ^= 1;
+    }
+    else if (color0 == color1)
+    {
+        indices.fill(0);
+    }
+
+    uint32_t packed = 0;
+    for (size_t i = 0; i < BLOCK_TEXELS; i++)
+        packed |= static_cast<uint32_t>(indices[i]) << (2 * i);
+
+    out[0] = static_cast<uint8_t>(color0);
+    out[1] = static_cast<uint8_t>(color0 >> 8);
+    out[2] = static_cast<uint8_t>(color1);
+    out[3] = static_cast<uint8_t>(color1 >> 8);
+
+    for (size_t byte = 0; byte < 4; byte++)
+        out[4 + byte] = static_cast<uint8_t>(packed >> (8 * byte));
+}
+
+void EncodeBc7Block(const uint32_t *texels, uint8_t *out) noexcept
+{
+    const std::array<Vec4, BLOCK_TEXELS> colors = UnpackBlock(texels);
+
+    Vec4 first, second;
+    FitEndpoints<4>(colors, first, second);
+
+    Bc7Endpoints endpoints{};
+    std::array<uint8_t, BLOCK_TEXELS> indices{};
+    float error = QuantizeBc7Endpoints(colors, first, second, endpoints, indices);
+
+    for (int iteration = 0; iteration < REFINE_ITERATIONS; iteration++)
+    {
+        std::array<float, BLOCK_TEXELS> weights;
+        for (size_t i = 0; i < BLOCK_TEXELS; i++)
+            weights[i] = static_cast<float>(64 - BC7_WEIGHTS[indices[i]]) / 64.0f;
+
+        if (!SolveEndpoints(colors, weights, first, second))
+            break;
+
+        Bc7Endpoints refined{};
+        std::array<uint8_t, BLOCK_TEXELS> refinedIndices{};
+        const float refinedError = QuantizeBc7Endpoints(colors, first, second, refined, refinedIndices);
+
+        if (refinedError >= error)
+            break;
+
+        endpoints = refined;
+        indices = refinedIndices;
+        error = refinedError;
+    }
+
+    // the first index is stored without its top bit, which therefore has to be 0
+    if (indices[0] & 8)
+    {
+        std::swap(endpoints.First, endpoints.Second);
+        std::swap(endpoints.FirstBit, endpoints.SecondBit);
+
+        for (uint8_t &index : indices)
+            index = static_cast<uint8_t>(15 - index);
+    }
+
+    std::memset(out, 0, 16);
+    BitWriter writer{out};
+
+    writer.Write(1u << BC7_MODE_6, BC7_MODE_6 + 1);
+
+    for (size_t c = 0; c < 4; c++)
+    {
+        writer.Write(endpoints.First[c], 7);
+        writer.Write(endpoints.Second[c], 7);
+    }
+
+    writer.Write(endpoints.FirstBit, 1);
+    writer.Write(endpoints.SecondBit, 1);
+
+    writer.Write(indices[0], 3);
+    for (size_t i = 1; i < BLOCK_TEXELS; i++)
+        writer.Write(indices[i], 4);
+}
+
+void DecodeBc1Block(const uint8_t *data, uint32_t *texels) noexcept
+{
+    const auto color0 = static_cast<uint16_t>(data[0] | data[1] << 8);
+    const auto color1 = static_cast<uint16_t>(data[2] | data[3] << 8);
+    const uint32_t packed = data[4] | data[5] << 8 | data[6] << 16 | static_cast<uint32_t>(data[7]) << 24;
+
+    std::array<uint32_t, 4> palette;
+    const Vec4 a = From565(color0), b = From565(color1);
+
+    const auto mix = [&a, &b](int weightA, int weightB, int divisor) {
+        const auto channel = [&](size_t c) {
+            return (weightA * static_cast<int>(a[c]) + weightB * static_cast<int>(b[c])) / divisor;
+        };
+        return Pack(channel(0), channel(1), channel(2), 255);
+    };
+
+    palette[0] = mix(1, 0, 1);
+    palette[1] = mix(0, 1, 1);
+
+    if (color0 > color1)
+    {
+        palette[2] = mix(2, 1, 3);
+        palette[3] = mix(1, 2, 3);
+    }
+    else
+    {
+        // three colors and transparent black
+        palette[2] = mix(1, 1, 2);
+        palette[3] = 0;
+    }
+
+    for (size_t i = 0; i < BLOCK_TEXELS; i++)
+        texels[i] = palette[packed >> (2 * i) & 3];
+}
+
+void DecodeBc7Block(const uint8_t *data, uint32_t *texels) noexcept
+{
+    BitReader reader{data};
+
+    // the mode is the position of the lowest set bit
+    uint32_t mode = 0;
+    while (mode < 8 && reader.Read(1) == 0)
+        mode++;
+
+    if (mode != BC7_MODE_6)
+    {
+        std::fill(texels, texels + BLOCK_TEXELS, MAGENTA);
+        return;
+    }
+
+    Bc7Endpoints endpoints{};
+
+    for (size_t c = 0; c < 4; c++)
+    {
+        endpoints.First[c] = static_cast<uint8_t>(reader.Read(7));
+        endpoints.Second[c] = static_cast<uint8_t>(reader.Read(7));
+    }
+
+    endpoints.FirstBit = static_cast<uint8_t>(reader.Read(1));
+    endpoints.SecondBit = static_cast<uint8_t>(reader.Read(1));
+
+    const std::array<Vec4, 16> palette = Bc7Palette(endpoints);
+
+    for (size_t i = 0; i < BLOCK_TEXELS; i++)
+    {
+        const Vec4 &color = palette[reader.Read(i == 0 ? 3 : 4)];
+        texels[i] = Pack(static_cast<int>(color[0]), static_cast<int>(color[1]), static_cast<int>(color[2]), static_cast<int>(color[3]));
+    }
+}
+
+double ComputePsnr(const TextureImage &reference, const TextureImage &image)
+{
+    ASSERT(reference.Texels.size() == image.Texels.size(), "images of different sizes");
+
+    double squaredError = 0.0;
+
+    for (size_t i = 0; i < reference.Texels.size(); i++)
+    {
+        const Vec4 a = Unpack(reference.Texels[i]), b = Unpack(image.Texels[i]);
+
+        for (size_t c = 0; c < 3; c++)
+            squaredError += static_cast<double>(a[c] - b[c]) * static_cast<double>(a[c] - b[c]);
+    }
+
+    if (squaredError == 0.0)
+        return std::numeric_limits<double>::infinity();
+
+    const double meanSquaredError = squaredError / static_cast<double>(reference.Texels.size() * 3);
+    return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
+
+} // namespace BlockCompression
+
+} // namespace MineClone
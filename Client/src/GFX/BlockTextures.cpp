@@ -0,0 +1,471 @@
+#include <MineClone/GFX/BlockTextures.hpp>
+
+#include <MineClone/GFX/VulkanContext.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr uint32_t CACHE_MAGIC = 0x5843544D; // "MTCX"
+
+// bump when the generator, the filters or the encoders change what they produce
+constexpr uint32_t CACHE_VERSION = 1;
+
+struct CacheHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t Hash;
+    uint32_t Format;
+    uint32_t Size;
+    uint32_t Levels;
+    float Psnr;
+    uint64_t DataSize;
+}; // struct CacheHeader
+
+// base color and how much it varies, per block
+struct BlockLook
+{
+    uint8_t R, G, B;
+    float Variation; // low frequency
+    float Grain;     // per texel
+}; // struct BlockLook
+
+constexpr std::array<BlockLook, BlockTextures::LAYER_COUNT> BLOCK_LOOKS = {{
+    {255, 0, 255, 0.0f, 0.0f},    // unknown
+    {125, 125, 125, 0.25f, 0.12f}, // stone
+    {134, 96, 67, 0.2f, 0.15f},    // dirt
+    {95, 159, 53, 0.2f, 0.15f},    // grass
+    {219, 207, 163, 0.1f, 0.08f},  // sand
+    {47, 67, 180, 0.15f, 0.03f},   // water
+    {60, 60, 60, 0.5f, 0.3f},      // bedrock
+    {255, 214, 120, 0.15f, 0.1f},  // lamp
+}};
+
+VkFormat ToVkFormat(TextureFormat format) noexcept
+{
+    switch (format)
+    {
+    case TextureFormat::Bc1:
+        return VK_FORMAT_BC1_RGB_SRGB_BLOCK;
+    case TextureFormat::Bc7:
+        return VK_FORMAT_BC7_SRGB_BLOCK;
+    default:
+        return VK_FORMAT_R8G8B8A8_SRGB;
+    }
+}
+
+uint32_t HashTexel(uint32_t seed, uint32_t x, uint32_t y) noexcept
+{
+    uint32_t hash = seed * 0x9E3779B1u ^ x * 0x85EBCA77u ^ y * 0xC2B2AE3Du;
+    hash ^= hash >> 15;
+    hash *= 0x2C1B3C6Du;
+    return hash ^ hash >> 13;
+}
+
+float ToUnit(uint32_t hash) noexcept
+{
+    return static_cast<float>(hash >> 8) / static_cast<float>(1u << 24);
+}
+
+// value noise on a lattice that repeats every period cells, so the texture tiles
+float PeriodicNoise(uint32_t seed, float x, float y, uint32_t period) noexcept
+{
+    const auto x0 = static_cast<uint32_t>(x), y0 = static_cast<uint32_t>(y);
+    const float fx = x - static_cast<float>(x0), fy = y - static_cast<float>(y0);
+    const float sx = fx * fx * (3.0f - 2.0f * fx), sy = fy * fy * (3.0f - 2.0f * fy);
+
+    const auto corner = [seed, period](uint32_t cx, uint32_t cy) {
+        return ToUnit(HashTexel(seed, cx % period, cy % period));
+    };
+
+    const float top = corner(x0, y0) + (corner(x0 + 1, y0) - corner(x0, y0)) * sx;
+    const float bottom = corner(x0, y0 + 1) + (corner(x0 + 1, y0 + 1) - corner(x0, y0 + 1)) * sx;
+    return top + (bottom - top) * sy;
+}
+
+// FNV-1a over everything that decides the encoded bytes
+uint64_t HashLayer(const TextureImage &image, TextureFormat format, MipFilter filter) noexcept
+{
+    uint64_t hash = 0xCBF29CE484222325;
+
+    const auto add = [&hash](const void *data, size_t size) {
+        for (size_t i = 0; i < size; i++)
+            hash = (hash ^ static_cast<const uint8_t *>(data)[i]) * 0x100000001B3;
+    };
+
+    const uint32_t parameters[] = {CACHE_VERSION, static_cast<uint32_t>(format), static_cast<uint32_t>(filter), image.Width, image.Height};
+    add(parameters, sizeof(parameters));
+    add(image.Texels.data(), image.Texels.size() * sizeof(uint32_t));
+
+    return hash;
+}
+
+} // namespace
+
+TextureImage GenerateBlockTexture(BlockId block, uint32_t size)
+{
+    TextureImage image{size, size, std::vector<uint32_t>(size_t{size} * size)};
+
+    if (block >= BLOCK_LOOKS.size() || block == Blocks::AIR)
+    {
+        // magenta and black checkers, impossible to miss
+        for (uint32_t y = 0; y < size; y++)
+        {
+            for (uint32_t x = 0; x < size; x++)
+                image.Texels[size_t{y} * size + x] = (x < size / 2) != (y < size / 2) ? 0xFF000000 : 0xFFFF00FF;
+        }
+
+        return image;
+    }
+
+    const BlockLook &look = BLOCK_LOOKS[block];
+
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            // two octaves of blotches, 4 and 8 cells across, and a grain per texel
+            const float u = static_cast<float>(x) / static_cast<float>(size), v = static_cast<float>(y) / static_cast<float>(size);
+            const float blotches = 0.65f * PeriodicNoise(block, u * 4.0f, v * 4.0f, 4) + 0.35f * PeriodicNoise(block + 97, u * 8.0f, v * 8.0f, 8);
+            const float grain = ToUnit(HashTexel(block * 31 + 7, x, y));
+            const float brightness = 1.0f + look.Variation * (2.0f * blotches - 1.0f) + look.Grain * (2.0f * grain - 1.0f);
+
+            const auto channel = [brightness](uint8_t base) {
+                return static_cast<uint32_t>(std::clamp(static_cast<int>(std::lround(base * brightness)), 0, 255));
+            };
+
+            image.Texels[size_t{y} * size + x] = channel(look.R) | channel(look.G) << 8 | channel(look.B) << 16 | 0xFF000000;
+        }
+    }
+
+    return image;
+}
+
+BlockTextures::~BlockTextures()
+{
+    Destroy();
+}
+
+void BlockTextures::Create(VulkanContext *context, JobSystem *jobSystem, const BlockTextureOptions &options)
+{
+    Destroy();
+
+    m_context = context;
+    m_options = options;
+    m_format = SelectFormat(options.Format);
+    m_levelCount = Mipmaps::GetLevelCount(TEXTURE_SIZE, TEXTURE_SIZE);
+    m_layers.assign(LAYER_COUNT, Layer{});
+
+    if (!m_options.CacheDirectory.empty())
+    {
+        std::error_code error;
+        std::filesystem::create_directories(m_options.CacheDirectory, error);
+
+        // encoding every start is slow, but not fatal
+        if (error)
+        {
+            std::cerr << "textures: no cache, failed to create " << m_options.CacheDirectory << ": " << error.message() << std::endl;
+            m_options.CacheDirectory.clear();
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    if (jobSystem != nullptr)
+    {
+        std::vector<JobHandle> jobs;
+        for (uint32_t layer = 0; layer < LAYER_COUNT; layer++)
+            jobs.push_back(jobSystem->Schedule([this, layer]() { EncodeLayer(layer); }, JobPriority::High));
+
+        for (const JobHandle &job : jobs)
+            jobSystem->WaitUrgent(job);
+    }
+    else
+    {
+        for (uint32_t layer = 0; layer < LAYER_COUNT; layer++)
+            EncodeLayer(layer);
+    }
+
+    m_encodeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // a job that threw left its layer empty
+    const size_t layerSize = m_layers.empty() ? 0 : m_layers[0].LevelOffsets.back();
+    if (std::any_of(m_layers.begin(), m_layers.end(), [layerSize](const Layer &layer) { return layer.Data.size() != layerSize || layerSize == 0; }))
+        throw GraphicsException("failed to encode the block textures");
+
+    CreateImage();
+    CreateSampler();
+}
+
+void BlockTextures::Destroy()
+{
+    if (m_context == nullptr)
+        return;
+
+    VkDevice device = m_context->GetDevice();
+
+    if (m_sampler != VK_NULL_HANDLE)
+    {
+        vkDestroySampler(device, m_sampler, nullptr);
+        m_sampler = VK_NULL_HANDLE;
+    }
+
+    if (m_imageView != VK_NULL_HANDLE)
+    {
+        vkDestroyImageView(device, m_imageView, nullptr);
+        m_imageView = VK_NULL_HANDLE;
+    }
+
+    if (m_image != VK_NULL_HANDLE)
+        m_context->GetMemoryAllocator().DestroyImage(m_image, m_memory);
+
+    m_layers.clear();
+    m_encodeSeconds = 0.0;
+    m_context = nullptr;
+}
+
+void BlockTextures::Dump(std::ostream &stream) const
+{
+    if (m_layers.empty())
+        return;
+
+    size_t bytes = 0, uncompressed = 0, cached = 0;
+    double psnr = 0.0;
+
+    for (const Layer &layer : m_layers)
+    {
+        bytes += layer.Data.size();
+        cached += layer.Cached;
+        psnr += layer.Psnr;
+    }
+
+    for (uint32_t level = 0, size = TEXTURE_SIZE; level < m_levelCount; level++, size = std::max(size / 2, 1u))
+        uncompressed += BlockCompression::GetEncodedSize(TextureFormat::Rgba8, size, size) * m_layers.size();
+
+    stream << "block textures: " << m_layers.size() << " layers of " << TEXTURE_SIZE << "x" << TEXTURE_SIZE << " with " << m_levelCount << " "
+           << Mipmaps::GetFilterName(m_options.Filter) << " mips as " << BlockCompression::GetFormatName(m_format) << ", " << bytes / 1024.0
+           << " KiB instead of " << uncompressed / 1024.0 << " KiB (" << static_cast<double>(uncompressed) / static_cast<double>(bytes)
+           << "x smaller), " << psnr / static_cast<double>(m_layers.size()) << " dB PSNR, " << cached << " layers from the cache, "
+           << m_encodeSeconds * 1000.0 << " ms to prepare\n";
+    stream.flush();
+}
+
+VkImageView BlockTextures::GetImageView() noexcept
+{
+    return m_imageView;
+}
+
+VkSampler BlockTextures::GetSampler() noexcept
+{
+    return m_sampler;
+}
+
+TextureFormat BlockTextures::GetFormat() const noexcept
+{
+    return m_format;
+}
+
+TextureFormat BlockTextures::SelectFormat(TextureFormat preferred)
+{
+    if (preferred == TextureFormat::Rgba8)
+        return preferred;
+
+    // the sampler filters linearly between mips
+    constexpr VkFormatFeatureFlags REQUIRED = VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+
+    VkFormatProperties properties{};
+    vkGetPhysicalDeviceFormatProperties(m_context->GetPhysicalDevice(), ToVkFormat(preferred), &properties);
+
+    if (m_context->GetPhysicalDeviceFeatures().textureCompressionBC && (properties.optimalTilingFeatures & REQUIRED) == REQUIRED)
+        return preferred;
+
+    std::cerr << "textures: the device can't sample " << BlockCompression::GetFormatName(preferred) << ", falling back to RGBA8" << std::endl;
+    return TextureFormat::Rgba8;
+}
+
+void BlockTextures::EncodeLayer(uint32_t index)
+{
+    Layer &layer = m_layers[index];
+
+    for (uint32_t level = 0, size = TEXTURE_SIZE; level < m_levelCount; level++, size = std::max(size / 2, 1u))
+    {
+        const size_t offset = layer.LevelOffsets.empty() ? 0 : layer.LevelOffsets.back();
+        layer.LevelOffsets.push_back(offset + BlockCompression::GetEncodedSize(m_format, size, size));
+    }
+
+    // offsets of every level, then the end
+    layer.LevelOffsets.insert(layer.LevelOffsets.begin(), 0);
+
+    const TextureImage image = GenerateBlockTexture(static_cast<BlockId>(index), TEXTURE_SIZE);
+    const uint64_t hash = HashLayer(image, m_format, m_options.Filter);
+
+    std::string path;
+    if (!m_options.CacheDirectory.empty())
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.tex", static_cast<unsigned long long>(hash));
+        path = (std::filesystem::path{m_options.CacheDirectory} / name).string();
+
+        if (LoadCached(path, hash, layer))
+            return;
+    }
+
+    const std::vector<TextureImage> chain = Mipmaps::GenerateChain(image, m_options.Filter);
+    layer.Data.reserve(layer.LevelOffsets.back());
+
+    for (const TextureImage &level : chain)
+        BlockCompression::Encode(m_format, level, layer.Data);
+
+    layer.Psnr = BlockCompression::ComputePsnr(image, BlockCompression::Decode(m_format, layer.Data.data(), TEXTURE_SIZE, TEXTURE_SIZE));
+
+    if (!path.empty())
+        SaveCached(path, hash, layer);
+}
+
+bool BlockTextures::LoadCached(const std::string &path, uint64_t hash, Layer &layer) const
+{
+    std::ifstream file{path, std::ios::binary};
+    if (!file)
+        return false;
+
+    CacheHeader header{};
+    file.read(reinterpret_cast<char *>(&header), sizeof(header));
+
+    // a hash collision would need the same size too, anything else is a stale or torn file and encoded again
+    if (!file || header.Magic != CACHE_MAGIC || header.Version != CACHE_VERSION || header.Hash != hash ||
+        header.Format != static_cast<uint32_t>(m_format) || header.Size != TEXTURE_SIZE || header.Levels != m_levelCount ||
+        header.DataSize != layer.LevelOffsets.back())
+    {
+        return false;
+    }
+
+    layer.Data.resize(header.DataSize);
+    file.read(reinterpret_cast<char *>(layer.Data.data()), static_cast<std::streamsize>(header.DataSize));
+
+    if (!file)
+    {
+        layer.Data.clear();
+        return false;
+    }
+
+    layer.Psnr = header.Psnr;
+    layer.Cached = true;
+    return true;
+}
+
+void BlockTextures::SaveCached(const std::string &path, uint64_t hash, const Layer &layer) const
+{
+    const CacheHeader header{CACHE_MAGIC,   CACHE_VERSION, hash, static_cast<uint32_t>(m_format), TEXTURE_SIZE, m_levelCount,
+                             static_cast<float>(layer.Psnr), layer.Data.size()};
+
+    // written next to it and renamed, a reader never sees half a file
+    const std::string temporary = path + ".tmp";
+
+    {
+        std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(layer.Data.data()), static_cast<std::streamsize>(layer.Data.size()));
+
+        if (!file)
+        {
+            std::cerr << "textures: failed to write " << temporary << std::endl;
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+
+    if (error)
+        std::cerr << "textures: failed to cache " << path << ": " << error.message() << std::endl;
+}
+
+void BlockTextures::CreateImage()
+{
+    const VkDevice device = m_context->GetDevice();
+    const VkFormat format = ToVkFormat(m_format);
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = format;
+    imageInfo.extent = {TEXTURE_SIZE, TEXTURE_SIZE, 1};
+    imageInfo.mipLevels = m_levelCount;
+    imageInfo.arrayLayers = LAYER_COUNT;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    m_context->GetMemoryAllocator().CreateImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_image, m_memory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = m_image;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    viewInfo.format = format;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = m_levelCount;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = LAYER_COUNT;
+
+    if (vkCreateImageView(device, &viewInfo, nullptr, &m_imageView) != VK_SUCCESS)
+        throw GraphicsException("failed to create the block texture view");
+
+    // every level of every layer is its own copy, the smallest levels are a partial block
+    UploadManager &uploads = m_context->GetUploadManager();
+
+    for (uint32_t layer = 0; layer < LAYER_COUNT; layer++)
+    {
+        const Layer &data = m_layers[layer];
+
+        for (uint32_t level = 0, size = TEXTURE_SIZE; level < m_levelCount; level++, size = std::max(size / 2, 1u))
+        {
+            const size_t offset = data.LevelOffsets[level];
+            const VkImageSubresourceLayers subresource{VK_IMAGE_ASPECT_COLOR_BIT, level, layer, 1};
+
+            if (!uploads.UploadImage(m_image, subresource, {size, size, 1}, data.Data.data() + offset, data.LevelOffsets[level + 1] - offset,
+                                     VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL))
+            {
+                throw GraphicsException("the upload ring has no room for the block textures");
+            }
+        }
+    }
+}
+
+void BlockTextures::CreateSampler()
+{
+    const VkPhysicalDeviceFeatures &features = m_context->GetPhysicalDeviceFeatures();
+
+    // crisp texels up close, filtered mips in the distance
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.anisotropyEnable = features.samplerAnisotropy;
+    samplerInfo.maxAnisotropy = std::min(8.0f, m_context->GetPhysicalDeviceProperties().limits.maxSamplerAnisotropy);
+    samplerInfo.maxLod = static_cast<float>(m_levelCount);
+
+    if (vkCreateSampler(m_context->GetDevice(), &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS)
+        throw GraphicsException("failed to create the block texture sampler");
+}
+
+} // namespace MineClone
@@ -0,0 +1,115 @@
+#include <MineClone/GFX/Camera.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr float MAX_PITCH = 1.55f;
+
+} // namespace
+
+void Camera::SetPosition(float x, float y, float z) noexcept
+{
+    m_x = x;
+    m_y = y;
+    m_z = z;
+}
+
+void Camera::SetRotation(float yaw, float pitch) noexcept
+{
+    m_yaw = std::remainder(yaw, 2.0f * 3.14159265f);
+    m_pitch = std::clamp(pitch, -MAX_PITCH, MAX_PITCH);
+}
+
+void Camera::Rotate(float yaw, float pitch) noexcept
+{
+    SetRotation(m_yaw + yaw, m_pitch + pitch);
+}
+
+void Camera::Move(float forward, float right, float up) noexcept
+{
+    const float sinYaw = std::sin(m_yaw), cosYaw = std::cos(m_yaw);
+
+    m_x += -sinYaw * forward + cosYaw * right;
+    m_y += up;
+    m_z += -cosYaw * forward - sinYaw * right;
+}
+
+void Camera::SetPerspective(float fovY, float nearPlane, float farPlane) noexcept
+{
+    m_fovY = fovY;
+    m_near = nearPlane;
+    m_far = farPlane;
+}
+
+void Camera::SetAspect(float aspect) noexcept
+{
+    m_aspect = aspect;
+}
+
+Camera::Matrix Camera::GetViewProjection() const noexcept
+{
+    const float sinYaw = std::sin(m_yaw), cosYaw = std::cos(m_yaw);
+    const float sinPitch = std::sin(m_pitch), cosPitch = std::cos(m_pitch);
+
+    // view basis: right, up and forward
+    const float fx = -sinYaw * cosPitch, fy = sinPitch, fz = -cosYaw * cosPitch;
+    const float rx = cosYaw, ry = 0.0f, rz = -sinYaw;
+    const float ux = ry * fz - rz * fy, uy = rz * fx - rx * fz, uz = rx * fy - ry * fx;
+
+    const float rp = rx * m_x + ry * m_y + rz * m_z;
+    const float up = ux * m_x + uy * m_y + uz * m_z;
+    const float fp = fx * m_x + fy * m_y + fz * m_z;
+
+    // the projection multiplied into the view matrix, row by row
+    const float focal = 1.0f / std::tan(m_fovY * 0.5f);
+    const float sx = focal / m_aspect, sy = -focal;
+    const float a = m_far / (m_near - m_far), b = m_near * m_far / (m_near - m_far);
+
+    Matrix m{};
+    const auto row = [&m](int index, float x, float y, float z, float w) {
+        m[0 + index] = x;
+        m[4 + index] = y;
+        m[8 + index] = z;
+        m[12 + index] = w;
+    };
+
+    row(0, sx * rx, sx * ry, sx * rz, -sx * rp);
+    row(1, sy * ux, sy * uy, sy * uz, -sy * up);
+    row(2, -a * fx, -a * fy, -a * fz, a * fp + b);
+    row(3, fx, fy, fz, -fp);
+
+    return m;
+}
+
+float Camera::GetX() const noexcept
+{
+    return m_x;
+}
+
+float Camera::GetY() const noexcept
+{
+    return m_y;
+}
+
+float Camera::GetZ() const noexcept
+{
+    return m_z;
+}
+
+float Camera::GetYaw() const noexcept
+{
+    return m_yaw;
+}
+
+float Camera::GetPitch() const noexcept
+{
+    return m_pitch;
+}
+
+} // namespace MineClone
@@ -0,0 +1,531 @@
+#include <MineClone/GFX/ChunkRenderer.hpp>
+
+#include <MineClone/GFX/VulkanContext.hpp>
+
+#include <algorithm>
+#include <array>
+
+namespace MineClone
+{
+
+static_assert(ChunkRenderer::MAX_SECTION_QUADS * 4 <= 0x10000, "quad corners of a section have to fit 16 bit indices");
+
+namespace
+{
+
+// the draw count of a frame sits in front of its commands, padded so the commands start 16 byte aligned
+constexpr VkDeviceSize COUNT_SIZE = 16;
+constexpr VkDeviceSize FRAME_INDIRECT_SIZE = COUNT_SIZE + VkDeviceSize{ChunkRenderer::SECTION_CAPACITY} * sizeof(VkDrawIndexedIndirectCommand);
+
+// world space bounds of the quads, tighter than the section cube for mostly empty or flat sections
+CullSection ComputeCullSection(int32_t x, int32_t y, int32_t z, const ChunkMesh &mesh, uint32_t firstQuad)
+{
+    // u and v axes of the face plane per axis, as in chunk.vert
+    constexpr int U_AXES[3][3] = {{0, 0, 1}, {1, 0, 0}, {1, 0, 0}};
+    constexpr int V_AXES[3][3] = {{0, 1, 0}, {0, 0, 1}, {0, 1, 0}};
+
+    int boundsMin[3] = {ChunkSection::SIZE, ChunkSection::SIZE, ChunkSection::SIZE};
+    int boundsMax[3] = {0, 0, 0};
+
+    for (const ChunkQuad &quad : mesh.Quads)
+    {
+        const int axis = static_cast<int>(quad.GetFace()) >> 1;
+        const int base[3] = {quad.GetX(), quad.GetY(), quad.GetZ()};
+
+        for (int i = 0; i < 3; i++)
+        {
+            boundsMin[i] = std::min(boundsMin[i], base[i]);
+            boundsMax[i] = std::max(boundsMax[i], base[i] + U_AXES[axis][i] * quad.GetWidth() + V_AXES[axis][i] * quad.GetHeight());
+        }
+    }
+
+    const auto originX = static_cast<float>(x * ChunkSection::SIZE);
+    const auto originY = static_cast<float>(y * ChunkSection::SIZE);
+    const auto originZ = static_cast<float>(z * ChunkSection::SIZE);
+
+    CullSection section{};
+    section.MinX = originX + static_cast<float>(boundsMin[0]);
+    section.MinY = originY + static_cast<float>(boundsMin[1]);
+    section.MinZ = originZ + static_cast<float>(boundsMin[2]);
+    section.FirstQuad = firstQuad;
+    section.MaxX = originX + static_cast<float>(boundsMax[0]);
+    section.MaxY = originY + static_cast<float>(boundsMax[1]);
+    section.MaxZ = originZ + static_cast<float>(boundsMax[2]);
+    section.QuadCount = static_cast<uint32_t>(mesh.Quads.size());
+    return section;
+}
+
+} // namespace
+
+ChunkRenderer::~ChunkRenderer()
+{
+    Destroy();
+}
+
+void ChunkRenderer::Create(VulkanContext *context)
+{
+    m_context = context;
+
+    const VkPhysicalDeviceFeatures &features = m_context->GetPhysicalDeviceFeatures();
+    m_indirectDraws = features.multiDrawIndirect && features.drawIndirectFirstInstance;
+
+    if (m_indirectDraws && m_context->IsDeviceExtensionEnabled(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+    {
+        m_drawIndexedIndirectCount =
+            reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(vkGetDeviceProcAddr(m_context->GetDevice(), "vkCmdDrawIndexedIndirectCountKHR"));
+    }
+
+    m_drawCounts.assign(VulkanContext::MAX_FRAMES_IN_FLIGHT, 0);
+
+    CreateDescriptors();
+    CreateBuffers();
+}
+
+void ChunkRenderer::CreateDescriptors()
+{
+    // quads, then section origins, then the block texture array
+    std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+
+    for (uint32_t binding = 0; binding < bindings.size(); binding++)
+    {
+        bindings[binding].binding = binding;
+        bindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[binding].descriptorCount = 1;
+        bindings[binding].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    }
+
+    bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[2].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(m_context->GetDevice(), &layoutInfo, nullptr, &m_descriptorSetLayout) != VK_SUCCESS)
+        throw GraphicsException("failed to create the chunk descriptor set layout");
+
+    const std::array<VkDescriptorPoolSize, 2> poolSizes = {{
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1},
+    }};
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = 1;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+
+    if (vkCreateDescriptorPool(m_context->GetDevice(), &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS)
+        throw GraphicsException("failed to create the chunk descriptor pool");
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &m_descriptorSetLayout;
+
+    if (vkAllocateDescriptorSets(m_context->GetDevice(), &allocInfo, &m_descriptorSet) != VK_SUCCESS)
+        throw GraphicsException("failed to allocate the chunk descriptor set");
+}
+
+void ChunkRenderer::CreateBuffers()
+{
+    MemoryAllocator &allocator = m_context->GetMemoryAllocator();
+
+    VkBufferCreateInfo quadInfo{};
+    quadInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    quadInfo.size = VkDeviceSize{QUAD_CAPACITY} * sizeof(ChunkQuad);
+    quadInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    quadInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    allocator.CreateBuffer(quadInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_quadBuffer, m_quadMemory);
+
+    VkBufferCreateInfo sectionInfo{};
+    sectionInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    sectionInfo.size = VkDeviceSize{SECTION_CAPACITY} * 4 * sizeof(int32_t);
+    sectionInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    sectionInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    allocator.CreateBuffer(sectionInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_sectionBuffer, m_sectionMemory);
+
+    // written by the cpu every frame, small enough that reading it from host memory costs the gpu nothing
+    VkBufferCreateInfo indirectInfo{};
+    indirectInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    indirectInfo.size = FRAME_INDIRECT_SIZE * VulkanContext::MAX_FRAMES_IN_FLIGHT;
+    indirectInfo.usage = VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
+    indirectInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    allocator.CreateBuffer(indirectInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_indirectBuffer,
+                           m_indirectMemory);
+    ASSERT(m_indirectMemory.Mapped != nullptr, "indirect buffer is not host visible");
+
+    // the same six indices per quad, offset by the quad index, every draw starts at index 0
+    std::vector<uint16_t> indices;
+    indices.reserve(MAX_SECTION_QUADS * 6);
+
+    for (uint32_t quad = 0; quad < MAX_SECTION_QUADS; quad++)
+    {
+        const auto base = static_cast<uint16_t>(quad * 4);
+        indices.insert(indices.end(), {base, static_cast<uint16_t>(base + 1), static_cast<uint16_t>(base + 2), static_cast<uint16_t>(base + 2),
+                                       static_cast<uint16_t>(base + 3), base});
+    }
+
+    VkBufferCreateInfo indexInfo{};
+    indexInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    indexInfo.size = indices.size() * sizeof(uint16_t);
+    indexInfo.usage = VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    indexInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    allocator.CreateBuffer(indexInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_indexBuffer, m_indexMemory);
+
+    if (!m_context->GetUploadManager().UploadBuffer(m_indexBuffer, 0, indices.data(), indexInfo.size))
+        throw GraphicsException("failed to upload the quad index buffer");
+
+    const std::array<VkBuffer, 2> buffers = {m_quadBuffer, m_sectionBuffer};
+    std::array<VkDescriptorBufferInfo, 2> bufferInfos{};
+    std::array<VkWriteDescriptorSet, 3> writes{};
+
+    for (uint32_t binding = 0; binding < bufferInfos.size(); binding++)
+    {
+        bufferInfos[binding].buffer = buffers[binding];
+        bufferInfos[binding].offset = 0;
+        bufferInfos[binding].range = VK_WHOLE_SIZE;
+
+        writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        writes[binding].dstSet = m_descriptorSet;
+        writes[binding].dstBinding = binding;
+        writes[binding].descriptorCount = 1;
+        writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        writes[binding].pBufferInfo = &bufferInfos[binding];
+    }
+
+    // created before the renderer, the image is already in its shader read layout once the uploads are submitted
+    BlockTextures &textures = m_context->GetBlockTextures();
+
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.sampler = textures.GetSampler();
+    imageInfo.imageView = textures.GetImageView();
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    writes[2].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writes[2].dstSet = m_descriptorSet;
+    writes[2].dstBinding = 2;
+    writes[2].descriptorCount = 1;
+    writes[2].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writes[2].pImageInfo = &imageInfo;
+
+    vkUpdateDescriptorSets(m_context->GetDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+}
+
+void ChunkRenderer::Destroy()
+{
+    if (m_context == nullptr)
+        return;
+
+    MemoryAllocator &allocator = m_context->GetMemoryAllocator();
+    allocator.DestroyBuffer(m_indirectBuffer, m_indirectMemory);
+    allocator.DestroyBuffer(m_sectionBuffer, m_sectionMemory);
+    allocator.DestroyBuffer(m_indexBuffer, m_indexMemory);
+    allocator.DestroyBuffer(m_quadBuffer, m_quadMemory);
+
+    for (const SectionDraw &draw : m_draws)
+    {
+        if (draw.Block != TlsfHeap::INVALID_BLOCK)
+            m_quadHeap.Free(draw.Block);
+    }
+
+    for (const RetiredSection &retired : m_retired)
+    {
+        if (retired.Block != TlsfHeap::INVALID_BLOCK)
+            m_quadHeap.Free(retired.Block);
+    }
+
+    // destroying the pool frees the set as well
+    if (m_descriptorPool != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorPool(m_context->GetDevice(), m_descriptorPool, nullptr);
+        m_descriptorPool = VK_NULL_HANDLE;
+        m_descriptorSet = VK_NULL_HANDLE;
+    }
+
+    if (m_descriptorSetLayout != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorSetLayout(m_context->GetDevice(), m_descriptorSetLayout, nullptr);
+        m_descriptorSetLayout = VK_NULL_HANDLE;
+    }
+
+    m_quadCount = 0;
+    m_draws.clear();
+    m_retired.clear();
+    m_frameCount = 0;
+    m_visibility.Clear();
+    m_visible.clear();
+    m_drawCounts.clear();
+    m_indirectDraws = false;
+    m_drawIndexedIndirectCount = nullptr;
+    m_context = nullptr;
+}
+
+bool ChunkRenderer::AddSection(int32_t x, int32_t y, int32_t z, const ChunkMesh &mesh, SectionConnectivity connectivity)
+{
+    ASSERT(mesh.Quads.size() <= MAX_SECTION_QUADS, "section mesh exceeds the shared index buffer");
+
+    if (m_visibility.GetSectionCount() + m_retired.size() >= SECTION_CAPACITY)
+        return false;
+
+    const auto quadCount = static_cast<uint32_t>(mesh.Quads.size());
+    SectionDraw draw{x, y, z, 0, quadCount, TlsfHeap::INVALID_BLOCK};
+
+    if (quadCount != 0)
+    {
+        TlsfHeap::Allocation allocation{};
+        if (!m_quadHeap.Allocate(quadCount, 1, allocation))
+            return false;
+
+        draw.FirstQuad = static_cast<uint32_t>(allocation.Offset);
+        draw.Block = allocation.Block;
+    }
+
+    // an origin queued for a section that then fails is harmless, the slot is written again by the retry
+    UploadManager &uploads = m_context->GetUploadManager();
+    const int32_t origin[4] = {x * ChunkSection::SIZE, y * ChunkSection::SIZE, z * ChunkSection::SIZE, 0};
+
+    const uint32_t index = m_visibility.Add(x, y, z, connectivity);
+
+    if (!uploads.UploadBuffer(m_sectionBuffer, index * sizeof(origin), origin, sizeof(origin)) ||
+        (quadCount != 0 && !uploads.UploadBuffer(m_quadBuffer, VkDeviceSize{draw.FirstQuad} * sizeof(ChunkQuad), mesh.Quads.data(),
+                                                 quadCount * sizeof(ChunkQuad))) ||
+        !m_context->GetGpuCulling().SetSection(index, ComputeCullSection(x, y, z, mesh, draw.FirstQuad)))
+    {
+        // the index was never drawn, it can be reused right away
+        m_visibility.Remove(index);
+        m_visibility.Release(index);
+
+        if (draw.Block != TlsfHeap::INVALID_BLOCK)
+            m_quadHeap.Free(draw.Block);
+
+        return false;
+    }
+
+    if (index == m_draws.size())
+        m_draws.push_back(draw);
+    else
+        m_draws[index] = draw;
+
+    m_quadCount += quadCount;
+    return true;
+}
+
+void ChunkRenderer::RemoveSection(int32_t x, int32_t y, int32_t z)
+{
+    const uint32_t index = m_visibility.Find(x, y, z);
+
+    if (index == SectionVisibility::INVALID)
+        return;
+
+    m_visibility.Remove(index);
+
+    // the cpu pass skips it from now on, the culling pass once the cleared bounds are uploaded
+    SectionDraw &draw = m_draws[index];
+    const bool hidden = m_context->GetGpuCulling().SetSection(index, CullSection{});
+    m_retired.push_back({index, draw.Block, hidden, m_frameCount + VulkanContext::MAX_FRAMES_IN_FLIGHT});
+
+    m_quadCount -= draw.QuadCount;
+    draw.QuadCount = 0;
+    draw.Block = TlsfHeap::INVALID_BLOCK;
+}
+
+void ChunkRenderer::ReleaseRetiredSections()
+{
+    m_frameCount++;
+
+    // A section removed after frame n was recorded is drawn by frame n at the latest. When this runs for frame
+    // n + MAX_FRAMES_IN_FLIGHT, the fence of frame n has signaled.
+    size_t kept = 0;
+
+    for (RetiredSection &retired : m_retired)
+    {
+        if (!retired.Hidden)
+        {
+            retired.Hidden = m_context->GetGpuCulling().SetSection(retired.Index, CullSection{});
+            retired.ReleaseFrame = m_frameCount + VulkanContext::MAX_FRAMES_IN_FLIGHT;
+        }
+        else if (m_frameCount >= retired.ReleaseFrame)
+        {
+            if (retired.Block != TlsfHeap::INVALID_BLOCK)
+                m_quadHeap.Free(retired.Block);
+
+            m_visibility.Release(retired.Index);
+            continue;
+        }
+
+        m_retired[kept++] = retired;
+    }
+
+    m_retired.resize(kept);
+}
+
+void ChunkRenderer::UpdateVisibility(const Camera &camera, size_t frame)
+{
+    ReleaseRetiredSections();
+
+    // the culling pass writes its own draw list
+    if (m_context->GetGpuCulling().IsActive())
+        return;
+
+    m_visibility.Update(camera, m_visible);
+
+    const VisibilityStatistics &statistics = m_visibility.GetStatistics();
+    m_visibilityUpdates++;
+    m_inFrustumTotal += statistics.InFrustum;
+    m_visibleTotal += statistics.Visible;
+
+    // the fence of this frame has been waited on, the gpu is done reading its commands
+    char *mapped = static_cast<char *>(m_indirectMemory.Mapped);
+    auto *commands = reinterpret_cast<VkDrawIndexedIndirectCommand *>(mapped + GetCommandOffset(frame));
+    uint32_t drawCount = 0;
+
+    // firstInstance picks the section origin, the vertex offset moves gl_VertexIndex to the first quad
+    for (const uint32_t section : m_visible)
+    {
+        const SectionDraw &draw = m_draws[section];
+        if (draw.QuadCount != 0)
+            commands[drawCount++] = {draw.QuadCount * 6, 1, 0, static_cast<int32_t>(draw.FirstQuad * 4), section};
+    }
+
+    *reinterpret_cast<uint32_t *>(mapped + GetCountOffset(frame)) = drawCount;
+    m_drawCounts[frame] = drawCount;
+}
+
+uint32_t ChunkRenderer::GetBatchCount(size_t frame) const noexcept
+{
+    if (m_context->GetGpuCulling().IsActive())
+        return m_draws.empty() ? 0 : 1;
+
+    if (m_drawCounts[frame] == 0)
+        return 0;
+
+    // a single indirect call has nothing to split
+    if (m_drawIndexedIndirectCount != nullptr || m_indirectDraws)
+        return 1;
+
+    return static_cast<uint32_t>((m_visible.size() + DRAWS_PER_BATCH - 1) / DRAWS_PER_BATCH);
+}
+
+void ChunkRenderer::RecordBatch(VkCommandBuffer commandBuffer, const Camera &camera, size_t frame, uint32_t batch) const
+{
+    GpuCulling &gpuCulling = m_context->GetGpuCulling();
+    const bool gpuCulled = gpuCulling.IsActive();
+    const uint32_t drawCount = m_drawCounts[frame];
+
+    PipelineManager &pipelines = m_context->GetPipelineManager();
+    const VkPipelineLayout layout = pipelines.GetPipelineLayout();
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelines.GetPipeline());
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &m_descriptorSet, 0, nullptr);
+    vkCmdBindIndexBuffer(commandBuffer, m_indexBuffer, 0, VK_INDEX_TYPE_UINT16);
+
+    PushConstants constants{};
+    constants.ViewProjection = camera.GetViewProjection();
+
+    vkCmdPushConstants(commandBuffer, layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+
+    const uint32_t maxDrawCount = std::min(SECTION_CAPACITY, m_context->GetPhysicalDeviceProperties().limits.maxDrawIndirectCount);
+    constexpr auto STRIDE = static_cast<uint32_t>(sizeof(VkDrawIndexedIndirectCommand));
+
+    if (gpuCulled)
+    {
+        VkBuffer drawBuffer = gpuCulling.GetDrawBuffer();
+        m_drawIndexedIndirectCount(commandBuffer, drawBuffer, gpuCulling.GetCommandOffset(frame), drawBuffer, gpuCulling.GetCountOffset(frame),
+                                   maxDrawCount, STRIDE);
+    }
+    else if (m_drawIndexedIndirectCount != nullptr)
+    {
+        // the count is read from the buffer, a gpu culling pass can write it without the cpu knowing
+        m_drawIndexedIndirectCount(commandBuffer, m_indirectBuffer, GetCommandOffset(frame), m_indirectBuffer, GetCountOffset(frame), maxDrawCount,
+                                   STRIDE);
+    }
+    else if (m_indirectDraws)
+    {
+        for (uint32_t first = 0; first < drawCount; first += maxDrawCount)
+        {
+            vkCmdDrawIndexedIndirect(commandBuffer, m_indirectBuffer, GetCommandOffset(frame) + VkDeviceSize{first} * STRIDE,
+                                     std::min(maxDrawCount, drawCount - first), STRIDE);
+        }
+    }
+    else
+    {
+        const size_t first = size_t{batch} * DRAWS_PER_BATCH;
+        const size_t last = std::min(first + DRAWS_PER_BATCH, m_visible.size());
+
+        for (size_t i = first; i < last; i++)
+        {
+            const uint32_t section = m_visible[i];
+            const SectionDraw &draw = m_draws[section];
+            if (draw.QuadCount != 0)
+                vkCmdDrawIndexed(commandBuffer, draw.QuadCount * 6, 1, 0, static_cast<int32_t>(draw.FirstQuad * 4), section);
+        }
+    }
+}
+
+void ChunkRenderer::Dump(std::ostream &stream) const
+{
+    const char *mode = m_drawIndexedIndirectCount != nullptr ? "indirect count" : m_indirectDraws ? "multi draw indirect" : "direct draws";
+
+    stream << "chunk renderer: " << GetSectionCount() << " sections, " << m_quadCount << " quads in " << m_quadHeap.GetFreeRangeCount()
+           << " free ranges, largest " << m_quadHeap.GetLargestFreeRange() << " quads (" << mode << ")\n";
+
+    if (m_visibilityUpdates == 0)
+        return;
+
+    const auto average = [this](uint64_t total) {
+        return static_cast<double>(total) / static_cast<double>(m_visibilityUpdates);
+    };
+
+    stream << "  visibility: " << average(m_inFrustumTotal) << " sections in the frustum, " << average(m_visibleTotal) << " visible on average over "
+           << m_visibilityUpdates << " frames (occlusion culling " << (m_visibility.IsOcclusionCullingEnabled() ? "on" : "off") << ")\n";
+    stream.flush();
+}
+
+SectionVisibility &ChunkRenderer::GetVisibility() noexcept
+{
+    return m_visibility;
+}
+
+VkDescriptorSetLayout ChunkRenderer::GetDescriptorSetLayout() noexcept
+{
+    return m_descriptorSetLayout;
+}
+
+size_t ChunkRenderer::GetSectionCount() const noexcept
+{
+    return m_visibility.GetSectionCount();
+}
+
+size_t ChunkRenderer::GetQuadCount() const noexcept
+{
+    return m_quadCount;
+}
+
+bool ChunkRenderer::UsesIndirectDraws() const noexcept
+{
+    return m_indirectDraws;
+}
+
+bool ChunkRenderer::UsesIndirectCount() const noexcept
+{
+    return m_drawIndexedIndirectCount != nullptr;
+}
+
+VkDeviceSize ChunkRenderer::GetCountOffset(size_t frame) const noexcept
+{
+    return FRAME_INDIRECT_SIZE * frame;
+}
+
+VkDeviceSize ChunkRenderer::GetCommandOffset(size_t frame) const noexcept
+{
+    return FRAME_INDIRECT_SIZE * frame + COUNT_SIZE;
+}
+
+} // namespace MineClone
@@ -0,0 +1,138 @@
+#include <MineClone/GFX/CommandPools.hpp>
+
+#include <MineClone/GFX/VulkanContext.hpp>
+
+namespace MineClone
+{
+
+CommandPools::~CommandPools()
+{
+    Destroy();
+}
+
+void CommandPools::Create(VulkanContext *context, size_t frameCount, size_t threadCount)
+{
+    ASSERT(frameCount != 0 && threadCount != 0, "command pools need at least one frame and one thread");
+
+    m_context = context;
+    m_threadCount = threadCount;
+    m_pools.resize(frameCount * threadCount);
+    m_primaries.resize(frameCount);
+
+    VkDevice device = m_context->GetDevice();
+
+    // buffers are only ever reset together with their pool
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = *m_context->GetQueueFamilyIndices().GraphicsFamily;
+
+    for (ThreadPool &pool : m_pools)
+    {
+        if (vkCreateCommandPool(device, &poolInfo, nullptr, &pool.Pool) != VK_SUCCESS)
+            throw GraphicsException("failed to create command pool!");
+    }
+
+    for (size_t frame = 0; frame < frameCount; frame++)
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = GetPool(frame, 0).Pool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(device, &allocInfo, &m_primaries[frame]) != VK_SUCCESS)
+            throw GraphicsException("failed to allocate command buffers!");
+    }
+}
+
+void CommandPools::Destroy()
+{
+    if (m_context == nullptr)
+        return;
+
+    // destroying a pool frees its command buffers as well
+    for (ThreadPool &pool : m_pools)
+    {
+        if (pool.Pool != VK_NULL_HANDLE)
+            vkDestroyCommandPool(m_context->GetDevice(), pool.Pool, nullptr);
+    }
+
+    m_pools.clear();
+    m_primaries.clear();
+    m_threadCount = 0;
+    m_resets = m_secondariesUsed = 0;
+    m_context = nullptr;
+}
+
+void CommandPools::Reset(size_t frame)
+{
+    for (size_t thread = 0; thread < m_threadCount; thread++)
+    {
+        ThreadPool &pool = GetPool(frame, thread);
+
+        if (vkResetCommandPool(m_context->GetDevice(), pool.Pool, 0) != VK_SUCCESS)
+            throw GraphicsException("failed to reset command pool!");
+
+        m_secondariesUsed += pool.Used;
+        pool.Used = 0;
+    }
+
+    m_resets++;
+}
+
+VkCommandBuffer CommandPools::GetPrimary(size_t frame) noexcept
+{
+    return m_primaries[frame];
+}
+
+VkCommandBuffer CommandPools::AllocateSecondary(size_t frame, size_t thread)
+{
+    ASSERT(thread < m_threadCount, "no command pool for this thread");
+
+    ThreadPool &pool = GetPool(frame, thread);
+
+    if (pool.Used == pool.Secondaries.size())
+    {
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = pool.Pool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        allocInfo.commandBufferCount = 1;
+
+        VkCommandBuffer commandBuffer;
+        if (vkAllocateCommandBuffers(m_context->GetDevice(), &allocInfo, &commandBuffer) != VK_SUCCESS)
+            throw GraphicsException("failed to allocate command buffers!");
+
+        pool.Secondaries.push_back(commandBuffer);
+    }
+
+    return pool.Secondaries[pool.Used++];
+}
+
+void CommandPools::Dump(std::ostream &stream) const
+{
+    size_t allocated = 0;
+    for (const ThreadPool &pool : m_pools)
+        allocated += pool.Secondaries.size();
+
+    stream << "command pools: " << m_pools.size() << " pools for " << m_threadCount << " threads, " << allocated << " secondary buffers";
+
+    if (m_resets != 0)
+        stream << ", " << static_cast<double>(m_secondariesUsed) / static_cast<double>(m_resets) << " used per frame on average";
+
+    stream << "\n";
+    stream.flush();
+}
+
+size_t CommandPools::GetThreadCount() const noexcept
+{
+    return m_threadCount;
+}
+
+CommandPools::ThreadPool &CommandPools::GetPool(size_t frame, size_t thread) noexcept
+{
+    return m_pools[frame * m_threadCount + thread];
+}
+
+} // namespace MineClone
@@ -0,0 +1,216 @@
+#include <MineClone/GFX/CullingReference.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace MineClone
+{
+
+namespace
+{
+
+// corners closer to the camera plane than this make the projected rectangle meaningless
+constexpr float NEAR_EPSILON = 1e-4f;
+
+bool InsideFrustum(const CullParameters &parameters, const CullSection &section) noexcept
+{
+    for (const Frustum::Plane &plane : parameters.Planes)
+    {
+        const float x = plane.X >= 0.0f ? section.MaxX : section.MinX;
+        const float y = plane.Y >= 0.0f ? section.MaxY : section.MinY;
+        const float z = plane.Z >= 0.0f ? section.MaxZ : section.MinZ;
+
+        if (plane.X * x + plane.Y * y + plane.Z * z + plane.W < 0.0f)
+            return false;
+    }
+
+    return true;
+}
+
+bool Occluded(const CullParameters &parameters, const CullSection &section, const DepthPyramid &pyramid) noexcept
+{
+    const Camera::Matrix &m = parameters.OcclusionViewProjection;
+
+    float minU = 1.0f, minV = 1.0f, maxU = 0.0f, maxV = 0.0f;
+    float nearest = 1.0f;
+
+    for (int corner = 0; corner < 8; corner++)
+    {
+        const float x = (corner & 1) != 0 ? section.MaxX : section.MinX;
+        const float y = (corner & 2) != 0 ? section.MaxY : section.MinY;
+        const float z = (corner & 4) != 0 ? section.MaxZ : section.MinZ;
+
+        const float clipX = m[0] * x + m[4] * y + m[8] * z + m[12];
+        const float clipY = m[1] * x + m[5] * y + m[9] * z + m[13];
+        const float clipZ = m[2] * x + m[6] * y + m[10] * z + m[14];
+        const float clipW = m[3] * x + m[7] * y + m[11] * z + m[15];
+
+        // a corner behind the camera, the box is too close to tell
+        if (clipW <= NEAR_EPSILON)
+            return false;
+
+        const float u = clipX / clipW * 0.5f + 0.5f;
+        const float v = clipY / clipW * 0.5f + 0.5f;
+
+        minU = std::min(minU, u);
+        minV = std::min(minV, v);
+        maxU = std::max(maxU, u);
+        maxV = std::max(maxV, v);
+        nearest = std::min(nearest, clipZ / clipW);
+    }
+
+    // outside of the previous view there is no depth to test against
+    if (minU > 1.0f || minV > 1.0f || maxU < 0.0f || maxV < 0.0f)
+        return false;
+
+    minU = std::clamp(minU, 0.0f, 1.0f);
+    minV = std::clamp(minV, 0.0f, 1.0f);
+    maxU = std::clamp(maxU, 0.0f, 1.0f);
+    maxV = std::clamp(maxV, 0.0f, 1.0f);
+
+    const auto width = static_cast<float>(pyramid.GetWidth());
+    const auto height = static_cast<float>(pyramid.GetHeight());
+
+    // the level where the rectangle spans at most two texels per axis, in integers so the shader picks the same one
+    const auto extent = static_cast<uint32_t>(std::ceil(std::max((maxU - minU) * width, (maxV - minV) * height)));
+    uint32_t level = 0;
+
+    while (level + 1 < pyramid.GetLevelCount() && (1u << level) < extent)
+        level++;
+
+    const uint32_t levelWidth = DepthPyramid::LevelSize(pyramid.GetWidth(), level);
+    const uint32_t levelHeight = DepthPyramid::LevelSize(pyramid.GetHeight(), level);
+
+    const uint32_t x0 = std::min(static_cast<uint32_t>(minU * width) >> level, levelWidth - 1);
+    const uint32_t x1 = std::min(static_cast<uint32_t>(maxU * width) >> level, levelWidth - 1);
+    const uint32_t y0 = std::min(static_cast<uint32_t>(minV * height) >> level, levelHeight - 1);
+    const uint32_t y1 = std::min(static_cast<uint32_t>(maxV * height) >> level, levelHeight - 1);
+
+    float farthest = 0.0f;
+
+    for (uint32_t y = y0; y <= y1; y++)
+    {
+        for (uint32_t x = x0; x <= x1; x++)
+            farthest = std::max(farthest, pyramid.Fetch(level, x, y));
+    }
+
+    return nearest > farthest;
+}
+
+} // namespace
+
+uint32_t DepthPyramid::LevelCount(uint32_t width, uint32_t height) noexcept
+{
+    uint32_t levels = 1;
+
+    while ((std::max(width, height) >> levels) != 0)
+        levels++;
+
+    return levels;
+}
+
+uint32_t DepthPyramid::LevelSize(uint32_t size, uint32_t level) noexcept
+{
+    return ((size - 1) >> level) + 1;
+}
+
+size_t DepthPyramid::TexelCount(uint32_t width, uint32_t height) noexcept
+{
+    size_t count = 0;
+
+    for (uint32_t level = 0; level < LevelCount(width, height); level++)
+        count += size_t{LevelSize(width, level)} * LevelSize(height, level);
+
+    return count;
+}
+
+void DepthPyramid::Resize(uint32_t width, uint32_t height)
+{
+    m_width = width;
+    m_height = height;
+    m_levelOffsets.clear();
+
+    size_t offset = 0;
+
+    for (uint32_t level = 0; level < LevelCount(width, height); level++)
+    {
+        m_levelOffsets.push_back(offset);
+        offset += size_t{LevelSize(width, level)} * LevelSize(height, level);
+    }
+
+    m_texels.resize(offset);
+}
+
+void DepthPyramid::Build(const float *depth, uint32_t width, uint32_t height)
+{
+    Resize(width, height);
+    std::copy(depth, depth + size_t{width} * height, m_texels.begin());
+
+    for (uint32_t level = 1; level < m_levelOffsets.size(); level++)
+    {
+        const uint32_t sourceWidth = LevelSize(width, level - 1), sourceHeight = LevelSize(height, level - 1);
+        const uint32_t levelWidth = LevelSize(width, level), levelHeight = LevelSize(height, level);
+
+        const float *source = m_texels.data() + m_levelOffsets[level - 1];
+        float *destination = m_texels.data() + m_levelOffsets[level];
+
+        // odd edges clamp onto a texel of the same footprint
+        for (uint32_t y = 0; y < levelHeight; y++)
+        {
+            const uint32_t y0 = 2 * y, y1 = std::min(2 * y + 1, sourceHeight - 1);
+
+            for (uint32_t x = 0; x < levelWidth; x++)
+            {
+                const uint32_t x0 = 2 * x, x1 = std::min(2 * x + 1, sourceWidth - 1);
+
+                destination[y * levelWidth + x] = std::max(std::max(source[y0 * sourceWidth + x0], source[y0 * sourceWidth + x1]),
+                                                           std::max(source[y1 * sourceWidth + x0], source[y1 * sourceWidth + x1]));
+            }
+        }
+    }
+}
+
+void DepthPyramid::Assign(const float *levels, uint32_t width, uint32_t height)
+{
+    Resize(width, height);
+    std::copy(levels, levels + m_texels.size(), m_texels.begin());
+}
+
+float DepthPyramid::Fetch(uint32_t level, uint32_t x, uint32_t y) const noexcept
+{
+    return m_texels[m_levelOffsets[level] + size_t{y} * LevelSize(m_width, level) + x];
+}
+
+uint32_t DepthPyramid::GetWidth() const noexcept
+{
+    return m_width;
+}
+
+uint32_t DepthPyramid::GetHeight() const noexcept
+{
+    return m_height;
+}
+
+uint32_t DepthPyramid::GetLevelCount() const noexcept
+{
+    return static_cast<uint32_t>(m_levelOffsets.size());
+}
+
+bool IsSectionVisible(const CullParameters &parameters, const CullSection &section, const DepthPyramid *pyramid) noexcept
+{
+    if (section.QuadCount == 0 || !InsideFrustum(parameters, section))
+        return false;
+
+    return (parameters.Flags & CullParameters::OCCLUSION) == 0 || pyramid == nullptr || !Occluded(parameters, section, *pyramid);
+}
+
+void CullSections(const CullParameters &parameters, const CullSection *sections, const DepthPyramid *pyramid, std::vector<uint32_t> &visible)
+{
+    for (uint32_t index = 0; index < parameters.SectionCount; index++)
+    {
+        if (IsSectionVisible(parameters, sections[index], pyramid))
+            visible.push_back(index);
+    }
+}
+
+} // namespace MineClone
@@ -0,0 +1,130 @@
+#include <MineClone/GFX/FrameLimiter.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <thread>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr std::array<const char *, static_cast<size_t>(LatencyMode::Count)> LATENCY_MODE_NAMES = {"low-latency", "throughput", "power-saving"};
+
+// short enough that the last step overshoots little, long enough that the thread really sleeps
+constexpr std::chrono::microseconds SLEEP_STEP{1000};
+
+} // namespace
+
+LatencySettings GetLatencyModeSettings(LatencyMode mode, double frameRateCap)
+{
+    switch (mode)
+    {
+    case LatencyMode::LowLatency:
+        // one frame in flight shortens input to photon by a frame, cpu and gpu no longer overlap in exchange
+        return {{VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR}, 1, frameRateCap};
+    case LatencyMode::PowerSaving:
+        return {{VK_PRESENT_MODE_FIFO_KHR}, 2, frameRateCap > 0.0 ? frameRateCap : POWER_SAVING_FRAME_RATE};
+    default:
+        return {{VK_PRESENT_MODE_MAILBOX_KHR}, 2, frameRateCap};
+    }
+}
+
+const char *GetLatencyModeName(LatencyMode mode) noexcept
+{
+    return LATENCY_MODE_NAMES[static_cast<size_t>(mode)];
+}
+
+bool ParseLatencyMode(const std::string &name, LatencyMode &mode) noexcept
+{
+    const auto found = std::find(LATENCY_MODE_NAMES.begin(), LATENCY_MODE_NAMES.end(), name);
+    if (found == LATENCY_MODE_NAMES.end())
+        return false;
+
+    mode = static_cast<LatencyMode>(found - LATENCY_MODE_NAMES.begin());
+    return true;
+}
+
+void FrameLimiter::SetFrameRate(double frameRate) noexcept
+{
+    if (frameRate == m_frameRate)
+        return;
+
+    m_frameRate = std::max(frameRate, 0.0);
+    m_period = m_frameRate > 0.0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_frameRate)) : Clock::duration{};
+
+    // the next Wait starts a new schedule
+    m_next = {};
+}
+
+void FrameLimiter::Wait()
+{
+    if (m_frameRate <= 0.0)
+        return;
+
+    const Clock::time_point now = Clock::now();
+
+    // behind by more than a frame, after a hitch, the schedule restarts instead of rushing to catch up
+    if (m_next == Clock::time_point{} || now > m_next + m_period)
+    {
+        m_next = now + m_period;
+        return;
+    }
+
+    SleepUntil(m_next);
+
+    const Clock::time_point woken = Clock::now();
+    m_frames++;
+    m_overshootTotal += std::chrono::duration<double>(woken - m_next).count();
+    m_sleptTotal += std::chrono::duration<double>(woken - now).count();
+
+    m_next += m_period;
+}
+
+void FrameLimiter::SleepUntil(Clock::time_point deadline)
+{
+    while (true)
+    {
+        const Clock::time_point start = Clock::now();
+        const double remaining = std::chrono::duration<double>(deadline - start).count();
+
+        // a step usually takes about the mean, rarely more than a standard deviation longer
+        const double estimate = m_sleepMean + std::sqrt(m_sleepM2 / static_cast<double>(m_sleepCount));
+        if (remaining <= estimate)
+            break;
+
+        std::this_thread::sleep_for(SLEEP_STEP);
+
+        const double observed = std::chrono::duration<double>(Clock::now() - start).count();
+        const double delta = observed - m_sleepMean;
+        m_sleepCount++;
+        m_sleepMean += delta / static_cast<double>(m_sleepCount);
+        m_sleepM2 += delta * (observed - m_sleepMean);
+    }
+
+    // yield instead of a pure spin, the render thread may share its core with a worker
+    while (Clock::now() < deadline)
+        std::this_thread::yield();
+}
+
+void FrameLimiter::Dump(std::ostream &stream) const
+{
+    if (m_frames == 0)
+        return;
+
+    const auto frames = static_cast<double>(m_frames);
+
+    stream << "frame limiter: " << m_frameRate << " fps cap, " << m_sleptTotal * 1000.0 / frames << " ms waited and "
+           << m_overshootTotal * 1000000.0 / frames << " us late per frame on average over " << m_frames << " frames, sleep step "
+           << m_sleepMean * 1000.0 << " ms\n";
+    stream.flush();
+}
+
+double FrameLimiter::GetFrameRate() const noexcept
+{
+    return m_frameRate;
+}
+
+} // namespace MineClone
@@ -0,0 +1,211 @@
+#include <MineClone/GFX/FrameProfiler.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+#include <MineClone/GFX/VulkanContext.hpp>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr uint32_t QUERIES_PER_TIMER = 2;
+constexpr uint32_t QUERIES_PER_FRAME = static_cast<uint32_t>(GpuTimer::Count) * QUERIES_PER_TIMER;
+
+constexpr std::array<const char *, static_cast<size_t>(CpuTimer::Count)> CPU_TIMER_NAMES = {"limiter", "fence wait", "acquire", "visibility",
+                                                                                              "record",  "submit",     "present"};
+constexpr std::array<const char *, static_cast<size_t>(GpuTimer::Count)> GPU_TIMER_NAMES = {"render pass"};
+
+void DumpStatistics(std::ostream &stream, const char *type, const char *name, const TimingStatistics &statistics)
+{
+    if (statistics.Samples == 0)
+        return;
+
+    stream << "  " << type << " " << std::left << std::setw(12) << name << std::right << " min " << std::setw(8) << statistics.Min << " ms  avg "
+           << std::setw(8) << statistics.Average << " ms  p99 " << std::setw(8) << statistics.P99 << " ms  (" << statistics.Samples
+           << " samples)\n";
+}
+
+} // namespace
+
+void RollingSamples::Add(double value) noexcept
+{
+    m_samples[m_next] = value;
+    m_next = (m_next + 1) % CAPACITY;
+    m_count = std::min(m_count + 1, CAPACITY);
+}
+
+TimingStatistics RollingSamples::Compute() const
+{
+    TimingStatistics statistics{};
+    statistics.Samples = m_count;
+
+    if (m_count == 0)
+        return statistics;
+
+    std::array<double, CAPACITY> sorted = m_samples;
+    std::sort(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(m_count));
+
+    double sum = 0.0;
+    for (size_t i = 0; i < m_count; i++)
+        sum += sorted[i];
+
+    const size_t p99Index = static_cast<size_t>(std::ceil(0.99 * static_cast<double>(m_count))) - 1;
+
+    statistics.Min = sorted[0];
+    statistics.Average = sum / static_cast<double>(m_count);
+    statistics.P99 = sorted[p99Index];
+    return statistics;
+}
+
+FrameProfiler::ScopedTimer::ScopedTimer(FrameProfiler &profiler, CpuTimer timer) noexcept
+    : m_profiler{profiler}, m_timer{timer}, m_start{std::chrono::steady_clock::now()}
+{
+}
+
+FrameProfiler::ScopedTimer::~ScopedTimer()
+{
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - m_start;
+    m_profiler.AddSample(m_timer, elapsed.count());
+}
+
+FrameProfiler::~FrameProfiler()
+{
+    Destroy();
+}
+
+void FrameProfiler::Create(VulkanContext *context)
+{
+    Destroy();
+    m_context = context;
+    m_pendingQueries.assign(VulkanContext::MAX_FRAMES_IN_FLIGHT, false);
+
+    // queues without valid timestamp bits can't be timed, only the cpu timers are collected then
+    const std::vector<VkQueueFamilyProperties> queueFamilies =
+        VulkanEnumerate<VkQueueFamilyProperties>(&vkGetPhysicalDeviceQueueFamilyProperties, m_context->GetPhysicalDevice());
+
+    const uint32_t validBits = queueFamilies[*m_context->GetQueueFamilyIndices().GraphicsFamily].timestampValidBits;
+
+    if (validBits == 0)
+        return;
+
+    m_timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+    m_timestampPeriod = static_cast<double>(m_context->GetPhysicalDeviceProperties().limits.timestampPeriod);
+
+    VkQueryPoolCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    createInfo.queryCount = QUERIES_PER_FRAME * static_cast<uint32_t>(VulkanContext::MAX_FRAMES_IN_FLIGHT);
+
+    if (vkCreateQueryPool(m_context->GetDevice(), &createInfo, nullptr, &m_queryPool) != VK_SUCCESS)
+        throw GraphicsException("failed to create timestamp query pool");
+}
+
+void FrameProfiler::Destroy()
+{
+    if (m_context == nullptr)
+        return;
+
+    if (m_queryPool != VK_NULL_HANDLE)
+    {
+        vkDestroyQueryPool(m_context->GetDevice(), m_queryPool, nullptr);
+        m_queryPool = VK_NULL_HANDLE;
+    }
+
+    m_pendingQueries.clear();
+}
+
+FrameProfiler::ScopedTimer FrameProfiler::Time(CpuTimer timer) noexcept
+{
+    return ScopedTimer{*this, timer};
+}
+
+void FrameProfiler::AddSample(CpuTimer timer, double milliseconds) noexcept
+{
+    m_cpuSamples[static_cast<size_t>(timer)].Add(milliseconds);
+}
+
+void FrameProfiler::ResetQueries(VkCommandBuffer commandBuffer, size_t frame)
+{
+    if (m_queryPool == VK_NULL_HANDLE)
+        return;
+
+    vkCmdResetQueryPool(commandBuffer, m_queryPool, QueryIndex(frame, static_cast<GpuTimer>(0)), QUERIES_PER_FRAME);
+    m_pendingQueries[frame] = true;
+}
+
+void FrameProfiler::BeginGpuTimer(VkCommandBuffer commandBuffer, size_t frame, GpuTimer timer)
+{
+    if (m_queryPool != VK_NULL_HANDLE)
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_queryPool, QueryIndex(frame, timer));
+}
+
+void FrameProfiler::EndGpuTimer(VkCommandBuffer commandBuffer, size_t frame, GpuTimer timer)
+{
+    if (m_queryPool != VK_NULL_HANDLE)
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_queryPool, QueryIndex(frame, timer) + 1);
+}
+
+void FrameProfiler::CollectGpuResults(size_t frame)
+{
+    if (m_queryPool == VK_NULL_HANDLE || !m_pendingQueries[frame])
+        return;
+
+    std::array<uint64_t, QUERIES_PER_FRAME> timestamps{};
+
+    // no wait bit, the fence already guarantees the results are available
+    const VkResult result =
+        vkGetQueryPoolResults(m_context->GetDevice(), m_queryPool, QueryIndex(frame, static_cast<GpuTimer>(0)), QUERIES_PER_FRAME,
+                              sizeof(timestamps), timestamps.data(), sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+    if (result != VK_SUCCESS)
+        return;
+
+    m_pendingQueries[frame] = false;
+
+    for (size_t timer = 0; timer < static_cast<size_t>(GpuTimer::Count); timer++)
+    {
+        const uint64_t begin = timestamps[timer * QUERIES_PER_TIMER] & m_timestampMask;
+        const uint64_t end = timestamps[timer * QUERIES_PER_TIMER + 1] & m_timestampMask;
+        const uint64_t ticks = (end - begin) & m_timestampMask;
+
+        m_gpuSamples[timer].Add(static_cast<double>(ticks) * m_timestampPeriod / 1'000'000.0);
+    }
+}
+
+TimingStatistics FrameProfiler::GetStatistics(CpuTimer timer) const
+{
+    return m_cpuSamples[static_cast<size_t>(timer)].Compute();
+}
+
+TimingStatistics FrameProfiler::GetStatistics(GpuTimer timer) const
+{
+    return m_gpuSamples[static_cast<size_t>(timer)].Compute();
+}
+
+void FrameProfiler::Dump(std::ostream &stream) const
+{
+    const std::ios::fmtflags flags = stream.flags();
+    stream << std::fixed << std::setprecision(3);
+
+    stream << "frame timings (last " << RollingSamples::CAPACITY << " frames):\n";
+
+    for (size_t timer = 0; timer < static_cast<size_t>(CpuTimer::Count); timer++)
+        DumpStatistics(stream, "cpu", CPU_TIMER_NAMES[timer], m_cpuSamples[timer].Compute());
+
+    for (size_t timer = 0; timer < static_cast<size_t>(GpuTimer::Count); timer++)
+        DumpStatistics(stream, "gpu", GPU_TIMER_NAMES[timer], m_gpuSamples[timer].Compute());
+
+    stream.flush();
+    stream.flags(flags);
+}
+
+uint32_t FrameProfiler::QueryIndex(size_t frame, GpuTimer timer) const noexcept
+{
+    return static_cast<uint32_t>(frame) * QUERIES_PER_FRAME + static_cast<uint32_t>(timer) * QUERIES_PER_TIMER;
+}
+
+} // namespace MineClone
@@ -0,0 +1,89 @@
+#include <MineClone/GFX/Frustum.hpp>
+
+#include <MineClone/Simd.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace MineClone
+{
+
+Frustum::Frustum(const Camera::Matrix &viewProjection) noexcept : m_planes{}
+{
+    const auto row = [&viewProjection](int index) {
+        return Plane{viewProjection[index], viewProjection[4 + index], viewProjection[8 + index], viewProjection[12 + index]};
+    };
+
+    const Plane x = row(0), y = row(1), z = row(2), w = row(3);
+
+    // Vulkan clip space: -w <= x, y <= w and 0 <= z <= w
+    m_planes[0] = {w.X + x.X, w.Y + x.Y, w.Z + x.Z, w.W + x.W};
+    m_planes[1] = {w.X - x.X, w.Y - x.Y, w.Z - x.Z, w.W - x.W};
+    m_planes[2] = {w.X + y.X, w.Y + y.Y, w.Z + y.Z, w.W + y.W};
+    m_planes[3] = {w.X - y.X, w.Y - y.Y, w.Z - y.Z, w.W - y.W};
+    m_planes[4] = z;
+    m_planes[5] = {w.X - z.X, w.Y - z.Y, w.Z - z.Z, w.W - z.W};
+
+    // normalized so distances are in blocks, which keeps the far plane test precise
+    for (Plane &plane : m_planes)
+    {
+        const float length = std::sqrt(plane.X * plane.X + plane.Y * plane.Y + plane.Z * plane.Z);
+        plane = {plane.X / length, plane.Y / length, plane.Z / length, plane.W / length};
+    }
+}
+
+bool Frustum::TestBox(float minX, float minY, float minZ, float maxX, float maxY, float maxZ) const noexcept
+{
+    for (const Plane &plane : m_planes)
+    {
+        const float x = plane.X >= 0.0f ? maxX : minX;
+        const float y = plane.Y >= 0.0f ? maxY : minY;
+        const float z = plane.Z >= 0.0f ? maxZ : minZ;
+
+        if (plane.X * x + plane.Y * y + plane.Z * z + plane.W < 0.0f)
+            return false;
+    }
+
+    return true;
+}
+
+void Frustum::TestCubes(const float *minX, const float *minY, const float *minZ, float size, size_t count, uint8_t *visible) const noexcept
+{
+    using namespace Simd;
+
+    // the furthest corner is min + size on the axes where the normal is positive, fold that into the plane offset
+    std::array<float, 6> offsets;
+    for (size_t i = 0; i < m_planes.size(); i++)
+    {
+        const Plane &plane = m_planes[i];
+        offsets[i] = plane.W + size * (std::max(plane.X, 0.0f) + std::max(plane.Y, 0.0f) + std::max(plane.Z, 0.0f));
+    }
+
+    const Float zero = Set(0.0f);
+
+    for (size_t base = 0; base < count; base += LANES)
+    {
+        const Float x = Load(minX + base), y = Load(minY + base), z = Load(minZ + base);
+        Int outside = SetInt(0);
+
+        for (size_t i = 0; i < m_planes.size(); i++)
+        {
+            const Plane &plane = m_planes[i];
+            const Float distance = MulAdd(Set(plane.X), x, MulAdd(Set(plane.Y), y, MulAdd(Set(plane.Z), z, Set(offsets[i]))));
+            outside = Or(outside, Less(distance, zero));
+        }
+
+        const uint32_t outsideBits = MoveMask(outside);
+        const size_t lanes = std::min(LANES, count - base);
+
+        for (size_t lane = 0; lane < lanes; lane++)
+            visible[base + lane] = static_cast<uint8_t>(~outsideBits >> lane & 1);
+    }
+}
+
+const std::array<Frustum::Plane, 6> &Frustum::GetPlanes() const noexcept
+{
+    return m_planes;
+}
+
+} // namespace MineClone
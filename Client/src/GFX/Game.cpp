@@ -1,9 +1,16 @@
 #include <MineClone/GFX/Game.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <utility>
+
 namespace MineClone
 {
 
-Game::Game(std::string title, size_t width, size_t height) : m_title{std::move(title)}, m_width{width}, m_height{height}
+Game::Game(std::string title, size_t width, size_t height, GameOptions options)
+    : m_title{std::move(title)}, m_width{width}, m_height{height}, m_options{options}
 {
 }
 
@@ -16,23 +23,63 @@ void Game::GameLoop()
 {
     Initialize();
 
+    // the player, the blocks and the entities tick on their own thread from here on, this loop streams and renders
+    const Camera &camera = m_vulkanContext.GetCamera();
+    m_simulation.Start(m_options.TickRate, {camera.GetX(), camera.GetY(), camera.GetZ(), camera.GetYaw(), camera.GetPitch()});
+
+    if (m_options.Headless)
+    {
+        HeadlessLoop();
+        return;
+    }
+
     while (!glfwWindowShouldClose(m_glWindow))
     {
+        m_vulkanContext.WaitForNextFrame();
+        glfwPollEvents();
+
         if (glfwGetKey(m_glWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         {
             glfwSetWindowShouldClose(m_glWindow, true);
             break;
         }
 
+        SampleInput();
+        UpdateCamera();
+        UpdateStreaming();
+        UploadPendingSections();
         m_vulkanContext.Render();
+    }
+}
 
-        glfwPollEvents();
+void Game::HeadlessLoop()
+{
+    using Clock = std::chrono::steady_clock;
+
+    const Clock::time_point start = Clock::now();
+
+    for (size_t frame = 0; frame < m_options.HeadlessFrames; frame++)
+    {
+        UpdateStreaming();
+        UploadPendingSections();
+        m_vulkanContext.WaitForNextFrame();
+        m_vulkanContext.Render();
     }
+
+    m_vulkanContext.WaitIdle();
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << "headless: rendered " << m_options.HeadlessFrames << " frames at " << m_width << "x" << m_height << " in " << seconds * 1000.0
+              << " ms (" << static_cast<double>(m_options.HeadlessFrames) / seconds << " fps)" << std::endl;
 }
 
 namespace
 {
 
+constexpr std::pair<int, LatencyMode> LATENCY_MODE_KEYS[] = {
+    {GLFW_KEY_F1, LatencyMode::LowLatency}, {GLFW_KEY_F2, LatencyMode::Throughput}, {GLFW_KEY_F3, LatencyMode::PowerSaving}};
+
 void GlResizeCallback(GLFWwindow *window, int width, int height)
 {
     static_cast<Game *>(glfwGetWindowUserPointer(window))->OnResize(static_cast<size_t>(width), static_cast<size_t>(height));
@@ -42,6 +89,34 @@ void GlResizeCallback(GLFWwindow *window, int width, int height)
 
 void Game::Initialize()
 {
+    m_jobSystem.Create(m_options.WorkerThreads);
+
+    m_simulation.SetWorldTick([this](const ChunkView &chunks, float seconds) {
+        // nothing edits blocks yet, the updates are found and counted but have no effect
+        m_scheduledTicks.clear();
+        m_randomTicks.clear();
+        m_blockTicker.Tick(chunks, m_scheduledTicks, m_randomTicks);
+
+        OnWorldTick(chunks, seconds);
+    });
+
+    StreamingOptions streaming{};
+    streaming.Radius = m_options.ViewDistance;
+    streaming.WorldDirectory = m_options.WorldDirectory;
+    m_chunkStreamer.Create(&m_jobSystem, streaming);
+
+    m_vulkanContext.SetJobSystem(m_options.SerialRecording ? nullptr : &m_jobSystem);
+    m_vulkanContext.SetLatencyMode(m_options.Latency, m_options.FrameRateCap);
+    m_vulkanContext.SetBlockTextureOptions(m_options.Textures);
+
+    if (m_options.Headless)
+    {
+        m_vulkanContext.InitializeHeadless({static_cast<uint32_t>(m_width), static_cast<uint32_t>(m_height)});
+        ConfigureRenderer();
+        LoadSpawnArea();
+        return;
+    }
+
     // glfw init
     if (!glfwInit())
         throw Exception("Failed to initialize GLFW");
@@ -61,10 +136,169 @@ void Game::Initialize()
 
     // init vulkan context
     m_vulkanContext.Initialize(m_glWindow);
+    ConfigureRenderer();
+    LoadSpawnArea();
+}
+
+void Game::ConfigureRenderer()
+{
+    m_vulkanContext.GetChunkRenderer().GetVisibility().SetOcclusionCulling(m_options.OcclusionCulling);
+
+    GpuCulling &gpuCulling = m_vulkanContext.GetGpuCulling();
+    gpuCulling.SetEnabled(m_options.GpuCulling);
+    gpuCulling.SetOcclusionCulling(m_options.OcclusionCulling);
+    gpuCulling.SetVerification(m_options.VerifyCulling);
+}
+
+void Game::LoadSpawnArea()
+{
+    Camera &camera = m_vulkanContext.GetCamera();
+    camera.SetPosition(8.0f, 110.0f, 8.0f);
+    camera.SetRotation(0.0f, -0.4f);
+
+    // the only place the render thread waits for chunks, the first frame shouldn't show an empty world
+    do
+    {
+        UpdateStreaming();
+        m_jobSystem.WaitIdle();
+    } while (!m_chunkStreamer.IsAreaMeshed(std::min(SPAWN_RADIUS, m_options.ViewDistance)));
+
+    UpdateStreaming();
+    OnSpawnAreaLoaded();
+}
+
+void Game::UpdateStreaming()
+{
+    const Camera &camera = m_vulkanContext.GetCamera();
+
+    m_evictedChunks.clear();
+
+    const size_t firstMeshed = m_pendingSections.size();
+    m_chunkStreamer.Update(camera.GetX(), camera.GetZ(), -std::sin(camera.GetYaw()), -std::cos(camera.GetYaw()), m_pendingSections,
+                           m_evictedChunks);
+
+    // the simulation works on a copy, which is only made when something changed
+    std::shared_ptr<ChunkView> view;
+    const auto editView = [this, &view]() -> ChunkView & {
+        if (view == nullptr)
+            view = std::make_shared<ChunkView>(*m_chunkView);
+
+        return *view;
+    };
+
+    // the sections of a chunk arrive together, chunks are handed over once they are meshed
+    for (size_t i = firstMeshed; i < m_pendingSections.size(); i++)
+    {
+        const StreamedSection &section = m_pendingSections[i];
+        if (i != firstMeshed && section.X == m_pendingSections[i - 1].X && section.Z == m_pendingSections[i - 1].Z)
+            continue;
+
+        if (std::shared_ptr<const Chunk> chunk = m_chunkStreamer.GetChunk(section.X, section.Z); chunk != nullptr)
+            editView().Add(std::move(chunk));
+    }
+
+    if (!m_evictedChunks.empty())
+    {
+        // meshes of evicted chunks may not have been uploaded yet
+        const auto evicted = [this](int32_t x, int32_t z) {
+            return std::any_of(m_evictedChunks.begin(), m_evictedChunks.end(), [x, z](const ChunkPosition &chunk) {
+                return chunk.X == x && chunk.Z == z;
+            });
+        };
+
+        m_pendingSections.erase(std::remove_if(m_pendingSections.begin(), m_pendingSections.end(),
+                                               [&evicted](const StreamedSection &section) {
+                                                   return evicted(section.X, section.Z);
+                                               }),
+                                m_pendingSections.end());
+
+        ChunkRenderer &renderer = m_vulkanContext.GetChunkRenderer();
+
+        for (const ChunkPosition &chunk : m_evictedChunks)
+        {
+            editView().Remove(chunk.X, chunk.Z);
+
+            for (int32_t y = 0; y < Chunk::SECTION_COUNT; y++)
+                renderer.RemoveSection(chunk.X, y, chunk.Z);
+        }
+    }
+
+    if (view != nullptr)
+    {
+        m_chunkView = std::move(view);
+        m_simulation.SetChunkView(m_chunkView);
+    }
+}
+
+void Game::UploadPendingSections()
+{
+    ChunkRenderer &renderer = m_vulkanContext.GetChunkRenderer();
+
+    size_t uploaded = 0;
+    while (uploaded < m_pendingSections.size())
+    {
+        const StreamedSection &pending = m_pendingSections[uploaded];
+
+        if (!renderer.AddSection(pending.X, pending.Y, pending.Z, pending.Mesh, pending.Connectivity))
+            break;
+
+        uploaded++;
+    }
+
+    m_pendingSections.erase(m_pendingSections.begin(), m_pendingSections.begin() + static_cast<std::ptrdiff_t>(uploaded));
+}
+
+void Game::SampleInput()
+{
+    const auto axis = [this](int positive, int negative) {
+        const bool positivePressed = glfwGetKey(m_glWindow, positive) == GLFW_PRESS;
+        const bool negativePressed = glfwGetKey(m_glWindow, negative) == GLFW_PRESS;
+        return static_cast<float>(positivePressed) - static_cast<float>(negativePressed);
+    };
+
+    PlayerInput input{};
+    input.Forward = axis(GLFW_KEY_W, GLFW_KEY_S);
+    input.Right = axis(GLFW_KEY_D, GLFW_KEY_A);
+    input.Up = axis(GLFW_KEY_SPACE, GLFW_KEY_LEFT_SHIFT);
+    input.Yaw = axis(GLFW_KEY_LEFT, GLFW_KEY_RIGHT);
+    input.Pitch = axis(GLFW_KEY_UP, GLFW_KEY_DOWN);
+
+    m_simulation.SetInput(input);
+
+    for (const auto &[key, mode] : LATENCY_MODE_KEYS)
+    {
+        if (glfwGetKey(m_glWindow, key) == GLFW_PRESS && m_vulkanContext.GetLatencyMode() != mode)
+        {
+            m_vulkanContext.SetLatencyMode(mode, m_options.FrameRateCap);
+            std::cout << "latency mode: " << GetLatencyModeName(mode) << std::endl;
+        }
+    }
+}
+
+void Game::UpdateCamera()
+{
+    const PlayerState player = m_simulation.Interpolate(Simulation::Clock::now());
+
+    Camera &camera = m_vulkanContext.GetCamera();
+    camera.SetPosition(player.X, player.Y, player.Z);
+    camera.SetRotation(player.Yaw, player.Pitch);
 }
 
 void Game::Destroy()
 {
+    StopSimulation();
+
+    m_blockTicker.Dump(std::cout);
+    m_blockTicker.Clear();
+
+    // jobs may still reference the world or the GPU, finish them first
+    if (m_chunkStreamer.GetStatistics().Meshed != 0)
+        m_chunkStreamer.Dump(std::cout);
+
+    m_chunkStreamer.Destroy();
+    m_jobSystem.Destroy();
+    m_pendingSections.clear();
+
     if (m_surface != VK_NULL_HANDLE)
     {
         vkDestroySurfaceKHR(m_vulkanContext.GetInstance(), m_surface, nullptr);
@@ -110,4 +344,26 @@ size_t Game::GetHeight() const noexcept
     return m_height;
 }
 
+JobSystem &Game::GetJobSystem() noexcept
+{
+    return m_jobSystem;
+}
+
+void Game::StopSimulation()
+{
+    if (!m_simulation.IsRunning())
+        return;
+
+    m_simulation.Stop();
+    m_simulation.Dump(std::cout);
+}
+
+void Game::OnSpawnAreaLoaded()
+{
+}
+
+void Game::OnWorldTick(const ChunkView &, float)
+{
+}
+
 } // namespace MineClone
\ No newline at end of file
@@ -0,0 +1,858 @@
+#include <MineClone/GFX/GpuCulling.hpp>
+
+#include <MineClone/GFX/Shader.hpp>
+#include <MineClone/GFX/VulkanContext.hpp>
+
+#include <MineClone_Client_Shaders.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace MineClone
+{
+
+namespace
+{
+
+// storage buffer offsets have to be aligned to minStorageBufferOffsetAlignment, which is at most 256
+constexpr VkDeviceSize OFFSET_ALIGNMENT = 256;
+
+// the draw count sits in front of the commands like in the chunk renderer's indirect buffer
+constexpr VkDeviceSize COUNT_SIZE = 16;
+constexpr VkDeviceSize DRAW_LIST_SIZE = COUNT_SIZE + VkDeviceSize{ChunkRenderer::SECTION_CAPACITY} * sizeof(VkDrawIndexedIndirectCommand);
+
+// only the first few mismatching frames are printed, the rest are counted
+constexpr uint64_t REPORTED_MISMATCHES = 8;
+
+constexpr VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) noexcept
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+constexpr uint32_t GroupCount(uint32_t count, uint32_t groupSize) noexcept
+{
+    return (count + groupSize - 1) / groupSize;
+}
+
+constexpr bool HasStencil(VkFormat format) noexcept
+{
+    return format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+}
+
+void MemoryBarrier(VkCommandBuffer commandBuffer, VkPipelineStageFlags srcStages, VkAccessFlags srcAccess, VkPipelineStageFlags dstStages,
+                   VkAccessFlags dstAccess)
+{
+    VkMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstAccessMask = dstAccess;
+
+    vkCmdPipelineBarrier(commandBuffer, srcStages, dstStages, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+}
+
+} // namespace
+
+GpuCulling::~GpuCulling()
+{
+    Destroy();
+}
+
+void GpuCulling::Create(VulkanContext *context)
+{
+    m_context = context;
+
+    // culled lists only have a count on the gpu, and the dispatch runs on the graphics queue
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(m_context->GetPhysicalDevice(), &familyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(m_context->GetPhysicalDevice(), &familyCount, families.data());
+
+    const uint32_t graphicsFamily = *m_context->GetQueueFamilyIndices().GraphicsFamily;
+    m_supported = m_context->GetChunkRenderer().UsesIndirectCount() && (families[graphicsFamily].queueFlags & VK_QUEUE_COMPUTE_BIT) != 0;
+
+    if (!m_supported)
+        return;
+
+    CreatePipelines();
+    CreateBuffers();
+    CreateDescriptors();
+    CreatePyramid();
+}
+
+void GpuCulling::CreatePipelines()
+{
+    VkDevice device = m_context->GetDevice();
+
+#ifdef MINECLONE_RUNTIME_SHADER_COMPILER
+    ShaderCompiler compiler;
+    const ShaderModule cullShader{device, compiler.Compile(RES_CULL_COMPUTE_SHADER, "cull.comp", VK_SHADER_STAGE_COMPUTE_BIT)};
+    const ShaderModule pyramidShader{device, compiler.Compile(RES_DEPTH_PYRAMID_COMPUTE_SHADER, "depth_pyramid.comp", VK_SHADER_STAGE_COMPUTE_BIT)};
+#else
+    const ShaderModule cullShader{device, VK_SHADER_STAGE_COMPUTE_BIT, RES_CULL_COMPUTE_SHADER, sizeof(RES_CULL_COMPUTE_SHADER)};
+    const ShaderModule pyramidShader{device, VK_SHADER_STAGE_COMPUTE_BIT, RES_DEPTH_PYRAMID_COMPUTE_SHADER, sizeof(RES_DEPTH_PYRAMID_COMPUTE_SHADER)};
+#endif
+
+    // sections, parameters, draw list, depth pyramid
+    std::array<VkDescriptorSetLayoutBinding, 4> cullBindings{};
+
+    for (uint32_t binding = 0; binding < cullBindings.size(); binding++)
+    {
+        cullBindings[binding].binding = binding;
+        cullBindings[binding].descriptorType = binding == 3 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        cullBindings[binding].descriptorCount = 1;
+        cullBindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    // source level, destination level
+    std::array<VkDescriptorSetLayoutBinding, 2> pyramidBindings{};
+
+    for (uint32_t binding = 0; binding < pyramidBindings.size(); binding++)
+    {
+        pyramidBindings[binding].binding = binding;
+        pyramidBindings[binding].descriptorType = binding == 0 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        pyramidBindings[binding].descriptorCount = 1;
+        pyramidBindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(cullBindings.size());
+    layoutInfo.pBindings = cullBindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_cullSetLayout) != VK_SUCCESS)
+        throw GraphicsException("failed to create the culling descriptor set layout");
+
+    layoutInfo.bindingCount = static_cast<uint32_t>(pyramidBindings.size());
+    layoutInfo.pBindings = pyramidBindings.data();
+
+    if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_pyramidSetLayout) != VK_SUCCESS)
+        throw GraphicsException("failed to create the depth pyramid descriptor set layout");
+
+    VkPipelineLayoutCreateInfo cullLayoutInfo{};
+    cullLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    cullLayoutInfo.setLayoutCount = 1;
+    cullLayoutInfo.pSetLayouts = &m_cullSetLayout;
+
+    if (vkCreatePipelineLayout(device, &cullLayoutInfo, nullptr, &m_cullPipelineLayout) != VK_SUCCESS)
+        throw GraphicsException("failed to create the culling pipeline layout");
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(PyramidPushConstants);
+
+    VkPipelineLayoutCreateInfo pyramidLayoutInfo{};
+    pyramidLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pyramidLayoutInfo.setLayoutCount = 1;
+    pyramidLayoutInfo.pSetLayouts = &m_pyramidSetLayout;
+    pyramidLayoutInfo.pushConstantRangeCount = 1;
+    pyramidLayoutInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(device, &pyramidLayoutInfo, nullptr, &m_pyramidPipelineLayout) != VK_SUCCESS)
+        throw GraphicsException("failed to create the depth pyramid pipeline layout");
+
+    std::array<VkComputePipelineCreateInfo, 2> pipelineInfos{};
+
+    pipelineInfos[0].sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfos[0].stage = cullShader.CreateInfo();
+    pipelineInfos[0].layout = m_cullPipelineLayout;
+    pipelineInfos[0].basePipelineIndex = -1;
+
+    pipelineInfos[1].sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfos[1].stage = pyramidShader.CreateInfo();
+    pipelineInfos[1].layout = m_pyramidPipelineLayout;
+    pipelineInfos[1].basePipelineIndex = -1;
+
+    std::array<VkPipeline, 2> pipelines{};
+
+    if (vkCreateComputePipelines(device, m_context->GetPipelineCache(), static_cast<uint32_t>(pipelineInfos.size()), pipelineInfos.data(), nullptr,
+                                 pipelines.data()) != VK_SUCCESS)
+    {
+        throw GraphicsException("failed to create the culling pipelines");
+    }
+
+    m_cullPipeline = pipelines[0];
+    m_pyramidPipeline = pipelines[1];
+
+    VkSamplerCreateInfo samplerInfo{};
+    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    samplerInfo.magFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    samplerInfo.maxLod = 16.0f;
+
+    if (vkCreateSampler(device, &samplerInfo, nullptr, &m_sampler) != VK_SUCCESS)
+        throw GraphicsException("failed to create the depth pyramid sampler");
+}
+
+void GpuCulling::CreateBuffers()
+{
+    MemoryAllocator &allocator = m_context->GetMemoryAllocator();
+    m_frameDrawSize = AlignUp(DRAW_LIST_SIZE, OFFSET_ALIGNMENT);
+
+    VkBufferCreateInfo sectionInfo{};
+    sectionInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    sectionInfo.size = VkDeviceSize{ChunkRenderer::SECTION_CAPACITY} * sizeof(CullSection);
+    sectionInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    sectionInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    allocator.CreateBuffer(sectionInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_sectionBuffer, m_sectionMemory);
+
+    VkBufferCreateInfo parameterInfo{};
+    parameterInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    parameterInfo.size = OFFSET_ALIGNMENT * VulkanContext::MAX_FRAMES_IN_FLIGHT;
+    parameterInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    parameterInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    allocator.CreateBuffer(parameterInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, m_parameterBuffer,
+                           m_parameterMemory);
+    ASSERT(m_parameterMemory.Mapped != nullptr, "culling parameters are not host visible");
+
+    VkBufferCreateInfo drawInfo{};
+    drawInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    drawInfo.size = m_frameDrawSize * VulkanContext::MAX_FRAMES_IN_FLIGHT;
+    drawInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+                     VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    drawInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    allocator.CreateBuffer(drawInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_drawBuffer, m_drawMemory);
+}
+
+void GpuCulling::CreateDescriptors()
+{
+    VkDevice device = m_context->GetDevice();
+    const auto frames = static_cast<uint32_t>(VulkanContext::MAX_FRAMES_IN_FLIGHT);
+
+    std::array<VkDescriptorPoolSize, 2> poolSizes{};
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSizes[0].descriptorCount = 3 * frames;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[1].descriptorCount = frames;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = frames;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+
+    if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS)
+        throw GraphicsException("failed to create the culling descriptor pool");
+
+    const std::vector<VkDescriptorSetLayout> layouts(frames, m_cullSetLayout);
+    m_cullSets.resize(frames);
+
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = frames;
+    allocInfo.pSetLayouts = layouts.data();
+
+    if (vkAllocateDescriptorSets(device, &allocInfo, m_cullSets.data()) != VK_SUCCESS)
+        throw GraphicsException("failed to allocate the culling descriptor sets");
+
+    // the pyramid binding follows in WriteCullPyramidDescriptors, it changes with the swap chain
+    for (uint32_t frame = 0; frame < frames; frame++)
+    {
+        std::array<VkDescriptorBufferInfo, 3> bufferInfos{};
+        bufferInfos[0] = {m_sectionBuffer, 0, VK_WHOLE_SIZE};
+        bufferInfos[1] = {m_parameterBuffer, OFFSET_ALIGNMENT * frame, sizeof(CullParameters)};
+        bufferInfos[2] = {m_drawBuffer, m_frameDrawSize * frame, DRAW_LIST_SIZE};
+
+        std::array<VkWriteDescriptorSet, 3> writes{};
+
+        for (uint32_t binding = 0; binding < writes.size(); binding++)
+        {
+            writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[binding].dstSet = m_cullSets[frame];
+            writes[binding].dstBinding = binding;
+            writes[binding].descriptorCount = 1;
+            writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[binding].pBufferInfo = &bufferInfos[binding];
+        }
+
+        vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+void GpuCulling::CreatePyramid()
+{
+    if (m_context == nullptr || !m_supported)
+        return;
+
+    DestroyPyramid();
+
+    VkDevice device = m_context->GetDevice();
+    SwapChain &swapChain = m_context->GetSwapChain();
+
+    m_pyramidExtent = swapChain.GetSwapChainExtent();
+    m_pyramidLevels = DepthPyramid::LevelCount(m_pyramidExtent.width, m_pyramidExtent.height);
+    m_occlusionSupported = swapChain.IsDepthSampled();
+
+    // the image exists even without occlusion support, the culling set always binds it
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = VK_FORMAT_R32_SFLOAT;
+    imageInfo.extent = {m_pyramidExtent.width, m_pyramidExtent.height, 1};
+    imageInfo.mipLevels = m_pyramidLevels;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    m_context->GetMemoryAllocator().CreateImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_pyramidImage, m_pyramidMemory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = m_pyramidImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = VK_FORMAT_R32_SFLOAT;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = m_pyramidLevels;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(device, &viewInfo, nullptr, &m_pyramidView) != VK_SUCCESS)
+        throw GraphicsException("failed to create the depth pyramid view");
+
+    // one view per level, the reduction reads one and writes the next
+    viewInfo.subresourceRange.levelCount = 1;
+
+    for (uint32_t level = 0; level < m_pyramidLevels; level++)
+    {
+        viewInfo.subresourceRange.baseMipLevel = level;
+
+        VkImageView &view = m_pyramidLevelViews.emplace_back();
+        if (vkCreateImageView(device, &viewInfo, nullptr, &view) != VK_SUCCESS)
+            throw GraphicsException("failed to create a depth pyramid level view");
+    }
+
+    WriteCullPyramidDescriptors();
+
+    if (m_occlusionSupported)
+    {
+        std::array<VkDescriptorPoolSize, 2> poolSizes{};
+        poolSizes[0].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSizes[0].descriptorCount = m_pyramidLevels;
+        poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        poolSizes[1].descriptorCount = m_pyramidLevels;
+
+        VkDescriptorPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.maxSets = m_pyramidLevels;
+        poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+        poolInfo.pPoolSizes = poolSizes.data();
+
+        if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_pyramidPool) != VK_SUCCESS)
+            throw GraphicsException("failed to create the depth pyramid descriptor pool");
+
+        const std::vector<VkDescriptorSetLayout> layouts(m_pyramidLevels, m_pyramidSetLayout);
+        m_pyramidSets.resize(m_pyramidLevels);
+
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = m_pyramidPool;
+        allocInfo.descriptorSetCount = m_pyramidLevels;
+        allocInfo.pSetLayouts = layouts.data();
+
+        if (vkAllocateDescriptorSets(device, &allocInfo, m_pyramidSets.data()) != VK_SUCCESS)
+            throw GraphicsException("failed to allocate the depth pyramid descriptor sets");
+
+        // level 0 reads the depth buffer, every other level the one below it
+        for (uint32_t level = 0; level < m_pyramidLevels; level++)
+        {
+            VkDescriptorImageInfo sourceInfo{};
+            sourceInfo.sampler = m_sampler;
+            sourceInfo.imageView = level == 0 ? swapChain.GetDepthImageView() : m_pyramidLevelViews[level - 1];
+            sourceInfo.imageLayout = level == 0 ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_GENERAL;
+
+            VkDescriptorImageInfo destinationInfo{};
+            destinationInfo.imageView = m_pyramidLevelViews[level];
+            destinationInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+            std::array<VkWriteDescriptorSet, 2> writes{};
+
+            writes[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[0].dstSet = m_pyramidSets[level];
+            writes[0].dstBinding = 0;
+            writes[0].descriptorCount = 1;
+            writes[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            writes[0].pImageInfo = &sourceInfo;
+
+            writes[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[1].dstSet = m_pyramidSets[level];
+            writes[1].dstBinding = 1;
+            writes[1].descriptorCount = 1;
+            writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            writes[1].pImageInfo = &destinationInfo;
+
+            vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+        }
+    }
+
+    m_pyramidInitialized = false;
+    m_pyramidValid = false;
+
+    if (m_verification)
+        CreateReadbacks();
+}
+
+void GpuCulling::WriteCullPyramidDescriptors()
+{
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.sampler = m_sampler;
+    imageInfo.imageView = m_pyramidView;
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    for (VkDescriptorSet set : m_cullSets)
+    {
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.dstBinding = 3;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &imageInfo;
+
+        vkUpdateDescriptorSets(m_context->GetDevice(), 1, &write, 0, nullptr);
+    }
+}
+
+void GpuCulling::CreateReadbacks()
+{
+    DestroyReadbacks();
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = GetReadbackPyramidOffset() + DepthPyramid::TexelCount(m_pyramidExtent.width, m_pyramidExtent.height) * sizeof(float);
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    m_readbacks.resize(VulkanContext::MAX_FRAMES_IN_FLIGHT);
+
+    for (Readback &readback : m_readbacks)
+    {
+        m_context->GetMemoryAllocator().CreateBuffer(bufferInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                                     readback.Buffer, readback.Memory);
+        ASSERT(readback.Memory.Mapped != nullptr, "culling readback is not host visible");
+    }
+}
+
+void GpuCulling::DestroyReadbacks()
+{
+    for (Readback &readback : m_readbacks)
+        m_context->GetMemoryAllocator().DestroyBuffer(readback.Buffer, readback.Memory);
+
+    m_readbacks.clear();
+}
+
+void GpuCulling::DestroyPyramid()
+{
+    if (m_context == nullptr)
+        return;
+
+    VkDevice device = m_context->GetDevice();
+
+    // readbacks are sized for the pyramid
+    DestroyReadbacks();
+
+    if (m_pyramidPool != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorPool(device, m_pyramidPool, nullptr);
+        m_pyramidPool = VK_NULL_HANDLE;
+    }
+
+    m_pyramidSets.clear();
+
+    for (VkImageView view : m_pyramidLevelViews)
+        vkDestroyImageView(device, view, nullptr);
+
+    m_pyramidLevelViews.clear();
+
+    if (m_pyramidView != VK_NULL_HANDLE)
+    {
+        vkDestroyImageView(device, m_pyramidView, nullptr);
+        m_pyramidView = VK_NULL_HANDLE;
+    }
+
+    m_context->GetMemoryAllocator().DestroyImage(m_pyramidImage, m_pyramidMemory);
+
+    m_pyramidLevels = 0;
+    m_pyramidInitialized = false;
+    m_pyramidValid = false;
+}
+
+void GpuCulling::Destroy()
+{
+    if (m_context == nullptr)
+        return;
+
+    DestroyPyramid();
+
+    VkDevice device = m_context->GetDevice();
+    MemoryAllocator &allocator = m_context->GetMemoryAllocator();
+
+    allocator.DestroyBuffer(m_drawBuffer, m_drawMemory);
+    allocator.DestroyBuffer(m_parameterBuffer, m_parameterMemory);
+    allocator.DestroyBuffer(m_sectionBuffer, m_sectionMemory);
+
+    // destroying the pool frees the sets as well
+    if (m_descriptorPool != VK_NULL_HANDLE)
+    {
+        vkDestroyDescriptorPool(device, m_descriptorPool, nullptr);
+        m_descriptorPool = VK_NULL_HANDLE;
+    }
+
+    m_cullSets.clear();
+
+    if (m_sampler != VK_NULL_HANDLE)
+    {
+        vkDestroySampler(device, m_sampler, nullptr);
+        m_sampler = VK_NULL_HANDLE;
+    }
+
+    for (VkPipeline *pipeline : {&m_cullPipeline, &m_pyramidPipeline})
+    {
+        if (*pipeline != VK_NULL_HANDLE)
+        {
+            vkDestroyPipeline(device, *pipeline, nullptr);
+            *pipeline = VK_NULL_HANDLE;
+        }
+    }
+
+    for (VkPipelineLayout *layout : {&m_cullPipelineLayout, &m_pyramidPipelineLayout})
+    {
+        if (*layout != VK_NULL_HANDLE)
+        {
+            vkDestroyPipelineLayout(device, *layout, nullptr);
+            *layout = VK_NULL_HANDLE;
+        }
+    }
+
+    for (VkDescriptorSetLayout *layout : {&m_cullSetLayout, &m_pyramidSetLayout})
+    {
+        if (*layout != VK_NULL_HANDLE)
+        {
+            vkDestroyDescriptorSetLayout(device, *layout, nullptr);
+            *layout = VK_NULL_HANDLE;
+        }
+    }
+
+    m_sections.clear();
+    m_supported = false;
+    m_context = nullptr;
+}
+
+bool GpuCulling::SetSection(uint32_t index, const CullSection &section)
+{
+    if (!m_supported)
+        return true;
+
+    if (!m_context->GetUploadManager().UploadBuffer(m_sectionBuffer, VkDeviceSize{index} * sizeof(CullSection), &section, sizeof(CullSection)))
+        return false;
+
+    if (m_sections.size() <= index)
+        m_sections.resize(index + 1, CullSection{});
+
+    m_sections[index] = section;
+    return true;
+}
+
+void GpuCulling::RecordCull(VkCommandBuffer commandBuffer, size_t frame, const Camera &camera)
+{
+    if (!m_pyramidInitialized)
+    {
+        // the pyramid stays in the general layout, it is written and sampled by compute shaders only
+        VkImageMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = m_pyramidImage;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, m_pyramidLevels, 0, 1};
+
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                             &barrier);
+        m_pyramidInitialized = true;
+    }
+
+    const Frustum frustum{camera.GetViewProjection()};
+
+    CullParameters parameters{};
+    parameters.Planes = frustum.GetPlanes();
+    parameters.OcclusionViewProjection = m_pyramidViewProjection;
+    parameters.SectionCount = static_cast<uint32_t>(m_sections.size());
+    parameters.Flags = m_occlusionCulling && m_occlusionSupported && m_pyramidValid ? CullParameters::OCCLUSION : 0;
+    parameters.PyramidWidth = m_pyramidExtent.width;
+    parameters.PyramidHeight = m_pyramidExtent.height;
+    parameters.PyramidLevels = m_pyramidLevels;
+
+    // the frame's fence has signaled, the gpu is done with this copy
+    std::memcpy(static_cast<char *>(m_parameterMemory.Mapped) + OFFSET_ALIGNMENT * frame, &parameters, sizeof(parameters));
+
+    vkCmdFillBuffer(commandBuffer, m_drawBuffer, GetCountOffset(frame), sizeof(uint32_t), 0);
+
+    // the cleared count, and the pyramid the previous frame reduced
+    MemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                  VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                  VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+
+    if (parameters.SectionCount != 0)
+    {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipeline);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipelineLayout, 0, 1, &m_cullSets[frame], 0, nullptr);
+        vkCmdDispatch(commandBuffer, GroupCount(parameters.SectionCount, WORKGROUP_SIZE), 1, 1);
+    }
+
+    // the draw list is read as indirect commands, and by the verification copy
+    MemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+                  VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                  VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT);
+
+    if (m_verification && !m_readbacks.empty())
+    {
+        Readback &readback = m_readbacks[frame];
+        readback.Parameters = parameters;
+        readback.Sections = m_sections;
+        readback.Occlusion = (parameters.Flags & CullParameters::OCCLUSION) != 0;
+        readback.Pending = true;
+
+        RecordReadback(commandBuffer, frame);
+    }
+}
+
+void GpuCulling::RecordReadback(VkCommandBuffer commandBuffer, size_t frame)
+{
+    const Readback &readback = m_readbacks[frame];
+
+    VkBufferCopy drawCopy{};
+    drawCopy.srcOffset = GetCountOffset(frame);
+    drawCopy.dstOffset = 0;
+    drawCopy.size = DRAW_LIST_SIZE;
+
+    vkCmdCopyBuffer(commandBuffer, m_drawBuffer, readback.Buffer, 1, &drawCopy);
+
+    // the pyramid this frame was culled against, before this frame's depth replaces it
+    if (readback.Occlusion)
+    {
+        std::vector<VkBufferImageCopy> copies(m_pyramidLevels);
+        VkDeviceSize offset = GetReadbackPyramidOffset();
+
+        for (uint32_t level = 0; level < m_pyramidLevels; level++)
+        {
+            const uint32_t width = DepthPyramid::LevelSize(m_pyramidExtent.width, level);
+            const uint32_t height = DepthPyramid::LevelSize(m_pyramidExtent.height, level);
+
+            copies[level].bufferOffset = offset;
+            copies[level].imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, level, 0, 1};
+            copies[level].imageExtent = {width, height, 1};
+
+            offset += VkDeviceSize{width} * height * sizeof(float);
+        }
+
+        vkCmdCopyImageToBuffer(commandBuffer, m_pyramidImage, VK_IMAGE_LAYOUT_GENERAL, readback.Buffer, static_cast<uint32_t>(copies.size()),
+                               copies.data());
+    }
+
+    MemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_HOST_BIT, VK_ACCESS_HOST_READ_BIT);
+}
+
+void GpuCulling::RecordDepthPyramid(VkCommandBuffer commandBuffer, const Camera &camera)
+{
+    if (!m_occlusionSupported || !m_occlusionCulling)
+    {
+        m_pyramidValid = false;
+        return;
+    }
+
+    // Depth writes finish before the reduction reads them. The culling dispatch and the readback copy earlier in the
+    // frame read the old pyramid, they finish before it is overwritten.
+    const VkFormat depthFormat = m_context->GetPipelineManager().GetDepthFormat();
+
+    VkImageMemoryBarrier depthBarrier{};
+    depthBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    depthBarrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    depthBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    depthBarrier.oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+    depthBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    depthBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    depthBarrier.image = m_context->GetSwapChain().GetDepthImage();
+    depthBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT | (HasStencil(depthFormat) ? VK_IMAGE_ASPECT_STENCIL_BIT : 0);
+    depthBarrier.subresourceRange.levelCount = 1;
+    depthBarrier.subresourceRange.layerCount = 1;
+
+    const VkPipelineStageFlags srcStages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                                           VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+    vkCmdPipelineBarrier(commandBuffer, srcStages, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &depthBarrier);
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pyramidPipeline);
+
+    for (uint32_t level = 0; level < m_pyramidLevels; level++)
+    {
+        const uint32_t sourceLevel = level == 0 ? 0 : level - 1;
+
+        PyramidPushConstants constants{};
+        constants.SourceSize[0] = static_cast<int32_t>(DepthPyramid::LevelSize(m_pyramidExtent.width, sourceLevel));
+        constants.SourceSize[1] = static_cast<int32_t>(DepthPyramid::LevelSize(m_pyramidExtent.height, sourceLevel));
+        constants.DestinationSize[0] = static_cast<int32_t>(DepthPyramid::LevelSize(m_pyramidExtent.width, level));
+        constants.DestinationSize[1] = static_cast<int32_t>(DepthPyramid::LevelSize(m_pyramidExtent.height, level));
+        constants.Reduce = level == 0 ? 0 : 1;
+
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, m_pyramidPipelineLayout, 0, 1, &m_pyramidSets[level], 0, nullptr);
+        vkCmdPushConstants(commandBuffer, m_pyramidPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+        vkCmdDispatch(commandBuffer, GroupCount(static_cast<uint32_t>(constants.DestinationSize[0]), PYRAMID_WORKGROUP_SIZE),
+                      GroupCount(static_cast<uint32_t>(constants.DestinationSize[1]), PYRAMID_WORKGROUP_SIZE), 1);
+
+        // the next level reads this one
+        MemoryBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                      VK_ACCESS_SHADER_READ_BIT);
+    }
+
+    m_pyramidViewProjection = camera.GetViewProjection();
+    m_pyramidValid = true;
+}
+
+void GpuCulling::Verify(size_t frame)
+{
+    if (!m_verification || m_readbacks.empty() || !m_readbacks[frame].Pending)
+        return;
+
+    Readback &readback = m_readbacks[frame];
+    readback.Pending = false;
+
+    const char *mapped = static_cast<const char *>(readback.Memory.Mapped);
+
+    uint32_t drawCount;
+    std::memcpy(&drawCount, mapped, sizeof(drawCount));
+    drawCount = std::min(drawCount, ChunkRenderer::SECTION_CAPACITY);
+
+    std::vector<VkDrawIndexedIndirectCommand> commands(drawCount);
+    std::memcpy(commands.data(), mapped + COUNT_SIZE, drawCount * sizeof(VkDrawIndexedIndirectCommand));
+
+    // the atomic counter hands out slots in any order
+    bool commandsMatch = true;
+    m_gpuVisible.clear();
+
+    for (const VkDrawIndexedIndirectCommand &command : commands)
+    {
+        m_gpuVisible.push_back(command.firstInstance);
+
+        if (command.firstInstance >= readback.Parameters.SectionCount)
+        {
+            commandsMatch = false;
+            continue;
+        }
+
+        const CullSection &section = readback.Sections[command.firstInstance];
+        commandsMatch = commandsMatch && command.indexCount == section.QuadCount * 6 && command.instanceCount == 1 &&
+                        command.vertexOffset == static_cast<int32_t>(section.FirstQuad * 4);
+    }
+
+    std::sort(m_gpuVisible.begin(), m_gpuVisible.end());
+
+    if (readback.Occlusion)
+    {
+        m_referencePyramid.Assign(reinterpret_cast<const float *>(mapped + GetReadbackPyramidOffset()), m_pyramidExtent.width,
+                                  m_pyramidExtent.height);
+    }
+
+    m_referenceVisible.clear();
+    CullSections(readback.Parameters, readback.Sections.data(), readback.Occlusion ? &m_referencePyramid : nullptr, m_referenceVisible);
+
+    m_verifiedFrames++;
+
+    if (commandsMatch && m_gpuVisible == m_referenceVisible)
+        return;
+
+    if (++m_mismatchedFrames <= REPORTED_MISMATCHES)
+    {
+        std::cerr << "gpu culling: frame " << m_verifiedFrames << " drew " << m_gpuVisible.size() << " sections, the cpu reference "
+                  << m_referenceVisible.size() << (commandsMatch ? "" : ", with malformed commands") << (readback.Occlusion ? " (hi-z)" : "")
+                  << std::endl;
+    }
+}
+
+void GpuCulling::Dump(std::ostream &stream) const
+{
+    if (!m_supported)
+        return;
+
+    stream << "gpu culling: " << (m_enabled ? "on" : "off") << ", hi-z " << (m_occlusionSupported && m_occlusionCulling ? "on" : "off");
+
+    if (m_verification)
+        stream << ", " << m_verifiedFrames << " frames verified against the cpu, " << m_mismatchedFrames << " mismatched";
+
+    stream << "\n";
+    stream.flush();
+}
+
+void GpuCulling::SetEnabled(bool enabled) noexcept
+{
+    if (enabled && !m_supported)
+        std::cerr << "gpu culling: the device lacks indirect count draws or compute on the graphics queue, culling on the cpu" << std::endl;
+
+    m_enabled = enabled && m_supported;
+}
+
+void GpuCulling::SetOcclusionCulling(bool enabled) noexcept
+{
+    m_occlusionCulling = enabled;
+}
+
+void GpuCulling::SetVerification(bool enabled)
+{
+    m_verification = enabled && m_supported;
+
+    if (m_verification && m_readbacks.empty() && m_pyramidImage != VK_NULL_HANDLE)
+        CreateReadbacks();
+}
+
+bool GpuCulling::IsSupported() const noexcept
+{
+    return m_supported;
+}
+
+bool GpuCulling::IsActive() const noexcept
+{
+    return m_supported && m_enabled;
+}
+
+bool GpuCulling::IsOcclusionSupported() const noexcept
+{
+    return m_occlusionSupported;
+}
+
+VkBuffer GpuCulling::GetDrawBuffer() noexcept
+{
+    return m_drawBuffer;
+}
+
+VkDeviceSize GpuCulling::GetCountOffset(size_t frame) const noexcept
+{
+    return m_frameDrawSize * frame;
+}
+
+VkDeviceSize GpuCulling::GetCommandOffset(size_t frame) const noexcept
+{
+    return m_frameDrawSize * frame + COUNT_SIZE;
+}
+
+VkDeviceSize GpuCulling::GetReadbackPyramidOffset() const noexcept
+{
+    return AlignUp(DRAW_LIST_SIZE, 16);
+}
+
+} // namespace MineClone
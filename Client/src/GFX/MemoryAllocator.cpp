@@ -0,0 +1,410 @@
+#include <MineClone/GFX/MemoryAllocator.hpp>
+
+#include <MineClone/GFX/VulkanContext.hpp>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace MineClone
+{
+
+namespace
+{
+
+// small heaps (integrated GPUs, the 256 MiB BAR window) get proportionally smaller blocks
+constexpr VkDeviceSize SMALL_HEAP_SIZE = VkDeviceSize{1} << 30;
+constexpr VkDeviceSize SMALL_HEAP_BLOCK_DIVISOR = 8;
+
+constexpr double MEBIBYTE = 1024.0 * 1024.0;
+
+constexpr VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment) noexcept
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+} // namespace
+
+double MemoryTypeStatistics::Fragmentation() const noexcept
+{
+    const VkDeviceSize free = ReservedBytes - UsedBytes;
+    return free == 0 ? 0.0 : 1.0 - static_cast<double>(LargestFreeRange) / static_cast<double>(free);
+}
+
+MemoryAllocator::~MemoryAllocator()
+{
+    Destroy();
+}
+
+void MemoryAllocator::Create(VulkanContext *context)
+{
+    m_context = context;
+
+    vkGetPhysicalDeviceMemoryProperties(m_context->GetPhysicalDevice(), &m_memoryProperties);
+    m_bufferImageGranularity = std::max<VkDeviceSize>(m_context->GetPhysicalDeviceProperties().limits.bufferImageGranularity, 1);
+
+    m_pools.resize(m_memoryProperties.memoryTypeCount);
+
+    for (uint32_t type = 0; type < m_memoryProperties.memoryTypeCount; type++)
+    {
+        const VkDeviceSize heapSize = m_memoryProperties.memoryHeaps[m_memoryProperties.memoryTypes[type].heapIndex].size;
+
+        if (heapSize <= SMALL_HEAP_SIZE)
+            m_pools[type].BlockSize = AlignUp(heapSize / SMALL_HEAP_BLOCK_DIVISOR, 1 << 20);
+    }
+}
+
+void MemoryAllocator::Destroy()
+{
+    if (m_context == nullptr)
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t leaked = 0;
+
+    for (MemoryTypePool &pool : m_pools)
+    {
+        leaked += pool.DedicatedCount;
+
+        for (std::unique_ptr<MemoryBlock> &block : pool.Blocks)
+        {
+            if (!block)
+                continue;
+
+            leaked += block->Heap.GetAllocationCount();
+            FreeDeviceMemory(block->Memory, block->Mapped);
+        }
+    }
+
+    if (leaked != 0)
+        std::cerr << "memory: " << leaked << " allocations were not freed" << std::endl;
+
+    m_pools.clear();
+    m_deviceAllocationCount = 0;
+    m_context = nullptr;
+}
+
+MemoryAllocation MemoryAllocator::Allocate(const VkMemoryRequirements &requirements, VkMemoryPropertyFlags properties, ResourceTiling tiling,
+                                           VkMemoryPropertyFlags preferred)
+{
+    VkDeviceSize size = requirements.size;
+    VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+
+    // optimal images get whole granularity pages, so a linear neighbour can never share one with them
+    if (tiling == ResourceTiling::Optimal && m_bufferImageGranularity > 1)
+    {
+        alignment = std::max(alignment, m_bufferImageGranularity);
+        size = AlignUp(size, m_bufferImageGranularity);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    MemoryAllocation allocation{};
+
+    const std::optional<uint32_t> preferredType = preferred != 0 ? FindMemoryType(requirements.memoryTypeBits, properties | preferred) : std::nullopt;
+    if (preferredType && AllocateFromType(*preferredType, size, alignment, allocation))
+        return allocation;
+
+    const std::optional<uint32_t> requiredType = FindMemoryType(requirements.memoryTypeBits, properties);
+    if (requiredType && requiredType != preferredType && AllocateFromType(*requiredType, size, alignment, allocation))
+        return allocation;
+
+    throw GraphicsException("failed to allocate " + std::to_string(size) + " bytes of device memory");
+}
+
+void MemoryAllocator::Free(MemoryAllocation &allocation)
+{
+    if (!allocation.IsValid())
+        return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    MemoryTypePool &pool = m_pools[allocation.MemoryType];
+
+    if (allocation.IsDedicated())
+    {
+        FreeDeviceMemory(allocation.Memory, allocation.Mapped);
+        pool.DedicatedCount--;
+        pool.DedicatedBytes -= allocation.Size;
+        allocation = {};
+        return;
+    }
+
+    std::unique_ptr<MemoryBlock> &block = pool.Blocks[allocation.Block];
+    block->Heap.Free(allocation.HeapBlock);
+
+    // keep one empty block around so a single allocation bouncing around zero doesn't hit vkAllocateMemory every time
+    if (block->Heap.IsEmpty())
+    {
+        const bool hasOtherEmpty = std::any_of(pool.Blocks.begin(), pool.Blocks.end(), [&](const std::unique_ptr<MemoryBlock> &other) {
+            return other && other != block && other->Heap.IsEmpty();
+        });
+
+        if (hasOtherEmpty)
+        {
+            FreeDeviceMemory(block->Memory, block->Mapped);
+            block.reset();
+        }
+    }
+
+    allocation = {};
+}
+
+void MemoryAllocator::CreateBuffer(const VkBufferCreateInfo &createInfo, VkMemoryPropertyFlags properties, VkBuffer &buffer,
+                                   MemoryAllocation &allocation, VkMemoryPropertyFlags preferred)
+{
+    if (vkCreateBuffer(m_context->GetDevice(), &createInfo, nullptr, &buffer) != VK_SUCCESS)
+        throw GraphicsException("failed to create a buffer");
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(m_context->GetDevice(), buffer, &requirements);
+
+    try
+    {
+        allocation = Allocate(requirements, properties, ResourceTiling::Linear, preferred);
+    }
+    catch (...)
+    {
+        vkDestroyBuffer(m_context->GetDevice(), buffer, nullptr);
+        buffer = VK_NULL_HANDLE;
+        throw;
+    }
+
+    vkBindBufferMemory(m_context->GetDevice(), buffer, allocation.Memory, allocation.Offset);
+}
+
+void MemoryAllocator::DestroyBuffer(VkBuffer &buffer, MemoryAllocation &allocation)
+{
+    if (buffer != VK_NULL_HANDLE)
+    {
+        vkDestroyBuffer(m_context->GetDevice(), buffer, nullptr);
+        buffer = VK_NULL_HANDLE;
+    }
+
+    Free(allocation);
+}
+
+void MemoryAllocator::CreateImage(const VkImageCreateInfo &createInfo, VkMemoryPropertyFlags properties, VkImage &image,
+                                  MemoryAllocation &allocation)
+{
+    if (vkCreateImage(m_context->GetDevice(), &createInfo, nullptr, &image) != VK_SUCCESS)
+        throw GraphicsException("failed to create an image");
+
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(m_context->GetDevice(), image, &requirements);
+
+    const ResourceTiling tiling = createInfo.tiling == VK_IMAGE_TILING_LINEAR ? ResourceTiling::Linear : ResourceTiling::Optimal;
+
+    try
+    {
+        allocation = Allocate(requirements, properties, tiling);
+    }
+    catch (...)
+    {
+        vkDestroyImage(m_context->GetDevice(), image, nullptr);
+        image = VK_NULL_HANDLE;
+        throw;
+    }
+
+    vkBindImageMemory(m_context->GetDevice(), image, allocation.Memory, allocation.Offset);
+}
+
+void MemoryAllocator::DestroyImage(VkImage &image, MemoryAllocation &allocation)
+{
+    if (image != VK_NULL_HANDLE)
+    {
+        vkDestroyImage(m_context->GetDevice(), image, nullptr);
+        image = VK_NULL_HANDLE;
+    }
+
+    Free(allocation);
+}
+
+MemoryStatistics MemoryAllocator::GetStatistics()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    MemoryStatistics statistics{};
+    statistics.DeviceAllocationCount = m_deviceAllocationCount;
+    statistics.MaxDeviceAllocationCount = m_context ? m_context->GetPhysicalDeviceProperties().limits.maxMemoryAllocationCount : 0;
+    statistics.Types.resize(m_pools.size());
+
+    for (size_t type = 0; type < m_pools.size(); type++)
+    {
+        const MemoryTypePool &pool = m_pools[type];
+        MemoryTypeStatistics &current = statistics.Types[type];
+
+        current.DedicatedCount = pool.DedicatedCount;
+        current.AllocationCount = pool.DedicatedCount;
+        current.ReservedBytes = pool.DedicatedBytes;
+        current.UsedBytes = pool.DedicatedBytes;
+
+        for (const std::unique_ptr<MemoryBlock> &block : pool.Blocks)
+        {
+            if (!block)
+                continue;
+
+            current.BlockCount++;
+            current.AllocationCount += block->Heap.GetAllocationCount();
+            current.ReservedBytes += block->Heap.GetSize();
+            current.UsedBytes += block->Heap.GetUsedSize();
+            current.FreeRangeCount += block->Heap.GetFreeRangeCount();
+            current.LargestFreeRange = std::max(current.LargestFreeRange, block->Heap.GetLargestFreeRange());
+        }
+    }
+
+    return statistics;
+}
+
+const VkPhysicalDeviceMemoryProperties &MemoryAllocator::GetMemoryProperties() const noexcept
+{
+    return m_memoryProperties;
+}
+
+void MemoryAllocator::Dump(std::ostream &stream)
+{
+    const MemoryStatistics statistics = GetStatistics();
+
+    const std::ios::fmtflags flags = stream.flags();
+    stream << std::fixed << std::setprecision(2);
+
+    stream << "device memory (" << statistics.DeviceAllocationCount << " of " << statistics.MaxDeviceAllocationCount << " allocations):\n";
+
+    for (size_t type = 0; type < statistics.Types.size(); type++)
+    {
+        const MemoryTypeStatistics &current = statistics.Types[type];
+
+        if (current.BlockCount == 0 && current.DedicatedCount == 0)
+            continue;
+
+        stream << "  type " << std::setw(2) << type << "  " << current.BlockCount << " blocks, " << current.DedicatedCount << " dedicated, "
+               << current.AllocationCount << " allocations, " << current.UsedBytes / MEBIBYTE << " / " << current.ReservedBytes / MEBIBYTE
+               << " MiB used, " << current.FreeRangeCount << " free ranges, " << current.Fragmentation() * 100.0 << "% fragmented\n";
+    }
+
+    stream.flags(flags);
+}
+
+std::optional<uint32_t> MemoryAllocator::FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const noexcept
+{
+    for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++)
+    {
+        if ((typeBits & (1u << i)) && (m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+            return i;
+    }
+
+    return std::nullopt;
+}
+
+bool MemoryAllocator::AllocateFromType(uint32_t memoryType, VkDeviceSize size, VkDeviceSize alignment, MemoryAllocation &allocation)
+{
+    MemoryTypePool &pool = m_pools[memoryType];
+
+    // large resources would mostly waste a shared block
+    if (size > pool.BlockSize / 2)
+        return AllocateDedicated(memoryType, size, allocation);
+
+    TlsfHeap::Allocation heapAllocation{};
+    size_t blockIndex = 0;
+
+    for (; blockIndex < pool.Blocks.size(); blockIndex++)
+    {
+        if (pool.Blocks[blockIndex] && pool.Blocks[blockIndex]->Heap.Allocate(size, alignment, heapAllocation))
+            break;
+    }
+
+    if (blockIndex == pool.Blocks.size())
+    {
+        auto block = std::make_unique<MemoryBlock>(pool.BlockSize);
+        block->Memory = AllocateDeviceMemory(memoryType, pool.BlockSize, &block->Mapped);
+
+        // the heap may be too full for another block but still fit the resource itself
+        if (block->Memory == VK_NULL_HANDLE)
+            return AllocateDedicated(memoryType, size, allocation);
+
+        if (!block->Heap.Allocate(size, alignment, heapAllocation))
+            throw GraphicsException("a fresh memory block could not fit the allocation");
+
+        const auto freeSlot = std::find_if(pool.Blocks.begin(), pool.Blocks.end(), [](const std::unique_ptr<MemoryBlock> &slot) { return !slot; });
+        blockIndex = static_cast<size_t>(freeSlot - pool.Blocks.begin());
+
+        if (freeSlot == pool.Blocks.end())
+            pool.Blocks.push_back(std::move(block));
+        else
+            *freeSlot = std::move(block);
+    }
+
+    const MemoryBlock &block = *pool.Blocks[blockIndex];
+
+    allocation.Memory = block.Memory;
+    allocation.Offset = heapAllocation.Offset;
+    allocation.Size = size;
+    allocation.Mapped = block.Mapped ? static_cast<char *>(block.Mapped) + heapAllocation.Offset : nullptr;
+    allocation.MemoryType = memoryType;
+    allocation.Block = static_cast<uint32_t>(blockIndex);
+    allocation.HeapBlock = heapAllocation.Block;
+    return true;
+}
+
+bool MemoryAllocator::AllocateDedicated(uint32_t memoryType, VkDeviceSize size, MemoryAllocation &allocation)
+{
+    void *mapped = nullptr;
+    const VkDeviceMemory memory = AllocateDeviceMemory(memoryType, size, &mapped);
+
+    if (memory == VK_NULL_HANDLE)
+        return false;
+
+    m_pools[memoryType].DedicatedCount++;
+    m_pools[memoryType].DedicatedBytes += size;
+
+    allocation.Memory = memory;
+    allocation.Offset = 0;
+    allocation.Size = size;
+    allocation.Mapped = mapped;
+    allocation.MemoryType = memoryType;
+    allocation.Block = 0;
+    allocation.HeapBlock = TlsfHeap::INVALID_BLOCK;
+    return true;
+}
+
+VkDeviceMemory MemoryAllocator::AllocateDeviceMemory(uint32_t memoryType, VkDeviceSize size, void **mapped)
+{
+    if (m_deviceAllocationCount >= m_context->GetPhysicalDeviceProperties().limits.maxMemoryAllocationCount)
+        return VK_NULL_HANDLE;
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryType;
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    if (vkAllocateMemory(m_context->GetDevice(), &allocInfo, nullptr, &memory) != VK_SUCCESS)
+        return VK_NULL_HANDLE;
+
+    m_deviceAllocationCount++;
+
+    *mapped = nullptr;
+
+    if (m_memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        if (vkMapMemory(m_context->GetDevice(), memory, 0, VK_WHOLE_SIZE, 0, mapped) != VK_SUCCESS)
+        {
+            FreeDeviceMemory(memory, nullptr);
+            throw GraphicsException("failed to map host visible memory");
+        }
+    }
+
+    return memory;
+}
+
+void MemoryAllocator::FreeDeviceMemory(VkDeviceMemory memory, void *mapped)
+{
+    if (mapped != nullptr)
+        vkUnmapMemory(m_context->GetDevice(), memory);
+
+    vkFreeMemory(m_context->GetDevice(), memory, nullptr);
+    m_deviceAllocationCount--;
+}
+
+} // namespace MineClone
@@ -0,0 +1,294 @@
+#include <MineClone/GFX/Mipmaps.hpp>
+
+#include <MineClone/Simd.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace MineClone
+{
+
+namespace
+{
+
+// Kaiser window shape, higher trades sharpness for less ringing
+constexpr double KAISER_BETA = 4.0;
+
+// taps on each side of the center of a 2:1 reduction
+constexpr int KAISER_RADIUS = 3;
+
+constexpr size_t LINEAR_TO_SRGB_STEPS = 4096;
+
+constexpr std::array<const char *, static_cast<size_t>(MipFilter::Count)> FILTER_NAMES = {"box", "kaiser"};
+
+struct Kernel
+{
+    int First; // offset of the first tap from 2x
+    std::vector<float> Weights;
+}; // struct Kernel
+
+// one float plane per channel, linear light
+struct Planes
+{
+    uint32_t Width, Height;
+    std::array<std::vector<float>, 4> Channels;
+}; // struct Planes
+
+double BesselI0(double x) noexcept
+{
+    double sum = 1.0, term = 1.0;
+
+    for (int k = 1; k < 32; k++)
+    {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+
+    return sum;
+}
+
+Kernel MakeKernel(MipFilter filter)
+{
+    if (filter == MipFilter::Box)
+        return {0, {0.5f, 0.5f}};
+
+    // the taps sit at half texel offsets around the center between texels 2x and 2x + 1
+    Kernel kernel{1 - KAISER_RADIUS, {}};
+    double total = 0.0;
+    std::vector<double> weights;
+
+    for (int tap = 0; tap < 2 * KAISER_RADIUS; tap++)
+    {
+        const double t = tap - KAISER_RADIUS + 0.5;
+
+        // half band sinc for the 2:1 reduction, windowed to the support
+        const double x = 3.14159265358979 * t / 2.0;
+        const double sinc = std::sin(x) / x;
+        const double ratio = t / KAISER_RADIUS;
+        const double window = BesselI0(KAISER_BETA * std::sqrt(std::max(0.0, 1.0 - ratio * ratio))) / BesselI0(KAISER_BETA);
+
+        weights.push_back(sinc * window);
+        total += weights.back();
+    }
+
+    for (const double weight : weights)
+        kernel.Weights.push_back(static_cast<float>(weight / total));
+
+    return kernel;
+}
+
+const Kernel &GetKernel(MipFilter filter)
+{
+    static const std::array<Kernel, static_cast<size_t>(MipFilter::Count)> kernels = {MakeKernel(MipFilter::Box), MakeKernel(MipFilter::Kaiser)};
+    return kernels[static_cast<size_t>(filter)];
+}
+
+const std::array<float, 256> &GetSrgbToLinear()
+{
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> result{};
+
+        for (size_t i = 0; i < result.size(); i++)
+        {
+            const double srgb = static_cast<double>(i) / 255.0;
+            result[i] = static_cast<float>(srgb <= 0.04045 ? srgb / 12.92 : std::pow((srgb + 0.055) / 1.055, 2.4));
+        }
+
+        return result;
+    }();
+
+    return table;
+}
+
+const std::array<uint8_t, LINEAR_TO_SRGB_STEPS> &GetLinearToSrgb()
+{
+    static const std::array<uint8_t, LINEAR_TO_SRGB_STEPS> table = [] {
+        std::array<uint8_t, LINEAR_TO_SRGB_STEPS> result{};
+
+        for (size_t i = 0; i < result.size(); i++)
+        {
+            const double linear = static_cast<double>(i) / (LINEAR_TO_SRGB_STEPS - 1);
+            const double srgb = linear <= 0.0031308 ? linear * 12.92 : 1.055 * std::pow(linear, 1.0 / 2.4) - 0.055;
+            result[i] = static_cast<uint8_t>(std::lround(srgb * 255.0));
+        }
+
+        return result;
+    }();
+
+    return table;
+}
+
+Planes ToPlanes(const TextureImage &image)
+{
+    const std::array<float, 256> &toLinear = GetSrgbToLinear();
+    const size_t count = image.Texels.size();
+
+    Planes planes{image.Width, image.Height, {}};
+    for (std::vector<float> &channel : planes.Channels)
+        channel.resize(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint32_t texel = image.Texels[i];
+        planes.Channels[0][i] = toLinear[texel & 0xFF];
+        planes.Channels[1][i] = toLinear[texel >> 8 & 0xFF];
+        planes.Channels[2][i] = toLinear[texel >> 16 & 0xFF];
+        planes.Channels[3][i] = static_cast<float>(texel >> 24) / 255.0f; // alpha is linear already
+    }
+
+    return planes;
+}
+
+TextureImage FromPlanes(const Planes &planes)
+{
+    const std::array<uint8_t, LINEAR_TO_SRGB_STEPS> &toSrgb = GetLinearToSrgb();
+
+    // the negative lobes of the Kaiser kernel overshoot at hard edges
+    const auto srgb = [&toSrgb](float linear) {
+        return static_cast<uint32_t>(toSrgb[static_cast<size_t>(std::clamp(linear, 0.0f, 1.0f) * (LINEAR_TO_SRGB_STEPS - 1) + 0.5f)]);
+    };
+
+    TextureImage image{planes.Width, planes.Height, {}};
+    image.Texels.resize(size_t{planes.Width} * planes.Height);
+
+    for (size_t i = 0; i < image.Texels.size(); i++)
+    {
+        const auto alpha = static_cast<uint32_t>(std::lround(std::clamp(planes.Channels[3][i], 0.0f, 1.0f) * 255.0f));
+        image.Texels[i] = srgb(planes.Channels[0][i]) | srgb(planes.Channels[1][i]) << 8 | srgb(planes.Channels[2][i]) << 16 | alpha << 24;
+    }
+
+    return image;
+}
+
+// halves the height, every output row is a weighted sum of whole input rows so the texels of a row go through in lanes
+void FilterRows(Planes &planes, const Kernel &kernel)
+{
+    const size_t width = planes.Width;
+    const uint32_t height = planes.Height / 2;
+    const size_t vectorWidth = width - width % Simd::LANES;
+
+    for (std::vector<float> &channel : planes.Channels)
+    {
+        std::vector<float> filtered(width * height, 0.0f);
+
+        for (uint32_t y = 0; y < height; y++)
+        {
+            float *out = filtered.data() + y * width;
+
+            for (size_t tap = 0; tap < kernel.Weights.size(); tap++)
+            {
+                // wraps around, the textures tile
+                const int64_t row = (int64_t{2} * y + kernel.First + static_cast<int64_t>(tap) + planes.Height) % planes.Height;
+                const float *in = channel.data() + row * width;
+                const float weight = kernel.Weights[tap];
+                const Simd::Float weights = Simd::Set(weight);
+
+                size_t x = 0;
+                for (; x < vectorWidth; x += Simd::LANES)
+                    Simd::Store(out + x, Simd::MulAdd(Simd::Load(in + x), weights, Simd::Load(out + x)));
+
+                for (; x < width; x++)
+                    out[x] += in[x] * weight;
+            }
+        }
+
+        channel = std::move(filtered);
+    }
+
+    planes.Height = height;
+}
+
+void Transpose(Planes &planes)
+{
+    const size_t width = planes.Width, height = planes.Height;
+
+    for (std::vector<float> &channel : planes.Channels)
+    {
+        std::vector<float> transposed(channel.size());
+
+        for (size_t y = 0; y < height; y++)
+        {
+            for (size_t x = 0; x < width; x++)
+                transposed[x * height + y] = channel[y * width + x];
+        }
+
+        channel = std::move(transposed);
+    }
+
+    std::swap(planes.Width, planes.Height);
+}
+
+bool IsPowerOfTwo(uint32_t value) noexcept
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+} // namespace
+
+namespace Mipmaps
+{
+
+const char *GetFilterName(MipFilter filter) noexcept
+{
+    return FILTER_NAMES[static_cast<size_t>(filter)];
+}
+
+bool ParseFilter(const std::string &name, MipFilter &filter) noexcept
+{
+    const auto found = std::find(FILTER_NAMES.begin(), FILTER_NAMES.end(), name);
+    if (found == FILTER_NAMES.end())
+        return false;
+
+    filter = static_cast<MipFilter>(found - FILTER_NAMES.begin());
+    return true;
+}
+
+uint32_t GetLevelCount(uint32_t width, uint32_t height) noexcept
+{
+    uint32_t levels = 1;
+
+    for (uint32_t size = std::max(width, height); size > 1; size >>= 1)
+        levels++;
+
+    return levels;
+}
+
+TextureImage Downsample(const TextureImage &image, MipFilter filter)
+{
+    ASSERT(IsPowerOfTwo(image.Width) && IsPowerOfTwo(image.Height), "mip chains need power of two sizes");
+    ASSERT(image.Texels.size() == size_t{image.Width} * image.Height, "texel count doesn't match the size");
+
+    const Kernel &kernel = GetKernel(filter);
+    Planes planes = ToPlanes(image);
+
+    // the vertical pass runs on rows, the horizontal one on the rows of the transposed image
+    if (planes.Height > 1)
+        FilterRows(planes, kernel);
+
+    if (planes.Width > 1)
+    {
+        Transpose(planes);
+        FilterRows(planes, kernel);
+        Transpose(planes);
+    }
+
+    return FromPlanes(planes);
+}
+
+std::vector<TextureImage> GenerateChain(const TextureImage &image, MipFilter filter)
+{
+    std::vector<TextureImage> chain;
+    chain.reserve(GetLevelCount(image.Width, image.Height));
+    chain.push_back(image);
+
+    // every level from the one above, the kernel was designed for exactly 2:1
+    while (chain.back().Width > 1 || chain.back().Height > 1)
+        chain.push_back(Downsample(chain.back(), filter));
+
+    return chain;
+}
+
+} // namespace Mipmaps
+
+} // namespace MineClone
@@ -0,0 +1,139 @@
+#include <MineClone/GFX/PipelineCache.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include <MineClone/GFX/VulkanContext.hpp>
+
+namespace MineClone
+{
+
+namespace
+{
+
+// layout of VK_PIPELINE_CACHE_HEADER_VERSION_ONE, see the vkGetPipelineCacheData spec
+struct PipelineCacheHeader
+{
+    uint32_t HeaderSize;
+    uint32_t HeaderVersion;
+    uint32_t VendorID;
+    uint32_t DeviceID;
+    uint8_t PipelineCacheUUID[VK_UUID_SIZE];
+};
+
+static_assert(sizeof(PipelineCacheHeader) == 16 + VK_UUID_SIZE);
+
+} // namespace
+
+PipelineCache::~PipelineCache()
+{
+    Destroy();
+}
+
+void PipelineCache::Create(VulkanContext *context, std::string path)
+{
+    Destroy();
+    m_context = context;
+    m_path = std::move(path);
+
+    std::vector<char> data = Load();
+
+    if (!data.empty() && !IsCompatible(data))
+    {
+        std::cerr << "pipeline cache: " << m_path << " was created by a different device or driver, discarding" << std::endl;
+        data.clear();
+    }
+
+    VkPipelineCacheCreateInfo createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    createInfo.initialDataSize = data.size();
+    createInfo.pInitialData = data.empty() ? nullptr : data.data();
+
+    if (vkCreatePipelineCache(m_context->GetDevice(), &createInfo, nullptr, &m_cache) != VK_SUCCESS)
+        throw GraphicsException("failed to create pipeline cache");
+}
+
+void PipelineCache::Save()
+{
+    if (m_cache == VK_NULL_HANDLE)
+        return;
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(m_context->GetDevice(), m_cache, &size, nullptr) != VK_SUCCESS || size == 0)
+        return;
+
+    std::vector<char> data(size);
+    if (vkGetPipelineCacheData(m_context->GetDevice(), m_cache, &size, data.data()) != VK_SUCCESS)
+        return;
+
+    const std::string temporaryPath = m_path + ".tmp";
+
+    {
+        std::ofstream file{temporaryPath, std::ios::binary | std::ios::trunc};
+        file.write(data.data(), static_cast<std::streamsize>(size));
+
+        if (!file)
+        {
+            std::cerr << "pipeline cache: failed to write " << temporaryPath << std::endl;
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, m_path, error);
+
+    if (error)
+        std::cerr << "pipeline cache: failed to replace " << m_path << ": " << error.message() << std::endl;
+}
+
+void PipelineCache::Destroy()
+{
+    if (m_cache == VK_NULL_HANDLE)
+        return;
+
+    Save();
+
+    vkDestroyPipelineCache(m_context->GetDevice(), m_cache, nullptr);
+    m_cache = VK_NULL_HANDLE;
+}
+
+VkPipelineCache PipelineCache::GetVkPipelineCache() noexcept
+{
+    return m_cache;
+}
+
+std::vector<char> PipelineCache::Load() const
+{
+    std::ifstream file{m_path, std::ios::binary | std::ios::ate};
+
+    if (!file)
+        return {};
+
+    std::vector<char> data(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+
+    if (!file.read(data.data(), static_cast<std::streamsize>(data.size())))
+        return {};
+
+    return data;
+}
+
+bool PipelineCache::IsCompatible(const std::vector<char> &data) const
+{
+    if (data.size() < sizeof(PipelineCacheHeader))
+        return false;
+
+    PipelineCacheHeader header{};
+    std::memcpy(&header, data.data(), sizeof(header));
+
+    const VkPhysicalDeviceProperties &properties = m_context->GetPhysicalDeviceProperties();
+
+    return header.HeaderSize >= sizeof(PipelineCacheHeader) && header.HeaderSize <= data.size() &&
+           header.HeaderVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE && header.VendorID == properties.vendorID &&
+           header.DeviceID == properties.deviceID &&
+           std::memcmp(header.PipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+} // namespace MineClone
@@ -0,0 +1,223 @@
+#include <MineClone/GFX/SectionVisibility.hpp>
+
+#include <MineClone/GFX/Frustum.hpp>
+#include <MineClone/Simd.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr int32_t OFFSETS[BLOCK_FACE_COUNT][3] = {{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}};
+
+// faces come in positive, negative pairs
+constexpr size_t Opposite(size_t face) noexcept
+{
+    return face ^ 1;
+}
+
+inline uint64_t Key(int32_t x, int32_t y, int32_t z) noexcept
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x) & 0xFFFFFF) << 40) | (static_cast<uint64_t>(static_cast<uint32_t>(z) & 0xFFFFFF) << 16) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(y) & 0xFFFF));
+}
+
+} // namespace
+
+uint32_t SectionVisibility::Add(int32_t x, int32_t y, int32_t z, SectionConnectivity connectivity)
+{
+    uint32_t index = static_cast<uint32_t>(m_nodes.size());
+
+    if (!m_free.empty())
+    {
+        index = m_free.back();
+        m_free.pop_back();
+    }
+
+    const auto [entry, inserted] = m_indices.emplace(Key(x, y, z), index);
+    ASSERT(inserted, "section was added twice");
+
+    Node &node = index == m_nodes.size() ? m_nodes.emplace_back() : m_nodes[index];
+    node.X = x;
+    node.Y = y;
+    node.Z = z;
+    node.Connectivity = connectivity;
+
+    // link up with the neighbors that are already loaded
+    for (size_t face = 0; face < BLOCK_FACE_COUNT; face++)
+    {
+        const uint32_t neighbor = Find(x + OFFSETS[face][0], y + OFFSETS[face][1], z + OFFSETS[face][2]);
+        node.Neighbors[face] = neighbor;
+
+        if (neighbor != INVALID)
+            m_nodes[neighbor].Neighbors[Opposite(face)] = index;
+    }
+
+    if (m_minX.size() <= index)
+    {
+        m_minX.resize(m_minX.size() + Simd::LANES, 0.0f);
+        m_minY.resize(m_minY.size() + Simd::LANES, 0.0f);
+        m_minZ.resize(m_minZ.size() + Simd::LANES, 0.0f);
+    }
+
+    m_minX[index] = static_cast<float>(x * ChunkSection::SIZE);
+    m_minY[index] = static_cast<float>(y * ChunkSection::SIZE);
+    m_minZ[index] = static_cast<float>(z * ChunkSection::SIZE);
+
+    if (m_inFrustum.size() <= index)
+    {
+        m_inFrustum.push_back(0);
+        m_visitedFrame.push_back(0);
+    }
+
+    return index;
+}
+
+void SectionVisibility::Remove(uint32_t index)
+{
+    Node &node = m_nodes[index];
+    m_indices.erase(Key(node.X, node.Y, node.Z));
+
+    for (size_t face = 0; face < BLOCK_FACE_COUNT; face++)
+    {
+        if (node.Neighbors[face] != INVALID)
+            m_nodes[node.Neighbors[face]].Neighbors[Opposite(face)] = INVALID;
+
+        node.Neighbors[face] = INVALID;
+    }
+
+    m_removed.push_back(index);
+}
+
+void SectionVisibility::Release(uint32_t index)
+{
+    const auto removed = std::find(m_removed.begin(), m_removed.end(), index);
+    ASSERT(removed != m_removed.end(), "section was released without being removed");
+
+    *removed = m_removed.back();
+    m_removed.pop_back();
+    m_free.push_back(index);
+}
+
+void SectionVisibility::Clear() noexcept
+{
+    m_nodes.clear();
+    m_indices.clear();
+    m_removed.clear();
+    m_free.clear();
+    m_minX.clear();
+    m_minY.clear();
+    m_minZ.clear();
+    m_inFrustum.clear();
+    m_visitedFrame.clear();
+    m_statistics = {};
+}
+
+uint32_t SectionVisibility::Find(int32_t x, int32_t y, int32_t z) const
+{
+    const auto entry = m_indices.find(Key(x, y, z));
+    return entry == m_indices.end() ? INVALID : entry->second;
+}
+
+void SectionVisibility::Update(const Camera &camera, std::vector<uint32_t> &visible)
+{
+    visible.clear();
+
+    const Frustum frustum{camera.GetViewProjection()};
+    frustum.TestCubes(m_minX.data(), m_minY.data(), m_minZ.data(), static_cast<float>(ChunkSection::SIZE), m_nodes.size(), m_inFrustum.data());
+
+    // unused nodes keep their old bounds, neither pass below may pick them
+    for (const std::vector<uint32_t> *unused : {&m_removed, &m_free})
+    {
+        for (const uint32_t index : *unused)
+            m_inFrustum[index] = 0;
+    }
+
+    m_statistics.Loaded = GetSectionCount();
+    m_statistics.InFrustum = 0;
+
+    for (const uint8_t inFrustum : m_inFrustum)
+        m_statistics.InFrustum += inFrustum;
+
+    const auto cameraSection = [](float position) {
+        return static_cast<int32_t>(std::floor(position / static_cast<float>(ChunkSection::SIZE)));
+    };
+
+    const uint32_t start = Find(cameraSection(camera.GetX()), cameraSection(camera.GetY()), cameraSection(camera.GetZ()));
+
+    if (!m_occlusionCulling || start == INVALID)
+    {
+        for (uint32_t index = 0; index < m_nodes.size(); index++)
+        {
+            if (m_inFrustum[index])
+                visible.push_back(index);
+        }
+
+        m_statistics.Visible = visible.size();
+        return;
+    }
+
+    // a fresh stamp instead of clearing the visited flags, they only need a reset when it wraps around
+    if (++m_frame == 0)
+    {
+        std::fill(m_visitedFrame.begin(), m_visitedFrame.end(), 0);
+        m_frame = 1;
+    }
+
+    m_queue.clear();
+    m_queue.push_back({start, static_cast<uint8_t>(BLOCK_FACE_COUNT), 0});
+    m_visitedFrame[start] = m_frame;
+
+    for (size_t head = 0; head < m_queue.size(); head++)
+    {
+        const Step step = m_queue[head];
+        const Node &node = m_nodes[step.Section];
+        visible.push_back(step.Section);
+
+        for (size_t face = 0; face < BLOCK_FACE_COUNT; face++)
+        {
+            // never head back towards the camera, and only leave through faces the way in connects to
+            if (step.Directions >> Opposite(face) & 1)
+                continue;
+
+            if (step.Entry != BLOCK_FACE_COUNT && !node.Connectivity.Connects(static_cast<BlockFace>(step.Entry), static_cast<BlockFace>(face)))
+                continue;
+
+            const uint32_t neighbor = node.Neighbors[face];
+
+            if (neighbor == INVALID || m_visitedFrame[neighbor] == m_frame || !m_inFrustum[neighbor])
+                continue;
+
+            m_visitedFrame[neighbor] = m_frame;
+            m_queue.push_back({neighbor, static_cast<uint8_t>(Opposite(face)), static_cast<uint8_t>(step.Directions | 1u << face)});
+        }
+    }
+
+    m_statistics.Visible = visible.size();
+}
+
+void SectionVisibility::SetOcclusionCulling(bool enabled) noexcept
+{
+    m_occlusionCulling = enabled;
+}
+
+bool SectionVisibility::IsOcclusionCullingEnabled() const noexcept
+{
+    return m_occlusionCulling;
+}
+
+size_t SectionVisibility::GetSectionCount() const noexcept
+{
+    return m_nodes.size() - m_removed.size() - m_free.size();
+}
+
+const VisibilityStatistics &SectionVisibility::GetStatistics() const noexcept
+{
+    return m_statistics;
+}
+
+} // namespace MineClone
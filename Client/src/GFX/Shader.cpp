@@ -9,39 +9,63 @@
 namespace MineClone
 {
 
-CompiledShader ShaderCompiler::Compile(const std::string &data, const std::string &name, shaderc_shader_kind kind)
+#ifdef MINECLONE_RUNTIME_SHADER_COMPILER
+CompiledShader ShaderCompiler::Compile(const std::string &data, const std::string &name, VkShaderStageFlagBits stage)
 {
 #ifdef OPTIMIZE_SHADERS
     m_options.SetOptimizationLevel(shaderc_optimization_level_performance);
 #endif
 
+    shaderc_shader_kind kind;
+
+    switch (stage)
+    {
+    case VK_SHADER_STAGE_FRAGMENT_BIT:
+        kind = shaderc_fragment_shader;
+        break;
+    case VK_SHADER_STAGE_VERTEX_BIT:
+        kind = shaderc_vertex_shader;
+        break;
+    case VK_SHADER_STAGE_COMPUTE_BIT:
+        kind = shaderc_compute_shader;
+        break;
+    default:
+        throw ShaderException("Unknown shader stage " + std::to_string(stage));
+    }
+
     shaderc::SpvCompilationResult result = m_compiler.CompileGlslToSpv(data, kind, name.c_str(), m_options);
 
     if (result.GetCompilationStatus() != shaderc_compilation_status_success)
         throw ShaderException(result.GetErrorMessage());
 
-    return CompiledShader{name, kind, std::vector<uint32_t>{std::begin(result), std::end(result)}};
+    return CompiledShader{name, stage, std::vector<uint32_t>{std::begin(result), std::end(result)}};
 }
+#endif
 
-ShaderModule::ShaderModule(VkDevice device, const CompiledShader &compiledShader)
-    : m_device{device}, m_kind{compiledShader.Kind}
+ShaderModule::ShaderModule(VkDevice device, VkShaderStageFlagBits stage, const uint32_t *code, size_t codeSize)
+    : m_device{device}, m_stage{stage}
 {
     VkShaderModuleCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    createInfo.codeSize = compiledShader.Data.size() * sizeof(uint32_t);
-    createInfo.pCode = compiledShader.Data.data();
+    createInfo.codeSize = codeSize;
+    createInfo.pCode = code;
 
     if (vkCreateShaderModule(m_device, &createInfo, nullptr, &m_module) != VK_SUCCESS)
         throw ShaderException("Failed to create shader module");
 }
 
+ShaderModule::ShaderModule(VkDevice device, const CompiledShader &compiledShader)
+    : ShaderModule(device, compiledShader.Stage, compiledShader.Data.data(), compiledShader.Data.size() * sizeof(uint32_t))
+{
+}
+
 ShaderModule::~ShaderModule()
 {
     Destroy();
 }
 
 ShaderModule::ShaderModule(ShaderModule &&rhs) noexcept
-    : m_device{rhs.m_device}, m_kind{rhs.m_kind}, m_module{rhs.m_module}
+    : m_device{rhs.m_device}, m_stage{rhs.m_stage}, m_module{rhs.m_module}
 {
     rhs.m_module = VK_NULL_HANDLE;
 }
@@ -49,7 +73,7 @@ ShaderModule::ShaderModule(ShaderModule &&rhs) noexcept
 ShaderModule &ShaderModule::operator=(ShaderModule &&rhs) noexcept
 {
     m_device = rhs.m_device;
-    m_kind = rhs.m_kind;
+    m_stage = rhs.m_stage;
     m_module = rhs.m_module;
     rhs.m_module = VK_NULL_HANDLE;
     return *this;
@@ -69,28 +93,16 @@ VkShaderModule ShaderModule::GetVkModule() const noexcept
     return m_module;
 }
 
-shaderc_shader_kind ShaderModule::GetKind() const noexcept
+VkShaderStageFlagBits ShaderModule::GetStage() const noexcept
 {
-    return m_kind;
+    return m_stage;
 }
 
 VkPipelineShaderStageCreateInfo ShaderModule::CreateInfo() const
 {
     VkPipelineShaderStageCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-
-    switch (GetKind())
-    {
-    case shaderc_fragment_shader:
-        createInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-        break;
-    case shaderc_vertex_shader:
-        createInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-        break;
-    default:
-        throw ShaderException("Unknown shader kind " + std::to_string(GetKind()));
-    }
-
+    createInfo.stage = GetStage();
     createInfo.module = GetVkModule();
     createInfo.pName = "main";
     return createInfo;
@@ -1,13 +1,11 @@
 #include <MineClone/GFX/SwapChain.hpp>
 
 #include <algorithm>
+#include <array>
 
-#include <MineClone/GFX/Shader.hpp>
 #include <MineClone/GFX/VulkanContext.hpp>
 #include <MineClone/Utility.hpp>
 
-#include <MineClone_Client_Shaders.hpp>
-
 namespace MineClone
 {
 
@@ -19,9 +17,16 @@ bool IsFormatBest(const VkSurfaceFormatKHR &format)
     return format.format == VK_FORMAT_B8G8R8A8_SRGB && format.colorSpace == VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
 }
 
-bool IsPresentModeBest(const VkPresentModeKHR &mode)
+// the first of the preferred modes the surface supports
+VkPresentModeKHR SelectPresentMode(const std::vector<VkPresentModeKHR> &supported, const std::vector<VkPresentModeKHR> &preferred)
 {
-    return mode == VK_PRESENT_MODE_MAILBOX_KHR;
+    for (const VkPresentModeKHR mode : preferred)
+    {
+        if (std::find(supported.begin(), supported.end(), mode) != supported.end())
+            return mode;
+    }
+
+    return VK_PRESENT_MODE_FIFO_KHR;
 }
 
 } // namespace
@@ -33,22 +38,25 @@ SwapChain::~SwapChain()
 
 void SwapChain::Create(VulkanContext *context)
 {
+    // keep the previous swap chain alive until its replacement exists, so the driver can hand over its images
+    const VkSwapchainKHR oldSwapChain = m_swapChain;
+    m_swapChain = VK_NULL_HANDLE;
+
     Destroy();
     m_context = context;
 
-    CreateSwapChain();
-    CreateImageViews();
-    CreateRenderPass();
-    CreateGraphicsPipeline();
-    CreateFramebuffers();
-}
+    if (m_context->IsHeadless())
+        CreateOffscreenImages();
+    else
+        CreateSwapChain(oldSwapChain);
 
-void SwapChain::Recreate()
-{
-    Create(m_context);
+    if (oldSwapChain != VK_NULL_HANDLE)
+        vkDestroySwapchainKHR(m_context->GetDevice(), oldSwapChain, nullptr);
+
+    CreateImageViews();
 }
 
-void SwapChain::CreateSwapChain()
+void SwapChain::CreateSwapChain(VkSwapchainKHR oldSwapChain)
 {
     const SwapChainSupportDetails &supportDetails = m_context->GetSwapChainSupportDetails();
 
@@ -66,7 +74,7 @@ void SwapChain::CreateSwapChain()
 
     // pick format and present modes
     m_swapChainFormat = FirstOrDefault(supportDetails.Formats, IsFormatBest, supportDetails.Formats[0]);
-    m_swapChainPresentMode = FirstOrDefault(supportDetails.PresentModes, IsPresentModeBest, VK_PRESENT_MODE_FIFO_KHR);
+    m_swapChainPresentMode = SelectPresentMode(supportDetails.PresentModes, m_context->GetLatencySettings().PresentModes);
 
     // create the swapchain
     VkSwapchainCreateInfoKHR createInfo{};
@@ -101,7 +109,7 @@ void SwapChain::CreateSwapChain()
     createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     createInfo.presentMode = m_swapChainPresentMode;
     createInfo.clipped = VK_TRUE;
-    createInfo.oldSwapchain = VK_NULL_HANDLE;
+    createInfo.oldSwapchain = oldSwapChain;
 
     if (vkCreateSwapchainKHR(m_context->GetDevice(), &createInfo, nullptr, &m_swapChain) != VK_SUCCESS)
         throw GraphicsException("failed to create swap chain");
@@ -109,6 +117,32 @@ void SwapChain::CreateSwapChain()
     m_swapChainImages = VulkanEnumerate<VkImage>(&vkGetSwapchainImagesKHR, m_context->GetDevice(), m_swapChain);
 }
 
+void SwapChain::CreateOffscreenImages()
+{
+    m_swapChainExtent = m_context->GetHeadlessExtent();
+    m_swapChainFormat = {VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR};
+
+    for (size_t i = 0; i < VulkanContext::MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        VkImageCreateInfo imageInfo{};
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = m_swapChainFormat.format;
+        imageInfo.extent = {m_swapChainExtent.width, m_swapChainExtent.height, 1};
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+        VkImage &image = m_swapChainImages.emplace_back();
+        MemoryAllocation &memory = m_offscreenImageMemory.emplace_back();
+        m_context->GetMemoryAllocator().CreateImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, memory);
+    }
+}
+
 void SwapChain::CreateImageViews()
 {
     m_swapChainImageViews.reserve(m_swapChainImages.size());
@@ -138,155 +172,59 @@ void SwapChain::CreateImageViews()
     }
 }
 
-void SwapChain::CreateRenderPass()
+void SwapChain::CreateDepthImage(VkFormat depthFormat)
 {
-    VkAttachmentDescription colorAttachment{};
-    colorAttachment.format = m_swapChainFormat.format;
-    colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
-    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-
-    VkAttachmentReference colorAttachmentRef{};
-    colorAttachmentRef.attachment = 0;
-    colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-    VkSubpassDescription subpass{};
-    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
-    subpass.colorAttachmentCount = 1;
-    subpass.pColorAttachments = &colorAttachmentRef;
-
-    VkRenderPassCreateInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-    renderPassInfo.attachmentCount = 1;
-    renderPassInfo.pAttachments = &colorAttachment;
-    renderPassInfo.subpassCount = 1;
-    renderPassInfo.pSubpasses = &subpass;
-
-    if (vkCreateRenderPass(m_context->GetDevice(), &renderPassInfo, nullptr, &m_renderPass) != VK_SUCCESS)
-        throw GraphicsException("failed to create render pass");
+    // gpu culling reduces the depth buffer into its Hi-Z pyramid, which needs a sampled image
+    VkFormatProperties properties;
+    vkGetPhysicalDeviceFormatProperties(m_context->GetPhysicalDevice(), depthFormat, &properties);
+    m_depthSampled = (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
+
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = depthFormat;
+    imageInfo.extent = {m_swapChainExtent.width, m_swapChainExtent.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | (m_depthSampled ? VK_IMAGE_USAGE_SAMPLED_BIT : 0);
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    m_context->GetMemoryAllocator().CreateImage(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_depthImage, m_depthImageMemory);
+
+    VkImageViewCreateInfo viewInfo{};
+    viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+    viewInfo.image = m_depthImage;
+    viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    viewInfo.format = depthFormat;
+    viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+    viewInfo.subresourceRange.baseMipLevel = 0;
+    viewInfo.subresourceRange.levelCount = 1;
+    viewInfo.subresourceRange.baseArrayLayer = 0;
+    viewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(m_context->GetDevice(), &viewInfo, nullptr, &m_depthImageView) != VK_SUCCESS)
+        throw GraphicsException("failed to create the depth image view");
 }
 
-void SwapChain::CreateGraphicsPipeline()
+void SwapChain::CreateFramebuffers(VkRenderPass renderPass, VkFormat depthFormat)
 {
-    ShaderCompiler compiler;
-
-    if (!m_compiledFragShader)
-        m_compiledFragShader = compiler.Compile(RES_FRAGMENT_SHADER, "fragment.frag", shaderc_fragment_shader);
-
-    if (!m_compiledVertShader)
-        m_compiledVertShader = compiler.Compile(RES_VERTEX_SHADER, "vertex.vert", shaderc_vertex_shader);
-
-    const ShaderModule fragShader{m_context->GetDevice(), *m_compiledFragShader};
-    const ShaderModule vertShader{m_context->GetDevice(), *m_compiledVertShader};
-
-    const std::array<VkPipelineShaderStageCreateInfo, 2> vertShaderStageInfo = {fragShader.CreateInfo(), vertShader.CreateInfo()};
-
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = 0;
-    vertexInputInfo.pVertexBindingDescriptions = nullptr;
-    vertexInputInfo.vertexAttributeDescriptionCount = 0;
-    vertexInputInfo.pVertexAttributeDescriptions = nullptr;
-
-    VkPipelineInputAssemblyStateCreateInfo inputAssembly{};
-    inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    inputAssembly.primitiveRestartEnable = VK_FALSE;
-
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = (float)m_swapChainExtent.width;
-    viewport.height = (float)m_swapChainExtent.height;
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = m_swapChainExtent;
-
-    VkPipelineViewportStateCreateInfo viewportState{};
-    viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportState.viewportCount = 1;
-    viewportState.pViewports = &viewport;
-    viewportState.scissorCount = 1;
-    viewportState.pScissors = &scissor;
-
-    VkPipelineRasterizationStateCreateInfo rasterizer{};
-    rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizer.depthClampEnable = VK_FALSE;
-    rasterizer.rasterizerDiscardEnable = VK_FALSE;
-    rasterizer.polygonMode = VK_POLYGON_MODE_FILL;
-    rasterizer.lineWidth = 1.0f;
-    rasterizer.cullMode = VK_CULL_MODE_BACK_BIT;
-    rasterizer.frontFace = VK_FRONT_FACE_CLOCKWISE;
-    rasterizer.depthBiasEnable = VK_FALSE;
-    rasterizer.depthBiasConstantFactor = 0.0f;
-    rasterizer.depthBiasClamp = 0.0f;
-    rasterizer.depthBiasSlopeFactor = 0.0f;
-
-    VkPipelineMultisampleStateCreateInfo multisampling{};
-    multisampling.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampling.sampleShadingEnable = VK_FALSE;
-    multisampling.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
-    multisampling.minSampleShading = 1.0f;
-    multisampling.pSampleMask = nullptr;
-    multisampling.alphaToCoverageEnable = VK_FALSE;
-    multisampling.alphaToOneEnable = VK_FALSE;
-
-    VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-    colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-    colorBlendAttachment.blendEnable = VK_FALSE;
-
-    VkPipelineColorBlendStateCreateInfo colorBlending{};
-    colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &colorBlendAttachment;
-
-    // TODO: Dynamic states
-
-    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-
-    if (vkCreatePipelineLayout(m_context->GetDevice(), &pipelineLayoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS)
-        throw GraphicsException("failed to create pipeline layout!");
-
-    VkGraphicsPipelineCreateInfo pipelineInfo{};
-    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = static_cast<uint32_t>(vertShaderStageInfo.size());
-    pipelineInfo.pStages = vertShaderStageInfo.data();
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssembly;
-    pipelineInfo.pViewportState = &viewportState;
-    pipelineInfo.pRasterizationState = &rasterizer;
-    pipelineInfo.pMultisampleState = &multisampling;
-    pipelineInfo.pDepthStencilState = nullptr;
-    pipelineInfo.pColorBlendState = &colorBlending;
-    pipelineInfo.pDynamicState = nullptr;
-    pipelineInfo.layout = m_pipelineLayout;
-    pipelineInfo.renderPass = m_renderPass;
-    pipelineInfo.subpass = 0;
-
-    if (vkCreateGraphicsPipelines(m_context->GetDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline) != VK_SUCCESS)
-        throw GraphicsException("failed to create graphics pipeline!");
-}
+    // the render pass orders depth accesses, so every framebuffer shares one depth image
+    CreateDepthImage(depthFormat);
 
-void SwapChain::CreateFramebuffers()
-{
     m_swapChainFramebuffers.reserve(m_swapChainImageViews.size());
 
     for (const VkImageView &view : m_swapChainImageViews)
     {
+        const std::array<VkImageView, 2> attachments = {view, m_depthImageView};
+
         VkFramebufferCreateInfo framebufferInfo{};
         framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebufferInfo.renderPass = m_renderPass;
-        framebufferInfo.attachmentCount = 1;
-        framebufferInfo.pAttachments = &view;
+        framebufferInfo.renderPass = renderPass;
+        framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+        framebufferInfo.pAttachments = attachments.data();
         framebufferInfo.width = m_swapChainExtent.width;
         framebufferInfo.height = m_swapChainExtent.height;
         framebufferInfo.layers = 1;
@@ -307,28 +245,30 @@ void SwapChain::Destroy()
 
     m_swapChainFramebuffers.clear();
 
-    if (m_pipeline != VK_NULL_HANDLE)
-    {
-        vkDestroyPipeline(m_context->GetDevice(), m_pipeline, nullptr);
-        m_pipeline = VK_NULL_HANDLE;
-    }
+    for (VkImageView &item : m_swapChainImageViews)
+        vkDestroyImageView(m_context->GetDevice(), item, nullptr);
+
+    m_swapChainImageViews.clear();
 
-    if (m_pipelineLayout != VK_NULL_HANDLE)
+    if (m_depthImageView != VK_NULL_HANDLE)
     {
-        vkDestroyPipelineLayout(m_context->GetDevice(), m_pipelineLayout, nullptr);
-        m_pipelineLayout = VK_NULL_HANDLE;
+        vkDestroyImageView(m_context->GetDevice(), m_depthImageView, nullptr);
+        m_depthImageView = VK_NULL_HANDLE;
     }
 
-    if (m_renderPass != VK_NULL_HANDLE)
+    if (m_depthImage != VK_NULL_HANDLE)
+        m_context->GetMemoryAllocator().DestroyImage(m_depthImage, m_depthImageMemory);
+
+    // offscreen images are owned by us, swap chain images by the swap chain
+    if (!m_offscreenImageMemory.empty())
     {
-        vkDestroyRenderPass(m_context->GetDevice(), m_renderPass, nullptr);
-        m_renderPass = VK_NULL_HANDLE;
-    }
+        for (size_t i = 0; i < m_offscreenImageMemory.size(); i++)
+            m_context->GetMemoryAllocator().DestroyImage(m_swapChainImages[i], m_offscreenImageMemory[i]);
 
-    for (VkImageView &item : m_swapChainImageViews)
-        vkDestroyImageView(m_context->GetDevice(), item, nullptr);
+        m_offscreenImageMemory.clear();
+    }
 
-    m_swapChainImageViews.clear();
+    m_swapChainImages.clear();
 
     if (m_swapChain != VK_NULL_HANDLE)
     {
@@ -347,6 +287,11 @@ VkExtent2D &SwapChain::GetSwapChainExtent() noexcept
     return m_swapChainExtent;
 }
 
+VkPresentModeKHR SwapChain::GetPresentMode() const noexcept
+{
+    return m_swapChainPresentMode;
+}
+
 VkSwapchainKHR SwapChain::GetSwapChain() noexcept
 {
     return m_swapChain;
@@ -362,24 +307,24 @@ std::vector<VkImageView> &SwapChain::GetSwapChainImageViews() noexcept
     return m_swapChainImageViews;
 }
 
-VkRenderPass SwapChain::GetRenderPass() noexcept
+std::vector<VkFramebuffer> &SwapChain::GetSwapChainFramebuffers() noexcept
 {
-    return m_renderPass;
+    return m_swapChainFramebuffers;
 }
 
-VkPipelineLayout SwapChain::GetPipelineLayout() noexcept
+VkImage SwapChain::GetDepthImage() noexcept
 {
-    return m_pipelineLayout;
+    return m_depthImage;
 }
 
-VkPipeline SwapChain::GetPipeline() noexcept
+VkImageView SwapChain::GetDepthImageView() noexcept
 {
-    return m_pipeline;
+    return m_depthImageView;
 }
 
-std::vector<VkFramebuffer> &SwapChain::GetSwapChainFramebuffers() noexcept
+bool SwapChain::IsDepthSampled() const noexcept
 {
-    return m_swapChainFramebuffers;
+    return m_depthSampled;
 }
 
 } // namespace MineClone
\ No newline at end of file
@@ -0,0 +1,268 @@
+#include <MineClone/GFX/TlsfHeap.hpp>
+
+#include <MineClone/Utility.hpp>
+
+namespace MineClone
+{
+
+TlsfHeap::TlsfHeap(uint64_t size) : m_size{size}
+{
+    ASSERT(size != 0, "TlsfHeap size must not be 0");
+
+    m_freeLists.fill(INVALID_BLOCK);
+
+    const uint32_t block = NewBlock();
+    m_blocks[block].Size = size;
+    InsertFree(block);
+}
+
+bool TlsfHeap::Allocate(uint64_t size, uint64_t alignment, Allocation &allocation)
+{
+    size = std::max<uint64_t>(size, 1);
+    alignment = std::max<uint64_t>(alignment, 1);
+
+    // any free block of this size can hold the allocation no matter where the aligned offset lands
+    const uint32_t block = FindFree(size + alignment - 1);
+
+    if (block == INVALID_BLOCK)
+        return false;
+
+    RemoveFree(block);
+
+    // the alignment padding becomes a free block of its own in front of the allocation
+    const uint64_t alignedOffset = (m_blocks[block].Offset + alignment - 1) & ~(alignment - 1);
+    const uint64_t padding = alignedOffset - m_blocks[block].Offset;
+
+    uint32_t used = block;
+
+    if (padding != 0)
+    {
+        Split(block, padding);
+        used = m_blocks[block].NextPhysical;
+        RemoveFree(used);
+        InsertFree(block);
+    }
+
+    if (m_blocks[used].Size > size)
+        Split(used, size);
+
+    m_blocks[used].Free = false;
+    m_usedSize += m_blocks[used].Size;
+    m_allocationCount++;
+
+    allocation.Block = used;
+    allocation.Offset = m_blocks[used].Offset;
+    return true;
+}
+
+void TlsfHeap::Free(uint32_t block)
+{
+    ASSERT(block < m_blocks.size() && !m_blocks[block].Free, "TlsfHeap::Free called with an invalid block");
+
+    m_usedSize -= m_blocks[block].Size;
+    m_allocationCount--;
+    m_blocks[block].Free = true;
+
+    // coalesce with both physical neighbours so free ranges never sit next to each other
+    const uint32_t previous = m_blocks[block].PreviousPhysical;
+    if (previous != INVALID_BLOCK && m_blocks[previous].Free)
+    {
+        RemoveFree(previous);
+        m_blocks[previous].Size += m_blocks[block].Size;
+        m_blocks[previous].NextPhysical = m_blocks[block].NextPhysical;
+
+        if (m_blocks[block].NextPhysical != INVALID_BLOCK)
+            m_blocks[m_blocks[block].NextPhysical].PreviousPhysical = previous;
+
+        ReleaseBlock(block);
+        block = previous;
+    }
+
+    const uint32_t next = m_blocks[block].NextPhysical;
+    if (next != INVALID_BLOCK && m_blocks[next].Free)
+    {
+        RemoveFree(next);
+        m_blocks[block].Size += m_blocks[next].Size;
+        m_blocks[block].NextPhysical = m_blocks[next].NextPhysical;
+
+        if (m_blocks[next].NextPhysical != INVALID_BLOCK)
+            m_blocks[m_blocks[next].NextPhysical].PreviousPhysical = block;
+
+        ReleaseBlock(next);
+    }
+
+    InsertFree(block);
+}
+
+uint64_t TlsfHeap::GetSize() const noexcept
+{
+    return m_size;
+}
+
+uint64_t TlsfHeap::GetUsedSize() const noexcept
+{
+    return m_usedSize;
+}
+
+size_t TlsfHeap::GetAllocationCount() const noexcept
+{
+    return m_allocationCount;
+}
+
+size_t TlsfHeap::GetFreeRangeCount() const noexcept
+{
+    return m_freeRangeCount;
+}
+
+uint64_t TlsfHeap::GetLargestFreeRange() const noexcept
+{
+    if (m_firstLevelBitmap == 0)
+        return 0;
+
+    // the largest range is somewhere in the highest non-empty bucket
+    const uint32_t firstLevel = BitScanReverse64(m_firstLevelBitmap);
+    const uint32_t secondLevel = BitScanReverse64(m_secondLevelBitmaps[firstLevel]);
+
+    uint64_t largest = 0;
+    for (uint32_t block = m_freeLists[firstLevel * SL_COUNT + secondLevel]; block != INVALID_BLOCK; block = m_blocks[block].NextFree)
+        largest = std::max(largest, m_blocks[block].Size);
+
+    return largest;
+}
+
+bool TlsfHeap::IsEmpty() const noexcept
+{
+    return m_allocationCount == 0;
+}
+
+void TlsfHeap::Mapping(uint64_t size, uint32_t &firstLevel, uint32_t &secondLevel) noexcept
+{
+    const uint32_t highestBit = BitScanReverse64(size);
+
+    // sizes below SL_COUNT get one bucket each
+    if (highestBit < SL_LOG2)
+    {
+        firstLevel = 0;
+        secondLevel = static_cast<uint32_t>(size);
+        return;
+    }
+
+    firstLevel = highestBit - SL_LOG2 + 1;
+    secondLevel = static_cast<uint32_t>(size >> (highestBit - SL_LOG2)) - SL_COUNT;
+}
+
+uint32_t TlsfHeap::NewBlock()
+{
+    if (!m_unusedBlocks.empty())
+    {
+        const uint32_t block = m_unusedBlocks.back();
+        m_unusedBlocks.pop_back();
+        m_blocks[block] = Block{};
+        return block;
+    }
+
+    m_blocks.emplace_back();
+    return static_cast<uint32_t>(m_blocks.size() - 1);
+}
+
+void TlsfHeap::ReleaseBlock(uint32_t block)
+{
+    m_unusedBlocks.push_back(block);
+}
+
+void TlsfHeap::InsertFree(uint32_t block)
+{
+    uint32_t firstLevel, secondLevel;
+    Mapping(m_blocks[block].Size, firstLevel, secondLevel);
+
+    uint32_t &head = m_freeLists[firstLevel * SL_COUNT + secondLevel];
+
+    m_blocks[block].Free = true;
+    m_blocks[block].PreviousFree = INVALID_BLOCK;
+    m_blocks[block].NextFree = head;
+
+    if (head != INVALID_BLOCK)
+        m_blocks[head].PreviousFree = block;
+
+    head = block;
+    m_firstLevelBitmap |= uint64_t{1} << firstLevel;
+    m_secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+    m_freeRangeCount++;
+}
+
+void TlsfHeap::RemoveFree(uint32_t block)
+{
+    uint32_t firstLevel, secondLevel;
+    Mapping(m_blocks[block].Size, firstLevel, secondLevel);
+
+    const Block &current = m_blocks[block];
+
+    if (current.PreviousFree != INVALID_BLOCK)
+        m_blocks[current.PreviousFree].NextFree = current.NextFree;
+    else
+        m_freeLists[firstLevel * SL_COUNT + secondLevel] = current.NextFree;
+
+    if (current.NextFree != INVALID_BLOCK)
+        m_blocks[current.NextFree].PreviousFree = current.PreviousFree;
+
+    if (m_freeLists[firstLevel * SL_COUNT + secondLevel] == INVALID_BLOCK)
+    {
+        m_secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+
+        if (m_secondLevelBitmaps[firstLevel] == 0)
+            m_firstLevelBitmap &= ~(uint64_t{1} << firstLevel);
+    }
+
+    m_blocks[block].Free = false;
+    m_freeRangeCount--;
+}
+
+uint32_t TlsfHeap::FindFree(uint64_t size) const noexcept
+{
+    // round up to the next bucket boundary so every block in the bucket we land in is large enough
+    const uint32_t highestBit = BitScanReverse64(size);
+    if (highestBit >= SL_LOG2)
+        size += (uint64_t{1} << (highestBit - SL_LOG2)) - 1;
+
+    uint32_t firstLevel, secondLevel;
+    Mapping(size, firstLevel, secondLevel);
+
+    if (firstLevel >= FL_COUNT)
+        return INVALID_BLOCK;
+
+    uint32_t secondLevelMap = m_secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+
+    if (secondLevelMap == 0)
+    {
+        const uint64_t firstLevelMap = firstLevel + 1 < FL_COUNT ? m_firstLevelBitmap & (~uint64_t{0} << (firstLevel + 1)) : 0;
+
+        if (firstLevelMap == 0)
+            return INVALID_BLOCK;
+
+        firstLevel = CountTrailingZeros64(firstLevelMap);
+        secondLevelMap = m_secondLevelBitmaps[firstLevel];
+    }
+
+    return m_freeLists[firstLevel * SL_COUNT + CountTrailingZeros(secondLevelMap)];
+}
+
+void TlsfHeap::Split(uint32_t block, uint64_t size)
+{
+    const uint32_t remainder = NewBlock();
+
+    // NewBlock may have grown the vector, so index again instead of holding references
+    m_blocks[remainder].Offset = m_blocks[block].Offset + size;
+    m_blocks[remainder].Size = m_blocks[block].Size - size;
+    m_blocks[remainder].PreviousPhysical = block;
+    m_blocks[remainder].NextPhysical = m_blocks[block].NextPhysical;
+
+    if (m_blocks[block].NextPhysical != INVALID_BLOCK)
+        m_blocks[m_blocks[block].NextPhysical].PreviousPhysical = remainder;
+
+    m_blocks[block].Size = size;
+    m_blocks[block].NextPhysical = remainder;
+
+    InsertFree(remainder);
+}
+
+} // namespace MineClone
@@ -0,0 +1,360 @@
+#include <MineClone/GFX/UploadManager.hpp>
+
+#include <MineClone/GFX/VulkanContext.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr VkAccessFlags CONSUMER_ACCESS = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT |
+                                          VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+// covers the texel block size of every format we upload, including BC blocks
+constexpr VkDeviceSize MIN_COPY_ALIGNMENT = 16;
+
+constexpr uint64_t AlignUp(uint64_t value, uint64_t alignment) noexcept
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+VkImageSubresourceRange ToRange(const VkImageSubresourceLayers &layers) noexcept
+{
+    return {layers.aspectMask, layers.mipLevel, 1, layers.baseArrayLayer, layers.layerCount};
+}
+
+} // namespace
+
+UploadManager::~UploadManager()
+{
+    Destroy();
+}
+
+void UploadManager::Create(VulkanContext *context)
+{
+    m_context = context;
+
+    const QueueFamilyIndices &indices = m_context->GetQueueFamilyIndices();
+    m_graphicsFamily = *indices.GraphicsFamily;
+    m_transferFamily = indices.TransferFamily.value_or(m_graphicsFamily);
+    m_transferQueue = m_context->GetTransferQueue();
+
+    const VkDeviceSize optimalAlignment = m_context->GetPhysicalDeviceProperties().limits.optimalBufferCopyOffsetAlignment;
+    m_copyAlignment = std::max(MIN_COPY_ALIGNMENT, optimalAlignment);
+
+    for (Batch &batch : m_batches)
+    {
+        VkCommandPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = m_transferFamily;
+
+        if (vkCreateCommandPool(m_context->GetDevice(), &poolInfo, nullptr, &batch.CommandPool) != VK_SUCCESS)
+            throw GraphicsException("failed to create an upload command pool");
+
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = batch.CommandPool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+
+        if (vkAllocateCommandBuffers(m_context->GetDevice(), &allocInfo, &batch.CommandBuffer) != VK_SUCCESS)
+            throw GraphicsException("failed to allocate an upload command buffer");
+
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+        VkSemaphoreCreateInfo semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        if (vkCreateFence(m_context->GetDevice(), &fenceInfo, nullptr, &batch.Fence) != VK_SUCCESS ||
+            vkCreateSemaphore(m_context->GetDevice(), &semaphoreInfo, nullptr, &batch.Semaphore) != VK_SUCCESS)
+        {
+            throw GraphicsException("failed to create upload synchronization objects");
+        }
+    }
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = RING_SIZE;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    m_context->GetMemoryAllocator().CreateBuffer(bufferInfo, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                                 m_ringBuffer, m_ringMemory);
+
+    ASSERT(m_ringMemory.Mapped != nullptr, "staging ring is not host visible");
+}
+
+void UploadManager::Destroy()
+{
+    if (m_context == nullptr)
+        return;
+
+    VkDevice device = m_context->GetDevice();
+
+    for (Batch &batch : m_batches)
+    {
+        if (batch.Fence != VK_NULL_HANDLE)
+        {
+            vkWaitForFences(device, 1, &batch.Fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+            vkDestroyFence(device, batch.Fence, nullptr);
+        }
+
+        if (batch.Semaphore != VK_NULL_HANDLE)
+            vkDestroySemaphore(device, batch.Semaphore, nullptr);
+
+        // destroying the pool frees its command buffer as well
+        if (batch.CommandPool != VK_NULL_HANDLE)
+            vkDestroyCommandPool(device, batch.CommandPool, nullptr);
+
+        batch = Batch{};
+    }
+
+    m_context->GetMemoryAllocator().DestroyBuffer(m_ringBuffer, m_ringMemory);
+
+    m_bufferCopies.clear();
+    m_imageCopies.clear();
+    m_ringHead = m_ringTail = m_submittedHead = 0;
+    m_context = nullptr;
+}
+
+bool UploadManager::UploadBuffer(VkBuffer buffer, VkDeviceSize offset, const void *data, VkDeviceSize size)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    VkDeviceSize ringOffset;
+    if (!Reserve(size, m_copyAlignment, ringOffset))
+        return false;
+
+    std::memcpy(static_cast<char *>(m_ringMemory.Mapped) + ringOffset, data, size);
+    m_bufferCopies.push_back({buffer, {ringOffset, offset, size}});
+    return true;
+}
+
+bool UploadManager::UploadImage(VkImage image, const VkImageSubresourceLayers &subresource, VkExtent3D extent, const void *data, VkDeviceSize size,
+                                VkImageLayout finalLayout)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    VkDeviceSize ringOffset;
+    if (!Reserve(size, m_copyAlignment, ringOffset))
+        return false;
+
+    std::memcpy(static_cast<char *>(m_ringMemory.Mapped) + ringOffset, data, size);
+
+    VkBufferImageCopy region{};
+    region.bufferOffset = ringOffset;
+    region.imageSubresource = subresource;
+    region.imageExtent = extent;
+
+    m_imageCopies.push_back({image, region, finalLayout});
+    return true;
+}
+
+VkSemaphore UploadManager::Submit(size_t frame)
+{
+    Batch &batch = m_batches[frame % MAX_BATCHES];
+
+    // submitted MAX_BATCHES frames ago and already waited on by that frame's graphics work, this rarely blocks
+    vkWaitForFences(m_context->GetDevice(), 1, &batch.Fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_ringTail = std::max(m_ringTail, batch.RingEnd);
+    batch.BufferAcquires.clear();
+    batch.ImageAcquires.clear();
+    batch.RingEnd = m_ringHead;
+
+    if (m_bufferCopies.empty() && m_imageCopies.empty())
+        return VK_NULL_HANDLE;
+
+    Record(batch);
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &batch.CommandBuffer;
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &batch.Semaphore;
+
+    vkResetFences(m_context->GetDevice(), 1, &batch.Fence);
+
+    if (vkQueueSubmit(m_transferQueue, 1, &submitInfo, batch.Fence) != VK_SUCCESS)
+        throw GraphicsException("failed to submit uploads");
+
+    m_submittedHead = m_ringHead;
+    m_bufferCopies.clear();
+    m_imageCopies.clear();
+
+    return batch.Semaphore;
+}
+
+void UploadManager::RecordAcquireBarriers(VkCommandBuffer commandBuffer, size_t frame)
+{
+    Batch &batch = m_batches[frame % MAX_BATCHES];
+
+    if (batch.BufferAcquires.empty() && batch.ImageAcquires.empty())
+        return;
+
+    // the source stages match the semaphore wait stages, which chains the barrier after the transfer submission
+    vkCmdPipelineBarrier(commandBuffer, CONSUMER_STAGES, CONSUMER_STAGES, 0, 0, nullptr, static_cast<uint32_t>(batch.BufferAcquires.size()),
+                         batch.BufferAcquires.data(), static_cast<uint32_t>(batch.ImageAcquires.size()), batch.ImageAcquires.data());
+
+    batch.BufferAcquires.clear();
+    batch.ImageAcquires.clear();
+}
+
+bool UploadManager::HasDedicatedQueue() const noexcept
+{
+    return m_transferFamily != m_graphicsFamily;
+}
+
+VkDeviceSize UploadManager::GetPendingBytes() noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_ringHead - m_submittedHead;
+}
+
+bool UploadManager::Reserve(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize &offset)
+{
+    if (size == 0 || size > RING_SIZE)
+        return false;
+
+    uint64_t start = AlignUp(m_ringHead, alignment);
+
+    // copies never wrap around the end of the ring, skip to its start instead
+    if (start % RING_SIZE + size > RING_SIZE)
+        start = AlignUp(start, RING_SIZE);
+
+    if (start + size - m_ringTail > RING_SIZE)
+        return false;
+
+    m_ringHead = start + size;
+    offset = start % RING_SIZE;
+    return true;
+}
+
+void UploadManager::Record(Batch &batch)
+{
+    vkResetCommandPool(m_context->GetDevice(), batch.CommandPool, 0);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(batch.CommandBuffer, &beginInfo) != VK_SUCCESS)
+        throw GraphicsException("failed to begin recording uploads");
+
+    const bool transferOwnership = HasDedicatedQueue();
+
+    // images start out undefined, their previous contents are replaced completely
+    std::vector<VkImageMemoryBarrier> imageBarriers;
+    imageBarriers.reserve(m_imageCopies.size());
+
+    for (const ImageCopy &copy : m_imageCopies)
+    {
+        VkImageMemoryBarrier &barrier = imageBarriers.emplace_back();
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = copy.Image;
+        barrier.subresourceRange = ToRange(copy.Region.imageSubresource);
+    }
+
+    if (!imageBarriers.empty())
+    {
+        vkCmdPipelineBarrier(batch.CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr,
+                             static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+    }
+
+    // one copy command per destination buffer
+    std::stable_sort(m_bufferCopies.begin(), m_bufferCopies.end(), [](const BufferCopy &a, const BufferCopy &b) { return a.Buffer < b.Buffer; });
+
+    std::vector<VkBufferCopy> regions;
+    for (size_t begin = 0; begin < m_bufferCopies.size();)
+    {
+        size_t end = begin;
+        regions.clear();
+
+        while (end < m_bufferCopies.size() && m_bufferCopies[end].Buffer == m_bufferCopies[begin].Buffer)
+            regions.push_back(m_bufferCopies[end++].Region);
+
+        vkCmdCopyBuffer(batch.CommandBuffer, m_ringBuffer, m_bufferCopies[begin].Buffer, static_cast<uint32_t>(regions.size()), regions.data());
+        begin = end;
+    }
+
+    for (const ImageCopy &copy : m_imageCopies)
+        vkCmdCopyBufferToImage(batch.CommandBuffer, m_ringBuffer, copy.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy.Region);
+
+    // Release to the graphics family when the copies ran on another queue family, the graphics queue records the
+    // matching acquire. Otherwise a plain barrier makes the writes visible to later submissions on the same queue.
+    std::vector<VkBufferMemoryBarrier> bufferReleases;
+
+    for (size_t i = 0; i < imageBarriers.size(); i++)
+    {
+        VkImageMemoryBarrier &barrier = imageBarriers[i];
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = transferOwnership ? 0 : CONSUMER_ACCESS;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = m_imageCopies[i].FinalLayout;
+        barrier.srcQueueFamilyIndex = transferOwnership ? m_transferFamily : VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = transferOwnership ? m_graphicsFamily : VK_QUEUE_FAMILY_IGNORED;
+
+        if (transferOwnership)
+        {
+            VkImageMemoryBarrier &acquire = batch.ImageAcquires.emplace_back(barrier);
+            acquire.srcAccessMask = 0;
+            acquire.dstAccessMask = CONSUMER_ACCESS;
+        }
+    }
+
+    if (transferOwnership)
+    {
+        for (const BufferCopy &copy : m_bufferCopies)
+        {
+            VkBufferMemoryBarrier &barrier = bufferReleases.emplace_back();
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = 0;
+            barrier.srcQueueFamilyIndex = m_transferFamily;
+            barrier.dstQueueFamilyIndex = m_graphicsFamily;
+            barrier.buffer = copy.Buffer;
+            barrier.offset = copy.Region.dstOffset;
+            barrier.size = copy.Region.size;
+
+            VkBufferMemoryBarrier &acquire = batch.BufferAcquires.emplace_back(barrier);
+            acquire.srcAccessMask = 0;
+            acquire.dstAccessMask = CONSUMER_ACCESS;
+        }
+
+        vkCmdPipelineBarrier(batch.CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr,
+                             static_cast<uint32_t>(bufferReleases.size()), bufferReleases.data(), static_cast<uint32_t>(imageBarriers.size()),
+                             imageBarriers.data());
+    }
+    else
+    {
+        VkMemoryBarrier memoryBarrier{};
+        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        memoryBarrier.dstAccessMask = CONSUMER_ACCESS;
+
+        vkCmdPipelineBarrier(batch.CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, CONSUMER_STAGES, 0, 1, &memoryBarrier, 0, nullptr,
+                             static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+    }
+
+    if (vkEndCommandBuffer(batch.CommandBuffer) != VK_SUCCESS)
+        throw GraphicsException("failed to record uploads");
+}
+
+} // namespace MineClone
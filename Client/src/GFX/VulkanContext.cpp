@@ -11,6 +11,14 @@
 
 namespace MineClone
 {
+
+namespace
+{
+
+constexpr const char *PIPELINE_CACHE_PATH = "pipeline_cache.bin";
+
+} // namespace
+
 InFlightFrameData::~InFlightFrameData()
 {
     Destroy();
@@ -43,12 +51,6 @@ void InFlightFrameData::Destroy()
         vkDestroySemaphore(Context->GetDevice(), ImageAvailableSemaphore, nullptr);
         ImageAvailableSemaphore = VK_NULL_HANDLE;
     }
-
-    if (CommandBuffer != VK_NULL_HANDLE)
-    {
-        vkFreeCommandBuffers(Context->GetDevice(), Context->GetCommandPool(), 1, &CommandBuffer);
-        CommandBuffer = VK_NULL_HANDLE;
-    }
 }
 
 VulkanContext::VulkanContext()
@@ -62,26 +64,94 @@ VulkanContext::~VulkanContext()
     Destroy();
 }
 
+void VulkanContext::SetJobSystem(JobSystem *jobSystem) noexcept
+{
+    m_jobSystem = jobSystem;
+}
+
+void VulkanContext::SetLatencyMode(LatencyMode mode, double frameRateCap)
+{
+    LatencySettings settings = GetLatencyModeSettings(mode, frameRateCap);
+
+    // before Initialize the swap chain is created with the new modes anyway
+    if (m_device != VK_NULL_HANDLE && settings.PresentModes != m_latencySettings.PresentModes)
+        RequireRecreateSwapChain();
+
+    settings.FramesInFlight = std::clamp<size_t>(settings.FramesInFlight, 1, MAX_FRAMES_IN_FLIGHT);
+
+    // every frame waits for the fence of its own resources, so frames can be reordered and skipped safely
+    if (m_currentFrame >= settings.FramesInFlight)
+    {
+        m_currentFrame = 0;
+        m_frameReady = false;
+    }
+
+    m_frameLimiter.SetFrameRate(settings.FrameRateCap);
+    m_latencyMode = mode;
+    m_latencySettings = std::move(settings);
+}
+
+void VulkanContext::SetBlockTextureOptions(const BlockTextureOptions &options)
+{
+    m_blockTextureOptions = options;
+}
+
 void VulkanContext::Initialize(GLFWwindow *window)
+{
+    m_headless = false;
+    m_window = window;
+
+    Initialize();
+}
+
+void VulkanContext::InitializeHeadless(VkExtent2D extent)
+{
+    m_headless = true;
+    m_headlessExtent = extent;
+    m_window = nullptr;
+
+    Initialize();
+}
+
+void VulkanContext::Initialize()
 {
 #ifdef ENABLE_VALIDATION_LAYERS
     m_requireValidationLayers = true;
 #endif
 
-    m_window = window;
-
     CreateInstance();
 
     if (m_requireValidationLayers)
         SetupDebugCallbacks();
 
-    CreateSurface();
+    if (!m_headless)
+        CreateSurface();
+
     PickPhysicalDevice();
     CreateLogicalDevice();
+    m_memoryAllocator.Create(this);
+    m_uploadManager.Create(this);
+    m_blockTextures.Create(this, m_jobSystem, m_blockTextureOptions);
+    m_chunkRenderer.Create(this);
+    CreatePipelineCache();
     CreateSwapChain();
-    CreateCommandPool();
-    CreateCommandBuffer();
+    m_gpuCulling.Create(this);
+    CreateCommandPools();
     CreateSyncObjects();
+    m_frameProfiler.Create(this);
+}
+
+void VulkanContext::WaitForNextFrame()
+{
+    if (m_frameLimiter.GetFrameRate() > 0.0)
+    {
+        const FrameProfiler::ScopedTimer timer = m_frameProfiler.Time(CpuTimer::Limiter);
+        m_frameLimiter.Wait();
+    }
+
+    const FrameProfiler::ScopedTimer timer = m_frameProfiler.Time(CpuTimer::FenceWait);
+    vkWaitForFences(m_device, 1, &m_inFlightFrameData[m_currentFrame].InFlightFence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+    m_frameReady = true;
 }
 
 void VulkanContext::Render()
@@ -94,36 +164,97 @@ void VulkanContext::Render()
 
     InFlightFrameData &frameData = m_inFlightFrameData[m_currentFrame];
 
-    // wait for previous frame
-    vkWaitForFences(m_device, 1, &frameData.InFlightFence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+    // wait for previous frame, unless WaitForNextFrame already did
+    if (!m_frameReady)
+    {
+        const FrameProfiler::ScopedTimer timer = m_frameProfiler.Time(CpuTimer::FenceWait);
+        vkWaitForFences(m_device, 1, &frameData.InFlightFence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+    }
+
+    m_frameReady = false;
+
+    // the signaled fence guarantees the timestamps of the last submission of this frame are available
+    m_frameProfiler.CollectGpuResults(m_currentFrame);
+    m_gpuCulling.Verify(m_currentFrame);
 
     uint32_t imageIndex;
-    if (!HandleDrawResult(vkAcquireNextImageKHR(m_device, m_swapChain.GetSwapChain(), std::numeric_limits<uint64_t>::max(),
-                                                frameData.ImageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex)))
+    if (m_headless)
     {
-        return;
+        // every frame in flight owns one offscreen image, guarded by its fence
+        imageIndex = static_cast<uint32_t>(m_currentFrame);
+    }
+    else
+    {
+        const FrameProfiler::ScopedTimer timer = m_frameProfiler.Time(CpuTimer::Acquire);
+
+        if (!HandleDrawResult(vkAcquireNextImageKHR(m_device, m_swapChain.GetSwapChain(), std::numeric_limits<uint64_t>::max(),
+                                                    frameData.ImageAvailableSemaphore, VK_NULL_HANDLE, &imageIndex)))
+        {
+            return;
+        }
     }
 
     vkResetFences(m_device, 1, &frameData.InFlightFence);
 
+    // uploads queued since the last frame go out first, this frame's commands wait for them
+    const VkSemaphore uploadSemaphore = m_uploadManager.Submit(m_currentFrame);
+
+    // cull against the camera of this frame before any draw is recorded
+    {
+        const FrameProfiler::ScopedTimer timer = m_frameProfiler.Time(CpuTimer::Visibility);
+        const VkExtent2D &extent = m_swapChain.GetSwapChainExtent();
+
+        m_camera.SetAspect(static_cast<float>(extent.width) / static_cast<float>(extent.height));
+        m_chunkRenderer.UpdateVisibility(m_camera, m_currentFrame);
+    }
+
     // record framebuffer
-    vkResetCommandBuffer(frameData.CommandBuffer, 0);
-    RecordCommandBuffer(frameData.CommandBuffer, imageIndex);
+    {
+        const FrameProfiler::ScopedTimer timer = m_frameProfiler.Time(CpuTimer::Record);
+        m_commandPools.Reset(m_currentFrame);
+        RecordCommandBuffer(m_commandPools.GetPrimary(m_currentFrame), imageIndex);
+    }
 
     // submit framebuffer
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+    const VkCommandBuffer commandBuffer = m_commandPools.GetPrimary(m_currentFrame);
+    uint32_t waitSemaphoreCount = 0;
+    VkSemaphore waitSemaphores[2];
+    VkPipelineStageFlags waitStages[2];
+
+    if (!m_headless)
+    {
+        waitSemaphores[waitSemaphoreCount] = frameData.ImageAvailableSemaphore;
+        waitStages[waitSemaphoreCount++] = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    }
+
+    if (uploadSemaphore != VK_NULL_HANDLE)
+    {
+        waitSemaphores[waitSemaphoreCount] = uploadSemaphore;
+        waitStages[waitSemaphoreCount++] = UploadManager::CONSUMER_STAGES;
+    }
+
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = &frameData.ImageAvailableSemaphore;
+    submitInfo.waitSemaphoreCount = waitSemaphoreCount;
+    submitInfo.pWaitSemaphores = waitSemaphores;
     submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &frameData.CommandBuffer;
-    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pCommandBuffers = &commandBuffer;
+    submitInfo.signalSemaphoreCount = m_headless ? 0 : 1;
     submitInfo.pSignalSemaphores = &frameData.RenderFinishedSemaphore;
 
-    if (vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, frameData.InFlightFence) != VK_SUCCESS)
-        throw std::runtime_error("failed to submit draw command buffer!");
+    {
+        const FrameProfiler::ScopedTimer timer = m_frameProfiler.Time(CpuTimer::Submit);
+
+        if (vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, frameData.InFlightFence) != VK_SUCCESS)
+            throw std::runtime_error("failed to submit draw command buffer!");
+    }
+
+    if (m_headless)
+    {
+        m_currentFrame = (m_currentFrame + 1) % m_latencySettings.FramesInFlight;
+        return;
+    }
 
     VkPresentInfoKHR presentInfo{};
     VkSwapchainKHR swapChain = m_swapChain.GetSwapChain();
@@ -134,15 +265,27 @@ void VulkanContext::Render()
     presentInfo.pSwapchains = &swapChain;
     presentInfo.pImageIndices = &imageIndex;
 
-    if (!HandleDrawResult(vkQueuePresentKHR(m_presentQueue, &presentInfo)))
-        return;
+    {
+        const FrameProfiler::ScopedTimer timer = m_frameProfiler.Time(CpuTimer::Present);
+
+        if (!HandleDrawResult(vkQueuePresentKHR(m_presentQueue, &presentInfo)))
+            return;
+    }
 
-    m_currentFrame = (m_currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    m_currentFrame = (m_currentFrame + 1) % m_latencySettings.FramesInFlight;
+}
+
+void VulkanContext::WaitIdle()
+{
+    if (m_device != VK_NULL_HANDLE)
+        vkDeviceWaitIdle(m_device);
 }
 
 void VulkanContext::RequireRecreateSwapChain()
 {
-    m_requireRecreateSwapChain = true;
+    // offscreen images have a fixed extent
+    if (!m_headless)
+        m_requireRecreateSwapChain = true;
 }
 
 void VulkanContext::CreateInstance()
@@ -181,10 +324,13 @@ void VulkanContext::CreateInstance()
     }
 
     // query for glfw extension
-    uint32_t extensionCount = 0;
-    const char **extensions = glfwGetRequiredInstanceExtensions(&extensionCount);
-    for (uint32_t i = 0; i < extensionCount; i++)
-        requiredExtensions.emplace_back(extensions[i]);
+    if (!m_headless)
+    {
+        uint32_t extensionCount = 0;
+        const char **extensions = glfwGetRequiredInstanceExtensions(&extensionCount);
+        for (uint32_t i = 0; i < extensionCount; i++)
+            requiredExtensions.emplace_back(extensions[i]);
+    }
 
     // create instance
     VkApplicationInfo appInfo{};
@@ -259,6 +405,9 @@ namespace
 constexpr const uint32_t INADEQUATE_GPU_SCORE = 0;
 const std::array<const char *, 1> REQUIRED_EXTENSIONS = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 
+// enabled whenever the device has them, users check IsDeviceExtensionEnabled
+const std::array<const char *, 1> OPTIONAL_EXTENSIONS = {VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME};
+
 QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface)
 {
     QueueFamilyIndices indices = {};
@@ -271,16 +420,22 @@ QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surfa
         const auto &current = queueFamilyProperties[i];
 
         VkBool32 canPresent = VK_FALSE;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &canPresent);
+        if (surface != VK_NULL_HANDLE)
+            vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &canPresent);
 
-        if (current.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+        if ((current.queueFlags & VK_QUEUE_GRAPHICS_BIT) && !indices.GraphicsFamily)
             indices.GraphicsFamily = i;
 
-        if (canPresent == VK_TRUE)
+        if (canPresent == VK_TRUE && !indices.PresentFamily)
             indices.PresentFamily = i;
 
-        if (indices.IsComplete())
-            break;
+        // a transfer only family maps to the copy engines, prefer one that can't do compute either
+        if ((current.queueFlags & VK_QUEUE_TRANSFER_BIT) && !(current.queueFlags & VK_QUEUE_GRAPHICS_BIT))
+        {
+            const bool computeFree = !(current.queueFlags & VK_QUEUE_COMPUTE_BIT);
+            if (!indices.TransferFamily || (computeFree && (queueFamilyProperties[*indices.TransferFamily].queueFlags & VK_QUEUE_COMPUTE_BIT)))
+                indices.TransferFamily = i;
+        }
     }
 
     return indices;
@@ -302,6 +457,7 @@ struct ScoredGPU
     VkPhysicalDevice Device;
     QueueFamilyIndices Indices;
     SwapChainSupportDetails SwapChainSupport;
+    VkPhysicalDeviceProperties Properties;
     uint32_t Score;
 
     [[nodiscard]] bool operator<(const ScoredGPU &other) const
@@ -317,18 +473,22 @@ ScoredGPU ScorePhysicalGPU(VkPhysicalDevice device, VkSurfaceKHR surface)
     scored.Indices = FindQueueFamilies(device, surface);
     scored.Score = 0;
 
-    VkPhysicalDeviceProperties properties;
+    VkPhysicalDeviceProperties &properties = scored.Properties;
     VkPhysicalDeviceFeatures features;
     vkGetPhysicalDeviceProperties(device, &properties);
     vkGetPhysicalDeviceFeatures(device, &features);
 
+    // headless contexts never present, so the swap chain requirements don't apply
+    const bool headless = surface == VK_NULL_HANDLE;
+
     // disqualify gpu if it doesn't support all required extensions
     const std::vector<VkExtensionProperties> presentExtensions =
         VulkanEnumerate<VkExtensionProperties>(&vkEnumerateDeviceExtensionProperties, device, nullptr);
 
     for (const char *requiredExtension : REQUIRED_EXTENSIONS)
     {
-        if (std::none_of(begin(presentExtensions), end(presentExtensions),
+        if (!headless &&
+            std::none_of(begin(presentExtensions), end(presentExtensions),
                          [&](const VkExtensionProperties &extension) { return strcmp(extension.extensionName, requiredExtension) == 0; }))
         {
             scored.Score = INADEQUATE_GPU_SCORE;
@@ -337,16 +497,19 @@ ScoredGPU ScorePhysicalGPU(VkPhysicalDevice device, VkSurfaceKHR surface)
     }
 
     // disqualify if swapchain is not adequate
-    scored.SwapChainSupport = QuerySwapChainSupport(device, surface);
-
-    if (!scored.SwapChainSupport.IsAdequate())
+    if (!headless)
     {
-        scored.Score = INADEQUATE_GPU_SCORE;
-        return scored;
+        scored.SwapChainSupport = QuerySwapChainSupport(device, surface);
+
+        if (!scored.SwapChainSupport.IsAdequate())
+        {
+            scored.Score = INADEQUATE_GPU_SCORE;
+            return scored;
+        }
     }
 
     // disqualify gpu if it doesn't support required features
-    if (!features.geometryShader || !scored.Indices.IsComplete())
+    if (!features.geometryShader || !scored.Indices.IsComplete(!headless))
     {
         scored.Score = INADEQUATE_GPU_SCORE;
         return scored;
@@ -379,16 +542,38 @@ void VulkanContext::PickPhysicalDevice()
         throw GraphicsException("no suitable physical devices found");
 
     m_physicalDevice = bestDevice->Device;
+    m_physicalDeviceProperties = bestDevice->Properties;
     m_queueFamilyIndices = bestDevice->Indices;
     m_swapChainSupportDetails = bestDevice->SwapChainSupport;
 }
 
 void VulkanContext::CreateLogicalDevice()
 {
-    VkPhysicalDeviceFeatures features;
-    vkGetPhysicalDeviceFeatures(m_physicalDevice, &features);
+    // every supported feature is enabled
+    vkGetPhysicalDeviceFeatures(m_physicalDevice, &m_physicalDeviceFeatures);
+
+    m_deviceExtensions.clear();
+    if (!m_headless)
+        m_deviceExtensions.assign(REQUIRED_EXTENSIONS.begin(), REQUIRED_EXTENSIONS.end());
+
+    const std::vector<VkExtensionProperties> availableExtensions =
+        VulkanEnumerate<VkExtensionProperties>(&vkEnumerateDeviceExtensionProperties, m_physicalDevice, nullptr);
+
+    for (const char *optionalExtension : OPTIONAL_EXTENSIONS)
+    {
+        if (std::any_of(begin(availableExtensions), end(availableExtensions),
+                        [&](const VkExtensionProperties &extension) { return strcmp(extension.extensionName, optionalExtension) == 0; }))
+        {
+            m_deviceExtensions.push_back(optionalExtension);
+        }
+    }
+
+    std::set<uint32_t> uniqueQueueIds{*m_queueFamilyIndices.GraphicsFamily};
+    if (m_queueFamilyIndices.PresentFamily)
+        uniqueQueueIds.insert(*m_queueFamilyIndices.PresentFamily);
+    if (m_queueFamilyIndices.TransferFamily)
+        uniqueQueueIds.insert(*m_queueFamilyIndices.TransferFamily);
 
-    std::set<uint32_t> uniqueQueueIds{*m_queueFamilyIndices.GraphicsFamily, *m_queueFamilyIndices.PresentFamily};
     std::vector<VkDeviceQueueCreateInfo> queueCreateInfos{};
 
     const float queuePriority = 1.0f;
@@ -397,7 +582,7 @@ void VulkanContext::CreateLogicalDevice()
     {
         VkDeviceQueueCreateInfo &info = queueCreateInfos.emplace_back();
         info.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-        info.queueFamilyIndex = *m_queueFamilyIndices.GraphicsFamily;
+        info.queueFamilyIndex = uniqueId;
         info.queueCount = 1;
         info.pQueuePriorities = &queuePriority;
     }
@@ -406,53 +591,58 @@ void VulkanContext::CreateLogicalDevice()
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
-    createInfo.pEnabledFeatures = &features;
+    createInfo.pEnabledFeatures = &m_physicalDeviceFeatures;
     createInfo.enabledLayerCount = static_cast<uint32_t>(m_requiredValidationLayers.size());
     createInfo.ppEnabledLayerNames = m_requiredValidationLayers.data();
-    createInfo.enabledExtensionCount = static_cast<uint32_t>(REQUIRED_EXTENSIONS.size());
-    createInfo.ppEnabledExtensionNames = REQUIRED_EXTENSIONS.data();
+    createInfo.enabledExtensionCount = static_cast<uint32_t>(m_deviceExtensions.size());
+    createInfo.ppEnabledExtensionNames = m_deviceExtensions.data();
 
     if (vkCreateDevice(m_physicalDevice, &createInfo, nullptr, &m_device) != VK_SUCCESS)
         throw GraphicsException("failed to create a logical device");
 
     vkGetDeviceQueue(m_device, *m_queueFamilyIndices.GraphicsFamily, 0, &m_graphicsQueue);
-    vkGetDeviceQueue(m_device, *m_queueFamilyIndices.PresentFamily, 0, &m_presentQueue);
+
+    if (m_queueFamilyIndices.PresentFamily)
+        vkGetDeviceQueue(m_device, *m_queueFamilyIndices.PresentFamily, 0, &m_presentQueue);
+
+    // without a dedicated family uploads share the graphics queue
+    if (m_queueFamilyIndices.TransferFamily)
+        vkGetDeviceQueue(m_device, *m_queueFamilyIndices.TransferFamily, 0, &m_transferQueue);
+    else
+        m_transferQueue = m_graphicsQueue;
+}
+
+void VulkanContext::CreatePipelineCache()
+{
+    m_pipelineCache.Create(this, PIPELINE_CACHE_PATH);
 }
 
 void VulkanContext::CreateSwapChain()
 {
     vkDeviceWaitIdle(m_device);
     m_swapChain.Create(this);
+    CreatePipelines();
+    m_swapChain.CreateFramebuffers(m_pipelineManager.GetRenderPass(), m_pipelineManager.GetDepthFormat());
+
+    // the depth pyramid follows the depth buffer, before Create this does nothing
+    m_gpuCulling.CreatePyramid();
 }
 
-void VulkanContext::CreateCommandPool()
+void VulkanContext::CreatePipelines()
 {
-    VkCommandPoolCreateInfo poolInfo{};
-    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-    poolInfo.queueFamilyIndex = *m_queueFamilyIndices.GraphicsFamily;
+    // pipelines don't depend on the extent, so they survive every recreate that keeps the surface format
+    const VkFormat colorFormat = m_swapChain.GetSwapChainFormat().format;
 
-    if (vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool) != VK_SUCCESS)
-        throw GraphicsException("failed to create command pool!");
+    if (m_pipelineManager.GetColorFormat() != colorFormat)
+        m_pipelineManager.Create(this, colorFormat);
 }
 
-void VulkanContext::CreateCommandBuffer()
+void VulkanContext::CreateCommandPools()
 {
+    // the render thread records too, while it waits for the workers
+    const size_t threadCount = m_jobSystem != nullptr ? m_jobSystem->GetWorkerCount() + 1 : 1;
 
-    VkCommandBufferAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.commandPool = m_commandPool;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandBufferCount = MAX_FRAMES_IN_FLIGHT;
-
-    std::vector<VkCommandBuffer> buffers;
-    buffers.resize(MAX_FRAMES_IN_FLIGHT);
-
-    if (vkAllocateCommandBuffers(m_device, &allocInfo, buffers.data()) != VK_SUCCESS)
-        throw GraphicsException("failed to allocate command buffers!");
-
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
-        m_inFlightFrameData[i].CommandBuffer = buffers[i];
+    m_commandPools.Create(this, MAX_FRAMES_IN_FLIGHT, threadCount);
 }
 
 void VulkanContext::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex)
@@ -463,26 +653,114 @@ void VulkanContext::RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t
     if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
         throw GraphicsException("failed to begin recording command buffer!");
 
-    VkClearValue clearColor{{{0.0f, 0.0f, 0.0f, 1.0f}}};
+    m_frameProfiler.ResetQueries(commandBuffer, m_currentFrame);
+    m_uploadManager.RecordAcquireBarriers(commandBuffer, m_currentFrame);
+
+    if (m_gpuCulling.IsActive())
+        m_gpuCulling.RecordCull(commandBuffer, m_currentFrame, m_camera);
+
+    std::array<VkClearValue, 2> clearValues{};
+    clearValues[0].color = {{0.55f, 0.7f, 0.9f, 1.0f}};
+    clearValues[1].depthStencil = {1.0f, 0};
 
     VkRenderPassBeginInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = m_swapChain.GetRenderPass();
+    renderPassInfo.renderPass = m_pipelineManager.GetRenderPass();
     renderPassInfo.framebuffer = m_swapChain.GetSwapChainFramebuffers()[imageIndex];
     renderPassInfo.renderArea.offset = {0, 0};
     renderPassInfo.renderArea.extent = m_swapChain.GetSwapChainExtent();
-    renderPassInfo.clearValueCount = 1;
-    renderPassInfo.pClearValues = &clearColor;
+    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+    renderPassInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_swapChain.GetPipeline());
-    vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+    m_frameProfiler.BeginGpuTimer(commandBuffer, m_currentFrame, GpuTimer::RenderPass);
+    vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    RecordDrawBatches(commandBuffer, imageIndex);
     vkCmdEndRenderPass(commandBuffer);
+    m_frameProfiler.EndGpuTimer(commandBuffer, m_currentFrame, GpuTimer::RenderPass);
+
+    if (m_gpuCulling.IsActive())
+        m_gpuCulling.RecordDepthPyramid(commandBuffer, m_camera);
 
     if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
         throw GraphicsException("failed to record command buffer!");
 }
 
+void VulkanContext::RecordDrawBatches(VkCommandBuffer commandBuffer, uint32_t imageIndex)
+{
+    const uint32_t batchCount = m_chunkRenderer.GetBatchCount(m_currentFrame);
+    if (batchCount == 0)
+        return;
+
+    const VkExtent2D &extent = m_swapChain.GetSwapChainExtent();
+
+    VkViewport viewport{};
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = static_cast<float>(extent.width);
+    viewport.height = static_cast<float>(extent.height);
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = extent;
+
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = m_pipelineManager.GetRenderPass();
+    inheritanceInfo.subpass = 0;
+    inheritanceInfo.framebuffer = m_swapChain.GetSwapChainFramebuffers()[imageIndex];
+
+    // a failed batch leaves its slot empty, jobs can't throw to the render thread
+    m_batchBuffers.assign(batchCount, VK_NULL_HANDLE);
+
+    // secondaries don't inherit any state, every batch sets up its own
+    const auto record = [this, &viewport, &scissor, &inheritanceInfo](uint32_t batch) {
+        // the render thread picks up batches too while it waits, with the pools of thread 0
+        const size_t thread = m_jobSystem != nullptr && m_jobSystem->IsWorkerThread() ? m_jobSystem->GetWorkerIndex() + 1 : 0;
+        const VkCommandBuffer secondary = m_commandPools.AllocateSecondary(m_currentFrame, thread);
+
+        VkCommandBufferBeginInfo beginInfo{};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+        if (vkBeginCommandBuffer(secondary, &beginInfo) != VK_SUCCESS)
+            throw GraphicsException("failed to begin recording command buffer!");
+
+        vkCmdSetViewport(secondary, 0, 1, &viewport);
+        vkCmdSetScissor(secondary, 0, 1, &scissor);
+        m_chunkRenderer.RecordBatch(secondary, m_camera, m_currentFrame, batch);
+
+        if (vkEndCommandBuffer(secondary) != VK_SUCCESS)
+            throw GraphicsException("failed to record command buffer!");
+
+        m_batchBuffers[batch] = secondary;
+    };
+
+    // a single batch isn't worth the round trip through the job system
+    if (m_jobSystem == nullptr || batchCount == 1)
+    {
+        for (uint32_t batch = 0; batch < batchCount; batch++)
+            record(batch);
+    }
+    else
+    {
+        for (uint32_t batch = 0; batch < batchCount; batch++)
+            m_recordJobs.push_back(m_jobSystem->Schedule([&record, batch]() { record(batch); }, JobPriority::High));
+
+        for (const JobHandle &job : m_recordJobs)
+            m_jobSystem->WaitUrgent(job);
+
+        m_recordJobs.clear();
+    }
+
+    if (std::find(m_batchBuffers.begin(), m_batchBuffers.end(), VK_NULL_HANDLE) != m_batchBuffers.end())
+        throw GraphicsException("failed to record draw batches!");
+
+    vkCmdExecuteCommands(commandBuffer, batchCount, m_batchBuffers.data());
+}
+
 void VulkanContext::CreateSyncObjects()
 {
     VkSemaphoreCreateInfo semaphoreInfo{};
@@ -506,18 +784,36 @@ void VulkanContext::CreateSyncObjects()
 void VulkanContext::Destroy()
 {
     if (m_device != VK_NULL_HANDLE)
+    {
         vkDeviceWaitIdle(m_device);
 
+        for (size_t frame = 0; frame < MAX_FRAMES_IN_FLIGHT; frame++)
+            m_frameProfiler.CollectGpuResults(frame);
+
+        m_frameProfiler.Dump(std::cout);
+        m_frameProfiler.Destroy();
+        m_frameLimiter.Dump(std::cout);
+        m_gpuCulling.Dump(std::cout);
+        m_gpuCulling.Destroy();
+        m_chunkRenderer.Dump(std::cout);
+        m_chunkRenderer.Destroy();
+        m_blockTextures.Dump(std::cout);
+        m_blockTextures.Destroy();
+        m_commandPools.Dump(std::cout);
+        m_uploadManager.Destroy();
+
+        m_memoryAllocator.Dump(std::cout);
+    }
+
     for (InFlightFrameData &data : m_inFlightFrameData)
         data.Destroy();
 
-    if (m_commandPool != VK_NULL_HANDLE)
-    {
-        vkDestroyCommandPool(m_device, m_commandPool, nullptr);
-        m_commandPool = VK_NULL_HANDLE;
-    }
+    m_commandPools.Destroy();
 
     m_swapChain.Destroy();
+    m_pipelineManager.Destroy();
+    m_pipelineCache.Destroy();
+    m_memoryAllocator.Destroy();
 
     if (m_device != VK_NULL_HANDLE)
     {
@@ -563,9 +859,8 @@ void VulkanContext::RecreateSwapChain()
         glfwWaitEvents();
     }
 
-    vkDeviceWaitIdle(m_device);
     m_swapChainSupportDetails = QuerySwapChainSupport(m_physicalDevice, m_surface);
-    m_swapChain.Recreate();
+    CreateSwapChain();
 }
 
 bool VulkanContext::HandleDrawResult(VkResult result)
@@ -583,6 +878,26 @@ bool VulkanContext::HandleDrawResult(VkResult result)
     }
 }
 
+LatencyMode VulkanContext::GetLatencyMode() const noexcept
+{
+    return m_latencyMode;
+}
+
+const LatencySettings &VulkanContext::GetLatencySettings() const noexcept
+{
+    return m_latencySettings;
+}
+
+bool VulkanContext::IsHeadless() const noexcept
+{
+    return m_headless;
+}
+
+VkExtent2D VulkanContext::GetHeadlessExtent() const noexcept
+{
+    return m_headlessExtent;
+}
+
 GLFWwindow *VulkanContext::GetWindow() noexcept
 {
     return m_window;
@@ -603,6 +918,21 @@ VkPhysicalDevice VulkanContext::GetPhysicalDevice() noexcept
     return m_physicalDevice;
 }
 
+VkPhysicalDeviceProperties &VulkanContext::GetPhysicalDeviceProperties() noexcept
+{
+    return m_physicalDeviceProperties;
+}
+
+const VkPhysicalDeviceFeatures &VulkanContext::GetPhysicalDeviceFeatures() const noexcept
+{
+    return m_physicalDeviceFeatures;
+}
+
+bool VulkanContext::IsDeviceExtensionEnabled(const char *name) const noexcept
+{
+    return std::any_of(m_deviceExtensions.begin(), m_deviceExtensions.end(), [name](const char *extension) { return strcmp(extension, name) == 0; });
+}
+
 VkDevice VulkanContext::GetDevice() noexcept
 {
     return m_device;
@@ -618,6 +948,11 @@ VkQueue VulkanContext::GetPresentQueue() noexcept
     return m_presentQueue;
 }
 
+VkQueue VulkanContext::GetTransferQueue() noexcept
+{
+    return m_transferQueue;
+}
+
 VkSurfaceKHR VulkanContext::GetSurface() noexcept
 {
     return m_surface;
@@ -633,14 +968,73 @@ SwapChainSupportDetails &VulkanContext::GetSwapChainSupportDetails() noexcept
     return m_swapChainSupportDetails;
 }
 
+MemoryAllocator &VulkanContext::GetMemoryAllocator() noexcept
+{
+    return m_memoryAllocator;
+}
+
 SwapChain &VulkanContext::GetSwapChain() noexcept
 {
     return m_swapChain;
 }
 
-VkCommandPool VulkanContext::GetCommandPool() noexcept
+PipelineManager &VulkanContext::GetPipelineManager() noexcept
+{
+    return m_pipelineManager;
+}
+
+FrameProfiler &VulkanContext::GetFrameProfiler() noexcept
+{
+    return m_frameProfiler;
+}
+
+UploadManager &VulkanContext::GetUploadManager() noexcept
 {
-    return m_commandPool;
+    return m_uploadManager;
+}
+
+BlockTextures &VulkanContext::GetBlockTextures() noexcept
+{
+    return m_blockTextures;
+}
+
+ChunkRenderer &VulkanContext::GetChunkRenderer() noexcept
+{
+    return m_chunkRenderer;
+}
+
+GpuCulling &VulkanContext::GetGpuCulling() noexcept
+{
+    return m_gpuCulling;
+}
+
+Camera &VulkanContext::GetCamera() noexcept
+{
+    return m_camera;
+}
+
+CommandPools &VulkanContext::GetCommandPools() noexcept
+{
+    return m_commandPools;
+}
+
+VkPipelineCache VulkanContext::GetPipelineCache() noexcept
+{
+    return m_pipelineCache.GetVkPipelineCache();
+}
+
+uint32_t VulkanContext::FindMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties)
+{
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vkGetPhysicalDeviceMemoryProperties(m_physicalDevice, &memoryProperties);
+
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++)
+    {
+        if ((typeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+            return i;
+    }
+
+    throw GraphicsException("failed to find a suitable memory type");
 }
 
 } // namespace MineClone
@@ -0,0 +1,120 @@
+#include <MineClone/Game/EntitySystems.hpp>
+
+#include <cmath>
+
+namespace MineClone
+{
+
+namespace
+{
+
+// horizontal speed kept per tick on the ground
+constexpr float GROUND_FRICTION = 0.6f;
+
+[[nodiscard]] inline uint32_t NextRandom(uint32_t &state) noexcept
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// 0 to 1
+[[nodiscard]] inline float NextFloat(uint32_t &state) noexcept
+{
+    return static_cast<float>(NextRandom(state) >> 8) * (1.0f / 16777216.0f);
+}
+
+[[nodiscard]] BoundingBox MakeBox(float x, float y, float z, float width, float height) noexcept
+{
+    return {x - width * 0.5f, y, z - width * 0.5f, x + width * 0.5f, y + height, z + width * 0.5f};
+}
+
+void Wander(EntityWorld &world, float seconds)
+{
+    world.EachColumn<Mob, PhysicsBody>([seconds](size_t count, const Entity *, Mob *mobs, PhysicsBody *bodies) {
+        for (size_t i = 0; i < count; i++)
+        {
+            Mob &mob = mobs[i];
+            PhysicsBody &body = bodies[i];
+
+            mob.WanderSeconds -= seconds;
+
+            if (mob.WanderSeconds <= 0.0f)
+            {
+                // standing still now and then
+                const float angle = NextFloat(mob.Random) * 6.2831853f;
+                const float speed = NextFloat(mob.Random) < 0.25f ? 0.0f : EntityConstants::MOB_SPEED;
+
+                mob.HeadingX = std::cos(angle) * speed;
+                mob.HeadingZ = std::sin(angle) * speed;
+                mob.WanderSeconds = 2.0f + NextFloat(mob.Random) * 6.0f;
+            }
+
+            // physics zeroes the velocity on the axes that hit something, a mob on the ground walked into a step
+            const bool blocked = (mob.HeadingX != 0.0f && body.VelocityX == 0.0f) || (mob.HeadingZ != 0.0f && body.VelocityZ == 0.0f);
+
+            if (blocked && body.OnGround)
+                body.VelocityY = EntityConstants::JUMP_VELOCITY;
+
+            body.VelocityX = mob.HeadingX;
+            body.VelocityZ = mob.HeadingZ;
+        }
+    });
+}
+
+void AgeItems(EntityWorld &world, float seconds)
+{
+    world.Each<ItemDrop>([&world, seconds](Entity entity, ItemDrop &item) {
+        item.Age += seconds;
+
+        if (item.Age >= EntityConstants::ITEM_LIFETIME)
+        {
+            world.Defer([entity](EntityWorld &target) {
+                target.Destroy(entity);
+            });
+        }
+    });
+}
+
+} // namespace
+
+Entity SpawnMob(EntityWorld &world, float x, float y, float z, uint32_t seed)
+{
+    // xorshift never leaves 0
+    const Mob mob{0.0f, 0.0f, 0.0f, seed == 0 ? 1 : seed};
+    return world.Create(mob, PhysicsBody{MakeBox(x, y, z, 0.6f, 1.8f), 0.0f, 0.0f, 0.0f, false});
+}
+
+Entity SpawnItem(EntityWorld &world, float x, float y, float z, BlockId block, uint16_t count)
+{
+    return world.Create(ItemDrop{block, count, 0.0f}, PhysicsBody{MakeBox(x, y, z, 0.25f, 0.25f), 0.0f, 4.0f, 0.0f, false});
+}
+
+void AddEntitySystems(SystemScheduler &scheduler, BlockAccess &blocks)
+{
+    scheduler.Add("wander", 0, GetComponentMask<Mob, PhysicsBody>(), &Wander);
+
+    scheduler.Add("physics", 0, GetComponentMask<PhysicsBody>(), [&blocks](EntityWorld &world, float seconds) {
+        // chunks may have been unloaded since the last tick
+        blocks.Reset();
+
+        world.EachColumn<PhysicsBody>([&blocks, seconds](size_t count, const Entity *, PhysicsBody *bodies) {
+            StepBodies(blocks, bodies, count, seconds, EntityConstants::GRAVITY);
+
+            // mobs set their own speed every tick, this only stops items from sliding
+            for (size_t i = 0; i < count; i++)
+            {
+                if (!bodies[i].OnGround)
+                    continue;
+
+                bodies[i].VelocityX *= GROUND_FRICTION;
+                bodies[i].VelocityZ *= GROUND_FRICTION;
+            }
+        });
+    });
+
+    scheduler.Add("items", 0, GetComponentMask<ItemDrop>(), &AgeItems);
+}
+
+} // namespace MineClone
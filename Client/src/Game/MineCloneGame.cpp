@@ -1,10 +1,65 @@
 #include <MineClone/Game/MineCloneGame.hpp>
 
+#include <iostream>
+
 namespace MineClone
 {
 
-MineCloneGame::MineCloneGame() : Game("Not Minecraft", 800, 600)
+MineCloneGame::MineCloneGame(GameOptions options)
+    : Game("Not Minecraft", 800, 600, options), m_blocks{[this](int32_t x, int32_t z) {
+          return m_tickChunks->Find(x, z);
+      }}
+{
+    AddEntitySystems(m_systems, m_blocks);
+
+    // drops are queued while the mobs are iterated, creating them right away would move the rows under the loop
+    m_systems.Add("drops", GetComponentMask<Mob, PhysicsBody>(), 0, [this](EntityWorld &world, float seconds) {
+        world.Each<Mob, PhysicsBody>([this, &world, seconds](Entity, Mob &, PhysicsBody &body) {
+            m_random ^= m_random << 13;
+            m_random ^= m_random >> 17;
+            m_random ^= m_random << 5;
+
+            if (static_cast<float>(m_random >> 8) * (1.0f / 16777216.0f) >= seconds / DROP_INTERVAL)
+                return;
+
+            const float x = (body.Box.MinX + body.Box.MaxX) * 0.5f;
+            const float z = (body.Box.MinZ + body.Box.MaxZ) * 0.5f;
+            const float y = body.Box.MinY + 0.5f;
+
+            world.Defer([x, y, z](EntityWorld &target) {
+                SpawnItem(target, x, y, z, Blocks::DIRT, 1);
+            });
+        });
+    });
+}
+
+MineCloneGame::~MineCloneGame()
+{
+    // the simulation calls into this class, it has to stop before the members go away
+    StopSimulation();
+
+    m_systems.Dump(std::cout);
+    m_entities.Dump(std::cout);
+    m_entities.Clear();
+}
+
+void MineCloneGame::OnSpawnAreaLoaded()
+{
+    for (int i = 0; i < SPAWN_MOBS; i++)
+    {
+        // dropped from above the terrain, they fall onto whatever is below
+        const float x = (static_cast<float>(i % 16) + 0.5f) / 16.0f * SPAWN_AREA - SPAWN_AREA * 0.5f;
+        const float z = (static_cast<float>(i / 16) + 0.5f) / 16.0f * SPAWN_AREA - SPAWN_AREA * 0.5f;
+
+        SpawnMob(m_entities, x, static_cast<float>(Chunk::HEIGHT - 8), z, static_cast<uint32_t>(i + 1) * 2654435761u);
+    }
+}
+
+void MineCloneGame::OnWorldTick(const ChunkView &chunks, float seconds)
 {
+    m_tickChunks = &chunks;
+    m_systems.Run(m_entities, seconds, &GetJobSystem());
+    m_tickChunks = nullptr;
 }
 
 } // namespace MineClone
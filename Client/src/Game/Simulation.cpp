@@ -0,0 +1,164 @@
+#include <MineClone/Game/Simulation.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace MineClone
+{
+
+namespace
+{
+
+// blocks and radians per second at full input
+constexpr float SPEED = 20.0f;
+constexpr float TURN_SPEED = 1.5f;
+
+PlayerState GetState(const Camera &camera) noexcept
+{
+    return {camera.GetX(), camera.GetY(), camera.GetZ(), camera.GetYaw(), camera.GetPitch()};
+}
+
+} // namespace
+
+Simulation::~Simulation()
+{
+    Stop();
+}
+
+void Simulation::SetWorldTick(WorldTickFunction function)
+{
+    ASSERT(!IsRunning(), "the world tick has to be set before the simulation starts");
+    m_worldTick = std::move(function);
+}
+
+void Simulation::Start(uint32_t tickRate, const PlayerState &player)
+{
+    Stop();
+
+    ASSERT(tickRate != 0, "the simulation needs a tick rate");
+
+    m_tickRate = tickRate;
+    m_tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / tickRate));
+
+    m_player.SetPosition(player.X, player.Y, player.Z);
+    m_player.SetRotation(player.Yaw, player.Pitch);
+    m_tick = 0;
+    m_skippedTicks = 0;
+    m_tickSeconds = 0.0;
+
+    // frames before the first tick see the starting state
+    SimulationSnapshot &snapshot = m_snapshots.GetWriteBuffer();
+    snapshot = {0, Clock::now(), GetState(m_player), GetState(m_player)};
+    m_snapshots.Publish();
+
+    m_running.store(true, std::memory_order_release);
+    m_thread = std::thread(&Simulation::Run, this);
+}
+
+void Simulation::Stop()
+{
+    m_running.store(false, std::memory_order_release);
+
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+void Simulation::SetInput(const PlayerInput &input) noexcept
+{
+    m_input.GetWriteBuffer() = input;
+    m_input.Publish();
+}
+
+void Simulation::SetChunkView(std::shared_ptr<const ChunkView> view) noexcept
+{
+    m_chunkViews.GetWriteBuffer() = std::move(view);
+    m_chunkViews.Publish();
+}
+
+PlayerState Simulation::Interpolate(Clock::time_point time) noexcept
+{
+    m_snapshots.Update();
+    const SimulationSnapshot &snapshot = m_snapshots.Read();
+
+    // past a full tick the next snapshot is late, hold the newest state rather than extrapolate
+    const float alpha = std::clamp(std::chrono::duration<float>(time - snapshot.Time).count() / std::chrono::duration<float>(m_tickDuration).count(),
+                                   0.0f, 1.0f);
+
+    const PlayerState &from = snapshot.Previous;
+    const PlayerState &to = snapshot.Current;
+
+    const auto lerp = [alpha](float a, float b) {
+        return a + (b - a) * alpha;
+    };
+
+    // yaw wraps around, turn the short way
+    const float yaw = from.Yaw + std::remainder(to.Yaw - from.Yaw, 2.0f * 3.14159265f) * alpha;
+
+    return {lerp(from.X, to.X), lerp(from.Y, to.Y), lerp(from.Z, to.Z), yaw, lerp(from.Pitch, to.Pitch)};
+}
+
+void Simulation::Run()
+{
+    Clock::time_point next = Clock::now() + m_tickDuration;
+
+    while (m_running.load(std::memory_order_acquire))
+    {
+        const Clock::time_point now = Clock::now();
+
+        if (now < next)
+        {
+            std::this_thread::sleep_until(next);
+            continue;
+        }
+
+        // far behind, after a breakpoint or a suspend, the world skips ahead instead of fast forwarding
+        if (now - next > m_tickDuration * MAX_CATCH_UP_TICKS)
+        {
+            m_skippedTicks += static_cast<uint64_t>((now - next) / m_tickDuration);
+            next = now;
+        }
+
+        m_input.Update();
+
+        const PlayerState previous = GetState(m_player);
+        Tick(m_input.Read());
+        m_tickSeconds += std::chrono::duration<double>(Clock::now() - now).count();
+
+        SimulationSnapshot &snapshot = m_snapshots.GetWriteBuffer();
+        snapshot = {++m_tick, next, previous, GetState(m_player)};
+        m_snapshots.Publish();
+
+        next += m_tickDuration;
+    }
+}
+
+void Simulation::Tick(const PlayerInput &input)
+{
+    const float seconds = std::chrono::duration<float>(m_tickDuration).count();
+
+    m_player.Rotate(input.Yaw * TURN_SPEED * seconds, input.Pitch * TURN_SPEED * seconds);
+    m_player.Move(input.Forward * SPEED * seconds, input.Right * SPEED * seconds, input.Up * SPEED * seconds);
+
+    m_chunkViews.Update();
+
+    if (const std::shared_ptr<const ChunkView> &chunks = m_chunkViews.Read(); m_worldTick && chunks != nullptr)
+        m_worldTick(*chunks, seconds);
+}
+
+void Simulation::Dump(std::ostream &stream) const
+{
+    if (m_tick == 0)
+        return;
+
+    stream << "simulation: " << m_tick << " ticks at " << m_tickRate << " Hz, " << m_tickSeconds * 1000.0 / static_cast<double>(m_tick)
+           << " ms/tick, " << m_skippedTicks << " skipped\n";
+    stream.flush();
+}
+
+bool Simulation::IsRunning() const noexcept
+{
+    return m_thread.joinable();
+}
+
+} // namespace MineClone
@@ -0,0 +1,384 @@
+#include <MineClone/Jobs/JobSystem.hpp>
+
+#include <iostream>
+
+namespace MineClone
+{
+
+namespace
+{
+
+thread_local const JobSystem *t_jobSystem = nullptr;
+thread_local size_t t_workerIndex = 0;
+thread_local size_t t_stealCursor = 0;
+
+} // namespace
+
+void JobGroup::Cancel() noexcept
+{
+    m_cancelled.store(true, std::memory_order_release);
+}
+
+bool JobGroup::IsCancelled() const noexcept
+{
+    return m_cancelled.load(std::memory_order_acquire);
+}
+
+bool JobGroup::IsIdle() const noexcept
+{
+    return m_pendingJobs.load(std::memory_order_acquire) == 0;
+}
+
+Job::Job(std::function<void()> function, JobPriority priority, std::shared_ptr<JobGroup> group)
+    : m_function{std::move(function)}, m_priority{priority}, m_group{std::move(group)}
+{
+}
+
+bool Job::IsFinished() const noexcept
+{
+    return m_finished.load(std::memory_order_acquire);
+}
+
+bool Job::IsCancelled() const noexcept
+{
+    return m_cancelled.load(std::memory_order_acquire);
+}
+
+JobPriority Job::GetPriority() const noexcept
+{
+    return m_priority;
+}
+
+JobSystem::~JobSystem()
+{
+    Destroy();
+}
+
+void JobSystem::Create(size_t workerCount)
+{
+    if (workerCount == 0)
+        workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+    workerCount = std::max<size_t>(workerCount, 1);
+
+    // every queue has to exist before the first worker starts stealing
+    for (size_t i = 0; i < workerCount; i++)
+        m_workers.push_back(std::make_unique<Worker>());
+
+    for (size_t i = 0; i < workerCount; i++)
+        m_workers[i]->Thread = std::thread(&JobSystem::WorkerMain, this, i);
+}
+
+void JobSystem::Destroy()
+{
+    if (m_workers.empty())
+        return;
+
+    WaitIdle();
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopping = true;
+    }
+
+    m_sleepCondition.notify_all();
+
+    for (auto &worker : m_workers)
+        worker->Thread.join();
+
+    m_workers.clear();
+    m_stopping = false;
+}
+
+JobHandle JobSystem::Schedule(std::function<void()> function, JobPriority priority, std::shared_ptr<JobGroup> group,
+                              const std::vector<JobHandle> &dependencies)
+{
+    ASSERT(!m_workers.empty(), "JobSystem::Schedule called before Create");
+
+    auto job = std::make_shared<Job>(std::move(function), priority, std::move(group));
+    job->m_self = job;
+
+    m_outstandingJobs.fetch_add(1, std::memory_order_relaxed);
+
+    if (job->m_group)
+        job->m_group->m_pendingJobs.fetch_add(1, std::memory_order_relaxed);
+
+    for (const JobHandle &dependency : dependencies)
+    {
+        if (!dependency)
+            continue;
+
+        std::lock_guard<std::mutex> lock(dependency->m_mutex);
+
+        if (dependency->IsFinished())
+        {
+            if (dependency->IsCancelled())
+                job->m_dependencyCancelled.store(true, std::memory_order_relaxed);
+
+            continue;
+        }
+
+        job->m_pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+        dependency->m_continuations.push_back(job.get());
+    }
+
+    // drop the reference held while the dependencies were registered
+    if (job->m_pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        Enqueue(job.get());
+
+    return job;
+}
+
+JobHandle JobSystem::Then(const JobHandle &job, std::function<void()> function, JobPriority priority)
+{
+    return Schedule(std::move(function), priority, job ? job->m_group : nullptr, {job});
+}
+
+void JobSystem::Wait(const JobHandle &job)
+{
+    while (job && !job->IsFinished())
+    {
+        if (!RunOne())
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::Wait(const JobGroup &group)
+{
+    while (!group.IsIdle())
+    {
+        if (!RunOne())
+            std::this_thread::yield();
+    }
+}
+
+void JobSystem::WaitUrgent(const JobHandle &job)
+{
+    WaitSleeping(job, true);
+}
+
+void JobSystem::WaitBlocking(const JobHandle &job)
+{
+    WaitSleeping(job, false);
+}
+
+void JobSystem::WaitIdle()
+{
+    while (m_outstandingJobs.load(std::memory_order_acquire) != 0)
+    {
+        if (!RunOne())
+            std::this_thread::yield();
+    }
+}
+
+size_t JobSystem::GetWorkerCount() const noexcept
+{
+    return m_workers.size();
+}
+
+bool JobSystem::IsWorkerThread() const noexcept
+{
+    return t_jobSystem == this;
+}
+
+size_t JobSystem::GetWorkerIndex() const noexcept
+{
+    return t_workerIndex;
+}
+
+void JobSystem::WorkerMain(size_t index)
+{
+    t_jobSystem = this;
+    t_workerIndex = index;
+    t_stealCursor = index;
+
+    while (true)
+    {
+        if (RunOne())
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+
+        m_sleepingWorkers.fetch_add(1);
+        m_sleepCondition.wait(lock, [this] { return m_stopping || m_queuedJobs.load() != 0; });
+        m_sleepingWorkers.fetch_sub(1);
+
+        if (m_stopping && m_queuedJobs.load() == 0)
+            break;
+    }
+
+    t_jobSystem = nullptr;
+}
+
+void JobSystem::Enqueue(Job *job)
+{
+    const auto priority = static_cast<size_t>(job->m_priority);
+
+    if (!IsWorkerThread() || !m_workers[t_workerIndex]->Queues[priority].Push(job))
+    {
+        std::lock_guard<std::mutex> lock(m_globalMutex);
+        m_globalQueues[priority].push_back(job);
+        m_globalSizes[priority].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // pairs with the sleeping counter in WorkerMain, either we see the sleeper or it sees the job
+    m_queuedJobs.fetch_add(1);
+
+    if (m_sleepingWorkers.load() != 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+        }
+
+        m_sleepCondition.notify_one();
+    }
+
+    WakeWaiters();
+}
+
+Job *JobSystem::FindJob(JobPriority lowest)
+{
+    const bool isWorker = IsWorkerThread();
+    const size_t count = m_workers.size();
+    const size_t start = t_stealCursor++;
+
+    for (size_t priority = 0; priority <= static_cast<size_t>(lowest); priority++)
+    {
+        if (isWorker)
+        {
+            if (Job *job = m_workers[t_workerIndex]->Queues[priority].Pop())
+                return job;
+        }
+
+        if (m_globalSizes[priority].load(std::memory_order_relaxed) != 0)
+        {
+            std::lock_guard<std::mutex> lock(m_globalMutex);
+            auto &queue = m_globalQueues[priority];
+
+            if (!queue.empty())
+            {
+                Job *job = queue.front();
+                queue.pop_front();
+                m_globalSizes[priority].fetch_sub(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const size_t victim = (start + i) % count;
+
+            if (isWorker && victim == t_workerIndex)
+                continue;
+
+            if (Job *job = m_workers[victim]->Queues[priority].Steal())
+                return job;
+        }
+    }
+
+    return nullptr;
+}
+
+bool JobSystem::RunOne(JobPriority lowest)
+{
+    Job *job = FindJob(lowest);
+
+    if (job == nullptr)
+        return false;
+
+    m_queuedJobs.fetch_sub(1);
+    Execute(job);
+    return true;
+}
+
+void JobSystem::Execute(Job *job)
+{
+    const std::shared_ptr<Job> self = std::move(job->m_self);
+
+    const bool cancelled = job->m_dependencyCancelled.load(std::memory_order_acquire) || (job->m_group && job->m_group->IsCancelled());
+
+    if (!cancelled)
+    {
+        try
+        {
+            job->m_function();
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << "jobs: job failed: " << e.what() << std::endl;
+        }
+    }
+
+    // release whatever the job captured as soon as possible
+    job->m_function = nullptr;
+
+    Finish(*job, cancelled);
+}
+
+void JobSystem::Finish(Job &job, bool cancelled)
+{
+    std::vector<Job *> continuations;
+
+    {
+        std::lock_guard<std::mutex> lock(job.m_mutex);
+        job.m_cancelled.store(cancelled, std::memory_order_release);
+        job.m_finished.store(true, std::memory_order_release);
+        continuations.swap(job.m_continuations);
+    }
+
+    for (Job *continuation : continuations)
+    {
+        if (cancelled)
+            continuation->m_dependencyCancelled.store(true, std::memory_order_release);
+
+        if (continuation->m_pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            Enqueue(continuation);
+    }
+
+    if (job.m_group)
+        job.m_group->m_pendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+
+    m_outstandingJobs.fetch_sub(1, std::memory_order_acq_rel);
+
+    WakeWaiters();
+}
+
+void JobSystem::WaitSleeping(const JobHandle &job, bool help)
+{
+    if (!job)
+        return;
+
+    const JobPriority lowest = job->GetPriority();
+
+    while (!job->IsFinished())
+    {
+        // read before looking for work, anything queued or finished after that changes it and ends the sleep
+        const uint64_t epoch = m_waitEpoch.load();
+
+        if (help && RunOne(lowest))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+
+        m_blockedWaiters.fetch_add(1);
+        m_waitCondition.wait(lock, [this, &job, epoch] { return job->IsFinished() || m_waitEpoch.load() != epoch; });
+        m_blockedWaiters.fetch_sub(1);
+    }
+}
+
+void JobSystem::WakeWaiters()
+{
+    m_waitEpoch.fetch_add(1);
+
+    // same handshake as with the sleeping workers, either the waiter sees the new epoch or we see the waiter
+    if (m_blockedWaiters.load() != 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+        }
+
+        m_waitCondition.notify_all();
+    }
+}
+
+} // namespace MineClone
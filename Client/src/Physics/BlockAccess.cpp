@@ -0,0 +1,31 @@
+#include <MineClone/Physics/BlockAccess.hpp>
+
+#include <utility>
+
+namespace MineClone
+{
+
+BlockAccess::BlockAccess(ChunkLookup lookup) : m_lookup{std::move(lookup)}
+{
+}
+
+void BlockAccess::Reset() noexcept
+{
+    m_slots = {};
+}
+
+size_t BlockAccess::GetLookupCount() const noexcept
+{
+    return m_lookupCount;
+}
+
+const Chunk *BlockAccess::Load(Slot &slot, int32_t chunkX, int32_t chunkZ)
+{
+    // missing chunks are cached as well, they are asked for just as often
+    slot = {chunkX, chunkZ, m_lookup(chunkX, chunkZ), true};
+    m_lookupCount++;
+
+    return slot.Cached;
+}
+
+} // namespace MineClone
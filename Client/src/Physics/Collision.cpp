@@ -0,0 +1,135 @@
+#include <MineClone/Physics/Collision.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace MineClone
+{
+
+namespace
+{
+
+// boxes resting exactly on a block face shouldn't collide with the blocks next to that face after rounding errors
+constexpr float EPSILON = 1e-4f;
+
+[[nodiscard]] inline int32_t First(float min) noexcept
+{
+    return static_cast<int32_t>(std::floor(min + EPSILON));
+}
+
+[[nodiscard]] inline int32_t Last(float max) noexcept
+{
+    return static_cast<int32_t>(std::floor(max - EPSILON));
+}
+
+// Clips the motion along one axis against the solid blocks in the swept range. Axis 0 is X, 1 is Y and 2 is Z, the
+// other two axes span the cross section of the box.
+float ClipAxis(BlockAccess &blocks, const BoundingBox &box, int axis, float motion)
+{
+    if (motion == 0.0f)
+        return 0.0f;
+
+    const float min[] = {box.MinX, box.MinY, box.MinZ};
+    const float max[] = {box.MaxX, box.MaxY, box.MaxZ};
+
+    const int u = axis == 0 ? 1 : 0;
+    const int v = axis == 2 ? 1 : 2;
+
+    // walk the swept range outward from the box, the first layer with a solid block is where it stops
+    int32_t begin, end, step;
+    if (motion > 0.0f)
+    {
+        begin = Last(max[axis]) + 1;
+        end = static_cast<int32_t>(std::floor(max[axis] + motion)) + 1;
+        step = 1;
+    }
+    else
+    {
+        begin = First(min[axis]) - 1;
+        end = static_cast<int32_t>(std::floor(min[axis] + motion)) - 1;
+        step = -1;
+    }
+
+    const int32_t firstU = First(min[u]), lastU = Last(max[u]);
+    const int32_t firstV = First(min[v]), lastV = Last(max[v]);
+
+    int32_t position[3];
+
+    for (int32_t layer = begin; layer != end; layer += step)
+    {
+        position[axis] = layer;
+
+        for (int32_t a = firstU; a <= lastU; a++)
+        {
+            position[u] = a;
+
+            for (int32_t b = firstV; b <= lastV; b++)
+            {
+                position[v] = b;
+
+                if (!blocks.IsSolid(position[0], position[1], position[2]))
+                    continue;
+
+                const float clipped = motion > 0.0f ? static_cast<float>(layer) - max[axis] : static_cast<float>(layer + 1) - min[axis];
+                return motion > 0.0f ? std::clamp(clipped, 0.0f, motion) : std::clamp(clipped, motion, 0.0f);
+            }
+        }
+    }
+
+    return motion;
+}
+
+inline void Offset(BoundingBox &box, int axis, float distance) noexcept
+{
+    float *min = &box.MinX;
+    float *max = &box.MaxX;
+
+    min[axis] += distance;
+    max[axis] += distance;
+}
+
+} // namespace
+
+MoveResult MoveBox(BlockAccess &blocks, BoundingBox &box, float dx, float dy, float dz)
+{
+    MoveResult result{};
+
+    result.Y = ClipAxis(blocks, box, 1, dy);
+    Offset(box, 1, result.Y);
+
+    result.X = ClipAxis(blocks, box, 0, dx);
+    Offset(box, 0, result.X);
+
+    result.Z = ClipAxis(blocks, box, 2, dz);
+    Offset(box, 2, result.Z);
+
+    result.CollidedX = result.X != dx;
+    result.CollidedY = result.Y != dy;
+    result.CollidedZ = result.Z != dz;
+
+    return result;
+}
+
+void StepBodies(BlockAccess &blocks, PhysicsBody *bodies, size_t count, float seconds, float gravity)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        PhysicsBody &body = bodies[i];
+        body.VelocityY -= gravity * seconds;
+
+        const MoveResult moved = MoveBox(blocks, body.Box, body.VelocityX * seconds, body.VelocityY * seconds, body.VelocityZ * seconds);
+
+        body.OnGround = moved.CollidedY && body.VelocityY < 0.0f;
+
+        if (moved.CollidedX)
+            body.VelocityX = 0.0f;
+
+        if (moved.CollidedY)
+            body.VelocityY = 0.0f;
+
+        if (moved.CollidedZ)
+            body.VelocityZ = 0.0f;
+    }
+}
+
+} // namespace MineClone
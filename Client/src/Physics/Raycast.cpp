@@ -0,0 +1,101 @@
+#include <MineClone/Physics/Raycast.hpp>
+
+#include <cmath>
+#include <limits>
+
+namespace MineClone
+{
+
+namespace
+{
+
+enum class TraceResult
+{
+    Clear,
+    Hit,
+    Unloaded
+}; // enum class TraceResult
+
+struct Axis
+{
+    int32_t Block;
+    int32_t Step;
+    float Next;  // distance to the next boundary
+    float Delta; // distance between boundaries
+}; // struct Axis
+
+[[nodiscard]] Axis MakeAxis(float origin, float direction) noexcept
+{
+    const float block = std::floor(origin);
+
+    if (direction > 0.0f)
+        return {static_cast<int32_t>(block), 1, (block + 1.0f - origin) / direction, 1.0f / direction};
+
+    if (direction < 0.0f)
+        return {static_cast<int32_t>(block), -1, (origin - block) / -direction, -1.0f / direction};
+
+    constexpr float NEVER = std::numeric_limits<float>::infinity();
+    return {static_cast<int32_t>(block), 0, NEVER, NEVER};
+}
+
+TraceResult Trace(BlockAccess &blocks, float originX, float originY, float originZ, float directionX, float directionY, float directionZ,
+                  float maxDistance, RaycastHit &hit)
+{
+    Axis axes[] = {MakeAxis(originX, directionX), MakeAxis(originY, directionY), MakeAxis(originZ, directionZ)};
+
+    // entering through a face means moving against its normal, PositiveX is entered going towards -X
+    constexpr BlockFace ENTERED[3][2] = {{BlockFace::PositiveX, BlockFace::NegativeX},
+                                         {BlockFace::PositiveY, BlockFace::NegativeY},
+                                         {BlockFace::PositiveZ, BlockFace::NegativeZ}};
+
+    float distance = 0.0f;
+    int entered = std::fabs(directionY) >= std::fabs(directionX) ? 1 : 0;
+    entered = std::fabs(directionZ) > std::fabs(entered == 0 ? directionX : directionY) ? 2 : entered;
+
+    while (true)
+    {
+        const int32_t x = axes[0].Block, y = axes[1].Block, z = axes[2].Block;
+
+        // out of the world vertically, and moving further away
+        if ((y < 0 && axes[1].Step <= 0) || (y >= Chunk::HEIGHT && axes[1].Step >= 0))
+            return TraceResult::Clear;
+
+        if (!blocks.IsLoaded(x, z))
+            return TraceResult::Unloaded;
+
+        if (const BlockId block = blocks.GetBlock(x, y, z); IsOpaque(block))
+        {
+            hit = {x, y, z, block, ENTERED[entered][axes[entered].Step > 0 ? 1 : 0], distance};
+            return TraceResult::Hit;
+        }
+
+        entered = axes[0].Next < axes[1].Next ? 0 : 1;
+        entered = axes[2].Next < axes[entered].Next ? 2 : entered;
+
+        Axis &axis = axes[entered];
+        distance = axis.Next;
+
+        if (distance > maxDistance)
+            return TraceResult::Clear;
+
+        axis.Block += axis.Step;
+        axis.Next += axis.Delta;
+    }
+}
+
+} // namespace
+
+bool Raycast(BlockAccess &blocks, float originX, float originY, float originZ, float directionX, float directionY, float directionZ,
+             float maxDistance, RaycastHit &hit)
+{
+    return Trace(blocks, originX, originY, originZ, directionX, directionY, directionZ, maxDistance, hit) == TraceResult::Hit;
+}
+
+bool HasLineOfSight(BlockAccess &blocks, float fromX, float fromY, float fromZ, float toX, float toY, float toZ)
+{
+    // a direction that isn't normalized makes the distances fractions of the way, the end is at 1
+    RaycastHit hit{};
+    return Trace(blocks, fromX, fromY, fromZ, toX - fromX, toY - fromY, toZ - fromZ, 1.0f, hit) == TraceResult::Clear;
+}
+
+} // namespace MineClone
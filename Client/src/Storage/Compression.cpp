@@ -0,0 +1,215 @@
+#include <MineClone/Storage/Compression.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = 0xFFFF;
+
+// the format requires the last five bytes to be literals and the last match to start twelve bytes before the end
+constexpr size_t LAST_LITERALS = 5;
+constexpr size_t MATCH_FIND_LIMIT = 12;
+
+constexpr unsigned HASH_BITS = 12;
+
+// after this many misses in a row the search starts skipping ahead, incompressible data goes through quickly
+constexpr unsigned SKIP_TRIGGER = 6;
+
+inline uint32_t Read32(const uint8_t *data) noexcept
+{
+    uint32_t value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+inline uint32_t Hash(uint32_t sequence) noexcept
+{
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// lengths of 15 and more spill into bytes of 255 and a remainder
+void AppendLength(std::vector<uint8_t> &output, size_t length)
+{
+    for (; length >= 255; length -= 255)
+        output.push_back(255);
+
+    output.push_back(static_cast<uint8_t>(length));
+}
+
+void AppendSequence(std::vector<uint8_t> &output, const uint8_t *literals, size_t literalLength, size_t offset, size_t matchLength)
+{
+    const size_t token = output.size();
+    output.push_back(static_cast<uint8_t>(std::min<size_t>(literalLength, 15) << 4));
+
+    if (literalLength >= 15)
+        AppendLength(output, literalLength - 15);
+
+    output.insert(output.end(), literals, literals + literalLength);
+
+    // the last sequence has literals only
+    if (matchLength == 0)
+        return;
+
+    output.push_back(static_cast<uint8_t>(offset));
+    output.push_back(static_cast<uint8_t>(offset >> 8));
+
+    const size_t length = matchLength - MIN_MATCH;
+    output[token] |= static_cast<uint8_t>(std::min<size_t>(length, 15));
+
+    if (length >= 15)
+        AppendLength(output, length - 15);
+}
+
+bool ReadLength(const uint8_t *&input, const uint8_t *end, size_t &length) noexcept
+{
+    uint8_t byte;
+
+    do
+    {
+        if (input == end)
+            return false;
+
+        byte = *input++;
+        length += byte;
+    } while (byte == 255);
+
+    return true;
+}
+
+} // namespace
+
+size_t CompressBound(size_t size) noexcept
+{
+    return size + size / 255 + 16;
+}
+
+void Compress(const uint8_t *data, size_t size, std::vector<uint8_t> &output)
+{
+    output.reserve(output.size() + CompressBound(size));
+
+    const uint8_t *const end = data + size;
+    const uint8_t *anchor = data;
+
+    if (size > MATCH_FIND_LIMIT)
+    {
+        // positions relative to data, 0 doubles as empty, it fails the match check or is a real match
+        std::array<uint32_t, size_t{1} << HASH_BITS> table{};
+
+        const uint8_t *const matchFindLimit = end - MATCH_FIND_LIMIT;
+        const uint8_t *const matchLimit = end - LAST_LITERALS;
+        const uint8_t *input = data + 1;
+        unsigned misses = 0;
+
+        while (input < matchFindLimit)
+        {
+            const uint32_t sequence = Read32(input);
+            uint32_t &slot = table[Hash(sequence)];
+            const uint8_t *match = data + slot;
+            slot = static_cast<uint32_t>(input - data);
+
+            if (static_cast<size_t>(input - match) > MAX_OFFSET || Read32(match) != sequence)
+            {
+                input += 1 + (misses++ >> SKIP_TRIGGER);
+                continue;
+            }
+
+            misses = 0;
+
+            // grow the match backwards into the pending literals, then forwards
+            while (input > anchor && match > data && input[-1] == match[-1])
+            {
+                input--;
+                match--;
+            }
+
+            size_t length = MIN_MATCH;
+            while (input + length < matchLimit && input[length] == match[length])
+                length++;
+
+            AppendSequence(output, anchor, static_cast<size_t>(input - anchor), static_cast<size_t>(input - match), length);
+
+            input += length;
+            anchor = input;
+
+            // the position two back is usually the start of the next repeat in runs
+            if (input < matchFindLimit)
+                table[Hash(Read32(input - 2))] = static_cast<uint32_t>(input - 2 - data);
+        }
+    }
+
+    AppendSequence(output, anchor, static_cast<size_t>(end - anchor), 0, 0);
+}
+
+bool Decompress(const uint8_t *data, size_t size, uint8_t *output, size_t outputSize) noexcept
+{
+    const uint8_t *input = data;
+    const uint8_t *const inputEnd = data + size;
+    uint8_t *out = output;
+    uint8_t *const outputEnd = output + outputSize;
+
+    while (true)
+    {
+        if (input == inputEnd)
+            return false;
+
+        const uint8_t token = *input++;
+
+        size_t literalLength = token >> 4;
+        if (literalLength == 15 && !ReadLength(input, inputEnd, literalLength))
+            return false;
+
+        if (literalLength > static_cast<size_t>(inputEnd - input) || literalLength > static_cast<size_t>(outputEnd - out))
+            return false;
+
+        std::memcpy(out, input, literalLength);
+        input += literalLength;
+        out += literalLength;
+
+        // the last sequence ends with its literals
+        if (input == inputEnd)
+            break;
+
+        if (inputEnd - input < 2)
+            return false;
+
+        const size_t offset = static_cast<size_t>(input[0]) | static_cast<size_t>(input[1]) << 8;
+        input += 2;
+
+        if (offset == 0 || offset > static_cast<size_t>(out - output))
+            return false;
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadLength(input, inputEnd, matchLength))
+            return false;
+
+        matchLength += MIN_MATCH;
+
+        if (matchLength > static_cast<size_t>(outputEnd - out))
+            return false;
+
+        const uint8_t *match = out - offset;
+
+        // overlapping matches repeat the last offset bytes, they have to be copied front to back
+        if (offset >= matchLength)
+        {
+            std::memcpy(out, match, matchLength);
+            out += matchLength;
+        }
+        else
+        {
+            for (size_t i = 0; i < matchLength; i++)
+                *out++ = match[i];
+        }
+    }
+
+    return out == outputEnd;
+}
+
+} // namespace MineClone
@@ -0,0 +1,214 @@
+#include <MineClone/Storage/MappedFile.hpp>
+
+#include <algorithm>
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MineClone
+{
+
+namespace
+{
+
+#ifndef _WIN32
+// Mappings are reserved in steps this large, so appending to the file rarely moves the mapping. Pages past the end of
+// the file are never touched, they only take address space.
+constexpr uint64_t MAPPING_GRANULARITY = uint64_t{64} << 20;
+#endif
+
+} // namespace
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+void MappedFile::Open(const std::string &path)
+{
+    Close();
+
+#ifdef _WIN32
+    m_handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (m_handle == INVALID_HANDLE_VALUE)
+    {
+        m_handle = nullptr;
+        throw Exception("failed to open " + path);
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_handle, &size))
+    {
+        Close();
+        throw Exception("failed to get the size of " + path);
+    }
+
+    m_size = static_cast<uint64_t>(size.QuadPart);
+#else
+    m_descriptor = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+
+    if (m_descriptor < 0)
+        throw Exception("failed to open " + path);
+
+    struct stat status = {};
+    if (fstat(m_descriptor, &status) != 0)
+    {
+        Close();
+        throw Exception("failed to get the size of " + path);
+    }
+
+    m_size = static_cast<uint64_t>(status.st_size);
+#endif
+
+    if (m_size != 0 && !Map(m_size))
+    {
+        Close();
+        throw Exception("failed to map " + path);
+    }
+}
+
+void MappedFile::Close() noexcept
+{
+    Unmap();
+
+#ifdef _WIN32
+    if (m_handle != nullptr)
+    {
+        CloseHandle(m_handle);
+        m_handle = nullptr;
+    }
+#else
+    if (m_descriptor >= 0)
+    {
+        close(m_descriptor);
+        m_descriptor = -1;
+    }
+#endif
+
+    m_size = 0;
+}
+
+bool MappedFile::Write(uint64_t offset, const void *data, size_t size)
+{
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    size_t written = 0;
+
+    while (written < size)
+    {
+#ifdef _WIN32
+        OVERLAPPED overlapped{};
+        overlapped.Offset = static_cast<DWORD>(offset + written);
+        overlapped.OffsetHigh = static_cast<DWORD>((offset + written) >> 32);
+
+        DWORD count = 0;
+        if (!WriteFile(m_handle, bytes + written, static_cast<DWORD>(std::min<size_t>(size - written, 1u << 30)), &count, &overlapped))
+            return false;
+#else
+        const ssize_t count = pwrite(m_descriptor, bytes + written, size - written, static_cast<off_t>(offset + written));
+
+        if (count < 0)
+            return false;
+#endif
+        written += static_cast<size_t>(count);
+    }
+
+    if (offset + size > m_size)
+    {
+        m_size = offset + size;
+
+        if (m_size > m_mappedSize)
+            return Map(m_size);
+    }
+
+    return true;
+}
+
+bool MappedFile::Sync()
+{
+#ifdef _WIN32
+    return FlushFileBuffers(m_handle) != 0;
+#elif defined(__linux__)
+    return fdatasync(m_descriptor) == 0;
+#else
+    return fsync(m_descriptor) == 0;
+#endif
+}
+
+bool MappedFile::Map(uint64_t size)
+{
+    Unmap();
+
+#ifdef _WIN32
+    // a mapping can't be larger than the file without growing it, so it covers exactly the current size
+    m_mapping = CreateFileMappingA(m_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr)
+        return false;
+
+    m_data = static_cast<const uint8_t *>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr)
+        return false;
+
+    m_mappedSize = size;
+#else
+    const uint64_t capacity = (size + MAPPING_GRANULARITY - 1) / MAPPING_GRANULARITY * MAPPING_GRANULARITY;
+
+    void *mapped = mmap(nullptr, capacity, PROT_READ, MAP_SHARED, m_descriptor, 0);
+    if (mapped == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<const uint8_t *>(mapped);
+    m_mappedSize = capacity;
+#endif
+
+    return true;
+}
+
+void MappedFile::Unmap() noexcept
+{
+#ifdef _WIN32
+    if (m_data != nullptr)
+        UnmapViewOfFile(m_data);
+
+    if (m_mapping != nullptr)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+#else
+    if (m_data != nullptr)
+        munmap(const_cast<uint8_t *>(m_data), m_mappedSize);
+#endif
+
+    m_data = nullptr;
+    m_mappedSize = 0;
+}
+
+bool MappedFile::IsOpen() const noexcept
+{
+#ifdef _WIN32
+    return m_handle != nullptr;
+#else
+    return m_descriptor >= 0;
+#endif
+}
+
+const uint8_t *MappedFile::GetData() const noexcept
+{
+    return m_data;
+}
+
+uint64_t MappedFile::GetSize() const noexcept
+{
+    return m_size;
+}
+
+} // namespace MineClone
@@ -0,0 +1,335 @@
+#include <MineClone/Storage/RegionFile.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr uint32_t MAGIC = 0x4752434D; // "MCRG"
+constexpr uint32_t VERSION = 2; // 2 checks the raw size of blobs as well
+
+// each copy of the table takes three sectors, the blobs start after both
+constexpr uint32_t TABLE_SECTORS = 3;
+constexpr uint32_t DATA_SECTOR = 2 * TABLE_SECTORS;
+
+// header sectors carry this many references, so they never look free
+constexpr uint8_t PINNED = 3;
+
+struct TableHeader
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint64_t Sequence;
+    uint64_t Checksum;
+}; // struct TableHeader
+
+struct BlobHeader
+{
+    uint32_t Size;
+    uint32_t RawSize;
+    uint64_t Checksum;
+}; // struct BlobHeader
+
+// catches torn and bit rotten writes, not tampering; seed covers header fields that aren't part of the data
+uint64_t Checksum(const uint8_t *data, size_t size, uint64_t seed = 0) noexcept
+{
+    constexpr uint64_t PRIME = 0x100000001B3;
+
+    uint64_t hash = 0xCBF29CE484222325 ^ size;
+    hash = ((hash ^ seed) << 31 | (hash ^ seed) >> 33) * PRIME;
+
+    size_t i = 0;
+
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+
+        hash ^= word;
+        hash = (hash << 31 | hash >> 33) * PRIME;
+    }
+
+    for (; i < size; i++)
+        hash = (hash ^ data[i]) * PRIME;
+
+    return hash ^ hash >> 32;
+}
+
+constexpr uint32_t SectorCount(uint64_t size) noexcept
+{
+    return static_cast<uint32_t>((size + RegionFile::SECTOR_SIZE - 1) / RegionFile::SECTOR_SIZE);
+}
+
+constexpr size_t Index(int x, int z) noexcept
+{
+    return static_cast<size_t>(z) * RegionFile::SIZE + static_cast<size_t>(x);
+}
+
+} // namespace
+
+RegionFile::~RegionFile()
+{
+    Close();
+}
+
+void RegionFile::Open(const std::string &path)
+{
+    Close();
+
+    m_path = path;
+    m_file.Open(path);
+
+    m_table = {};
+    m_slots = {};
+    m_dirty = false;
+
+    if (m_file.GetSize() == 0)
+    {
+        // a new region, two empty tables with the second one newer
+        m_sequence = 0;
+
+        if (!WriteTable(0) || !WriteTable(1) || !m_file.Sync())
+        {
+            m_file.Close();
+            throw Exception("failed to initialize region file " + path);
+        }
+
+        m_newestSlot = 1;
+    }
+    else
+    {
+        std::array<uint64_t, 2> sequences{};
+        std::array<bool, 2> valid{};
+
+        for (int slot = 0; slot < 2; slot++)
+        {
+            valid[slot] = ReadTable(slot, sequences[slot], m_slots[slot]);
+
+            if (!valid[slot])
+                m_slots[slot] = {};
+        }
+
+        if (!valid[0] && !valid[1])
+        {
+            m_file.Close();
+            throw Exception("region file " + path + " has no intact offset table");
+        }
+
+        m_newestSlot = !valid[0] || (valid[1] && sequences[1] > sequences[0]) ? 1 : 0;
+        m_sequence = sequences[m_newestSlot];
+        m_table = m_slots[m_newestSlot];
+    }
+
+    m_sectorReferences.assign(std::max(SectorCount(m_file.GetSize()), DATA_SECTOR), 0);
+    std::fill_n(m_sectorReferences.begin(), DATA_SECTOR, PINNED);
+    m_firstFreeSector = DATA_SECTOR;
+
+    for (const Table *table : {&m_table, &m_slots[0], &m_slots[1]})
+    {
+        for (const TableEntry &entry : *table)
+            Reference(entry, 1);
+    }
+}
+
+void RegionFile::Close()
+{
+    if (!m_file.IsOpen())
+        return;
+
+    if (!Flush())
+        std::cerr << "region: failed to flush " << m_path << ", the last saves are lost" << std::endl;
+
+    m_file.Close();
+    m_sectorReferences.clear();
+}
+
+bool RegionFile::ReadTable(int slot, uint64_t &sequence, Table &table) const
+{
+    const uint64_t offset = uint64_t{TABLE_SECTORS} * SECTOR_SIZE * static_cast<uint64_t>(slot);
+
+    if (m_file.GetSize() < offset + sizeof(TableHeader) + sizeof(Table))
+        return false;
+
+    const uint8_t *data = m_file.GetData() + offset;
+
+    TableHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (header.Magic != MAGIC || header.Version != VERSION || header.Checksum != Checksum(data + sizeof(header), sizeof(Table)))
+        return false;
+
+    std::memcpy(table.data(), data + sizeof(header), sizeof(Table));
+    sequence = header.Sequence;
+
+    // entries past the end of the file can only come from a truncated copy, drop them rather than fault on them
+    const uint32_t fileSectors = SectorCount(m_file.GetSize());
+
+    for (TableEntry &entry : table)
+    {
+        if (entry.SectorCount != 0 && (entry.Sector < DATA_SECTOR || entry.Sector + entry.SectorCount > fileSectors))
+        {
+            std::cerr << "region: dropping a chunk past the end of " << m_path << std::endl;
+            entry = {};
+        }
+    }
+
+    return true;
+}
+
+bool RegionFile::WriteTable(int slot)
+{
+    static_assert(sizeof(TableHeader) + sizeof(Table) <= TABLE_SECTORS * SECTOR_SIZE, "the table has to fit its sectors");
+
+    m_writeBuffer.resize(sizeof(TableHeader) + sizeof(Table));
+
+    TableHeader header{MAGIC, VERSION, ++m_sequence, Checksum(reinterpret_cast<const uint8_t *>(m_table.data()), sizeof(Table))};
+    std::memcpy(m_writeBuffer.data(), &header, sizeof(header));
+    std::memcpy(m_writeBuffer.data() + sizeof(header), m_table.data(), sizeof(Table));
+
+    const uint64_t offset = uint64_t{TABLE_SECTORS} * SECTOR_SIZE * static_cast<uint64_t>(slot);
+    return m_file.Write(offset, m_writeBuffer.data(), m_writeBuffer.size());
+}
+
+bool RegionFile::Find(int x, int z, Blob &blob) const
+{
+    const TableEntry &entry = m_table[Index(x, z)];
+
+    if (entry.SectorCount == 0)
+        return false;
+
+    const uint8_t *data = m_file.GetData() + uint64_t{entry.Sector} * SECTOR_SIZE;
+
+    BlobHeader header;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (sizeof(header) + uint64_t{header.Size} > uint64_t{entry.SectorCount} * SECTOR_SIZE ||
+        header.Checksum != Checksum(data + sizeof(header), header.Size, header.RawSize))
+    {
+        return false;
+    }
+
+    blob.Data = data + sizeof(header);
+    blob.Size = header.Size;
+    blob.RawSize = header.RawSize;
+    return true;
+}
+
+bool RegionFile::Save(int x, int z, const uint8_t *data, size_t size, size_t rawSize)
+{
+    const uint32_t count = SectorCount(sizeof(BlobHeader) + size);
+    const uint32_t sector = AllocateSectors(count);
+
+    // padded to whole sectors, so the file always ends on a sector boundary
+    m_writeBuffer.assign(size_t{count} * SECTOR_SIZE, 0);
+
+    const BlobHeader header{static_cast<uint32_t>(size), static_cast<uint32_t>(rawSize), Checksum(data, size, rawSize)};
+    std::memcpy(m_writeBuffer.data(), &header, sizeof(header));
+    std::memcpy(m_writeBuffer.data() + sizeof(header), data, size);
+
+    if (!m_file.Write(uint64_t{sector} * SECTOR_SIZE, m_writeBuffer.data(), m_writeBuffer.size()))
+        return false;
+
+    TableEntry &entry = m_table[Index(x, z)];
+    Reference(entry, -1);
+    entry = {sector, count};
+    Reference(entry, 1);
+
+    m_dirty = true;
+    return true;
+}
+
+bool RegionFile::Flush()
+{
+    if (!m_dirty)
+        return true;
+
+    // the blobs have to be on disk before a table points at them
+    const int slot = 1 - m_newestSlot;
+
+    if (!m_file.Sync() || !WriteTable(slot) || !m_file.Sync())
+        return false;
+
+    for (const TableEntry &entry : m_slots[slot])
+        Reference(entry, -1);
+
+    m_slots[slot] = m_table;
+
+    for (const TableEntry &entry : m_slots[slot])
+        Reference(entry, 1);
+
+    m_newestSlot = slot;
+    m_dirty = false;
+    return true;
+}
+
+uint32_t RegionFile::AllocateSectors(uint32_t count)
+{
+    // first fit, a run that reaches the end of the file is extended
+    uint32_t run = 0;
+    const auto sectorCount = static_cast<uint32_t>(m_sectorReferences.size());
+
+    for (uint32_t sector = m_firstFreeSector; sector < sectorCount; sector++)
+    {
+        if (m_sectorReferences[sector] != 0)
+        {
+            run = 0;
+            continue;
+        }
+
+        if (++run == count)
+            return sector + 1 - count;
+    }
+
+    const uint32_t first = sectorCount - run;
+    m_sectorReferences.resize(size_t{first} + count, 0);
+    return first;
+}
+
+void RegionFile::Reference(const TableEntry &entry, int delta)
+{
+    if (entry.SectorCount == 0)
+        return;
+
+    for (uint32_t sector = entry.Sector; sector < entry.Sector + entry.SectorCount; sector++)
+        m_sectorReferences[sector] = static_cast<uint8_t>(m_sectorReferences[sector] + delta);
+
+    if (delta < 0 && m_sectorReferences[entry.Sector] == 0)
+        m_firstFreeSector = std::min(m_firstFreeSector, entry.Sector);
+
+    while (m_firstFreeSector < m_sectorReferences.size() && m_sectorReferences[m_firstFreeSector] != 0)
+        m_firstFreeSector++;
+}
+
+bool RegionFile::Contains(int x, int z) const noexcept
+{
+    return m_table[Index(x, z)].SectorCount != 0;
+}
+
+size_t RegionFile::GetChunkCount() const noexcept
+{
+    return static_cast<size_t>(std::count_if(m_table.begin(), m_table.end(), [](const TableEntry &entry) {
+        return entry.SectorCount != 0;
+    }));
+}
+
+uint64_t RegionFile::GetFileSize() const noexcept
+{
+    return m_file.GetSize();
+}
+
+uint64_t RegionFile::GetUsedSize() const noexcept
+{
+    uint64_t sectors = DATA_SECTOR;
+
+    for (const TableEntry &entry : m_table)
+        sectors += entry.SectorCount;
+
+    return sectors * SECTOR_SIZE;
+}
+
+} // namespace MineClone
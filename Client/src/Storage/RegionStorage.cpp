@@ -0,0 +1,229 @@
+#include <MineClone/Storage/RegionStorage.hpp>
+
+#include <MineClone/Storage/Compression.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+#include <mutex>
+
+namespace MineClone
+{
+
+namespace
+{
+
+// floor division, chunk -1 is in region -1
+constexpr int32_t RegionCoordinate(int32_t chunk) noexcept
+{
+    return chunk >= 0 ? chunk / RegionFile::SIZE : (chunk + 1) / RegionFile::SIZE - 1;
+}
+
+constexpr int LocalCoordinate(int32_t chunk) noexcept
+{
+    return static_cast<int>(chunk - RegionCoordinate(chunk) * RegionFile::SIZE);
+}
+
+constexpr uint64_t RegionKey(int32_t x, int32_t z) noexcept
+{
+    return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(z);
+}
+
+} // namespace
+
+RegionStorage::~RegionStorage()
+{
+    Close();
+}
+
+void RegionStorage::Open(const std::string &directory)
+{
+    Close();
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    if (error)
+        throw Exception("failed to create the world directory " + directory + ": " + error.message());
+
+    m_directory = directory;
+}
+
+void RegionStorage::Close()
+{
+    const std::unique_lock lock{m_mutex};
+
+    // closing flushes
+    m_regions.clear();
+}
+
+bool RegionStorage::Load(Chunk &chunk)
+{
+    const int32_t regionX = RegionCoordinate(chunk.GetX());
+    const int32_t regionZ = RegionCoordinate(chunk.GetZ());
+    const int x = LocalCoordinate(chunk.GetX());
+    const int z = LocalCoordinate(chunk.GetZ());
+
+    {
+        const std::shared_lock lock{m_mutex};
+
+        if (const OpenRegion *region = FindRegion(regionX, regionZ))
+            return Decode(region->File, x, z, chunk);
+    }
+
+    // opening the region changes the map, that needs the exclusive lock
+    const std::unique_lock lock{m_mutex};
+
+    const OpenRegion *region = OpenRegionFile(regionX, regionZ, false);
+    return region != nullptr && Decode(region->File, x, z, chunk);
+}
+
+bool RegionStorage::Save(const Chunk &chunk)
+{
+    thread_local std::vector<uint8_t> serialized;
+    thread_local std::vector<uint8_t> compressed;
+
+    serialized.clear();
+    chunk.Serialize(serialized);
+
+    compressed.clear();
+    Compress(serialized.data(), serialized.size(), compressed);
+
+    const int32_t regionX = RegionCoordinate(chunk.GetX());
+    const int32_t regionZ = RegionCoordinate(chunk.GetZ());
+
+    const std::unique_lock lock{m_mutex};
+
+    OpenRegion *region = OpenRegionFile(regionX, regionZ, true);
+    if (region == nullptr)
+        return false;
+
+    if (!region->File.Save(LocalCoordinate(chunk.GetX()), LocalCoordinate(chunk.GetZ()), compressed.data(), compressed.size(),
+                           serialized.size()))
+    {
+        std::cerr << "region: failed to save chunk " << chunk.GetX() << ", " << chunk.GetZ() << std::endl;
+        return false;
+    }
+
+    m_saves++;
+    m_rawBytes += serialized.size();
+    m_compressedBytes += compressed.size();
+    return true;
+}
+
+bool RegionStorage::Flush()
+{
+    const std::unique_lock lock{m_mutex};
+
+    bool flushed = true;
+
+    for (auto &[key, region] : m_regions)
+        flushed = region->File.Flush() && flushed;
+
+    return flushed;
+}
+
+StorageStatistics RegionStorage::GetStatistics() const
+{
+    return {m_loads.load(), m_saves.load(), m_rawBytes.load(), m_compressedBytes.load()};
+}
+
+uint64_t RegionStorage::GetFileSize() const
+{
+    const std::shared_lock lock{m_mutex};
+
+    uint64_t size = 0;
+
+    for (const auto &[key, region] : m_regions)
+        size += region->File.GetFileSize();
+
+    return size;
+}
+
+RegionStorage::OpenRegion *RegionStorage::FindRegion(int32_t x, int32_t z)
+{
+    const auto found = m_regions.find(RegionKey(x, z));
+
+    if (found == m_regions.end())
+        return nullptr;
+
+    found->second->LastUse = ++m_useCounter;
+    return found->second.get();
+}
+
+RegionStorage::OpenRegion *RegionStorage::OpenRegionFile(int32_t x, int32_t z, bool create)
+{
+    // another thread may have opened it between the locks
+    if (OpenRegion *region = FindRegion(x, z))
+        return region;
+
+    const std::string path = GetRegionPath(x, z);
+
+    if (!create && !std::filesystem::exists(path))
+        return nullptr;
+
+    if (m_regions.size() >= MAX_OPEN_REGIONS)
+    {
+        const auto oldest = std::min_element(m_regions.begin(), m_regions.end(), [](const auto &a, const auto &b) {
+            return a.second->LastUse < b.second->LastUse;
+        });
+
+        m_regions.erase(oldest);
+    }
+
+    auto region = std::make_unique<OpenRegion>();
+
+    try
+    {
+        region->File.Open(path);
+    }
+    catch (const Exception &e)
+    {
+        // the chunks in it get generated again, and the file is left alone for inspection
+        std::cerr << "region: " << e.what() << std::endl;
+        return nullptr;
+    }
+
+    region->LastUse = ++m_useCounter;
+    return m_regions.emplace(RegionKey(x, z), std::move(region)).first->second.get();
+}
+
+bool RegionStorage::Decode(const RegionFile &region, int x, int z, Chunk &chunk)
+{
+    thread_local std::vector<uint8_t> serialized;
+
+    RegionFile::Blob blob;
+
+    if (!region.Find(x, z, blob))
+    {
+        if (region.Contains(x, z))
+            std::cerr << "region: chunk " << chunk.GetX() << ", " << chunk.GetZ() << " is damaged" << std::endl;
+
+        return false;
+    }
+
+    // the checksum covers the size, this only guards against files written by something else
+    if (blob.RawSize > Chunk::MAX_SERIALIZED_SIZE)
+    {
+        std::cerr << "region: chunk " << chunk.GetX() << ", " << chunk.GetZ() << " claims " << blob.RawSize << " bytes" << std::endl;
+        return false;
+    }
+
+    serialized.resize(blob.RawSize);
+
+    if (!Decompress(blob.Data, blob.Size, serialized.data(), serialized.size()) || !chunk.Deserialize(serialized.data(), serialized.size()))
+    {
+        std::cerr << "region: chunk " << chunk.GetX() << ", " << chunk.GetZ() << " doesn't decode" << std::endl;
+        return false;
+    }
+
+    m_loads++;
+    return true;
+}
+
+std::string RegionStorage::GetRegionPath(int32_t x, int32_t z) const
+{
+    return (std::filesystem::path{m_directory} / ("r." + std::to_string(x) + "." + std::to_string(z) + ".mcr")).string();
+}
+
+} // namespace MineClone
@@ -0,0 +1,129 @@
+#include <MineClone/World/BlockTicker.hpp>
+
+#include <chrono>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr int SIZE = ChunkSection::SIZE;
+
+// floor division for negative block coordinates
+inline int32_t ChunkCoordinate(int32_t block) noexcept
+{
+    return block >> 4;
+}
+
+} // namespace
+
+void BlockTicker::Clear()
+{
+    m_wheel = {};
+}
+
+void BlockTicker::Schedule(int32_t x, int32_t y, int32_t z, BlockId block, uint64_t delay)
+{
+    m_wheel.Schedule(delay, {x, y, z, block});
+    m_statistics.Scheduled++;
+}
+
+void BlockTicker::Tick(const ChunkView &chunks, std::vector<BlockTick> &scheduled, std::vector<BlockTick> &random)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    TickScheduled(chunks, scheduled);
+    TickRandom(chunks, random);
+
+    m_chunkCount = chunks.GetSize();
+
+    m_statistics.Ticks++;
+    m_statistics.TotalMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void BlockTicker::Dump(std::ostream &stream) const
+{
+    if (m_statistics.Ticks == 0)
+        return;
+
+    const auto ticks = static_cast<double>(m_statistics.Ticks);
+    const size_t sections = m_statistics.SectionsSampled + m_statistics.SectionsSkipped;
+
+    stream << "world ticks: " << m_statistics.Ticks << " ticks over " << m_chunkCount << " chunks, " << m_statistics.TotalMilliseconds / ticks
+           << " ms/tick, " << static_cast<double>(m_statistics.RandomTicks) / ticks << " random ticks/tick, "
+           << (sections == 0 ? 0.0 : 100.0 * static_cast<double>(m_statistics.SectionsSkipped) / static_cast<double>(sections))
+           << "% of sections skipped, " << m_statistics.Expired << " of " << m_statistics.Scheduled << " scheduled ticks delivered, "
+           << m_statistics.Dropped << " dropped, " << m_wheel.GetSize() << " pending\n";
+    stream.flush();
+}
+
+size_t BlockTicker::GetPendingCount() const noexcept
+{
+    return m_wheel.GetSize();
+}
+
+const TickStatistics &BlockTicker::GetStatistics() const noexcept
+{
+    return m_statistics;
+}
+
+void BlockTicker::TickScheduled(const ChunkView &chunks, std::vector<BlockTick> &scheduled)
+{
+    m_expired.clear();
+    m_wheel.Advance(m_expired);
+
+    for (const BlockTick &tick : m_expired)
+    {
+        const Chunk *chunk = tick.Y >= 0 && tick.Y < Chunk::HEIGHT ? chunks.Find(ChunkCoordinate(tick.X), ChunkCoordinate(tick.Z)) : nullptr;
+
+        if (chunk == nullptr || chunk->GetBlock(tick.X & 15, tick.Y, tick.Z & 15) != tick.Block)
+        {
+            m_statistics.Dropped++;
+            continue;
+        }
+
+        scheduled.push_back(tick);
+        m_statistics.Expired++;
+    }
+}
+
+void BlockTicker::TickRandom(const ChunkView &chunks, std::vector<BlockTick> &random)
+{
+    static_assert(RANDOM_TICKS_PER_SECTION * 12 <= 64, "the positions of a section come from one random number");
+
+    chunks.ForEach([this, &random](const Chunk &chunk) {
+        const int32_t baseX = chunk.GetX() * SIZE, baseZ = chunk.GetZ() * SIZE;
+
+        for (int s = 0; s < Chunk::SECTION_COUNT; s++)
+        {
+            const ChunkSection &section = chunk.GetSection(s);
+
+            if (section.GetTickableCount() == 0)
+            {
+                m_statistics.SectionsSkipped++;
+                continue;
+            }
+
+            m_statistics.SectionsSampled++;
+
+            // 12 bits are one position in the section
+            uint64_t bits = NextRandom();
+
+            for (uint32_t i = 0; i < RANDOM_TICKS_PER_SECTION; i++, bits >>= 12)
+            {
+                const auto index = static_cast<size_t>(bits & (ChunkSection::VOLUME - 1));
+                const BlockId block = section.Get(index);
+
+                if (!IsRandomlyTicked(block))
+                    continue;
+
+                random.push_back({baseX + static_cast<int32_t>(index & 15), s * SIZE + static_cast<int32_t>(index >> 8),
+                                  baseZ + static_cast<int32_t>(index >> 4 & 15), block});
+                m_statistics.RandomTicks++;
+            }
+        }
+    });
+}
+
+} // namespace MineClone
@@ -0,0 +1,91 @@
+#include <MineClone/World/Chunk.hpp>
+
+namespace MineClone
+{
+
+Chunk::Chunk(int32_t x, int32_t z) noexcept : m_x{x}, m_z{z}
+{
+}
+
+ChunkSection &Chunk::GetSection(int index) noexcept
+{
+    return m_sections[index];
+}
+
+const ChunkSection &Chunk::GetSection(int index) const noexcept
+{
+    return m_sections[index];
+}
+
+NibbleArray &Chunk::GetSkyLight(int section) noexcept
+{
+    return m_skyLight[section];
+}
+
+const NibbleArray &Chunk::GetSkyLight(int section) const noexcept
+{
+    return m_skyLight[section];
+}
+
+NibbleArray &Chunk::GetBlockLight(int section) noexcept
+{
+    return m_blockLight[section];
+}
+
+const NibbleArray &Chunk::GetBlockLight(int section) const noexcept
+{
+    return m_blockLight[section];
+}
+
+int32_t Chunk::GetX() const noexcept
+{
+    return m_x;
+}
+
+int32_t Chunk::GetZ() const noexcept
+{
+    return m_z;
+}
+
+void Chunk::Compact()
+{
+    for (ChunkSection &section : m_sections)
+        section.Compact();
+
+    for (int i = 0; i < SECTION_COUNT; i++)
+    {
+        m_skyLight[i].Compact();
+        m_blockLight[i].Compact();
+    }
+}
+
+void Chunk::Serialize(std::vector<uint8_t> &output) const
+{
+    for (const ChunkSection &section : m_sections)
+        section.Serialize(output);
+}
+
+bool Chunk::Deserialize(const uint8_t *data, size_t size)
+{
+    const uint8_t *end = data + size;
+
+    for (ChunkSection &section : m_sections)
+    {
+        if (!section.Deserialize(data, end))
+            return false;
+    }
+
+    return data == end;
+}
+
+size_t Chunk::GetMemoryUsage() const noexcept
+{
+    size_t usage = sizeof(Chunk) - sizeof(m_sections) - sizeof(m_skyLight) - sizeof(m_blockLight);
+
+    for (int i = 0; i < SECTION_COUNT; i++)
+        usage += m_sections[i].GetMemoryUsage() + m_skyLight[i].GetMemoryUsage() + m_blockLight[i].GetMemoryUsage();
+
+    return usage;
+}
+
+} // namespace MineClone
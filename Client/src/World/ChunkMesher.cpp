@@ -0,0 +1,304 @@
+#include <MineClone/World/ChunkMesher.hpp>
+
+#include <chrono>
+
+#include <MineClone/Utility.hpp>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr int SIZE = ChunkSection::SIZE;
+constexpr uint32_t FACE_BITS = 0xFFFF;
+constexpr uint32_t NEGATIVE_PADDING = 1u << 0;
+constexpr uint32_t POSITIVE_PADDING = 1u << (SIZE + 1);
+
+constexpr bool IsPositive(BlockFace face) noexcept
+{
+    return face == BlockFace::PositiveX || face == BlockFace::PositiveY || face == BlockFace::PositiveZ;
+}
+
+// planes are indexed as [slice][v] with u as the bit, this maps them back to section coordinates
+// X: u = z, v = y    Y: u = x, v = z    Z: u = x, v = y
+inline void PlaneToSection(BlockFace face, int slice, int u, int v, int &x, int &y, int &z) noexcept
+{
+    switch (face)
+    {
+    case BlockFace::PositiveX:
+    case BlockFace::NegativeX:
+        x = slice, y = v, z = u;
+        break;
+    case BlockFace::PositiveY:
+    case BlockFace::NegativeY:
+        x = u, y = slice, z = v;
+        break;
+    default:
+        x = u, y = v, z = slice;
+        break;
+    }
+}
+
+inline size_t PlaneIndex(BlockFace face, int slice, int u, int v) noexcept
+{
+    int x, y, z;
+    PlaneToSection(face, slice, u, v, x, y, z);
+    return ChunkSection::Index(x, y, z);
+}
+
+} // namespace
+
+void ChunkMesh::Clear() noexcept
+{
+    Quads.clear();
+    FaceCount = 0;
+}
+
+double MeshingStatistics::AverageMicroseconds() const noexcept
+{
+    return SectionCount == 0 ? 0.0 : TotalMilliseconds * 1000.0 / static_cast<double>(SectionCount);
+}
+
+void ChunkMesher::Mesh(const ChunkSection &section, const Neighbors &neighbors, ChunkMesh &mesh)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    mesh.Clear();
+
+    if (!section.IsEmpty())
+    {
+        BuildColumns(section, neighbors);
+
+        MeshAxis(BlockFace::PositiveX, BlockFace::NegativeX, m_columnsX, mesh);
+        MeshAxis(BlockFace::PositiveY, BlockFace::NegativeY, m_columnsY, mesh);
+        MeshAxis(BlockFace::PositiveZ, BlockFace::NegativeZ, m_columnsZ, mesh);
+    }
+
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    m_statistics.SectionCount++;
+    m_statistics.FaceCount += mesh.FaceCount;
+    m_statistics.QuadCount += mesh.Quads.size();
+    m_statistics.TotalMilliseconds += elapsed.count();
+}
+
+const MeshingStatistics &ChunkMesher::GetStatistics() const noexcept
+{
+    return m_statistics;
+}
+
+void ChunkMesher::ResetStatistics() noexcept
+{
+    m_statistics = {};
+}
+
+void ChunkMesher::BuildColumns(const ChunkSection &section, const Neighbors &neighbors)
+{
+    if (section.GetStorageMode() == ChunkSection::StorageMode::SingleValue)
+    {
+        const BlockId block = section.Get(0);
+        const uint32_t column = IsOpaque(block) ? FACE_BITS << 1 : 0;
+
+        m_blocks.fill(block);
+        m_columnsX.fill(column);
+        m_columnsY.fill(column);
+        m_columnsZ.fill(column);
+    }
+    else
+    {
+        m_columnsX.fill(0);
+        m_columnsY.fill(0);
+        m_columnsZ.fill(0);
+
+        for (size_t i = 0; i < ChunkSection::VOLUME; i++)
+        {
+            const BlockId block = section.Get(i);
+            m_blocks[i] = block;
+
+            if (!IsOpaque(block))
+                continue;
+
+            const size_t x = i & 15, z = (i >> 4) & 15, y = i >> 8;
+
+            m_columnsX[(y << 4) | z] |= 1u << (x + 1);
+            m_columnsY[(z << 4) | x] |= 1u << (y + 1);
+            m_columnsZ[(y << 4) | x] |= 1u << (z + 1);
+        }
+    }
+
+    // one layer of every neighbor pads the columns so faces against solid neighbors get culled
+    const auto padding = [&](BlockFace face, std::array<uint32_t, 256> &columns, uint32_t bit, auto index) {
+        const ChunkSection *neighbor = neighbors[static_cast<size_t>(face)];
+
+        if (neighbor == nullptr || neighbor->IsEmpty())
+            return;
+
+        for (int a = 0; a < SIZE; a++)
+        {
+            for (int b = 0; b < SIZE; b++)
+            {
+                if (IsOpaque(neighbor->Get(index(a, b))))
+                    columns[(a << 4) | b] |= bit;
+            }
+        }
+    };
+
+    padding(BlockFace::PositiveX, m_columnsX, POSITIVE_PADDING, [](int y, int z) { return ChunkSection::Index(0, y, z); });
+    padding(BlockFace::NegativeX, m_columnsX, NEGATIVE_PADDING, [](int y, int z) { return ChunkSection::Index(SIZE - 1, y, z); });
+    padding(BlockFace::PositiveY, m_columnsY, POSITIVE_PADDING, [](int z, int x) { return ChunkSection::Index(x, 0, z); });
+    padding(BlockFace::NegativeY, m_columnsY, NEGATIVE_PADDING, [](int z, int x) { return ChunkSection::Index(x, SIZE - 1, z); });
+    padding(BlockFace::PositiveZ, m_columnsZ, POSITIVE_PADDING, [](int y, int x) { return ChunkSection::Index(x, y, 0); });
+    padding(BlockFace::NegativeZ, m_columnsZ, NEGATIVE_PADDING, [](int y, int x) { return ChunkSection::Index(x, y, SIZE - 1); });
+}
+
+void ChunkMesher::MeshAxis(BlockFace positive, BlockFace negative, const std::array<uint32_t, 256> &columns, ChunkMesh &mesh)
+{
+    // a face is visible where a solid bit is followed by an empty one, this loop is branch free and vectorizes
+    std::array<uint32_t, 256> positiveFaces;
+    std::array<uint32_t, 256> negativeFaces;
+
+    for (size_t i = 0; i < columns.size(); i++)
+    {
+        const uint32_t column = columns[i];
+        positiveFaces[i] = ((column & ~(column >> 1)) >> 1) & FACE_BITS;
+        negativeFaces[i] = ((column & ~(column << 1)) >> 1) & FACE_BITS;
+    }
+
+    for (auto &plane : m_positivePlanes)
+        plane.fill(0);
+
+    for (auto &plane : m_negativePlanes)
+        plane.fill(0);
+
+    // transpose the columns into one plane per slice, column (a, b) lands in row a, bit b
+    for (size_t i = 0; i < columns.size(); i++)
+    {
+        const size_t row = i >> 4;
+        const auto bit = static_cast<uint16_t>(1u << (i & 15));
+
+        for (uint32_t faces = positiveFaces[i]; faces != 0; faces &= faces - 1)
+            m_positivePlanes[CountTrailingZeros(faces)][row] |= bit;
+
+        for (uint32_t faces = negativeFaces[i]; faces != 0; faces &= faces - 1)
+            m_negativePlanes[CountTrailingZeros(faces)][row] |= bit;
+
+        mesh.FaceCount += PopCount(positiveFaces[i]) + PopCount(negativeFaces[i]);
+    }
+
+    for (int slice = 0; slice < SIZE; slice++)
+    {
+        MergePlane(positive, slice, m_positivePlanes[slice], mesh);
+        MergePlane(negative, slice, m_negativePlanes[slice], mesh);
+    }
+}
+
+void ChunkMesher::MergePlane(BlockFace face, int slice, std::array<uint16_t, ChunkSection::SIZE> &rows, ChunkMesh &mesh)
+{
+    // faces only merge when their corners are shaded the same, so occlusion is part of the merge key
+    for (int v = 0; v < SIZE; v++)
+    {
+        for (uint32_t bits = rows[v]; bits != 0; bits &= bits - 1)
+        {
+            const int u = static_cast<int>(CountTrailingZeros(bits));
+            m_occlusion[(v << 4) | u] = ComputeOcclusion(face, slice, u, v);
+        }
+    }
+
+    const auto matches = [&](int u, int v, BlockId block, uint8_t occlusion) {
+        return m_blocks[PlaneIndex(face, slice, u, v)] == block && m_occlusion[(v << 4) | u] == occlusion;
+    };
+
+    for (int v = 0; v < SIZE; v++)
+    {
+        while (rows[v] != 0)
+        {
+            const int u = static_cast<int>(CountTrailingZeros(rows[v]));
+            const BlockId block = m_blocks[PlaneIndex(face, slice, u, v)];
+            const uint8_t occlusion = m_occlusion[(v << 4) | u];
+
+            // grow along u while the faces are set and look the same
+            int width = 1;
+            while (u + width < SIZE && (rows[v] >> (u + width) & 1) && matches(u + width, v, block, occlusion))
+                width++;
+
+            const auto run = static_cast<uint16_t>(((1u << width) - 1) << u);
+
+            // then along v while the whole run is present in the next row
+            int height = 1;
+            while (v + height < SIZE && (rows[v + height] & run) == run)
+            {
+                bool same = true;
+                for (int i = 0; i < width && same; i++)
+                    same = matches(u + i, v + height, block, occlusion);
+
+                if (!same)
+                    break;
+
+                height++;
+            }
+
+            for (int i = 0; i < height; i++)
+                rows[v + i] &= static_cast<uint16_t>(~run);
+
+            EmitQuad(face, slice, u, v, width, height, block, occlusion, mesh);
+        }
+    }
+}
+
+void ChunkMesher::EmitQuad(BlockFace face, int slice, int u, int v, int width, int height, BlockId block, uint8_t occlusion, ChunkMesh &mesh)
+{
+    int x, y, z;
+    PlaneToSection(face, IsPositive(face) ? slice + 1 : slice, u, v, x, y, z);
+
+    // one texture layer per block until block properties exist
+    mesh.Quads.push_back(ChunkQuad::Pack(x, y, z, face, width, height, block, occlusion));
+}
+
+bool ChunkMesher::IsOpaqueAt(int x, int y, int z) const noexcept
+{
+    const bool insideX = static_cast<unsigned>(x) < SIZE;
+    const bool insideY = static_cast<unsigned>(y) < SIZE;
+    const bool insideZ = static_cast<unsigned>(z) < SIZE;
+
+    // the padded columns reach one block into the face neighbors, edge and corner neighbors count as air
+    if (insideY && insideZ)
+        return m_columnsX[(y << 4) | z] >> (x + 1) & 1;
+
+    if (insideZ && insideX)
+        return m_columnsY[(z << 4) | x] >> (y + 1) & 1;
+
+    if (insideY && insideX)
+        return m_columnsZ[(y << 4) | x] >> (z + 1) & 1;
+
+    return false;
+}
+
+uint8_t ChunkMesher::ComputeOcclusion(BlockFace face, int slice, int u, int v) const noexcept
+{
+    // the blocks around the air block the face looks into
+    const int front = IsPositive(face) ? slice + 1 : slice - 1;
+
+    const auto opaque = [&](int du, int dv) {
+        int x, y, z;
+        PlaneToSection(face, front, u + du, v + dv, x, y, z);
+        return static_cast<int>(IsOpaqueAt(x, y, z));
+    };
+
+    static constexpr int CORNERS[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+
+    uint8_t occlusion = 0;
+    for (int corner = 0; corner < 4; corner++)
+    {
+        const int du = CORNERS[corner][0], dv = CORNERS[corner][1];
+        const int sideU = opaque(du, 0), sideV = opaque(0, dv);
+
+        // two solid sides hide the corner block completely
+        const int light = sideU && sideV ? 0 : 3 - sideU - sideV - opaque(du, dv);
+        occlusion |= static_cast<uint8_t>(light << (2 * corner));
+    }
+
+    return occlusion;
+}
+
+} // namespace MineClone
@@ -0,0 +1,424 @@
+#include <MineClone/World/ChunkSection.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr uint8_t MAX_PALETTE_BITS_LOG2 = 3;
+constexpr uint8_t DIRECT_BITS_LOG2 = 4;
+constexpr size_t MAX_PALETTE_SIZE = size_t{1} << (1u << MAX_PALETTE_BITS_LOG2);
+
+constexpr size_t WordCount(uint8_t bitsLog2) noexcept
+{
+    return (ChunkSection::VOLUME << bitsLog2) / 64;
+}
+
+constexpr size_t PaletteCapacity(uint8_t bitsLog2) noexcept
+{
+    return size_t{1} << (1u << bitsLog2);
+}
+
+// header, palette size, palette and entries of the widest palette
+static_assert(ChunkSection::MAX_SERIALIZED_SIZE >= 2 + 2 + MAX_PALETTE_SIZE * sizeof(BlockId) + WordCount(MAX_PALETTE_BITS_LOG2) * 8);
+static_assert(ChunkSection::MAX_SERIALIZED_SIZE == 2 + WordCount(DIRECT_BITS_LOG2) * 8);
+
+template <typename T>
+void Append(std::vector<uint8_t> &output, const T *values, size_t count)
+{
+    const size_t offset = output.size();
+    output.resize(offset + count * sizeof(T));
+    std::memcpy(output.data() + offset, values, count * sizeof(T));
+}
+
+template <typename T>
+bool Consume(const uint8_t *&data, const uint8_t *end, T *values, size_t count)
+{
+    if (static_cast<size_t>(end - data) < count * sizeof(T))
+        return false;
+
+    std::memcpy(values, data, count * sizeof(T));
+    data += count * sizeof(T);
+    return true;
+}
+
+} // namespace
+
+ChunkSection::ChunkSection(BlockId fill) noexcept
+{
+    Fill(fill);
+}
+
+void ChunkSection::Set(size_t index, BlockId block)
+{
+    const BlockId previous = Get(index);
+
+    if (previous == block)
+        return;
+
+    if (previous == Blocks::AIR)
+        ++m_nonAirCount;
+    else if (block == Blocks::AIR)
+        --m_nonAirCount;
+
+    m_tickableCount = static_cast<uint16_t>(m_tickableCount + IsRandomlyTicked(block) - IsRandomlyTicked(previous));
+
+    switch (m_mode)
+    {
+    case StorageMode::SingleValue:
+        // split into a one bit palette, every entry still points at the old value
+        m_mode = StorageMode::Palette;
+        m_bitsLog2 = 0;
+        m_palette = {m_singleValue, block};
+        m_paletteCounts = {static_cast<uint16_t>(VOLUME - 1), 1};
+        m_data = std::vector<uint64_t>(WordCount(m_bitsLog2), 0);
+        WriteEntry(index, 1);
+        break;
+
+    case StorageMode::Palette: {
+        // release the old entry first so its slot can be reused by the new block
+        --m_paletteCounts[ReadEntry(index)];
+
+        const uint32_t entry = GetOrAddPaletteEntry(block);
+
+        if (m_mode == StorageMode::Direct)
+        {
+            WriteEntry(index, block);
+            break;
+        }
+
+        WriteEntry(index, entry);
+
+        if (++m_paletteCounts[entry] == VOLUME)
+            Fill(block);
+
+        break;
+    }
+
+    case StorageMode::Direct:
+        WriteEntry(index, block);
+        break;
+    }
+}
+
+void ChunkSection::Fill(BlockId block) noexcept
+{
+    m_mode = StorageMode::SingleValue;
+    m_bitsLog2 = 0;
+    m_singleValue = block;
+    m_nonAirCount = block == Blocks::AIR ? 0 : static_cast<uint16_t>(VOLUME);
+    m_tickableCount = IsRandomlyTicked(block) ? static_cast<uint16_t>(VOLUME) : 0;
+    m_palette = std::vector<BlockId>{};
+    m_paletteCounts = std::vector<uint16_t>{};
+    m_data = std::vector<uint64_t>{};
+}
+
+void ChunkSection::Assign(const BlockId *blocks)
+{
+    m_nonAirCount = static_cast<uint16_t>(VOLUME - std::count(blocks, blocks + VOLUME, Blocks::AIR));
+    m_tickableCount = static_cast<uint16_t>(std::count_if(blocks, blocks + VOLUME, IsRandomlyTicked));
+
+    BuildPalette(blocks);
+}
+
+void ChunkSection::Compact()
+{
+    if (m_mode == StorageMode::SingleValue)
+        return;
+
+    std::vector<BlockId> blocks(VOLUME);
+    for (size_t i = 0; i < VOLUME; i++)
+        blocks[i] = Get(i);
+
+    BuildPalette(blocks.data());
+}
+
+void ChunkSection::Serialize(std::vector<uint8_t> &output) const
+{
+    const uint8_t header[2] = {static_cast<uint8_t>(m_mode), m_bitsLog2};
+    Append(output, header, 2);
+
+    switch (m_mode)
+    {
+    case StorageMode::SingleValue:
+        Append(output, &m_singleValue, 1);
+        break;
+
+    case StorageMode::Palette: {
+        const auto paletteSize = static_cast<uint16_t>(m_palette.size());
+        Append(output, &paletteSize, 1);
+        Append(output, m_palette.data(), m_palette.size());
+        Append(output, m_data.data(), m_data.size());
+        break;
+    }
+
+    case StorageMode::Direct:
+        Append(output, m_data.data(), m_data.size());
+        break;
+    }
+}
+
+bool ChunkSection::Deserialize(const uint8_t *&data, const uint8_t *end)
+{
+    uint8_t header[2];
+    if (!Consume(data, end, header, 2) || header[0] > static_cast<uint8_t>(StorageMode::Direct))
+        return false;
+
+    const auto mode = static_cast<StorageMode>(header[0]);
+    const uint8_t bitsLog2 = header[1];
+
+    if (mode == StorageMode::SingleValue)
+    {
+        BlockId block;
+        if (!Consume(data, end, &block, 1))
+            return false;
+
+        Fill(block);
+        return true;
+    }
+
+    if (mode == StorageMode::Palette)
+    {
+        uint16_t paletteSize;
+        if (bitsLog2 > MAX_PALETTE_BITS_LOG2 || !Consume(data, end, &paletteSize, 1) || paletteSize > PaletteCapacity(bitsLog2))
+            return false;
+
+        m_palette.resize(paletteSize);
+        if (!Consume(data, end, m_palette.data(), paletteSize))
+            return false;
+    }
+    else if (bitsLog2 != DIRECT_BITS_LOG2)
+    {
+        return false;
+    }
+
+    m_mode = mode;
+    m_bitsLog2 = bitsLog2;
+    m_data.resize(WordCount(bitsLog2));
+
+    if (!Consume(data, end, m_data.data(), m_data.size()))
+        return false;
+
+    // the counts aren't stored, they follow from the entries
+    m_nonAirCount = 0;
+    m_tickableCount = 0;
+
+    if (mode == StorageMode::Direct)
+    {
+        m_palette = std::vector<BlockId>{};
+        m_paletteCounts = std::vector<uint16_t>{};
+
+        for (size_t i = 0; i < VOLUME; i++)
+        {
+            const auto block = static_cast<BlockId>(ReadEntry(i));
+            m_nonAirCount += block != Blocks::AIR;
+            m_tickableCount += IsRandomlyTicked(block);
+        }
+
+        return true;
+    }
+
+    m_paletteCounts.assign(m_palette.size(), 0);
+
+    for (size_t i = 0; i < VOLUME; i++)
+    {
+        const uint32_t entry = ReadEntry(i);
+        if (entry >= m_palette.size())
+            return false;
+
+        ++m_paletteCounts[entry];
+    }
+
+    for (size_t entry = 0; entry < m_palette.size(); entry++)
+    {
+        if (m_palette[entry] != Blocks::AIR)
+            m_nonAirCount += m_paletteCounts[entry];
+
+        if (IsRandomlyTicked(m_palette[entry]))
+            m_tickableCount += m_paletteCounts[entry];
+    }
+
+    return true;
+}
+
+ChunkSection::StorageMode ChunkSection::GetStorageMode() const noexcept
+{
+    return m_mode;
+}
+
+unsigned ChunkSection::GetBitsPerEntry() const noexcept
+{
+    return m_mode == StorageMode::SingleValue ? 0 : 1u << m_bitsLog2;
+}
+
+size_t ChunkSection::GetPaletteSize() const noexcept
+{
+    switch (m_mode)
+    {
+    case StorageMode::SingleValue:
+        return 1;
+    case StorageMode::Palette:
+        return m_palette.size();
+    default:
+        return 0;
+    }
+}
+
+size_t ChunkSection::GetNonAirCount() const noexcept
+{
+    return m_nonAirCount;
+}
+
+bool ChunkSection::IsEmpty() const noexcept
+{
+    return m_nonAirCount == 0;
+}
+
+size_t ChunkSection::GetTickableCount() const noexcept
+{
+    return m_tickableCount;
+}
+
+size_t ChunkSection::GetMemoryUsage() const noexcept
+{
+    return sizeof(ChunkSection) + m_palette.capacity() * sizeof(BlockId) + m_paletteCounts.capacity() * sizeof(uint16_t) +
+           m_data.capacity() * sizeof(uint64_t);
+}
+
+void ChunkSection::WriteEntry(size_t index, uint32_t value) noexcept
+{
+    const unsigned entriesPerWordLog2 = 6 - m_bitsLog2;
+    const size_t word = index >> entriesPerWordLog2;
+    const unsigned shift = static_cast<unsigned>(index & ((size_t{1} << entriesPerWordLog2) - 1)) << m_bitsLog2;
+    const uint64_t mask = (uint64_t{1} << (1u << m_bitsLog2)) - 1;
+
+    m_data[word] = (m_data[word] & ~(mask << shift)) | (static_cast<uint64_t>(value) << shift);
+}
+
+uint32_t ChunkSection::GetOrAddPaletteEntry(BlockId block)
+{
+    size_t freeEntry = m_palette.size();
+
+    for (size_t i = 0; i < m_palette.size(); i++)
+    {
+        if (m_palette[i] == block)
+            return static_cast<uint32_t>(i);
+
+        if (m_paletteCounts[i] == 0 && freeEntry == m_palette.size())
+            freeEntry = i;
+    }
+
+    // reuse an entry whose blocks have all been overwritten before growing
+    if (freeEntry != m_palette.size())
+    {
+        m_palette[freeEntry] = block;
+        return static_cast<uint32_t>(freeEntry);
+    }
+
+    if (m_palette.size() == PaletteCapacity(m_bitsLog2))
+    {
+        if (m_bitsLog2 == MAX_PALETTE_BITS_LOG2)
+        {
+            ConvertToDirect();
+            return block;
+        }
+
+        Repack(m_bitsLog2 + 1);
+    }
+
+    m_palette.push_back(block);
+    m_paletteCounts.push_back(0);
+    return static_cast<uint32_t>(m_palette.size() - 1);
+}
+
+void ChunkSection::Repack(uint8_t bitsLog2)
+{
+    std::vector<uint32_t> entries(VOLUME);
+    for (size_t i = 0; i < VOLUME; i++)
+        entries[i] = ReadEntry(i);
+
+    m_bitsLog2 = bitsLog2;
+    m_data = std::vector<uint64_t>(WordCount(m_bitsLog2), 0);
+
+    for (size_t i = 0; i < VOLUME; i++)
+        WriteEntry(i, entries[i]);
+}
+
+void ChunkSection::ConvertToDirect()
+{
+    std::vector<BlockId> blocks(VOLUME);
+    for (size_t i = 0; i < VOLUME; i++)
+        blocks[i] = m_palette[ReadEntry(i)];
+
+    StoreDirect(blocks.data());
+}
+
+void ChunkSection::StoreDirect(const BlockId *blocks)
+{
+    m_mode = StorageMode::Direct;
+    m_bitsLog2 = DIRECT_BITS_LOG2;
+    m_palette = std::vector<BlockId>{};
+    m_paletteCounts = std::vector<uint16_t>{};
+    m_data = std::vector<uint64_t>(WordCount(m_bitsLog2), 0);
+
+    for (size_t i = 0; i < VOLUME; i++)
+        WriteEntry(i, blocks[i]);
+}
+
+void ChunkSection::BuildPalette(const BlockId *blocks)
+{
+    // neighbouring blocks are usually the same, so remembering the last one skips most of the palette lookups
+    std::vector<BlockId> distinct{blocks[0]};
+    BlockId last = blocks[0];
+
+    for (size_t i = 1; i < VOLUME && distinct.size() <= MAX_PALETTE_SIZE; i++)
+    {
+        if (blocks[i] == last)
+            continue;
+
+        last = blocks[i];
+
+        if (std::find(distinct.begin(), distinct.end(), last) == distinct.end())
+            distinct.push_back(last);
+    }
+
+    std::sort(distinct.begin(), distinct.end());
+
+    if (distinct.size() == 1)
+    {
+        Fill(distinct[0]);
+        return;
+    }
+
+    if (distinct.size() > MAX_PALETTE_SIZE)
+    {
+        StoreDirect(blocks);
+        return;
+    }
+
+    uint8_t bitsLog2 = 0;
+    while (PaletteCapacity(bitsLog2) < distinct.size())
+        bitsLog2++;
+
+    m_mode = StorageMode::Palette;
+    m_bitsLog2 = bitsLog2;
+    m_palette = distinct;
+    m_paletteCounts.assign(distinct.size(), 0);
+    m_data = std::vector<uint64_t>(WordCount(m_bitsLog2), 0);
+
+    uint32_t entry = 0;
+    for (size_t i = 0; i < VOLUME; i++)
+    {
+        if (i == 0 || blocks[i] != blocks[i - 1])
+            entry = static_cast<uint32_t>(std::lower_bound(distinct.begin(), distinct.end(), blocks[i]) - distinct.begin());
+
+        WriteEntry(i, entry);
+        ++m_paletteCounts[entry];
+    }
+}
+
+} // namespace MineClone
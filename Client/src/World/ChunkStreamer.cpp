@@ -0,0 +1,499 @@
+#include <MineClone/World/ChunkStreamer.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <iterator>
+
+namespace MineClone
+{
+
+namespace
+{
+
+// a chunk straight behind the camera is scheduled as if it were this many times further away
+constexpr float BEHIND_WEIGHT = 2.0f;
+
+inline uint64_t Key(int32_t x, int32_t z) noexcept
+{
+    return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(z);
+}
+
+inline int32_t ChunkCoordinate(float block) noexcept
+{
+    return static_cast<int32_t>(std::floor(block / static_cast<float>(ChunkSection::SIZE)));
+}
+
+inline bool InRange(int32_t dx, int32_t dz, int radius) noexcept
+{
+    return dx * dx + dz * dz <= radius * radius;
+}
+
+} // namespace
+
+ChunkStreamer::~ChunkStreamer()
+{
+    Destroy();
+}
+
+void ChunkStreamer::Create(JobSystem *jobSystem, const StreamingOptions &options)
+{
+    m_jobSystem = jobSystem;
+    m_options = options;
+
+    if (m_options.MaxJobs == 0)
+        m_options.MaxJobs = 2 * m_jobSystem->GetWorkerCount();
+
+    m_persistent = !m_options.WorldDirectory.empty();
+
+    if (m_persistent)
+        m_storage.Open(m_options.WorldDirectory);
+
+    m_saveGroup = std::make_shared<JobGroup>();
+}
+
+void ChunkStreamer::Destroy()
+{
+    if (m_jobSystem == nullptr)
+        return;
+
+    for (auto &[key, entry] : m_chunks)
+    {
+        if (entry.Group != nullptr)
+            entry.Group->Cancel();
+    }
+
+    // running jobs still finish, and they reference the generator and the storage
+    for (auto &[key, entry] : m_chunks)
+    {
+        if (entry.Group != nullptr)
+            m_jobSystem->Wait(*entry.Group);
+    }
+
+    for (const std::shared_ptr<JobGroup> &group : m_cancelled)
+        m_jobSystem->Wait(*group);
+
+    m_jobSystem->Wait(*m_saveGroup);
+
+    if (m_persistent)
+    {
+        std::vector<const Chunk *> chunks;
+
+        for (const auto &[key, entry] : m_chunks)
+        {
+            if (entry.Generated)
+                chunks.push_back(entry.Data.get());
+        }
+
+        // left over when a background save failed, unless the position is resident with a newer copy
+        for (const auto &[key, chunk] : m_unsaved)
+        {
+            if (const ChunkEntry *entry = Find(chunk->GetX(), chunk->GetZ()); entry == nullptr || !entry->Generated)
+                chunks.push_back(chunk.get());
+        }
+
+        for (const Chunk *chunk : chunks)
+        {
+            if (!m_storage.Save(*chunk))
+                break;
+        }
+
+        if (!m_storage.Flush())
+            std::cerr << "streaming: failed to save the world to " << m_options.WorldDirectory << std::endl;
+
+        m_storage.Close();
+    }
+
+    m_chunks.clear();
+    m_cancelled.clear();
+    m_unsaved.clear();
+    m_completions.clear();
+    m_processing.clear();
+    m_candidates.clear();
+    m_jobsInFlight = 0;
+    m_hasCenter = false;
+    m_persistent = false;
+    m_saveGroup.reset();
+    m_statistics = {};
+    m_jobSystem = nullptr;
+}
+
+void ChunkStreamer::Update(float x, float z, float directionX, float directionZ, std::vector<StreamedSection> &meshed,
+                           std::vector<ChunkPosition> &evicted)
+{
+    ProcessCompletions(meshed);
+
+    const int32_t centerX = ChunkCoordinate(x);
+    const int32_t centerZ = ChunkCoordinate(z);
+
+    // the set of chunks only changes when the camera crosses into another chunk
+    if (!m_hasCenter || centerX != m_centerX || centerZ != m_centerZ)
+    {
+        m_centerX = centerX;
+        m_centerZ = centerZ;
+        m_hasCenter = true;
+
+        Evict(evicted);
+        Request();
+    }
+
+    Schedule(directionX, directionZ);
+}
+
+void ChunkStreamer::ProcessCompletions(std::vector<StreamedSection> &meshed)
+{
+    {
+        const std::lock_guard lock{m_completionMutex};
+        std::swap(m_completions, m_processing);
+    }
+
+    for (Completion &completion : m_processing)
+    {
+        const auto found = m_chunks.find(completion.Key);
+
+        if (found == m_chunks.end() || found->second.Ticket != completion.Ticket)
+        {
+            m_statistics.Discarded++;
+            continue;
+        }
+
+        ChunkEntry &entry = found->second;
+        entry.Group.reset();
+        m_jobsInFlight--;
+
+        if (entry.State == ChunkState::Loading)
+        {
+            entry.Data = std::move(completion.Data);
+            entry.Generated = completion.Generated;
+            entry.State = ChunkState::Loaded;
+
+            if (entry.Generated)
+                m_statistics.Generated++;
+            else
+                m_statistics.Loaded++;
+        }
+        else
+        {
+            std::move(completion.Sections.begin(), completion.Sections.end(), std::back_inserter(meshed));
+            entry.State = ChunkState::Meshed;
+            m_statistics.Meshed++;
+        }
+    }
+
+    m_processing.clear();
+}
+
+void ChunkStreamer::Evict(std::vector<ChunkPosition> &evicted)
+{
+    const int evictRadius = m_options.Radius + 1 + m_options.Hysteresis;
+    std::vector<uint64_t> unsaved;
+
+    m_cancelled.erase(std::remove_if(m_cancelled.begin(), m_cancelled.end(),
+                                     [](const std::shared_ptr<JobGroup> &group) {
+                                         return group->IsIdle();
+                                     }),
+                      m_cancelled.end());
+
+    for (auto entry = m_chunks.begin(); entry != m_chunks.end();)
+    {
+        ChunkEntry &chunk = entry->second;
+
+        if (InRange(chunk.X - m_centerX, chunk.Z - m_centerZ, evictRadius))
+        {
+            ++entry;
+            continue;
+        }
+
+        // jobs that haven't started are skipped, running ones finish and their results are dropped by the ticket
+        if (chunk.Group != nullptr)
+        {
+            chunk.Group->Cancel();
+            m_cancelled.push_back(std::move(chunk.Group));
+            m_jobsInFlight--;
+        }
+
+        if (chunk.State == ChunkState::Meshed)
+            evicted.push_back({chunk.X, chunk.Z});
+
+        if (chunk.Data != nullptr)
+            m_statistics.Evicted++;
+
+        if (m_persistent && chunk.Generated)
+        {
+            const std::lock_guard lock{m_unsavedMutex};
+            m_unsaved[entry->first] = std::move(chunk.Data);
+            unsaved.push_back(entry->first);
+        }
+
+        entry = m_chunks.erase(entry);
+    }
+
+    if (unsaved.empty())
+        return;
+
+    // One job per batch, so the flush covers all of them. Each position saves whatever was evicted last, a chunk that was
+    // reloaded and evicted again in the meantime is already newer than when this batch was scheduled.
+    m_jobSystem->Schedule(
+        [this, unsaved = std::move(unsaved)] {
+            const std::lock_guard saveLock{m_saveMutex};
+
+            for (const uint64_t key : unsaved)
+            {
+                std::shared_ptr<const Chunk> chunk;
+                {
+                    const std::lock_guard lock{m_unsavedMutex};
+                    const auto found = m_unsaved.find(key);
+
+                    // written by a later batch
+                    if (found == m_unsaved.end())
+                        continue;
+
+                    chunk = found->second;
+                }
+
+                if (!m_storage.Save(*chunk))
+                    return;
+
+                // a newer eviction stays until its own save
+                const std::lock_guard lock{m_unsavedMutex};
+                if (const auto found = m_unsaved.find(key); found != m_unsaved.end() && found->second == chunk)
+                    m_unsaved.erase(found);
+            }
+
+            if (!m_storage.Flush())
+                std::cerr << "streaming: failed to flush " << m_options.WorldDirectory << std::endl;
+        },
+        JobPriority::Low, m_saveGroup);
+}
+
+void ChunkStreamer::Request()
+{
+    // one ring past the meshed radius, those chunks are the neighbors of the outermost meshes
+    const int loadRadius = m_options.Radius + 1;
+
+    for (int32_t dz = -loadRadius; dz <= loadRadius; dz++)
+    {
+        for (int32_t dx = -loadRadius; dx <= loadRadius; dx++)
+        {
+            if (!InRange(dx, dz, loadRadius))
+                continue;
+
+            const int32_t x = m_centerX + dx, z = m_centerZ + dz;
+            m_chunks.try_emplace(Key(x, z), ChunkEntry{x, z});
+        }
+    }
+}
+
+void ChunkStreamer::Schedule(float directionX, float directionZ)
+{
+    if (m_jobsInFlight >= m_options.MaxJobs)
+        return;
+
+    const float length = std::sqrt(directionX * directionX + directionZ * directionZ);
+
+    if (length > 1e-3f)
+    {
+        directionX /= length;
+        directionZ /= length;
+    }
+    else
+    {
+        directionX = directionZ = 0.0f;
+    }
+
+    const int loadRadius = m_options.Radius + 1;
+    m_candidates.clear();
+
+    for (auto &[key, entry] : m_chunks)
+    {
+        const int32_t dx = entry.X - m_centerX, dz = entry.Z - m_centerZ;
+
+        // the outer ring is only loaded, as neighbors; chunks in the hysteresis band keep what they have but get no new work
+        const bool load = entry.State == ChunkState::Missing && InRange(dx, dz, loadRadius);
+        const bool mesh = entry.State == ChunkState::Loaded && InRange(dx, dz, m_options.Radius) && HasNeighbors(entry);
+
+        if (!load && !mesh)
+            continue;
+
+        const auto distance = std::sqrt(static_cast<float>(dx * dx + dz * dz));
+        const float facing = distance > 0.0f ? (static_cast<float>(dx) * directionX + static_cast<float>(dz) * directionZ) / distance : 1.0f;
+
+        // 1 straight ahead up to BEHIND_WEIGHT straight behind
+        const float weight = 1.0f + (BEHIND_WEIGHT - 1.0f) * 0.5f * (1.0f - facing);
+        m_candidates.push_back({distance * weight, &entry});
+    }
+
+    const size_t count = std::min(m_candidates.size(), m_options.MaxJobs - m_jobsInFlight);
+
+    std::partial_sort(m_candidates.begin(), m_candidates.begin() + static_cast<std::ptrdiff_t>(count), m_candidates.end(),
+                      [](const Candidate &a, const Candidate &b) {
+                          return a.Priority < b.Priority;
+                      });
+
+    for (size_t i = 0; i < count; i++)
+    {
+        ChunkEntry &entry = *m_candidates[i].Entry;
+
+        if (entry.State == ChunkState::Missing)
+            ScheduleLoad(entry);
+        else
+            ScheduleMesh(entry);
+    }
+}
+
+void ChunkStreamer::ScheduleLoad(ChunkEntry &entry)
+{
+    entry.State = ChunkState::Loading;
+    entry.Group = std::make_shared<JobGroup>();
+    entry.Ticket = m_nextTicket++;
+    m_jobsInFlight++;
+
+    m_jobSystem->Schedule(
+        [this, key = Key(entry.X, entry.Z), ticket = entry.Ticket, x = entry.X, z = entry.Z, group = entry.Group] {
+            // evicted but not written yet, still counts as generated so it gets saved on the next eviction
+            std::shared_ptr<const Chunk> unsaved;
+            {
+                const std::lock_guard lock{m_unsavedMutex};
+                if (const auto found = m_unsaved.find(key); found != m_unsaved.end())
+                    unsaved = found->second;
+            }
+
+            if (unsaved != nullptr)
+            {
+                Complete({key, ticket, std::move(unsaved), true, {}});
+                return;
+            }
+
+            auto chunk = std::make_shared<Chunk>(x, z);
+            const bool loaded = m_persistent && m_storage.Load(*chunk);
+
+            // generating is the expensive part, skip it when the chunk was evicted in the meantime
+            if (!loaded)
+            {
+                if (group->IsCancelled())
+                    return;
+
+                m_generator.Generate(*chunk);
+            }
+
+            chunk->Compact();
+            Complete({key, ticket, std::move(chunk), !loaded, {}});
+        },
+        JobPriority::Normal, entry.Group);
+}
+
+void ChunkStreamer::ScheduleMesh(ChunkEntry &entry)
+{
+    entry.State = ChunkState::Meshing;
+    entry.Group = std::make_shared<JobGroup>();
+    entry.Ticket = m_nextTicket++;
+    m_jobsInFlight++;
+
+    // the job keeps its chunks alive, they may be evicted while it runs
+    const std::array<std::shared_ptr<const Chunk>, 5> chunks = {entry.Data, Find(entry.X + 1, entry.Z)->Data, Find(entry.X - 1, entry.Z)->Data,
+                                                                Find(entry.X, entry.Z + 1)->Data, Find(entry.X, entry.Z - 1)->Data};
+
+    m_jobSystem->Schedule(
+        [this, key = Key(entry.X, entry.Z), ticket = entry.Ticket, chunks] {
+            const Chunk &chunk = *chunks[0];
+            Completion completion{key, ticket, nullptr, false, {}};
+            completion.Sections.reserve(Chunk::SECTION_COUNT);
+
+            ChunkMesher mesher;
+
+            for (int y = 0; y < Chunk::SECTION_COUNT; y++)
+            {
+                const ChunkSection &section = chunk.GetSection(y);
+                const ChunkMesher::Neighbors neighbors = {&chunks[1]->GetSection(y),
+                                                          &chunks[2]->GetSection(y),
+                                                          y + 1 < Chunk::SECTION_COUNT ? &chunk.GetSection(y + 1) : nullptr,
+                                                          y > 0 ? &chunk.GetSection(y - 1) : nullptr,
+                                                          &chunks[3]->GetSection(y),
+                                                          &chunks[4]->GetSection(y)};
+
+                // empty sections still carry connectivity, the visibility search walks through them
+                StreamedSection streamed{chunk.GetX(), y, chunk.GetZ(), {}, SectionConnectivity::Compute(section)};
+                mesher.Mesh(section, neighbors, streamed.Mesh);
+                completion.Sections.push_back(std::move(streamed));
+            }
+
+            Complete(std::move(completion));
+        },
+        JobPriority::Normal, entry.Group);
+}
+
+void ChunkStreamer::Complete(Completion completion)
+{
+    const std::lock_guard lock{m_completionMutex};
+    m_completions.push_back(std::move(completion));
+}
+
+const ChunkStreamer::ChunkEntry *ChunkStreamer::Find(int32_t x, int32_t z) const
+{
+    const auto found = m_chunks.find(Key(x, z));
+    return found == m_chunks.end() ? nullptr : &found->second;
+}
+
+bool ChunkStreamer::HasNeighbors(const ChunkEntry &entry) const
+{
+    constexpr int32_t OFFSETS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+    for (const auto &offset : OFFSETS)
+    {
+        const ChunkEntry *neighbor = Find(entry.X + offset[0], entry.Z + offset[1]);
+
+        if (neighbor == nullptr || neighbor->Data == nullptr)
+            return false;
+    }
+
+    return true;
+}
+
+std::shared_ptr<const Chunk> ChunkStreamer::GetChunk(int32_t x, int32_t z) const
+{
+    const ChunkEntry *entry = Find(x, z);
+    return entry == nullptr ? nullptr : entry->Data;
+}
+
+bool ChunkStreamer::IsAreaMeshed(int radius) const
+{
+    for (int32_t dz = -radius; dz <= radius; dz++)
+    {
+        for (int32_t dx = -radius; dx <= radius; dx++)
+        {
+            if (!InRange(dx, dz, radius))
+                continue;
+
+            const ChunkEntry *entry = Find(m_centerX + dx, m_centerZ + dz);
+
+            if (entry == nullptr || entry->State != ChunkState::Meshed)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void ChunkStreamer::Dump(std::ostream &stream) const
+{
+    stream << "streaming: " << m_statistics.Loaded << " chunks loaded, " << m_statistics.Generated << " generated, " << m_statistics.Meshed
+           << " meshed, " << m_statistics.Evicted << " evicted, " << m_statistics.Discarded << " results discarded (radius " << m_options.Radius
+           << ", " << m_options.MaxJobs << " jobs in flight)\n";
+
+    if (m_persistent)
+    {
+        const StorageStatistics storage = m_storage.GetStatistics();
+        stream << "  storage: " << storage.Saves << " chunks saved, " << storage.RawBytes << " bytes compressed to " << storage.CompressedBytes
+               << "\n";
+    }
+
+    stream.flush();
+}
+
+const StreamingStatistics &ChunkStreamer::GetStatistics() const noexcept
+{
+    return m_statistics;
+}
+
+} // namespace MineClone
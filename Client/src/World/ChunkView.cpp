@@ -0,0 +1,40 @@
+#include <MineClone/World/ChunkView.hpp>
+
+#include <utility>
+
+namespace MineClone
+{
+
+namespace
+{
+
+inline uint64_t Key(int32_t x, int32_t z) noexcept
+{
+    return static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32 | static_cast<uint32_t>(z);
+}
+
+} // namespace
+
+void ChunkView::Add(std::shared_ptr<const Chunk> chunk)
+{
+    const uint64_t key = Key(chunk->GetX(), chunk->GetZ());
+    m_chunks[key] = std::move(chunk);
+}
+
+void ChunkView::Remove(int32_t x, int32_t z)
+{
+    m_chunks.erase(Key(x, z));
+}
+
+const Chunk *ChunkView::Find(int32_t x, int32_t z) const
+{
+    const auto found = m_chunks.find(Key(x, z));
+    return found == m_chunks.end() ? nullptr : found->second.get();
+}
+
+size_t ChunkView::GetSize() const noexcept
+{
+    return m_chunks.size();
+}
+
+} // namespace MineClone
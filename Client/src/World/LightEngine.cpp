@@ -0,0 +1,397 @@
+#include <MineClone/World/LightEngine.hpp>
+
+#include <algorithm>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr int SIZE = ChunkSection::SIZE;
+constexpr uint8_t MAX_LEVEL = 15;
+
+struct Offset
+{
+    int X, Y, Z;
+}; // struct Offset
+
+// in BlockFace order
+constexpr std::array<Offset, BLOCK_FACE_COUNT> OFFSETS = {{{1, 0, 0}, {-1, 0, 0}, {0, 1, 0}, {0, -1, 0}, {0, 0, 1}, {0, 0, -1}}};
+constexpr size_t DOWN = static_cast<size_t>(BlockFace::NegativeY);
+
+// x and z relative to the center, nullptr outside of the neighborhood or for missing neighbors
+inline Chunk *ChunkAt(const LightEngine::Neighborhood &chunks, int x, int z) noexcept
+{
+    if (x < -SIZE || x >= 2 * SIZE || z < -SIZE || z >= 2 * SIZE)
+        return nullptr;
+
+    return chunks[(z + SIZE) / SIZE][(x + SIZE) / SIZE];
+}
+
+inline uint8_t GetLight(const Chunk &chunk, LightChannel channel, int x, int y, int z) noexcept
+{
+    return channel == LightChannel::Sky ? chunk.GetSkyLight(x & 15, y, z & 15) : chunk.GetBlockLight(x & 15, y, z & 15);
+}
+
+inline void SetLight(Chunk &chunk, LightChannel channel, int x, int y, int z, uint8_t level)
+{
+    if (channel == LightChannel::Sky)
+        chunk.SetSkyLight(x & 15, y, z & 15, level);
+    else
+        chunk.SetBlockLight(x & 15, y, z & 15, level);
+}
+
+inline NibbleArray &GetLightSection(Chunk &chunk, LightChannel channel, int section) noexcept
+{
+    return channel == LightChannel::Sky ? chunk.GetSkyLight(section) : chunk.GetBlockLight(section);
+}
+
+// the lowest y the sky reaches in a column, 0 when nothing blocks it
+int ColumnHeight(const Chunk &chunk, int x, int z) noexcept
+{
+    for (int s = Chunk::SECTION_COUNT - 1; s >= 0; s--)
+    {
+        const ChunkSection &section = chunk.GetSection(s);
+        if (section.IsEmpty())
+            continue;
+
+        for (int y = SIZE - 1; y >= 0; y--)
+        {
+            if (IsOpaque(section.Get(x, y, z)))
+                return s * SIZE + y + 1;
+        }
+    }
+
+    return 0;
+}
+
+} // namespace
+
+void LightEngine::LightChunk(const Neighborhood &chunks)
+{
+    Chunk &center = *chunks[1][1];
+
+    for (int s = 0; s < Chunk::SECTION_COUNT; s++)
+    {
+        center.GetSkyLight(s).Fill(0);
+        center.GetBlockLight(s).Fill(0);
+    }
+
+    m_addQueue.clear();
+    SeedSkyLight(chunks);
+    SeedBorders(chunks, LightChannel::Sky);
+    PropagateAddition(chunks, LightChannel::Sky);
+
+    SeedBlockLight(chunks);
+    SeedBorders(chunks, LightChannel::Block);
+    PropagateAddition(chunks, LightChannel::Block);
+
+    // sections that ended up dark or fully lit don't need their arrays
+    for (int s = 0; s < Chunk::SECTION_COUNT; s++)
+    {
+        center.GetSkyLight(s).Compact();
+        center.GetBlockLight(s).Compact();
+    }
+
+    m_statistics.LitChunks++;
+}
+
+void LightEngine::Update(const Neighborhood &chunks, const LightChange *changes, size_t count)
+{
+    Chunk &center = *chunks[1][1];
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const LightChange &change = changes[i];
+        ASSERT(change.X >= 0 && change.X < SIZE && change.Z >= 0 && change.Z < SIZE && change.Y >= 0 && change.Y < Chunk::HEIGHT,
+               "light change outside of the center chunk");
+    }
+
+    for (const LightChannel channel : {LightChannel::Sky, LightChannel::Block})
+    {
+        m_removeQueue.clear();
+        m_addQueue.clear();
+
+        // whatever was lit through the changed blocks goes dark first, the border of that area is queued to come back
+        for (size_t i = 0; i < count; i++)
+        {
+            const LightChange &change = changes[i];
+            const uint8_t level = GetLight(center, channel, change.X, change.Y, change.Z);
+
+            if (level != 0)
+            {
+                SetLight(center, channel, change.X, change.Y, change.Z, 0);
+                m_removeQueue.push_back(Node::Pack(change.X, change.Y, change.Z, level));
+            }
+        }
+
+        PropagateRemoval(chunks, channel);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const LightChange &change = changes[i];
+            const BlockId block = center.GetBlock(change.X, change.Y, change.Z);
+
+            if (channel == LightChannel::Block)
+            {
+                const uint8_t emission = GetLightEmission(block);
+
+                if (emission > GetLight(center, channel, change.X, change.Y, change.Z))
+                {
+                    SetLight(center, channel, change.X, change.Y, change.Z, emission);
+                    m_addQueue.push_back(Node::Pack(change.X, change.Y, change.Z, emission));
+                }
+            }
+
+            // light flows in from every side of a block that opened up
+            if (!IsOpaque(block))
+                SeedNeighbors(chunks, channel, change.X, change.Y, change.Z);
+        }
+
+        PropagateAddition(chunks, channel);
+    }
+
+    m_statistics.Changes += count;
+}
+
+const LightStatistics &LightEngine::GetStatistics() const noexcept
+{
+    return m_statistics;
+}
+
+void LightEngine::ResetStatistics() noexcept
+{
+    m_statistics = {};
+}
+
+void LightEngine::SeedSkyLight(const Neighborhood &chunks)
+{
+    Chunk &center = *chunks[1][1];
+
+    std::array<int, SIZE * SIZE> heights;
+    for (int z = 0; z < SIZE; z++)
+    {
+        for (int x = 0; x < SIZE; x++)
+            heights[z * SIZE + x] = ColumnHeight(center, x, z);
+    }
+
+    // sections above every column are lit everywhere and need no storage, only the ones below are set block by block
+    const int highest = *std::max_element(heights.begin(), heights.end());
+    const int firstUniform = (highest + SIZE - 1) / SIZE;
+
+    for (int s = firstUniform; s < Chunk::SECTION_COUNT; s++)
+        center.GetSkyLight(s).Fill(MAX_LEVEL);
+
+    for (int z = 0; z < SIZE; z++)
+    {
+        for (int x = 0; x < SIZE; x++)
+        {
+            const int height = heights[z * SIZE + x];
+
+            for (int y = height; y < firstUniform * SIZE; y++)
+                center.SetSkyLight(x, y, z, MAX_LEVEL);
+
+            // only the part of the column that a horizontal neighbor doesn't share spreads sideways
+            for (size_t face = 0; face < BLOCK_FACE_COUNT; face++)
+            {
+                const Offset offset = OFFSETS[face];
+                if (offset.Y != 0)
+                    continue;
+
+                const int nx = x + offset.X, nz = z + offset.Z;
+                int neighborHeight;
+
+                if (nx >= 0 && nx < SIZE && nz >= 0 && nz < SIZE)
+                    neighborHeight = heights[nz * SIZE + nx];
+                else if (const Chunk *neighbor = ChunkAt(chunks, nx, nz); neighbor != nullptr)
+                    neighborHeight = ColumnHeight(*neighbor, nx & 15, nz & 15);
+                else
+                    continue;
+
+                for (int y = height; y < neighborHeight; y++)
+                    m_addQueue.push_back(Node::Pack(x, y, z, MAX_LEVEL));
+            }
+        }
+    }
+}
+
+void LightEngine::SeedBlockLight(const Neighborhood &chunks)
+{
+    Chunk &center = *chunks[1][1];
+
+    for (int s = 0; s < Chunk::SECTION_COUNT; s++)
+    {
+        const ChunkSection &section = center.GetSection(s);
+
+        if (section.IsEmpty() || (section.GetStorageMode() == ChunkSection::StorageMode::SingleValue && GetLightEmission(section.Get(0)) == 0))
+            continue;
+
+        for (size_t index = 0; index < ChunkSection::VOLUME; index++)
+        {
+            const uint8_t emission = GetLightEmission(section.Get(index));
+            if (emission == 0)
+                continue;
+
+            const int x = static_cast<int>(index & 15), z = static_cast<int>(index >> 4 & 15), y = s * SIZE + static_cast<int>(index >> 8);
+            center.SetBlockLight(x, y, z, emission);
+            m_addQueue.push_back(Node::Pack(x, y, z, emission));
+        }
+    }
+}
+
+void LightEngine::SeedBorders(const Neighborhood &chunks, LightChannel channel)
+{
+    Chunk &center = *chunks[1][1];
+
+    for (size_t face = 0; face < BLOCK_FACE_COUNT; face++)
+    {
+        const Offset offset = OFFSETS[face];
+        if (offset.Y != 0)
+            continue;
+
+        Chunk *neighbor = chunks[offset.Z + 1][offset.X + 1];
+        if (neighbor == nullptr)
+            continue;
+
+        for (int s = 0; s < Chunk::SECTION_COUNT; s++)
+        {
+            const NibbleArray &outside = GetLightSection(*neighbor, channel, s);
+            const NibbleArray &inside = GetLightSection(center, channel, s);
+
+            // nothing bright enough to spread, or nothing it could brighten
+            if (outside.IsUniform() && (outside.GetFill() <= 1 || (inside.IsUniform() && inside.GetFill() + 1 >= outside.GetFill())))
+                continue;
+
+            for (int y = s * SIZE; y < (s + 1) * SIZE; y++)
+            {
+                for (int t = 0; t < SIZE; t++)
+                {
+                    // the row of blocks just outside of the center
+                    const int x = offset.X == 0 ? t : (offset.X > 0 ? SIZE : -1);
+                    const int z = offset.Z == 0 ? t : (offset.Z > 0 ? SIZE : -1);
+
+                    const uint8_t level = GetLight(*neighbor, channel, x, y, z);
+                    if (level > 1)
+                        m_addQueue.push_back(Node::Pack(x, y, z, level));
+                }
+            }
+        }
+    }
+}
+
+void LightEngine::SeedNeighbors(const Neighborhood &chunks, LightChannel channel, int x, int y, int z)
+{
+    // nothing is above the top of the world but the sky
+    if (channel == LightChannel::Sky && y == Chunk::HEIGHT - 1)
+    {
+        SetLight(*chunks[1][1], channel, x, y, z, MAX_LEVEL);
+        m_addQueue.push_back(Node::Pack(x, y, z, MAX_LEVEL));
+        return;
+    }
+
+    for (const Offset &offset : OFFSETS)
+    {
+        const int nx = x + offset.X, ny = y + offset.Y, nz = z + offset.Z;
+        if (ny < 0 || ny >= Chunk::HEIGHT)
+            continue;
+
+        const Chunk *neighbor = ChunkAt(chunks, nx, nz);
+        if (neighbor == nullptr)
+            continue;
+
+        const uint8_t level = GetLight(*neighbor, channel, nx, ny, nz);
+        if (level > 1)
+            m_addQueue.push_back(Node::Pack(nx, ny, nz, level));
+    }
+}
+
+void LightEngine::PropagateRemoval(const Neighborhood &chunks, LightChannel channel)
+{
+    for (size_t head = 0; head < m_removeQueue.size(); head++)
+    {
+        const Node node = m_removeQueue[head];
+        const int x = node.GetX(), y = node.GetY(), z = node.GetZ();
+        const uint8_t level = node.GetLevel();
+
+        for (size_t face = 0; face < BLOCK_FACE_COUNT; face++)
+        {
+            const Offset offset = OFFSETS[face];
+            const int nx = x + offset.X, ny = y + offset.Y, nz = z + offset.Z;
+            if (ny < 0 || ny >= Chunk::HEIGHT)
+                continue;
+
+            Chunk *neighbor = ChunkAt(chunks, nx, nz);
+            if (neighbor == nullptr)
+                continue;
+
+            const uint8_t neighborLevel = GetLight(*neighbor, channel, nx, ny, nz);
+            if (neighborLevel == 0)
+                continue;
+
+            // dimmer neighbors may have been lit from here, brighter ones are lit from elsewhere and fill the gap again
+            const bool skyColumn = channel == LightChannel::Sky && face == DOWN && level == MAX_LEVEL && neighborLevel == MAX_LEVEL;
+
+            if (neighborLevel < level || skyColumn)
+            {
+                SetLight(*neighbor, channel, nx, ny, nz, 0);
+                m_removeQueue.push_back(Node::Pack(nx, ny, nz, neighborLevel));
+                m_statistics.Removed++;
+
+                // an emitter in the area lights itself again
+                const uint8_t emission = channel == LightChannel::Block ? GetLightEmission(neighbor->GetBlock(nx & 15, ny, nz & 15)) : 0;
+                if (emission != 0)
+                {
+                    SetLight(*neighbor, channel, nx, ny, nz, emission);
+                    m_addQueue.push_back(Node::Pack(nx, ny, nz, emission));
+                }
+            }
+            else
+            {
+                m_addQueue.push_back(Node::Pack(nx, ny, nz, neighborLevel));
+            }
+        }
+    }
+
+    m_removeQueue.clear();
+}
+
+void LightEngine::PropagateAddition(const Neighborhood &chunks, LightChannel channel)
+{
+    for (size_t head = 0; head < m_addQueue.size(); head++)
+    {
+        const Node node = m_addQueue[head];
+        const int x = node.GetX(), y = node.GetY(), z = node.GetZ();
+
+        // the level may have been raised since the node was queued, never lowered
+        const uint8_t level = GetLight(*ChunkAt(chunks, x, z), channel, x, y, z);
+        if (level <= 1)
+            continue;
+
+        for (size_t face = 0; face < BLOCK_FACE_COUNT; face++)
+        {
+            const Offset offset = OFFSETS[face];
+            const int nx = x + offset.X, ny = y + offset.Y, nz = z + offset.Z;
+            if (ny < 0 || ny >= Chunk::HEIGHT)
+                continue;
+
+            Chunk *neighbor = ChunkAt(chunks, nx, nz);
+            if (neighbor == nullptr || IsOpaque(neighbor->GetBlock(nx & 15, ny, nz & 15)))
+                continue;
+
+            const bool skyColumn = channel == LightChannel::Sky && face == DOWN && level == MAX_LEVEL;
+            const auto target = static_cast<uint8_t>(skyColumn ? MAX_LEVEL : level - 1);
+
+            if (GetLight(*neighbor, channel, nx, ny, nz) >= target)
+                continue;
+
+            SetLight(*neighbor, channel, nx, ny, nz, target);
+            m_addQueue.push_back(Node::Pack(nx, ny, nz, target));
+            m_statistics.Added++;
+        }
+    }
+
+    m_addQueue.clear();
+}
+
+} // namespace MineClone
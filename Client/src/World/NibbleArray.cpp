@@ -0,0 +1,61 @@
+#include <MineClone/World/NibbleArray.hpp>
+
+#include <algorithm>
+
+namespace MineClone
+{
+
+NibbleArray::NibbleArray(uint8_t fill) noexcept : m_fill{fill}
+{
+}
+
+void NibbleArray::Set(size_t index, uint8_t value)
+{
+    if (m_data.empty())
+    {
+        if (value == m_fill)
+            return;
+
+        m_data.assign(BYTE_SIZE, static_cast<uint8_t>(m_fill | m_fill << 4));
+    }
+
+    uint8_t &byte = m_data[index >> 1];
+    const unsigned shift = static_cast<unsigned>(index & 1) << 2;
+    byte = static_cast<uint8_t>((byte & ~(15u << shift)) | (value & 15u) << shift);
+}
+
+void NibbleArray::Fill(uint8_t value) noexcept
+{
+    m_fill = value;
+    m_data.clear();
+    m_data.shrink_to_fit();
+}
+
+void NibbleArray::Compact()
+{
+    if (m_data.empty())
+        return;
+
+    const uint8_t first = m_data[0];
+    if ((first & 15) != first >> 4 || !std::all_of(m_data.begin(), m_data.end(), [first](uint8_t byte) { return byte == first; }))
+        return;
+
+    Fill(first & 15);
+}
+
+uint8_t NibbleArray::GetFill() const noexcept
+{
+    return m_fill;
+}
+
+bool NibbleArray::IsUniform() const noexcept
+{
+    return m_data.empty();
+}
+
+size_t NibbleArray::GetMemoryUsage() const noexcept
+{
+    return sizeof(NibbleArray) + m_data.capacity();
+}
+
+} // namespace MineClone
@@ -0,0 +1,213 @@
+#include <MineClone/World/Noise.hpp>
+
+#include <MineClone/Simd.hpp>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr int32_t PRIME_X = 501125321;
+constexpr int32_t PRIME_Y = 1136930381;
+constexpr int32_t PRIME_Z = 1720413743;
+constexpr int32_t HASH_MULTIPLIER = 0x27d4eb2d;
+
+// brings the peaks of the 2D kernel in line with the 3D one
+constexpr float SCALE_2D = 0.66f;
+
+inline Simd::Float Fade(Simd::Float t) noexcept
+{
+    // 6t^5 - 15t^4 + 10t^3
+    const Simd::Float inner = Simd::MulAdd(t, Simd::MulAdd(t, Simd::Set(6.0f), Simd::Set(-15.0f)), Simd::Set(10.0f));
+    return Simd::Mul(Simd::Mul(Simd::Mul(t, t), t), inner);
+}
+
+inline Simd::Float Lerp(Simd::Float a, Simd::Float b, Simd::Float t) noexcept
+{
+    return Simd::MulAdd(t, Simd::Sub(b, a), a);
+}
+
+inline Simd::Int Hash(Simd::Int seed, Simd::Int x, Simd::Int y) noexcept
+{
+    Simd::Int hash = Simd::Mul(Simd::Xor(seed, Simd::Xor(x, y)), Simd::SetInt(HASH_MULTIPLIER));
+    return Simd::Xor(hash, Simd::ShiftRight(hash, 15));
+}
+
+inline Simd::Int Hash(Simd::Int seed, Simd::Int x, Simd::Int y, Simd::Int z) noexcept
+{
+    return Hash(seed, x, Simd::Xor(y, z));
+}
+
+// flips the sign of value where bit 31 of sign is set
+inline Simd::Float FlipSign(Simd::Float value, Simd::Int sign) noexcept
+{
+    return Simd::AsFloat(Simd::Xor(Simd::AsInt(value), sign));
+}
+
+// one of the 8 gradients (+-1, +-2) and (+-2, +-1)
+inline Simd::Float Gradient(Simd::Int hash, Simd::Float x, Simd::Float z) noexcept
+{
+    const Simd::Int h = Simd::And(hash, Simd::SetInt(7));
+    const Simd::Int first = Simd::Less(h, Simd::SetInt(4));
+
+    const Simd::Float u = Simd::Select(first, x, z);
+    const Simd::Float v = Simd::Select(first, z, x);
+
+    return Simd::MulAdd(FlipSign(v, Simd::ShiftLeft(Simd::And(h, Simd::SetInt(2)), 30)), Simd::Set(2.0f), FlipSign(u, Simd::ShiftLeft(h, 31)));
+}
+
+// one of the 12 cube edge gradients, as in improved Perlin noise
+inline Simd::Float Gradient(Simd::Int hash, Simd::Float x, Simd::Float y, Simd::Float z) noexcept
+{
+    const Simd::Int h = Simd::And(hash, Simd::SetInt(15));
+
+    const Simd::Float u = Simd::Select(Simd::Less(h, Simd::SetInt(8)), x, y);
+    const Simd::Int useX = Simd::Or(Simd::Equal(h, Simd::SetInt(12)), Simd::Equal(h, Simd::SetInt(14)));
+    const Simd::Float v = Simd::Select(Simd::Less(h, Simd::SetInt(4)), y, Simd::Select(useX, x, z));
+
+    return Simd::Add(FlipSign(u, Simd::ShiftLeft(h, 31)), FlipSign(v, Simd::ShiftLeft(Simd::And(h, Simd::SetInt(2)), 30)));
+}
+
+Simd::Float Kernel2D(Simd::Int seed, Simd::Float x, Simd::Float z) noexcept
+{
+    const Simd::Float x0 = Simd::Floor(x), z0 = Simd::Floor(z);
+    const Simd::Float fx = Simd::Sub(x, x0), fz = Simd::Sub(z, z0);
+    const Simd::Float fx1 = Simd::Sub(fx, Simd::Set(1.0f)), fz1 = Simd::Sub(fz, Simd::Set(1.0f));
+
+    const Simd::Int ix = Simd::Mul(Simd::ToInt(x0), Simd::SetInt(PRIME_X));
+    const Simd::Int iz = Simd::Mul(Simd::ToInt(z0), Simd::SetInt(PRIME_Z));
+    const Simd::Int ix1 = Simd::Add(ix, Simd::SetInt(PRIME_X));
+    const Simd::Int iz1 = Simd::Add(iz, Simd::SetInt(PRIME_Z));
+
+    const Simd::Float n00 = Gradient(Hash(seed, ix, iz), fx, fz);
+    const Simd::Float n10 = Gradient(Hash(seed, ix1, iz), fx1, fz);
+    const Simd::Float n01 = Gradient(Hash(seed, ix, iz1), fx, fz1);
+    const Simd::Float n11 = Gradient(Hash(seed, ix1, iz1), fx1, fz1);
+
+    const Simd::Float u = Fade(fx), v = Fade(fz);
+
+    return Simd::Mul(Lerp(Lerp(n00, n10, u), Lerp(n01, n11, u), v), Simd::Set(SCALE_2D));
+}
+
+Simd::Float Kernel3D(Simd::Int seed, Simd::Float x, Simd::Float y, Simd::Float z) noexcept
+{
+    const Simd::Float x0 = Simd::Floor(x), y0 = Simd::Floor(y), z0 = Simd::Floor(z);
+    const Simd::Float fx = Simd::Sub(x, x0), fy = Simd::Sub(y, y0), fz = Simd::Sub(z, z0);
+    const Simd::Float fx1 = Simd::Sub(fx, Simd::Set(1.0f)), fy1 = Simd::Sub(fy, Simd::Set(1.0f)), fz1 = Simd::Sub(fz, Simd::Set(1.0f));
+
+    const Simd::Int ix = Simd::Mul(Simd::ToInt(x0), Simd::SetInt(PRIME_X));
+    const Simd::Int iy = Simd::Mul(Simd::ToInt(y0), Simd::SetInt(PRIME_Y));
+    const Simd::Int iz = Simd::Mul(Simd::ToInt(z0), Simd::SetInt(PRIME_Z));
+    const Simd::Int ix1 = Simd::Add(ix, Simd::SetInt(PRIME_X));
+    const Simd::Int iy1 = Simd::Add(iy, Simd::SetInt(PRIME_Y));
+    const Simd::Int iz1 = Simd::Add(iz, Simd::SetInt(PRIME_Z));
+
+    const Simd::Float n000 = Gradient(Hash(seed, ix, iy, iz), fx, fy, fz);
+    const Simd::Float n100 = Gradient(Hash(seed, ix1, iy, iz), fx1, fy, fz);
+    const Simd::Float n010 = Gradient(Hash(seed, ix, iy1, iz), fx, fy1, fz);
+    const Simd::Float n110 = Gradient(Hash(seed, ix1, iy1, iz), fx1, fy1, fz);
+    const Simd::Float n001 = Gradient(Hash(seed, ix, iy, iz1), fx, fy, fz1);
+    const Simd::Float n101 = Gradient(Hash(seed, ix1, iy, iz1), fx1, fy, fz1);
+    const Simd::Float n011 = Gradient(Hash(seed, ix, iy1, iz1), fx, fy1, fz1);
+    const Simd::Float n111 = Gradient(Hash(seed, ix1, iy1, iz1), fx1, fy1, fz1);
+
+    const Simd::Float u = Fade(fx), v = Fade(fy), w = Fade(fz);
+
+    const Simd::Float near = Lerp(Lerp(n000, n100, u), Lerp(n010, n110, u), v);
+    const Simd::Float far = Lerp(Lerp(n001, n101, u), Lerp(n011, n111, u), v);
+
+    return Lerp(near, far, w);
+}
+
+template <typename Kernel>
+Simd::Float Fractal(uint32_t seed, const FractalSettings &settings, Kernel kernel) noexcept
+{
+    Simd::Float sum = Simd::Set(0.0f);
+    float frequency = settings.Frequency, amplitude = 1.0f, totalAmplitude = 0.0f;
+
+    for (int octave = 0; octave < settings.Octaves; octave++)
+    {
+        const Simd::Int octaveSeed = Simd::SetInt(static_cast<int32_t>(seed + static_cast<uint32_t>(octave) * 0x9E3779B9u));
+        sum = Simd::MulAdd(kernel(octaveSeed, Simd::Set(frequency)), Simd::Set(amplitude), sum);
+
+        totalAmplitude += amplitude;
+        frequency *= settings.Lacunarity;
+        amplitude *= settings.Gain;
+    }
+
+    return Simd::Mul(sum, Simd::Set(totalAmplitude > 0.0f ? 1.0f / totalAmplitude : 0.0f));
+}
+
+// runs evaluate on full batches of lanes, the tail goes through a padded copy
+template <size_t Inputs, typename Evaluate>
+void ForEachBatch(const float *const (&inputs)[Inputs], float *out, size_t count, Evaluate evaluate) noexcept
+{
+    size_t i = 0;
+
+    for (; i + Simd::LANES <= count; i += Simd::LANES)
+    {
+        Simd::Float values[Inputs];
+        for (size_t input = 0; input < Inputs; input++)
+            values[input] = Simd::Load(inputs[input] + i);
+
+        Simd::Store(out + i, evaluate(values));
+    }
+
+    if (i == count)
+        return;
+
+    float padded[Inputs][Simd::LANES] = {};
+    float result[Simd::LANES];
+
+    for (size_t input = 0; input < Inputs; input++)
+        std::copy(inputs[input] + i, inputs[input] + count, padded[input]);
+
+    Simd::Float values[Inputs];
+    for (size_t input = 0; input < Inputs; input++)
+        values[input] = Simd::Load(padded[input]);
+
+    Simd::Store(result, evaluate(values));
+    std::copy(result, result + (count - i), out + i);
+}
+
+} // namespace
+
+namespace Noise
+{
+
+void Gradient2D(uint32_t seed, const float *x, const float *z, float *out, size_t count) noexcept
+{
+    const Simd::Int seedLanes = Simd::SetInt(static_cast<int32_t>(seed));
+
+    ForEachBatch<2>({x, z}, out, count, [&](const Simd::Float *values) { return Kernel2D(seedLanes, values[0], values[1]); });
+}
+
+void Gradient3D(uint32_t seed, const float *x, const float *y, const float *z, float *out, size_t count) noexcept
+{
+    const Simd::Int seedLanes = Simd::SetInt(static_cast<int32_t>(seed));
+
+    ForEachBatch<3>({x, y, z}, out, count, [&](const Simd::Float *values) { return Kernel3D(seedLanes, values[0], values[1], values[2]); });
+}
+
+void Fractal2D(uint32_t seed, const FractalSettings &settings, const float *x, const float *z, float *out, size_t count) noexcept
+{
+    ForEachBatch<2>({x, z}, out, count, [&](const Simd::Float *values) {
+        return Fractal(seed, settings, [&](Simd::Int octaveSeed, Simd::Float frequency) {
+            return Kernel2D(octaveSeed, Simd::Mul(values[0], frequency), Simd::Mul(values[1], frequency));
+        });
+    });
+}
+
+void Fractal3D(uint32_t seed, const FractalSettings &settings, const float *x, const float *y, const float *z, float *out, size_t count) noexcept
+{
+    ForEachBatch<3>({x, y, z}, out, count, [&](const Simd::Float *values) {
+        return Fractal(seed, settings, [&](Simd::Int octaveSeed, Simd::Float frequency) {
+            return Kernel3D(octaveSeed, Simd::Mul(values[0], frequency), Simd::Mul(values[1], frequency), Simd::Mul(values[2], frequency));
+        });
+    });
+}
+
+} // namespace Noise
+
+} // namespace MineClone
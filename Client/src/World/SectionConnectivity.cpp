@@ -0,0 +1,129 @@
+#include <MineClone/World/SectionConnectivity.hpp>
+
+#include <array>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr int SIZE = ChunkSection::SIZE;
+
+// bit of every unordered face pair, the diagonal is unused
+constexpr std::array<std::array<uint8_t, BLOCK_FACE_COUNT>, BLOCK_FACE_COUNT> PAIR_BITS = [] {
+    std::array<std::array<uint8_t, BLOCK_FACE_COUNT>, BLOCK_FACE_COUNT> bits{};
+    uint8_t next = 0;
+
+    for (size_t a = 0; a < BLOCK_FACE_COUNT; a++)
+    {
+        for (size_t b = a + 1; b < BLOCK_FACE_COUNT; b++)
+        {
+            bits[a][b] = next;
+            bits[b][a] = next;
+            next++;
+        }
+    }
+
+    return bits;
+}();
+
+// section faces the block at index touches
+inline uint32_t BoundaryFaces(size_t index) noexcept
+{
+    const size_t x = index & 15, z = (index >> 4) & 15, y = index >> 8;
+    uint32_t faces = 0;
+
+    faces |= static_cast<uint32_t>(x == SIZE - 1) << static_cast<int>(BlockFace::PositiveX);
+    faces |= static_cast<uint32_t>(x == 0) << static_cast<int>(BlockFace::NegativeX);
+    faces |= static_cast<uint32_t>(y == SIZE - 1) << static_cast<int>(BlockFace::PositiveY);
+    faces |= static_cast<uint32_t>(y == 0) << static_cast<int>(BlockFace::NegativeY);
+    faces |= static_cast<uint32_t>(z == SIZE - 1) << static_cast<int>(BlockFace::PositiveZ);
+    faces |= static_cast<uint32_t>(z == 0) << static_cast<int>(BlockFace::NegativeZ);
+
+    return faces;
+}
+
+} // namespace
+
+SectionConnectivity SectionConnectivity::Compute(const ChunkSection &section)
+{
+    if (section.IsEmpty())
+        return SectionConnectivity{ALL};
+
+    if (section.GetStorageMode() == ChunkSection::StorageMode::SingleValue)
+        return SectionConnectivity{IsOpaque(section.Get(0)) ? NONE : ALL};
+
+    // opaque blocks start out visited, the fill only walks through the rest
+    std::array<bool, ChunkSection::VOLUME> visited;
+    for (size_t i = 0; i < ChunkSection::VOLUME; i++)
+        visited[i] = IsOpaque(section.Get(i));
+
+    std::array<uint16_t, ChunkSection::VOLUME> stack;
+    uint16_t bits = NONE;
+
+    for (size_t start = 0; start < ChunkSection::VOLUME; start++)
+    {
+        // only air that reaches the boundary can connect two faces
+        if (visited[start] || BoundaryFaces(start) == 0)
+            continue;
+
+        size_t top = 0;
+        stack[top++] = static_cast<uint16_t>(start);
+        visited[start] = true;
+
+        uint32_t faces = 0;
+
+        while (top != 0)
+        {
+            const size_t index = stack[--top];
+            const size_t x = index & 15, z = (index >> 4) & 15, y = index >> 8;
+
+            faces |= BoundaryFaces(index);
+
+            const auto visit = [&](bool inside, size_t neighbor) {
+                if (inside && !visited[neighbor])
+                {
+                    visited[neighbor] = true;
+                    stack[top++] = static_cast<uint16_t>(neighbor);
+                }
+            };
+
+            visit(x < SIZE - 1, index + 1);
+            visit(x > 0, index - 1);
+            visit(z < SIZE - 1, index + 16);
+            visit(z > 0, index - 16);
+            visit(y < SIZE - 1, index + 256);
+            visit(y > 0, index - 256);
+        }
+
+        for (size_t a = 0; a < BLOCK_FACE_COUNT; a++)
+        {
+            for (size_t b = a + 1; b < BLOCK_FACE_COUNT; b++)
+            {
+                if ((faces >> a & 1) && (faces >> b & 1))
+                    bits |= static_cast<uint16_t>(1u << PAIR_BITS[a][b]);
+            }
+        }
+
+        if (bits == ALL)
+            break;
+    }
+
+    return SectionConnectivity{bits};
+}
+
+bool SectionConnectivity::Connects(BlockFace a, BlockFace b) const noexcept
+{
+    if (a == b)
+        return true;
+
+    return m_bits >> PAIR_BITS[static_cast<size_t>(a)][static_cast<size_t>(b)] & 1;
+}
+
+uint16_t SectionConnectivity::GetBits() const noexcept
+{
+    return m_bits;
+}
+
+} // namespace MineClone
@@ -0,0 +1,192 @@
+#include <MineClone/World/TerrainGenerator.hpp>
+
+#include <cmath>
+#include <vector>
+
+namespace MineClone
+{
+
+namespace
+{
+
+constexpr int SIZE = ChunkSection::SIZE;
+constexpr int COLUMN_COUNT = SIZE * SIZE;
+
+// 3D noise is sampled every LATTICE_STEP blocks and trilinearly interpolated in between
+constexpr int LATTICE_STEP = 4;
+constexpr int LATTICE_WIDTH = SIZE / LATTICE_STEP + 1;
+constexpr int LATTICE_HEIGHT = Chunk::HEIGHT / LATTICE_STEP + 1;
+constexpr size_t LATTICE_VOLUME = LATTICE_WIDTH * LATTICE_WIDTH * LATTICE_HEIGHT;
+
+constexpr uint32_t OVERHANG_SEED = 0x68E31DA4;
+constexpr uint32_t CAVE_SEED_A = 0xB5297A4D;
+constexpr uint32_t CAVE_SEED_B = 0x1B56C4E9;
+
+constexpr int FILLER_DEPTH = 3;
+
+// lattice columns are y contiguous so a whole column can be interpolated in one pass
+constexpr size_t LatticeIndex(int x, int z, int y) noexcept
+{
+    return (static_cast<size_t>(x) * LATTICE_WIDTH + static_cast<size_t>(z)) * LATTICE_HEIGHT + static_cast<size_t>(y);
+}
+
+struct Lattice
+{
+    std::vector<float> X, Y, Z;
+    std::vector<float> Overhang, CaveA, CaveB;
+
+    Lattice() : X(LATTICE_VOLUME), Y(LATTICE_VOLUME), Z(LATTICE_VOLUME), Overhang(LATTICE_VOLUME), CaveA(LATTICE_VOLUME), CaveB(LATTICE_VOLUME)
+    {
+    }
+}; // struct Lattice
+
+// bilinear blend of the four lattice columns around a block column
+void InterpolateColumn(const std::vector<float> &lattice, int x, int z, float *out) noexcept
+{
+    const int cellX = x / LATTICE_STEP, cellZ = z / LATTICE_STEP;
+    const float tx = static_cast<float>(x % LATTICE_STEP) / LATTICE_STEP;
+    const float tz = static_cast<float>(z % LATTICE_STEP) / LATTICE_STEP;
+
+    const float *c00 = &lattice[LatticeIndex(cellX, cellZ, 0)];
+    const float *c10 = &lattice[LatticeIndex(cellX + 1, cellZ, 0)];
+    const float *c01 = &lattice[LatticeIndex(cellX, cellZ + 1, 0)];
+    const float *c11 = &lattice[LatticeIndex(cellX + 1, cellZ + 1, 0)];
+
+    float column[LATTICE_HEIGHT];
+    for (int y = 0; y < LATTICE_HEIGHT; y++)
+    {
+        const float near = c00[y] + tx * (c10[y] - c00[y]);
+        const float far = c01[y] + tx * (c11[y] - c01[y]);
+        column[y] = near + tz * (far - near);
+    }
+
+    for (int y = 0; y < Chunk::HEIGHT; y++)
+    {
+        const int cell = y / LATTICE_STEP;
+        const float t = static_cast<float>(y % LATTICE_STEP) / LATTICE_STEP;
+        out[y] = column[cell] + t * (column[cell + 1] - column[cell]);
+    }
+}
+
+} // namespace
+
+TerrainGenerator::TerrainGenerator(TerrainSettings settings) : m_settings{settings}
+{
+}
+
+void TerrainGenerator::Generate(Chunk &chunk) const
+{
+    const float originX = static_cast<float>(chunk.GetX()) * SIZE;
+    const float originZ = static_cast<float>(chunk.GetZ()) * SIZE;
+
+    // surface height, one batch for the whole chunk
+    float columnX[COLUMN_COUNT], columnZ[COLUMN_COUNT], heights[COLUMN_COUNT];
+    for (int i = 0; i < COLUMN_COUNT; i++)
+    {
+        columnX[i] = originX + static_cast<float>(i & 15);
+        columnZ[i] = originZ + static_cast<float>(i >> 4);
+    }
+
+    Noise::Fractal2D(m_settings.Seed, m_settings.Height, columnX, columnZ, heights, COLUMN_COUNT);
+
+    for (float &height : heights)
+        height = m_settings.BaseHeight + m_settings.HeightAmplitude * height;
+
+    // coarse 3D fields for overhangs and caves
+    Lattice lattice;
+    for (int x = 0; x < LATTICE_WIDTH; x++)
+    {
+        for (int z = 0; z < LATTICE_WIDTH; z++)
+        {
+            for (int y = 0; y < LATTICE_HEIGHT; y++)
+            {
+                const size_t index = LatticeIndex(x, z, y);
+                lattice.X[index] = originX + static_cast<float>(x * LATTICE_STEP);
+                lattice.Y[index] = static_cast<float>(y * LATTICE_STEP);
+                lattice.Z[index] = originZ + static_cast<float>(z * LATTICE_STEP);
+            }
+        }
+    }
+
+    const float *X = lattice.X.data(), *Y = lattice.Y.data(), *Z = lattice.Z.data();
+    Noise::Fractal3D(m_settings.Seed ^ OVERHANG_SEED, m_settings.Overhang, X, Y, Z, lattice.Overhang.data(), LATTICE_VOLUME);
+    Noise::Fractal3D(m_settings.Seed ^ CAVE_SEED_A, m_settings.Cave, X, Y, Z, lattice.CaveA.data(), LATTICE_VOLUME);
+    Noise::Fractal3D(m_settings.Seed ^ CAVE_SEED_B, m_settings.Cave, X, Y, Z, lattice.CaveB.data(), LATTICE_VOLUME);
+
+    // resolve blocks column by column, top down so the surface layers know how deep they are
+    std::vector<BlockId> blocks(static_cast<size_t>(Chunk::HEIGHT) * COLUMN_COUNT);
+
+    float overhang[Chunk::HEIGHT], caveA[Chunk::HEIGHT], caveB[Chunk::HEIGHT];
+    float density[Chunk::HEIGHT];
+    bool cave[Chunk::HEIGHT];
+
+    for (int z = 0; z < SIZE; z++)
+    {
+        for (int x = 0; x < SIZE; x++)
+        {
+            const float height = heights[(z << 4) | x];
+
+            InterpolateColumn(lattice.Overhang, x, z, overhang);
+            InterpolateColumn(lattice.CaveA, x, z, caveA);
+            InterpolateColumn(lattice.CaveB, x, z, caveB);
+
+            for (int y = 0; y < Chunk::HEIGHT; y++)
+            {
+                density[y] = height - static_cast<float>(y) + m_settings.OverhangAmplitude * overhang[y];
+                cave[y] = std::fabs(caveA[y]) < m_settings.CaveThreshold && std::fabs(caveB[y]) < m_settings.CaveThreshold;
+            }
+
+            // keep caves from breaching the sea floor
+            const int caveCeiling = height < static_cast<float>(m_settings.SeaLevel + 2) ? static_cast<int>(height) - 6 : Chunk::HEIGHT;
+
+            int depth = 0;
+            BlockId filler = Blocks::DIRT;
+
+            for (int y = Chunk::HEIGHT - 1; y >= 0; y--)
+            {
+                BlockId block;
+
+                if (y == 0)
+                {
+                    block = Blocks::BEDROCK;
+                }
+                else if (density[y] > 0.0f)
+                {
+                    if (depth == 0)
+                    {
+                        const bool beach = y <= m_settings.SeaLevel + 1;
+                        filler = beach ? Blocks::SAND : Blocks::DIRT;
+                        block = beach ? Blocks::SAND : Blocks::GRASS;
+                    }
+                    else
+                    {
+                        block = depth <= FILLER_DEPTH ? filler : Blocks::STONE;
+                    }
+
+                    depth++;
+
+                    if (cave[y] && y < caveCeiling)
+                        block = Blocks::AIR;
+                }
+                else
+                {
+                    depth = 0;
+                    block = y <= m_settings.SeaLevel ? Blocks::WATER : Blocks::AIR;
+                }
+
+                // sections are stacked y major, so the chunk wide index is the section index continued upwards
+                blocks[(static_cast<size_t>(y) << 8) | (static_cast<size_t>(z) << 4) | static_cast<size_t>(x)] = block;
+            }
+        }
+    }
+
+    for (int section = 0; section < Chunk::SECTION_COUNT; section++)
+        chunk.GetSection(section).Assign(blocks.data() + section * ChunkSection::VOLUME);
+}
+
+const TerrainSettings &TerrainGenerator::GetSettings() const noexcept
+{
+    return m_settings;
+}
+
+} // namespace MineClone
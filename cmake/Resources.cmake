@@ -33,3 +33,61 @@ function(create_resource_bundle name)
     add_library(${name} INTERFACE)
     target_include_directories(${name} INTERFACE "${include_directory}")
 endfunction()
+
+function(create_shader_bundle name)
+    set(include_directory "${CMAKE_CURRENT_BINARY_DIR}/resources/${name}")
+    set(file "${include_directory}/${name}.hpp")
+
+    set(include_guard "${name}_HPP_")
+    string(TOUPPER "${include_guard}" include_guard)
+
+    find_program(GLSLC_EXECUTABLE NAMES glslc HINTS "$ENV{VULKAN_SDK}/bin" "$ENV{VULKAN_SDK}/Bin")
+
+    if (NOT GLSLC_EXECUTABLE)
+        message(FATAL_ERROR "glslc not found, install the Vulkan SDK or enable MINECLONE_RUNTIME_SHADER_COMPILER")
+    endif()
+
+    file(MAKE_DIRECTORY "${include_directory}")
+    file(WRITE  "${file}" "// This file is generated by CMake. Do not edit.\n")
+    file(APPEND "${file}" "#ifndef ${include_guard}\n")
+    file(APPEND "${file}" "#define ${include_guard}\n")
+    file(APPEND "${file}" "#pragma once\n\n")
+    file(APPEND "${file}" "#include <cstdint>\n\n")
+
+    set(outputs)
+
+    foreach(arg IN LISTS ARGN)
+        if (NOT DEFINED resource_name)
+            set(resource_name ${arg})
+            continue()
+        endif()
+
+        # glslc emits the optimized SPIR-V words as a C initializer list, which the header includes at build time
+        get_filename_component(source "${arg}" ABSOLUTE)
+        set(output "${include_directory}/${arg}.spv.inc")
+
+        add_custom_command(
+                OUTPUT "${output}"
+                COMMAND "${GLSLC_EXECUTABLE}" -O -mfmt=c -o "${output}" "${source}"
+                DEPENDS "${source}"
+                COMMENT "Compiling shader ${arg}"
+                VERBATIM
+        )
+
+        list(APPEND outputs "${output}")
+
+        file(APPEND "${file}" "inline constexpr uint32_t ${resource_name}[] =\n")
+        file(APPEND "${file}" "#include \"${arg}.spv.inc\"\n")
+        file(APPEND "${file}" ";\n\n")
+
+        unset(resource_name)
+    endforeach()
+
+    file(APPEND "${file}" "#endif // ${include_guard}\n")
+
+    # INTERFACE libraries can't have dependencies before CMake 3.19, consumers add ${name}_Compile to theirs instead
+    add_custom_target(${name}_Compile DEPENDS ${outputs})
+
+    add_library(${name} INTERFACE)
+    target_include_directories(${name} INTERFACE "${include_directory}")
+endfunction()